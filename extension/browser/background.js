@@ -1,11 +1,20 @@
 var port = browser.runtime.connectNative('mozillavpn');
 
+// The version of the server list we have already received.
+var serversVersion = 0;
+
 port.onMessage.addListener((response) => {
   console.log('Received: ' + JSON.stringify(response));
+
+  if (response.t === 'servers' && response.version) {
+    serversVersion = response.version;
+  }
 });
 
+// The status changes are pushed by the client.
+port.postMessage({t: 'subscribe'});
+
 setInterval(() => {
-  port.postMessage({t: 'servers'});
-  port.postMessage({t: 'status'});
+  port.postMessage({t: 'servers', version: serversVersion});
   port.postMessage({t: 'disabled_apps'});
 }, 1000);
@@ -18,6 +18,7 @@ import (
   "net"
   "bytes"
   "errors"
+  "strings"
   "unsafe"
 
   "C"
@@ -560,39 +561,56 @@ func NetfilterMarkCgroupV1(cgroup uint32) int32 {
   return mozvpn_ctx.nftCommit()
 }
 
-//export NetfilterMarkCgroupV2
-func NetfilterMarkCgroupV2(cgroup string) int32 {
+// Splits a newline-separated list of cgroup paths.
+func nftCgroupList(cgroups string) []string {
+  var list []string
+  for _, cgroup := range strings.Split(cgroups, "\n") {
+    if len(cgroup) > 0 {
+      list = append(list, cgroup)
+    }
+  }
+  return list
+}
+
+// Marks the traffic of a newline-separated list of cgroups, with a single
+// netfilter transaction.
+//export NetfilterMarkCgroupsV2
+func NetfilterMarkCgroupsV2(cgroups string) int32 {
   if mozvpn_ctx.fwmark == 0 {
     log.Println("Unable to mark traffic: no fwmark")
     return -1
   }
 
-  log.Println("Marking traffic from cgroup", cgroup)
-  mozvpn_ctx.nftMarkCgroup2xt(cgroup)
+  for _, cgroup := range nftCgroupList(cgroups) {
+    log.Println("Marking traffic from cgroup", cgroup)
+    mozvpn_ctx.nftMarkCgroup2xt(cgroup)
+  }
 
   return mozvpn_ctx.nftCommit()
 }
 
-//export NetfilterResetCgroupV2
-func NetfilterResetCgroupV2(cgroup string) int32 {
-  xtcgroup := nftXtCgroupMatch(cgroup)
-
-  // Delete all mangle rules matching against the cgroup.
-  rules, err := mozvpn_ctx.conn.GetRules(mozvpn_ctx.table_inet, mozvpn_ctx.mangle)
-  if err != nil {
-    log.Println("Failed to inspect inet/mangle rules", err)
-  } else {
-    mozvpn_ctx.nftDelCgroup2xt(rules, &xtcgroup)
+// Removes the marks of a newline-separated list of cgroups, with a single
+// netfilter transaction.
+//export NetfilterResetCgroupsV2
+func NetfilterResetCgroupsV2(cgroups string) int32 {
+  var xtcgroups []expr.Match
+  for _, cgroup := range nftCgroupList(cgroups) {
+    xtcgroups = append(xtcgroups, nftXtCgroupMatch(cgroup))
   }
 
-  // Delete all NAT rules matching against the cgroup.
-  rules, err = mozvpn_ctx.conn.GetRules(mozvpn_ctx.table_inet, mozvpn_ctx.nat)
-  if err != nil {
-    log.Println("Failed to inspect inet/nat rules", err)
-  } else {
-    mozvpn_ctx.nftDelCgroup2xt(rules, &xtcgroup)
+  // Delete all mangle and NAT rules matching against the cgroups. The rules
+  // are fetched once per chain.
+  for _, chain := range []*nftables.Chain{mozvpn_ctx.mangle, mozvpn_ctx.nat} {
+    rules, err := mozvpn_ctx.conn.GetRules(mozvpn_ctx.table_inet, chain)
+    if err != nil {
+      log.Println("Failed to inspect inet/" + chain.Name + " rules", err)
+      continue
+    }
+    for i := range xtcgroups {
+      mozvpn_ctx.nftDelCgroup2xt(rules, &xtcgroups[i])
+    }
   }
-  
+
   return mozvpn_ctx.nftCommit()
 }
 
@@ -8,42 +8,48 @@ import vpn.mozilla.lottie 1.0
 Item {
     id: lottieItem
 
+    // The renderer. Possible values:
+    // - "native": the animation is drawn by the C++ renderer
+    // - "canvas": the animation is drawn by lottie-web on a QML Canvas
+    // Default: "native"
+    property string backend: "native"
+
     // The source can be a QRC URL only.
-    property alias source: lottiePrivate.source
+    property alias source: lottieNative.source
 
     // Speed of execution. Default: 1.0
-    property alias speed: lottiePrivate.speed
+    property alias speed: lottieNative.speed
 
     // Possible values:
     // - true: infinite loop
     // - false: no loops
     // - number: the number of loops
     // Default: false
-    property alias loops: lottiePrivate.loops
+    property alias loops: lottieNative.loops
 
     // Reverse direction. Default: false
-    property alias reverse: lottiePrivate.reverse
+    property alias reverse: lottieNative.reverse
 
     // Read-only animation status. The status is an object containing the
     // following properties:
     // - playing: readonly boolean. Default: false
     // - currentTime: readonly double. Default: 0
     // - totalTime: readonly integer. Default: 0
-    property alias status: lottiePrivate.status
+    readonly property var status: backend === "canvas" ? lottiePrivate.status : lottieNative.status
 
     // Enable/disable the auto-play. Default: false
-    property alias autoPlay: lottiePrivate.autoPlay
+    property alias autoPlay: lottieNative.autoPlay
 
     // Similar to Image.fillMode, the supported values are:
     // - "stretch": the image is scaled to fit
     // - "preserveAspectFit": the image is scaled uniformly to fit without cropping
     // - "preserveAspectCrop": the image is scaled uniformly to fill, cropping if necessary
     // - "pad": the image is not transformed
-    property alias fillMode: lottiePrivate.fillMode
+    property alias fillMode: lottieNative.fillMode
 
-    function play() { lottiePrivate.play(); }
-    function pause() { lottiePrivate.pause(); }
-    function stop() { lottiePrivate.stop(); }
+    function play() { backend === "canvas" ? lottiePrivate.play() : lottieNative.play(); }
+    function pause() { backend === "canvas" ? lottiePrivate.pause() : lottieNative.pause(); }
+    function stop() { backend === "canvas" ? lottiePrivate.stop() : lottieNative.stop(); }
 
     signal loopCompleted()
 
@@ -64,6 +70,7 @@ Item {
     Canvas {
         id: canvas
         anchors.fill: parent
+        visible: lottieItem.backend === "canvas"
 
         // HTML DOM compatibility API
         property real offsetWidth: width
@@ -74,6 +81,16 @@ Item {
         }
     }
 
+    LottieNative {
+        id: lottieNative
+        anchors.fill: parent
+        visible: lottieItem.backend !== "canvas"
+
+        property bool componentCompleted: false
+
+        readyToPlay: visible && componentCompleted && source && lottieItem.visible
+    }
+
     onWidthChanged: Qt.callLater(lottiePrivate.clearAndResize)
     onHeightChanged: Qt.callLater(lottiePrivate.clearAndResize)
 
@@ -82,14 +99,24 @@ Item {
 
         property bool componentCompleted: false
 
-        readyToPlay: canvas.available && componentCompleted && source && lottieItem.visible
+        source: lottieNative.source
+        speed: lottieNative.speed
+        loops: lottieNative.loops
+        reverse: lottieNative.reverse
+        autoPlay: lottieNative.autoPlay
+        fillMode: lottieNative.fillMode
+
+        // The lottie-web module is loaded only for the canvas backend.
+        readyToPlay: lottieItem.backend === "canvas" && canvas.available && componentCompleted && source && lottieItem.visible
     }
 
     onParentChanged: Qt.callLater(lottiePrivate.destroyAndRecreate);
 
     Component.onCompleted: {
         lottiePrivate.loopCompleted.connect(loopCompleted);
+        lottieNative.loopCompleted.connect(loopCompleted);
 
+        lottieNative.componentCompleted = true;
         lottiePrivate.componentCompleted = true;
         lottiePrivate.setCanvasAndContainer(canvas, container);
     }
@@ -0,0 +1,510 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "lottiemodel.h"
+
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QWeakPointer>
+#include <cmath>
+
+// Precompositions can reference other precompositions.
+constexpr int MAX_PRECOMP_DEPTH = 8;
+
+namespace {
+QMutex s_cacheMutex;
+QHash<QString, QWeakPointer<const LottieModel>> s_cache;
+
+double easeComponent(const QJsonValue& value, double defaultValue) {
+  if (value.isArray()) {
+    return value.toArray().at(0).toDouble(defaultValue);
+  }
+  return value.toDouble(defaultValue);
+}
+
+QPointF parseEasing(const QJsonValue& json, const QPointF& defaultValue) {
+  if (!json.isObject()) {
+    return defaultValue;
+  }
+
+  QJsonObject obj = json.toObject();
+  return QPointF(easeComponent(obj["x"], defaultValue.x()),
+                 easeComponent(obj["y"], defaultValue.y()));
+}
+
+double bezier(double a, double b, double t) {
+  // Cubic bezier from 0 to 1 with control points a and b.
+  double u = 1 - t;
+  return 3 * u * u * t * a + 3 * u * t * t * b + t * t * t;
+}
+
+double bezierSlope(double a, double b, double t) {
+  double u = 1 - t;
+  return 3 * u * u * a + 6 * u * t * (b - a) + 3 * t * t * (1 - b);
+}
+
+}  // namespace
+
+// static
+QSharedPointer<const LottieModel> LottieModel::load(const QString& fileName,
+                                                    QString* errorString) {
+  {
+    QMutexLocker lock(&s_cacheMutex);
+    QSharedPointer<const LottieModel> model =
+        s_cache.value(fileName).toStrongRef();
+    if (model) {
+      return model;
+    }
+  }
+
+  QFile file(fileName);
+  if (!file.open(QFile::ReadOnly)) {
+    *errorString = QString("Failed to open the source URL %1").arg(fileName);
+    return nullptr;
+  }
+
+  QSharedPointer<const LottieModel> model =
+      fromJson(file.readAll(), errorString);
+  if (!model) {
+    return nullptr;
+  }
+
+  QMutexLocker lock(&s_cacheMutex);
+  s_cache.insert(fileName, model);
+  return model;
+}
+
+// static
+QSharedPointer<const LottieModel> LottieModel::fromJson(
+    const QByteArray& json, QString* errorString) {
+  QJsonParseError error;
+  QJsonDocument doc = QJsonDocument::fromJson(json, &error);
+  if (!doc.isObject()) {
+    *errorString = QString("Failed to parse the source as JSON: %1")
+                       .arg(error.errorString());
+    return nullptr;
+  }
+
+  QJsonObject obj = doc.object();
+
+  QSharedPointer<LottieModel> model(new LottieModel());
+  model->m_frameRate = obj["fr"].toDouble();
+  model->m_inPoint = obj["ip"].toDouble();
+  model->m_outPoint = obj["op"].toDouble();
+  model->m_width = obj["w"].toDouble();
+  model->m_height = obj["h"].toDouble();
+
+  if (model->m_frameRate <= 0 || model->totalFrames() <= 0 ||
+      model->m_width <= 0 || model->m_height <= 0) {
+    *errorString = "Invalid animation: missing size or duration";
+    return nullptr;
+  }
+
+  QHash<QString, QJsonValue> assets;
+  for (const QJsonValue& asset : obj["assets"].toArray()) {
+    QJsonObject assetObj = asset.toObject();
+    if (assetObj.contains("layers")) {
+      assets.insert(assetObj["id"].toString(), assetObj["layers"]);
+    }
+  }
+
+  model->m_layers = parseLayers(obj["layers"], assets, 0);
+  return model;
+}
+
+// static
+QList<LottieModel::Layer> LottieModel::parseLayers(
+    const QJsonValue& json, const QHash<QString, QJsonValue>& assets,
+    int depth) {
+  QList<Layer> layers;
+
+  for (const QJsonValue& value : json.toArray()) {
+    QJsonObject obj = value.toObject();
+
+    Layer layer;
+    layer.m_index = obj["ind"].toInt(-1);
+    layer.m_parent = obj["parent"].toInt(-1);
+    layer.m_type = obj["ty"].toInt(LayerNull);
+    layer.m_inPoint = obj["ip"].toDouble();
+    layer.m_outPoint = obj["op"].toDouble();
+    layer.m_startTime = obj["st"].toDouble();
+    layer.m_stretch = obj["sr"].toDouble(1);
+    if (layer.m_stretch == 0) {
+      layer.m_stretch = 1;
+    }
+    layer.m_hidden = obj["hd"].toBool();
+    layer.m_matteSource = obj["td"].toInt() != 0;
+    layer.m_transform = parseTransform(obj["ks"].toObject());
+
+    switch (layer.m_type) {
+      case LayerShape:
+        layer.m_shapes = parseShapes(obj["shapes"]);
+        break;
+
+      case LayerSolid:
+        layer.m_width = obj["sw"].toDouble();
+        layer.m_height = obj["sh"].toDouble();
+        layer.m_color = QColor(obj["sc"].toString());
+        break;
+
+      case LayerPrecomp:
+        layer.m_width = obj["w"].toDouble();
+        layer.m_height = obj["h"].toDouble();
+        if (depth < MAX_PRECOMP_DEPTH) {
+          layer.m_layers =
+              parseLayers(assets.value(obj["refId"].toString()), assets,
+                          depth + 1);
+        }
+        break;
+
+      default:
+        break;
+    }
+
+    layers.append(layer);
+  }
+
+  return layers;
+}
+
+// static
+QList<LottieModel::Shape> LottieModel::parseShapes(const QJsonValue& json) {
+  QList<Shape> shapes;
+
+  for (const QJsonValue& value : json.toArray()) {
+    QJsonObject obj = value.toObject();
+    if (obj["hd"].toBool()) {
+      continue;
+    }
+
+    QString type = obj["ty"].toString();
+    Shape shape;
+
+    if (type == "gr") {
+      shape.m_type = ShapeGroup;
+
+      // The transform of a group is its last item.
+      QJsonArray items = obj["it"].toArray();
+      for (const QJsonValue& item : items) {
+        if (item.toObject()["ty"].toString() == "tr") {
+          shape.m_transform = parseTransform(item.toObject());
+        }
+      }
+      shape.m_children = parseShapes(items);
+    } else if (type == "sh") {
+      shape.m_type = ShapePath;
+      shape.m_path = parseProperty(obj["ks"], QList<double>());
+
+      // The closed flag is part of the path value.
+      QJsonValue k = obj["ks"].toObject()["k"];
+      if (k.isArray() && k.toArray().at(0).isObject()) {
+        k = k.toArray().at(0).toObject()["s"];
+      }
+      parseValue(k, &shape.m_closed);
+    } else if (type == "el") {
+      shape.m_type = ShapeEllipse;
+      shape.m_position = parseProperty(obj["p"], {0, 0});
+      shape.m_size = parseProperty(obj["s"], {0, 0});
+    } else if (type == "rc") {
+      shape.m_type = ShapeRect;
+      shape.m_position = parseProperty(obj["p"], {0, 0});
+      shape.m_size = parseProperty(obj["s"], {0, 0});
+      shape.m_roundness = parseProperty(obj["r"], {0});
+    } else if (type == "fl" || type == "st") {
+      shape.m_type = type == "fl" ? ShapeFill : ShapeStroke;
+      shape.m_color = parseProperty(obj["c"], {0, 0, 0, 1});
+      shape.m_opacity = parseProperty(obj["o"], {100});
+      shape.m_fillRule =
+          obj["r"].toInt(1) == 2 ? Qt::OddEvenFill : Qt::WindingFill;
+
+      if (shape.m_type == ShapeStroke) {
+        shape.m_width = parseProperty(obj["w"], {1});
+        shape.m_miterLimit = obj["ml"].toDouble(4);
+
+        switch (obj["lc"].toInt(2)) {
+          case 1:
+            shape.m_capStyle = Qt::FlatCap;
+            break;
+          case 3:
+            shape.m_capStyle = Qt::SquareCap;
+            break;
+          default:
+            shape.m_capStyle = Qt::RoundCap;
+            break;
+        }
+
+        switch (obj["lj"].toInt(2)) {
+          case 1:
+            shape.m_joinStyle = Qt::MiterJoin;
+            break;
+          case 3:
+            shape.m_joinStyle = Qt::BevelJoin;
+            break;
+          default:
+            shape.m_joinStyle = Qt::RoundJoin;
+            break;
+        }
+      }
+    } else {
+      // Transforms are handled with their group. Merges, trims and any other
+      // modifier are not supported.
+      continue;
+    }
+
+    shapes.append(shape);
+  }
+
+  return shapes;
+}
+
+// static
+LottieModel::Transform LottieModel::parseTransform(const QJsonObject& json) {
+  Transform transform;
+  transform.m_anchor = parseProperty(json["a"], {0, 0});
+  transform.m_scale = parseProperty(json["s"], {100, 100});
+  transform.m_rotation = parseProperty(json["r"], {0});
+  transform.m_opacity = parseProperty(json["o"], {100});
+
+  QJsonObject position = json["p"].toObject();
+  if (position["s"].toBool()) {
+    transform.m_splitPosition = true;
+    transform.m_positionX = parseProperty(position["x"], {0});
+    transform.m_positionY = parseProperty(position["y"], {0});
+  } else {
+    transform.m_position = parseProperty(position, {0, 0});
+  }
+
+  return transform;
+}
+
+// static
+LottieModel::Property LottieModel::parseProperty(
+    const QJsonValue& json, const QList<double>& defaultValue) {
+  Property property;
+  property.m_value = defaultValue;
+
+  if (!json.isObject()) {
+    return property;
+  }
+
+  QJsonValue k = json.toObject()["k"];
+  if (!k.isArray() || !k.toArray().at(0).isObject() ||
+      !k.toArray().at(0).toObject().contains("t")) {
+    property.m_value = parseValue(k, nullptr);
+    if (property.m_value.isEmpty()) {
+      property.m_value = defaultValue;
+    }
+    return property;
+  }
+
+  QJsonArray keyframes = k.toArray();
+  for (qsizetype i = 0; i < keyframes.count(); ++i) {
+    QJsonObject obj = keyframes.at(i).toObject();
+
+    Keyframe keyframe;
+    keyframe.m_time = obj["t"].toDouble();
+    keyframe.m_start = parseValue(obj["s"], nullptr);
+    keyframe.m_end = parseValue(obj["e"], nullptr);
+    keyframe.m_easeOut = parseEasing(obj["o"], QPointF(0, 0));
+    keyframe.m_easeIn = parseEasing(obj["i"], QPointF(1, 1));
+    keyframe.m_hold = obj["h"].toInt() == 1;
+
+    // Older files store the end value in each keyframe, the newer ones take
+    // it from the next keyframe. The last keyframe can have only a time.
+    if (keyframe.m_start.isEmpty() && !property.m_keyframes.isEmpty()) {
+      keyframe.m_start = property.m_keyframes.last().m_end;
+    }
+    if (keyframe.m_end.isEmpty() && i + 1 < keyframes.count()) {
+      keyframe.m_end =
+          parseValue(keyframes.at(i + 1).toObject()["s"], nullptr);
+    }
+    if (keyframe.m_end.isEmpty()) {
+      keyframe.m_end = keyframe.m_start;
+    }
+
+    property.m_keyframes.append(keyframe);
+  }
+
+  if (!property.m_keyframes.isEmpty()) {
+    property.m_value = property.m_keyframes.first().m_start;
+  }
+
+  return property;
+}
+
+// static
+QList<double> LottieModel::parseValue(const QJsonValue& json, bool* closed) {
+  QList<double> value;
+
+  if (json.isDouble()) {
+    value.append(json.toDouble());
+    return value;
+  }
+
+  QJsonObject path;
+  if (json.isObject()) {
+    path = json.toObject();
+  } else if (json.isArray() && json.toArray().at(0).isObject()) {
+    // Path keyframes wrap the value in an array.
+    path = json.toArray().at(0).toObject();
+  } else {
+    for (const QJsonValue& number : json.toArray()) {
+      value.append(number.toDouble());
+    }
+    return value;
+  }
+
+  QJsonArray vertices = path["v"].toArray();
+  QJsonArray inTangents = path["i"].toArray();
+  QJsonArray outTangents = path["o"].toArray();
+  for (qsizetype i = 0; i < vertices.count(); ++i) {
+    QJsonArray v = vertices.at(i).toArray();
+    QJsonArray in = inTangents.at(i).toArray();
+    QJsonArray out = outTangents.at(i).toArray();
+    value << v.at(0).toDouble() << v.at(1).toDouble() << in.at(0).toDouble()
+          << in.at(1).toDouble() << out.at(0).toDouble()
+          << out.at(1).toDouble();
+  }
+
+  if (closed) {
+    *closed = path["c"].toBool();
+  }
+
+  return value;
+}
+
+// static
+double LottieModel::ease(const QPointF& out, const QPointF& in,
+                         double progress) {
+  if (progress <= 0) {
+    return 0;
+  }
+  if (progress >= 1) {
+    return 1;
+  }
+
+  // Linear easing.
+  if (out.x() == out.y() && in.x() == in.y()) {
+    return progress;
+  }
+
+  // Let's find the bezier parameter for this progress with Newton's method,
+  // falling back to a bisection if it does not converge.
+  double t = progress;
+  for (int i = 0; i < 8; ++i) {
+    double error = bezier(out.x(), in.x(), t) - progress;
+    if (std::fabs(error) < 1e-6) {
+      return bezier(out.y(), in.y(), t);
+    }
+
+    double slope = bezierSlope(out.x(), in.x(), t);
+    if (std::fabs(slope) < 1e-6) {
+      break;
+    }
+    t -= error / slope;
+  }
+
+  double low = 0;
+  double high = 1;
+  t = progress;
+  for (int i = 0; i < 32; ++i) {
+    double x = bezier(out.x(), in.x(), t);
+    if (std::fabs(x - progress) < 1e-6) {
+      break;
+    }
+    if (x < progress) {
+      low = t;
+    } else {
+      high = t;
+    }
+    t = (low + high) / 2;
+  }
+
+  return bezier(out.y(), in.y(), t);
+}
+
+QList<double> LottieModel::Property::valueAt(double frame) const {
+  if (m_keyframes.isEmpty()) {
+    return m_value;
+  }
+
+  const Keyframe& first = m_keyframes.first();
+  if (frame <= first.m_time) {
+    return first.m_start;
+  }
+
+  for (qsizetype i = 0; i < m_keyframes.count() - 1; ++i) {
+    const Keyframe& keyframe = m_keyframes.at(i);
+    const Keyframe& next = m_keyframes.at(i + 1);
+    if (frame >= next.m_time) {
+      continue;
+    }
+
+    if (keyframe.m_hold || next.m_time <= keyframe.m_time ||
+        keyframe.m_start.count() != keyframe.m_end.count()) {
+      return keyframe.m_start;
+    }
+
+    double progress = ease(
+        keyframe.m_easeOut, keyframe.m_easeIn,
+        (frame - keyframe.m_time) / (next.m_time - keyframe.m_time));
+
+    QList<double> value(keyframe.m_start.count());
+    for (qsizetype j = 0; j < value.count(); ++j) {
+      value[j] = keyframe.m_start.at(j) +
+                 (keyframe.m_end.at(j) - keyframe.m_start.at(j)) * progress;
+    }
+    return value;
+  }
+
+  // After the last keyframe.
+  const Keyframe& last = m_keyframes.last();
+  if (m_keyframes.count() > 1 && last.m_start.isEmpty()) {
+    return m_keyframes.at(m_keyframes.count() - 2).m_end;
+  }
+  return last.m_start;
+}
+
+double LottieModel::Property::scalarAt(double frame,
+                                       double defaultValue) const {
+  QList<double> value = valueAt(frame);
+  return value.isEmpty() ? defaultValue : value.first();
+}
+
+QPointF LottieModel::Property::pointAt(double frame,
+                                       const QPointF& defaultValue) const {
+  QList<double> value = valueAt(frame);
+  if (value.count() < 2) {
+    return defaultValue;
+  }
+  return QPointF(value.at(0), value.at(1));
+}
+
+QTransform LottieModel::Transform::matrixAt(double frame) const {
+  QPointF anchor = m_anchor.pointAt(frame, QPointF(0, 0));
+  QPointF scale = m_scale.pointAt(frame, QPointF(100, 100));
+
+  QPointF position;
+  if (m_splitPosition) {
+    position =
+        QPointF(m_positionX.scalarAt(frame), m_positionY.scalarAt(frame));
+  } else {
+    position = m_position.pointAt(frame, QPointF(0, 0));
+  }
+
+  // QTransform applies the last operation first.
+  QTransform matrix;
+  matrix.translate(position.x(), position.y());
+  matrix.rotate(m_rotation.scalarAt(frame));
+  matrix.scale(scale.x() / 100, scale.y() / 100);
+  matrix.translate(-anchor.x(), -anchor.y());
+  return matrix;
+}
+
+double LottieModel::Transform::opacityAt(double frame) const {
+  return qBound(0.0, m_opacity.scalarAt(frame, 100) / 100, 1.0);
+}
@@ -0,0 +1,177 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef LOTTIEMODEL_H
+#define LOTTIEMODEL_H
+
+#include <QColor>
+#include <QHash>
+#include <QList>
+#include <QPointF>
+#include <QSharedPointer>
+#include <QString>
+#include <QTransform>
+
+class QJsonObject;
+class QJsonValue;
+
+// The Bodymovin JSON of an animation, parsed once into a flattened
+// representation: every property is a static value or a list of keyframes,
+// and every value is a list of numbers (points are [x, y], colors are
+// [r, g, b, a] and paths are [vx, vy, ix, iy, ox, oy] for each vertex).
+//
+// Only the features used by the VPN animations are supported: shape, solid,
+// null and precomposition layers with parenting; groups, paths, ellipses,
+// rectangles, fills and strokes. Other items, masks and mattes are ignored.
+
+class LottieModel final {
+ public:
+  struct Keyframe {
+    double m_time = 0;
+    QList<double> m_start;
+    QList<double> m_end;
+    // Control points of the cubic-bezier easing.
+    QPointF m_easeOut = QPointF(0, 0);
+    QPointF m_easeIn = QPointF(1, 1);
+    bool m_hold = false;
+  };
+
+  struct Property {
+    QList<double> m_value;
+    QList<Keyframe> m_keyframes;
+
+    bool isAnimated() const { return !m_keyframes.isEmpty(); }
+
+    QList<double> valueAt(double frame) const;
+    double scalarAt(double frame, double defaultValue = 0) const;
+    QPointF pointAt(double frame, const QPointF& defaultValue) const;
+  };
+
+  struct Transform {
+    Property m_anchor;
+    Property m_position;
+    // Used instead of m_position when the dimensions are separated.
+    bool m_splitPosition = false;
+    Property m_positionX;
+    Property m_positionY;
+    Property m_scale;
+    Property m_rotation;
+    Property m_opacity;
+
+    QTransform matrixAt(double frame) const;
+    // Between 0 and 1.
+    double opacityAt(double frame) const;
+  };
+
+  enum ShapeType {
+    ShapeGroup,
+    ShapePath,
+    ShapeEllipse,
+    ShapeRect,
+    ShapeFill,
+    ShapeStroke,
+  };
+
+  struct Shape {
+    ShapeType m_type = ShapeGroup;
+
+    // Groups.
+    QList<Shape> m_children;
+    Transform m_transform;
+
+    // Paths, ellipses and rectangles.
+    Property m_path;
+    bool m_closed = false;
+    Property m_position;
+    Property m_size;
+    Property m_roundness;
+
+    // Fills and strokes.
+    Property m_color;
+    Property m_opacity;
+    Property m_width;
+    Qt::FillRule m_fillRule = Qt::WindingFill;
+    Qt::PenCapStyle m_capStyle = Qt::FlatCap;
+    Qt::PenJoinStyle m_joinStyle = Qt::MiterJoin;
+    double m_miterLimit = 4;
+  };
+
+  enum LayerType {
+    LayerPrecomp = 0,
+    LayerSolid = 1,
+    LayerImage = 2,
+    LayerNull = 3,
+    LayerShape = 4,
+  };
+
+  struct Layer {
+    int m_index = -1;
+    int m_parent = -1;
+    int m_type = LayerNull;
+    double m_inPoint = 0;
+    double m_outPoint = 0;
+    double m_startTime = 0;
+    double m_stretch = 1;
+    bool m_hidden = false;
+    // Track matte sources are not drawn.
+    bool m_matteSource = false;
+
+    Transform m_transform;
+    QList<Shape> m_shapes;
+
+    // Precompositions and solids.
+    QList<Layer> m_layers;
+    double m_width = 0;
+    double m_height = 0;
+    QColor m_color;
+
+    // Converts a frame of the composition into a frame of the layer.
+    double localFrame(double frame) const {
+      return (frame - m_startTime) / m_stretch;
+    }
+  };
+
+  // Returns the parsed animation. The models are shared: a file is parsed
+  // once for all the items showing it.
+  static QSharedPointer<const LottieModel> load(const QString& fileName,
+                                                QString* errorString);
+
+  static QSharedPointer<const LottieModel> fromJson(const QByteArray& json,
+                                                    QString* errorString);
+
+  double frameRate() const { return m_frameRate; }
+  double inPoint() const { return m_inPoint; }
+  double outPoint() const { return m_outPoint; }
+  double totalFrames() const { return m_outPoint - m_inPoint; }
+  double width() const { return m_width; }
+  double height() const { return m_height; }
+
+  const QList<Layer>& layers() const { return m_layers; }
+
+  // Exposed for testing.
+  static double ease(const QPointF& out, const QPointF& in, double progress);
+
+ private:
+  LottieModel() = default;
+
+  static Property parseProperty(const QJsonValue& json,
+                                const QList<double>& defaultValue);
+  static QList<double> parseValue(const QJsonValue& json, bool* closed);
+  static Transform parseTransform(const QJsonObject& json);
+  static QList<Shape> parseShapes(const QJsonValue& json);
+  static QList<Layer> parseLayers(const QJsonValue& json,
+                                  const QHash<QString, QJsonValue>& assets,
+                                  int depth);
+
+ private:
+  double m_frameRate = 0;
+  double m_inPoint = 0;
+  double m_outPoint = 0;
+  double m_width = 0;
+  double m_height = 0;
+
+  QList<Layer> m_layers;
+};
+
+#endif  // LOTTIEMODEL_H
@@ -0,0 +1,224 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "lottienative.h"
+
+#include <QJSEngine>
+#include <QPainter>
+#include <QtMath>
+
+#include "lottiemodel.h"
+#include "lottieprivate.h"
+#include "lottierenderer.h"
+
+constexpr const char* FILLMODE_STRETCH = "stretch";
+constexpr const char* FILLMODE_PAD = "pad";
+constexpr const char* FILLMODE_PRESERVEASPECTFIT = "preserveAspectFit";
+constexpr const char* FILLMODE_PRESERVEASPECTCROP = "preserveAspectCrop";
+
+// About 60 frames per second, as requestAnimationFrame.
+constexpr int FRAME_INTERVAL_MSEC = 16;
+
+// As lottie-web, which stops at `totalFrames - 0.01`.
+constexpr double LAST_FRAME_OFFSET = 0.01;
+
+LottieNative::LottieNative(QQuickItem* parent)
+    : QQuickPaintedItem(parent), m_loops(false) {
+  // The status is a member: the JS engine must not garbage-collect it.
+  QJSEngine::setObjectOwnership(&m_status, QJSEngine::CppOwnership);
+
+  m_timer.setTimerType(Qt::PreciseTimer);
+  m_timer.setInterval(FRAME_INTERVAL_MSEC);
+  connect(&m_timer, &QTimer::timeout, this, &LottieNative::advance);
+}
+
+LottieNative::~LottieNative() = default;
+
+void LottieNative::setSource(const QString& source) {
+  m_source = source;
+  emit sourceChanged();
+  loadAnimation();
+}
+
+void LottieNative::setReadyToPlay(bool readyToPlay) {
+  m_readyToPlay = readyToPlay;
+  emit readyToPlayChanged();
+
+  if (!m_readyToPlay) {
+    m_timer.stop();
+    return;
+  }
+
+  if (m_modelSource != m_source) {
+    loadAnimation();
+    return;
+  }
+
+  if (m_status.playing()) {
+    m_elapsedTimer.restart();
+    m_timer.start();
+  }
+}
+
+void LottieNative::setSpeed(qreal speed) {
+  m_speed = speed;
+  emit speedChanged();
+}
+
+void LottieNative::setLoops(QJSValue loops) {
+  if (!loops.isBool() && !loops.isNumber()) {
+    return;
+  }
+
+  m_loops = loops;
+  emit loopsChanged();
+  loadAnimation();
+}
+
+void LottieNative::setReverse(bool reverse) {
+  m_reverse = reverse;
+  emit reverseChanged();
+}
+
+void LottieNative::setAutoPlay(bool autoPlay) {
+  m_autoPlay = autoPlay;
+  emit autoPlayChanged();
+  loadAnimation();
+}
+
+void LottieNative::setFillMode(const QString& fillMode) {
+  if (fillMode != FILLMODE_STRETCH && fillMode != FILLMODE_PRESERVEASPECTFIT &&
+      fillMode != FILLMODE_PRESERVEASPECTCROP && fillMode != FILLMODE_PAD)
+    return;
+
+  m_fillMode = fillMode;
+  emit fillModeChanged();
+  update();
+}
+
+QJSValue LottieNative::status() {
+  return LottiePrivate::engine()->toScriptValue(&m_status);
+}
+
+void LottieNative::loadAnimation() {
+  if (!m_readyToPlay) return;
+
+  bool wasPlaying = m_status.playing();
+
+  m_timer.stop();
+  m_model.reset();
+  m_modelSource = m_source;
+  m_frame = 0;
+  m_loopCount = 0;
+  update();
+
+  if (m_source.isEmpty()) return;
+
+  // The models are cached: restarting the animation does not parse it again.
+  QString errorString;
+  m_model = LottieModel::load(m_source, &errorString);
+  if (!m_model) {
+    m_status.error(errorString);
+    return;
+  }
+
+  m_status.reset();
+
+  if (wasPlaying || m_autoPlay) {
+    play();
+  } else {
+    m_status.resetAndNotify();
+  }
+}
+
+void LottieNative::play() {
+  if (!m_model) return;
+
+  // A completed animation starts again.
+  double totalFrames = m_model->totalFrames();
+  if (!m_reverse && m_frame >= totalFrames) {
+    m_frame = 0;
+  } else if (m_reverse && m_frame <= 0) {
+    m_frame = totalFrames;
+  }
+
+  m_elapsedTimer.restart();
+  if (m_readyToPlay) {
+    m_timer.start();
+  }
+
+  m_status.updateAndNotify(true);
+}
+
+void LottieNative::pause() {
+  if (!m_model) return;
+
+  m_timer.stop();
+  m_status.updateAndNotify(false);
+}
+
+void LottieNative::stop() {
+  if (!m_model) return;
+
+  m_timer.stop();
+  m_frame = 0;
+  m_loopCount = 0;
+  update();
+
+  m_status.resetAndNotify();
+}
+
+bool LottieNative::canLoop() const {
+  if (m_loops.isBool()) {
+    return m_loops.toBool();
+  }
+
+  return m_loopCount < m_loops.toInt();
+}
+
+void LottieNative::advance() {
+  Q_ASSERT(m_model);
+
+  double totalFrames = m_model->totalFrames();
+  double delta = m_elapsedTimer.restart() / 1000.0 * m_model->frameRate() *
+                 (m_reverse ? -m_speed : m_speed);
+  if (delta == 0) return;
+
+  double frame = m_frame + delta;
+  if (frame >= 0 && frame < totalFrames) {
+    m_frame = frame;
+    update();
+    m_status.updateAndNotify(true, m_frame, static_cast<int>(totalFrames));
+    return;
+  }
+
+  if (!canLoop()) {
+    // The last frame stays visible.
+    m_timer.stop();
+    m_frame = frame < 0 ? 0 : totalFrames;
+    update();
+    m_status.updateAndNotify(true, m_frame, static_cast<int>(totalFrames));
+    m_status.resetAndNotify();
+    return;
+  }
+
+  ++m_loopCount;
+  m_frame = frame - qFloor(frame / totalFrames) * totalFrames;
+  update();
+  m_status.updateAndNotify(true, m_frame, static_cast<int>(totalFrames));
+  emit loopCompleted();
+}
+
+void LottieNative::paint(QPainter* painter) {
+  if (!m_model) return;
+
+  painter->setTransform(
+      LottieRenderer::viewTransform(QSizeF(m_model->width(), m_model->height()),
+                                    size(), m_fillMode),
+      true);
+
+  // The out-point is excluded: a completed animation shows the frame before.
+  double frame = qMin(m_frame, m_model->totalFrames() - LAST_FRAME_OFFSET);
+  LottieRenderer::render(painter, *m_model, m_model->inPoint() + frame);
+}
@@ -0,0 +1,107 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef LOTTIENATIVE_H
+#define LOTTIENATIVE_H
+
+#include <QElapsedTimer>
+#include <QJSValue>
+#include <QSharedPointer>
+#include <QTimer>
+#include <QtQuick/QQuickPaintedItem>
+
+#include "lottiestatus.h"
+
+class LottieModel;
+
+// Plays an animation with the C++ renderer, without the JS engine. The
+// properties and the status are the same as the ones of LottiePrivate, and
+// the playback follows the lottie-web semantics.
+class LottieNative : public QQuickPaintedItem {
+  Q_OBJECT
+  Q_PROPERTY(QString source READ source WRITE setSource NOTIFY sourceChanged)
+  Q_PROPERTY(bool readyToPlay READ readyToPlay WRITE setReadyToPlay NOTIFY
+                 readyToPlayChanged)
+  Q_PROPERTY(qreal speed READ speed WRITE setSpeed NOTIFY speedChanged)
+  Q_PROPERTY(QJSValue loops READ loops WRITE setLoops NOTIFY loopsChanged)
+  Q_PROPERTY(bool reverse READ reverse WRITE setReverse NOTIFY reverseChanged)
+  Q_PROPERTY(QJSValue status READ status CONSTANT)
+  Q_PROPERTY(
+      bool autoPlay READ autoPlay WRITE setAutoPlay NOTIFY autoPlayChanged)
+  Q_PROPERTY(
+      QString fillMode READ fillMode WRITE setFillMode NOTIFY fillModeChanged)
+  QML_ELEMENT
+
+ public:
+  LottieNative(QQuickItem* parent = 0);
+  ~LottieNative();
+
+  Q_INVOKABLE void play();
+  Q_INVOKABLE void pause();
+  Q_INVOKABLE void stop();
+
+  const QString& source() const { return m_source; }
+  void setSource(const QString& source);
+
+  bool readyToPlay() const { return m_readyToPlay; }
+  void setReadyToPlay(bool readyToPlay);
+
+  qreal speed() const { return m_speed; }
+  void setSpeed(qreal speed);
+
+  QJSValue loops() const { return m_loops; }
+  void setLoops(QJSValue loops);
+
+  bool reverse() const { return m_reverse; }
+  void setReverse(bool reverse);
+
+  QJSValue status();
+
+  bool autoPlay() const { return m_autoPlay; }
+  void setAutoPlay(bool autoPlay);
+
+  const QString& fillMode() const { return m_fillMode; }
+  void setFillMode(const QString& fillMode);
+
+  void paint(QPainter* painter) override;
+
+ signals:
+  void sourceChanged();
+  void readyToPlayChanged();
+  void speedChanged();
+  void loopsChanged();
+  void reverseChanged();
+  void autoPlayChanged();
+  void fillModeChanged();
+  void loopCompleted();
+
+ private:
+  void loadAnimation();
+  void advance();
+
+  // Returns true if the animation can start a new loop.
+  bool canLoop() const;
+
+ private:
+  QString m_source;
+  bool m_readyToPlay = false;
+  qreal m_speed = 1.0;
+  QJSValue m_loops;
+  bool m_reverse = false;
+  LottieStatus m_status;
+  bool m_autoPlay = false;
+  QString m_fillMode = "stretch";
+
+  QSharedPointer<const LottieModel> m_model;
+  QString m_modelSource;
+
+  // Relative to the in-point of the animation.
+  double m_frame = 0;
+  int m_loopCount = 0;
+
+  QTimer m_timer;
+  QElapsedTimer m_elapsedTimer;
+};
+
+#endif  // LOTTIENATIVE_H
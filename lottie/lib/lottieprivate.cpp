@@ -8,6 +8,7 @@
 #include <QGlobalStatic>
 #include <QJSEngine>
 
+#include "lottienative.h"
 #include "lottieprivatedocument.h"
 #include "lottieprivatenavigator.h"
 #include "lottieprivatewindow.h"
@@ -28,7 +29,8 @@ void LottiePrivate::initialize(QJSEngine* engine, const QString& userAgent) {
   Q_ASSERT(engine);
   s_engine = engine;
 
-  qmlRegisterTypesAndRevisions<LottiePrivate>("vpn.mozilla.lottie", 1);
+  qmlRegisterTypesAndRevisions<LottiePrivate, LottieNative>(
+      "vpn.mozilla.lottie", 1);
   qmlRegisterModule("vpn.mozilla.lottie", 1, 0);
 
   Q_ASSERT(!userAgent.isEmpty());
@@ -0,0 +1,306 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "lottierenderer.h"
+
+#include <QHash>
+#include <QPainter>
+#include <QPen>
+
+// Parents can be parented too.
+constexpr int MAX_PARENT_DEPTH = 32;
+
+namespace {
+
+QColor colorAt(const LottieModel::Property& property, double opacity,
+               double frame) {
+  QList<double> value = property.valueAt(frame);
+  while (value.count() < 3) {
+    value.append(0);
+  }
+
+  double alpha = value.count() > 3 ? value.at(3) : 1;
+  QColor color;
+  color.setRgbF(qBound(0.0, value.at(0), 1.0), qBound(0.0, value.at(1), 1.0),
+                qBound(0.0, value.at(2), 1.0),
+                qBound(0.0, alpha * opacity, 1.0));
+  return color;
+}
+
+}  // namespace
+
+// static
+void LottieRenderer::render(QPainter* painter, const LottieModel& model,
+                            double frame) {
+  painter->save();
+  painter->setRenderHint(QPainter::Antialiasing);
+  painter->setClipRect(QRectF(0, 0, model.width(), model.height()),
+                       Qt::IntersectClip);
+  renderLayers(painter, model.layers(), frame, painter->worldTransform());
+  painter->restore();
+}
+
+// static
+QTransform LottieRenderer::viewTransform(const QSizeF& composition,
+                                         const QSizeF& item,
+                                         const QString& fillMode) {
+  QTransform transform;
+  if (composition.isEmpty() || item.isEmpty()) {
+    return transform;
+  }
+
+  double scaleX = item.width() / composition.width();
+  double scaleY = item.height() / composition.height();
+
+  if (fillMode == "stretch") {
+    transform.scale(scaleX, scaleY);
+    return transform;
+  }
+
+  double scale = 1;
+  if (fillMode == "preserveAspectFit") {
+    scale = qMin(scaleX, scaleY);
+  } else if (fillMode == "preserveAspectCrop") {
+    scale = qMax(scaleX, scaleY);
+  }
+
+  // Centered, as lottie-web does with "xMidYMid".
+  transform.translate((item.width() - composition.width() * scale) / 2,
+                      (item.height() - composition.height() * scale) / 2);
+  transform.scale(scale, scale);
+  return transform;
+}
+
+// static
+void LottieRenderer::renderLayers(QPainter* painter,
+                                  const QList<LottieModel::Layer>& layers,
+                                  double frame, const QTransform& transform) {
+  QHash<int, const LottieModel::Layer*> indexes;
+  for (const LottieModel::Layer& layer : layers) {
+    if (layer.m_index >= 0) {
+      indexes.insert(layer.m_index, &layer);
+    }
+  }
+
+  // The first layer is the topmost one.
+  for (qsizetype i = layers.count() - 1; i >= 0; --i) {
+    const LottieModel::Layer& layer = layers.at(i);
+    if (layer.m_hidden || layer.m_matteSource ||
+        layer.m_type == LottieModel::LayerNull ||
+        layer.m_type == LottieModel::LayerImage || frame < layer.m_inPoint ||
+        frame >= layer.m_outPoint) {
+      continue;
+    }
+
+    double localFrame = layer.localFrame(frame);
+    QTransform matrix = layer.m_transform.matrixAt(localFrame);
+
+    // Parenting inherits the transform, not the opacity.
+    const LottieModel::Layer* parent = indexes.value(layer.m_parent);
+    for (int depth = 0; parent && depth < MAX_PARENT_DEPTH; ++depth) {
+      matrix *= parent->m_transform.matrixAt(parent->localFrame(frame));
+      parent = indexes.value(parent->m_parent);
+    }
+
+    double opacity = layer.m_transform.opacityAt(localFrame);
+    if (opacity <= 0) {
+      continue;
+    }
+
+    painter->save();
+    painter->setOpacity(painter->opacity() * opacity);
+
+    QTransform layerTransform = matrix * transform;
+
+    switch (layer.m_type) {
+      case LottieModel::LayerShape:
+        renderShapes(painter, layer.m_shapes, localFrame, layerTransform);
+        break;
+
+      case LottieModel::LayerSolid:
+        painter->setTransform(layerTransform);
+        painter->fillRect(QRectF(0, 0, layer.m_width, layer.m_height),
+                          layer.m_color);
+        break;
+
+      case LottieModel::LayerPrecomp:
+        painter->setTransform(layerTransform);
+        painter->setClipRect(QRectF(0, 0, layer.m_width, layer.m_height),
+                             Qt::IntersectClip);
+        renderLayers(painter, layer.m_layers, localFrame, layerTransform);
+        break;
+
+      default:
+        break;
+    }
+
+    painter->restore();
+  }
+}
+
+// static
+void LottieRenderer::renderShapes(QPainter* painter,
+                                  const QList<LottieModel::Shape>& shapes,
+                                  double frame, const QTransform& transform) {
+  // A fill or a stroke applies to the paths listed before it, including the
+  // ones of the previous groups. The first items are drawn on top.
+  struct Operation {
+    const LottieModel::Shape* m_shape;
+    QPainterPath m_path;
+  };
+
+  QPainterPath paths;
+  QList<Operation> operations;
+
+  for (const LottieModel::Shape& shape : shapes) {
+    switch (shape.m_type) {
+      case LottieModel::ShapeGroup:
+        operations.append(Operation{&shape, QPainterPath()});
+        paths.addPath(shape.m_transform.matrixAt(frame).map(
+            shapePaths(shape.m_children, frame)));
+        break;
+
+      case LottieModel::ShapeFill:
+      case LottieModel::ShapeStroke:
+        operations.append(Operation{&shape, paths});
+        break;
+
+      default:
+        paths.addPath(shapePath(shape, frame));
+        break;
+    }
+  }
+
+  for (qsizetype i = operations.count() - 1; i >= 0; --i) {
+    const Operation& operation = operations.at(i);
+    const LottieModel::Shape& shape = *operation.m_shape;
+
+    if (shape.m_type == LottieModel::ShapeGroup) {
+      double opacity = shape.m_transform.opacityAt(frame);
+      if (opacity <= 0) {
+        continue;
+      }
+
+      painter->save();
+      painter->setOpacity(painter->opacity() * opacity);
+      renderShapes(painter, shape.m_children, frame,
+                   shape.m_transform.matrixAt(frame) * transform);
+      painter->restore();
+      continue;
+    }
+
+    painter->setTransform(transform);
+    drawStyle(painter, shape, operation.m_path, frame);
+  }
+}
+
+// static
+QPainterPath LottieRenderer::shapePaths(
+    const QList<LottieModel::Shape>& shapes, double frame) {
+  QPainterPath paths;
+
+  for (const LottieModel::Shape& shape : shapes) {
+    if (shape.m_type == LottieModel::ShapeGroup) {
+      paths.addPath(shape.m_transform.matrixAt(frame).map(
+          shapePaths(shape.m_children, frame)));
+    } else {
+      paths.addPath(shapePath(shape, frame));
+    }
+  }
+
+  return paths;
+}
+
+// static
+QPainterPath LottieRenderer::shapePath(const LottieModel::Shape& shape,
+                                       double frame) {
+  QPainterPath path;
+
+  switch (shape.m_type) {
+    case LottieModel::ShapePath: {
+      // Each vertex is [vx, vy, ix, iy, ox, oy], with relative tangents.
+      QList<double> value = shape.m_path.valueAt(frame);
+      qsizetype count = value.count() / 6;
+      if (count == 0) {
+        break;
+      }
+
+      auto vertex = [&](qsizetype i) {
+        return QPointF(value.at(i * 6), value.at(i * 6 + 1));
+      };
+      auto inTangent = [&](qsizetype i) {
+        return vertex(i) + QPointF(value.at(i * 6 + 2), value.at(i * 6 + 3));
+      };
+      auto outTangent = [&](qsizetype i) {
+        return vertex(i) + QPointF(value.at(i * 6 + 4), value.at(i * 6 + 5));
+      };
+
+      path.moveTo(vertex(0));
+      for (qsizetype i = 1; i < count; ++i) {
+        path.cubicTo(outTangent(i - 1), inTangent(i), vertex(i));
+      }
+
+      if (shape.m_closed) {
+        path.cubicTo(outTangent(count - 1), inTangent(0), vertex(0));
+        path.closeSubpath();
+      }
+      break;
+    }
+
+    case LottieModel::ShapeEllipse: {
+      QPointF center = shape.m_position.pointAt(frame, QPointF(0, 0));
+      QPointF size = shape.m_size.pointAt(frame, QPointF(0, 0));
+      path.addEllipse(center, size.x() / 2, size.y() / 2);
+      break;
+    }
+
+    case LottieModel::ShapeRect: {
+      QPointF center = shape.m_position.pointAt(frame, QPointF(0, 0));
+      QPointF size = shape.m_size.pointAt(frame, QPointF(0, 0));
+      double radius = shape.m_roundness.scalarAt(frame);
+      QRectF rect(center.x() - size.x() / 2, center.y() - size.y() / 2,
+                  size.x(), size.y());
+      if (radius > 0) {
+        path.addRoundedRect(rect, radius, radius);
+      } else {
+        path.addRect(rect);
+      }
+      break;
+    }
+
+    default:
+      break;
+  }
+
+  return path;
+}
+
+// static
+void LottieRenderer::drawStyle(QPainter* painter,
+                               const LottieModel::Shape& style,
+                               const QPainterPath& path, double frame) {
+  if (path.isEmpty()) {
+    return;
+  }
+
+  double opacity =
+      qBound(0.0, style.m_opacity.scalarAt(frame, 100) / 100, 1.0);
+  QColor color = colorAt(style.m_color, opacity, frame);
+
+  if (style.m_type == LottieModel::ShapeFill) {
+    QPainterPath filled(path);
+    filled.setFillRule(style.m_fillRule);
+    painter->fillPath(filled, color);
+    return;
+  }
+
+  double width = style.m_width.scalarAt(frame, 1);
+  if (width <= 0) {
+    return;
+  }
+
+  QPen pen(color, width, Qt::SolidLine, style.m_capStyle, style.m_joinStyle);
+  pen.setMiterLimit(style.m_miterLimit);
+  painter->strokePath(path, pen);
+}
@@ -0,0 +1,52 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef LOTTIERENDERER_H
+#define LOTTIERENDERER_H
+
+#include <QList>
+#include <QPainterPath>
+#include <QSizeF>
+#include <QTransform>
+
+#include "lottiemodel.h"
+
+class QPainter;
+
+// Draws a frame of a LottieModel with QPainter.
+class LottieRenderer final {
+ private:
+  LottieRenderer() = default;
+
+ public:
+  // Draws the frame in the coordinates of the composition.
+  static void render(QPainter* painter, const LottieModel& model,
+                     double frame);
+
+  // Maps the composition into an item of the given size, with the same
+  // semantics as Image.fillMode ("stretch", "pad", "preserveAspectFit" or
+  // "preserveAspectCrop").
+  static QTransform viewTransform(const QSizeF& composition,
+                                  const QSizeF& item, const QString& fillMode);
+
+ private:
+  static void renderLayers(QPainter* painter,
+                           const QList<LottieModel::Layer>& layers,
+                           double frame, const QTransform& transform);
+
+  static void renderShapes(QPainter* painter,
+                           const QList<LottieModel::Shape>& shapes,
+                           double frame, const QTransform& transform);
+
+  // Returns the paths of the shapes, in the coordinates of their container.
+  static QPainterPath shapePaths(const QList<LottieModel::Shape>& shapes,
+                                 double frame);
+  static QPainterPath shapePath(const LottieModel::Shape& shape,
+                                double frame);
+
+  static void drawStyle(QPainter* painter, const LottieModel::Shape& style,
+                        const QPainterPath& path, double frame);
+};
+
+#endif  // LOTTIERENDERER_H
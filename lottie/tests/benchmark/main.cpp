@@ -0,0 +1,105 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <QElapsedTimer>
+#include <QGuiApplication>
+#include <QQmlEngine>
+#include <QQuickItem>
+#include <QQuickView>
+#include <QtTest/QtTest>
+#include <algorithm>
+#include <ctime>
+#include <numeric>
+
+#include "lottie.h"
+
+// Frames rendered before the measurement, to skip the loading.
+constexpr int WARMUP_FRAMES = 10;
+constexpr int MEASURED_FRAMES = 300;
+
+// Plays the same animation with each backend and reports, for each frame,
+// the interval between two swaps and the CPU time used by the process.
+class BenchmarkLottie final : public QObject {
+  Q_OBJECT
+
+ private slots:
+  void initTestCase() {
+    m_engine = new QQmlEngine(this);
+    Lottie::initialize(m_engine, "LottieBenchmark 0.1");
+  }
+
+  void frameTime_data() {
+    QTest::addColumn<QString>("backend");
+    QTest::newRow("native") << "native";
+    QTest::newRow("canvas") << "canvas";
+  }
+
+  void frameTime() {
+    QFETCH(QString, backend);
+
+    QQuickView view(m_engine, nullptr);
+    view.setResizeMode(QQuickView::SizeRootObjectToView);
+    view.resize(400, 300);
+    view.setInitialProperties({{"backend", backend}});
+    view.setSource(QUrl("qrc:/benchmark.qml"));
+    QCOMPARE(view.status(), QQuickView::Ready);
+
+    view.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&view));
+
+    QList<double> intervals;
+    int frames = 0;
+    QElapsedTimer timer;
+    std::clock_t cpuStart = 0;
+
+    connect(&view, &QQuickWindow::frameSwapped, &view, [&]() {
+      ++frames;
+      if (frames == WARMUP_FRAMES) {
+        cpuStart = std::clock();
+        timer.start();
+        return;
+      }
+
+      if (frames > WARMUP_FRAMES) {
+        intervals.append(timer.nsecsElapsed() / 1e6);
+        timer.restart();
+      }
+    });
+
+    QVERIFY(QMetaObject::invokeMethod(view.rootObject(), "play"));
+    QTRY_VERIFY_WITH_TIMEOUT(intervals.count() >= MEASURED_FRAMES, 60000);
+
+    double cpu = static_cast<double>(std::clock() - cpuStart) * 1000 /
+                 CLOCKS_PER_SEC / intervals.count();
+
+    std::sort(intervals.begin(), intervals.end());
+    double mean = std::accumulate(intervals.begin(), intervals.end(), 0.0) /
+                  intervals.count();
+    double p95 = intervals.at(intervals.count() * 95 / 100);
+
+    QString result("%1: frame interval mean %2 ms, p95 %3 ms, max %4 ms; "
+                   "CPU time %5 ms per frame");
+    qInfo().noquote() << result.arg(backend)
+                             .arg(mean, 0, 'f', 2)
+                             .arg(p95, 0, 'f', 2)
+                             .arg(intervals.last(), 0, 'f', 2)
+                             .arg(cpu, 0, 'f', 2);
+
+    QMetaObject::invokeMethod(view.rootObject(), "stop");
+  }
+
+ private:
+  QQmlEngine* m_engine = nullptr;
+};
+
+int main(int argc, char* argv[]) {
+  // The frames are swapped on the main thread.
+  qputenv("QSG_RENDER_LOOP", "basic");
+
+  QGuiApplication app(argc, argv);
+  BenchmarkLottie benchmark;
+  return QTest::qExec(&benchmark, argc, argv);
+}
+
+#include "main.moc"
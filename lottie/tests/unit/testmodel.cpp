@@ -0,0 +1,159 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "testmodel.h"
+
+#include <QImage>
+#include <QPainter>
+
+#include "../../lib/lottiemodel.h"
+#include "../../lib/lottierenderer.h"
+
+namespace {
+
+QImage renderFrame(const LottieModel& model, double frame) {
+  QImage image(model.width(), model.height(), QImage::Format_ARGB32);
+  image.fill(Qt::transparent);
+
+  QPainter painter(&image);
+  LottieRenderer::render(&painter, model, frame);
+  painter.end();
+
+  return image;
+}
+
+}  // namespace
+
+void TestModel::ease() {
+  // Linear.
+  QCOMPARE(LottieModel::ease(QPointF(0, 0), QPointF(1, 1), 0), 0.0);
+  QCOMPARE(LottieModel::ease(QPointF(0, 0), QPointF(1, 1), 1), 1.0);
+  QVERIFY(qAbs(LottieModel::ease(QPointF(0, 0), QPointF(1, 1), 0.5) - 0.5) <
+          0.001);
+
+  // Ease-in-out: slower at the edges, symmetric in the middle.
+  QPointF out(0.42, 0);
+  QPointF in(0.58, 1);
+  QVERIFY(LottieModel::ease(out, in, 0.1) < 0.1);
+  QVERIFY(LottieModel::ease(out, in, 0.9) > 0.9);
+  QVERIFY(qAbs(LottieModel::ease(out, in, 0.5) - 0.5) < 0.001);
+
+  double previous = 0;
+  for (int i = 1; i <= 100; ++i) {
+    double value = LottieModel::ease(out, in, i / 100.0);
+    QVERIFY(value >= previous);
+    previous = value;
+  }
+}
+
+void TestModel::invalidJson() {
+  QString errorString;
+  QVERIFY(!LottieModel::fromJson("wow", &errorString));
+  QVERIFY(!errorString.isEmpty());
+
+  errorString.clear();
+  QVERIFY(!LottieModel::fromJson("{\"fr\":60,\"ip\":0,\"op\":0}",
+                                 &errorString));
+  QVERIFY(!errorString.isEmpty());
+
+  errorString.clear();
+  QVERIFY(!LottieModel::load(":/wow.json", &errorString));
+  QVERIFY(!errorString.isEmpty());
+}
+
+void TestModel::keyframes() {
+  QString errorString;
+  QSharedPointer<const LottieModel> model = LottieModel::fromJson(
+      "{\"fr\":30,\"ip\":0,\"op\":20,\"w\":10,\"h\":10,\"layers\":[{"
+      "\"ty\":3,\"ip\":0,\"op\":20,\"ks\":{"
+      "\"o\":{\"a\":1,\"k\":["
+      "{\"t\":0,\"s\":[0],\"o\":{\"x\":[0],\"y\":[0]},"
+      "\"i\":{\"x\":[1],\"y\":[1]}},"
+      "{\"t\":10,\"s\":[100],\"h\":1},"
+      "{\"t\":15,\"s\":[50]}]},"
+      "\"p\":{\"s\":true,\"x\":{\"a\":0,\"k\":3},\"y\":{\"a\":0,\"k\":4}}"
+      "}}]}",
+      &errorString);
+  QVERIFY(model);
+  QCOMPARE(model->frameRate(), 30.0);
+  QCOMPARE(model->totalFrames(), 20.0);
+  QCOMPARE(model->layers().count(), 1);
+
+  const LottieModel::Transform& transform = model->layers().at(0).m_transform;
+
+  // Before the first and after the last keyframe, the value is clamped.
+  QCOMPARE(transform.opacityAt(-5), 0.0);
+  QVERIFY(qAbs(transform.opacityAt(5) - 0.5) < 0.001);
+  QCOMPARE(transform.opacityAt(10), 1.0);
+  // Hold keyframe.
+  QCOMPARE(transform.opacityAt(14), 1.0);
+  QCOMPARE(transform.opacityAt(15), 0.5);
+  QCOMPARE(transform.opacityAt(30), 0.5);
+
+  // Split position.
+  QCOMPARE(transform.matrixAt(0).map(QPointF(0, 0)), QPointF(3, 4));
+}
+
+void TestModel::renderSolid() {
+  QString errorString;
+  QSharedPointer<const LottieModel> model = LottieModel::fromJson(
+      "{\"fr\":30,\"ip\":0,\"op\":10,\"w\":20,\"h\":20,\"layers\":["
+      "{\"ty\":1,\"ip\":0,\"op\":5,\"sw\":10,\"sh\":20,\"sc\":\"#ff0000\","
+      "\"ks\":{}},"
+      "{\"ty\":1,\"ip\":0,\"op\":10,\"sw\":20,\"sh\":20,\"sc\":\"#0000ff\","
+      "\"ks\":{}}]}",
+      &errorString);
+  QVERIFY(model);
+
+  // The first layer is drawn on top of the second one, until its out-point.
+  QImage image = renderFrame(*model, 0);
+  QCOMPARE(image.pixelColor(5, 10), QColor(Qt::red));
+  QCOMPARE(image.pixelColor(15, 10), QColor(Qt::blue));
+
+  image = renderFrame(*model, 5);
+  QCOMPARE(image.pixelColor(5, 10), QColor(Qt::blue));
+}
+
+void TestModel::renderShapes() {
+  QString errorString;
+  QSharedPointer<const LottieModel> model = LottieModel::fromJson(
+      "{\"fr\":30,\"ip\":0,\"op\":10,\"w\":20,\"h\":20,\"layers\":[{"
+      "\"ty\":4,\"ip\":0,\"op\":10,\"ks\":{},\"shapes\":[{\"ty\":\"gr\","
+      "\"it\":["
+      "{\"ty\":\"rc\",\"p\":{\"a\":0,\"k\":[5,10]},"
+      "\"s\":{\"a\":0,\"k\":[10,20]},\"r\":{\"a\":0,\"k\":0}},"
+      "{\"ty\":\"fl\",\"c\":{\"a\":0,\"k\":[0,1,0,1]},"
+      "\"o\":{\"a\":0,\"k\":100}},"
+      "{\"ty\":\"tr\",\"p\":{\"a\":0,\"k\":[10,0]}}]}]}]}",
+      &errorString);
+  QVERIFY(model);
+
+  // The group moves the rectangle to the right half.
+  QImage image = renderFrame(*model, 0);
+  QCOMPARE(image.pixelColor(15, 10), QColor(Qt::green));
+  QCOMPARE(image.pixelColor(5, 10).alpha(), 0);
+}
+
+void TestModel::viewTransform() {
+  QSizeF composition(100, 50);
+
+  QTransform stretch =
+      LottieRenderer::viewTransform(composition, QSizeF(200, 200), "stretch");
+  QCOMPARE(stretch.map(QPointF(100, 50)), QPointF(200, 200));
+
+  QTransform fit = LottieRenderer::viewTransform(
+      composition, QSizeF(200, 200), "preserveAspectFit");
+  QCOMPARE(fit.map(QPointF(0, 0)), QPointF(0, 50));
+  QCOMPARE(fit.map(QPointF(100, 50)), QPointF(200, 150));
+
+  QTransform crop = LottieRenderer::viewTransform(
+      composition, QSizeF(200, 200), "preserveAspectCrop");
+  QCOMPARE(crop.map(QPointF(0, 0)), QPointF(-100, 0));
+
+  QTransform pad =
+      LottieRenderer::viewTransform(composition, QSizeF(200, 200), "pad");
+  QCOMPARE(pad.map(QPointF(0, 0)), QPointF(50, 75));
+}
+
+static TestModel s_testModel;
@@ -52,8 +52,9 @@ StackView {
         return;
       }
 
-      if (stackView.get(pos+1).sourceComponent === null ||
-          (MZNavigator.loadingFlags === MZNavigator.ForceReload)) {
+      const reload = stackView.get(pos+1).sourceComponent === null ||
+          (MZNavigator.loadingFlags === MZNavigator.ForceReload);
+      if (reload) {
         stackView.get(pos+1).sourceComponent = null;
         stackView.get(pos+1).sourceComponent = MZNavigator.component;
       }
@@ -72,6 +73,11 @@ StackView {
           stackView.get(i+1).x = 0; 
         }
       }
+
+      // The screen is already created: the loader does not emit `loaded`.
+      if (!reload) {
+        MZNavigator.screenLoaded(MZNavigator.component);
+      }
   }
 
 
@@ -13,4 +13,7 @@ Loader {
     // Let's use `onCompleted` to take the current value of
     // MZNavigator.component without creating a property binding.
     Component.onCompleted: () => { loader.sourceComponent = MZNavigator.component }
+
+    // The navigation ends when the screen is created.
+    onLoaded: () => { MZNavigator.screenLoaded(loader.sourceComponent) }
 }
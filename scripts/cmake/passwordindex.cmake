@@ -0,0 +1,45 @@
+# This Source Code Form is subject to the terms of the Mozilla Public
+# License, v. 2.0. If a copy of the MPL was not distributed with this
+# file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+## Converts a front-coded password list into the binary index read by
+## PasswordIndex, and generates a resource file exposing it as
+## <PREFIX>/<ALIAS>. The path of the resource file is stored in OUTPUT_VAR.
+##
+## The index is generated at configure time so that the resource file can be
+## shared by every target linking against it, whatever its directory.
+function(generate_password_index OUTPUT_VAR)
+    cmake_parse_arguments(PIDX "" "SOURCE;PREFIX;ALIAS" "" ${ARGN})
+
+    string(MAKE_C_IDENTIFIER "${PIDX_PREFIX}/${PIDX_ALIAS}" PIDX_ID)
+    set(PIDX_DIR ${CMAKE_CURRENT_BINARY_DIR}/passwordindex/${PIDX_ID})
+    set(PIDX_SCRIPT ${CMAKE_SOURCE_DIR}/scripts/utils/generate_password_index.py)
+    file(MAKE_DIRECTORY ${PIDX_DIR})
+
+    execute_process(
+        RESULT_VARIABLE PIDX_RESULT
+        COMMAND ${PYTHON_EXECUTABLE} ${PIDX_SCRIPT}
+            -o ${PIDX_DIR}/${PIDX_ALIAS} ${PIDX_SOURCE}
+    )
+    if(NOT PIDX_RESULT EQUAL 0)
+        message(FATAL_ERROR "Failed to generate the password index for ${PIDX_SOURCE}")
+    endif()
+
+    ## Regenerate the index when the list or the generator change.
+    set_property(DIRECTORY APPEND PROPERTY CMAKE_CONFIGURE_DEPENDS
+        ${PIDX_SOURCE}
+        ${PIDX_SCRIPT}
+    )
+
+    ## The index is stored uncompressed, so it can be mapped in place.
+    file(WRITE ${PIDX_DIR}/passwordindex.qrc.tmp
+        "<RCC>\n"
+        "    <qresource prefix=\"${PIDX_PREFIX}\">\n"
+        "        <file alias=\"${PIDX_ALIAS}\" compression-algorithm=\"none\">${PIDX_DIR}/${PIDX_ALIAS}</file>\n"
+        "    </qresource>\n"
+        "</RCC>\n"
+    )
+    configure_file(${PIDX_DIR}/passwordindex.qrc.tmp ${PIDX_DIR}/passwordindex.qrc COPYONLY)
+
+    set(${OUTPUT_VAR} ${PIDX_DIR}/passwordindex.qrc PARENT_SCOPE)
+endfunction()
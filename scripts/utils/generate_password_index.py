@@ -0,0 +1,105 @@
+#! /usr/bin/env python3
+# This Source Code Form is subject to the terms of the Mozilla Public
+# License, v. 2.0. If a copy of the MPL was not distributed with this
+# file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+# Converts the front-coded common-password list (see
+# https://en.wikipedia.org/wiki/Incremental_encoding) into the sorted, block
+# indexed binary blob read by src/authenticationinapp/passwordindex.cpp.
+#
+# Layout (all integers are little-endian uint32):
+#   header:  "MZPI" version count blockSize blockCount dataSize
+#   offsets: blockCount offsets of the first entry of each block in `data`
+#   data:    per block, the first entry is stored in full and NUL-terminated.
+#            The following entries are stored as one byte with the number of
+#            characters shared with the previous entry, followed by the
+#            NUL-terminated suffix.
+
+import argparse
+import struct
+import sys
+
+MAGIC = b"MZPI"
+VERSION = 1
+MAX_ENTRY_LENGTH = 255
+RADIX = 36
+
+
+def decode(filename):
+    entries = []
+    prev = ""
+    with open(filename, "r", encoding="ascii") as file:
+        for index, line in enumerate(file):
+            line = line.rstrip("\n")
+            if not line:
+                exit(f"Empty line {index + 1} in {filename}")
+
+            shared = int(line[0], RADIX)
+            if index == 0 and shared != 0:
+                exit(f"The first entry of {filename} cannot share a prefix")
+
+            decoded = prev[:shared] + line[1:]
+            prev = decoded
+            entries.append(decoded.encode("ascii"))
+    return entries
+
+
+def shared_prefix(a, b):
+    length = min(len(a), len(b))
+    for i in range(length):
+        if a[i] != b[i]:
+            return i
+    return length
+
+
+def encode(entries, block_size):
+    entries = sorted(set(entries))
+    for entry in entries:
+        if len(entry) == 0 or len(entry) > MAX_ENTRY_LENGTH:
+            exit(f"Invalid entry length: {entry!r}")
+
+    offsets = []
+    data = bytearray()
+    prev = b""
+    for index, entry in enumerate(entries):
+        if index % block_size == 0:
+            offsets.append(len(data))
+            data += entry
+        else:
+            shared = shared_prefix(prev, entry)
+            data.append(shared)
+            data += entry[shared:]
+        data.append(0)
+        prev = entry
+
+    header = MAGIC + struct.pack(
+        "<5I", VERSION, len(entries), block_size, len(offsets), len(data)
+    )
+    return header + struct.pack(f"<{len(offsets)}I", *offsets) + bytes(data)
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(
+        description="Generate the common-password index"
+    )
+    parser.add_argument(
+        "-o", "--output", required=True, help="The output index file"
+    )
+    parser.add_argument(
+        "-b",
+        "--block-size",
+        type=int,
+        default=32,
+        help="Number of entries per front-coded block",
+    )
+    parser.add_argument("source", help="The front-coded password list")
+    args = parser.parse_args()
+
+    if args.block_size < 1:
+        exit("The block size must be positive")
+
+    blob = encode(decode(args.source), args.block_size)
+    with open(args.output, "wb") as file:
+        file.write(blob)
+
+    sys.exit(0)
@@ -5,14 +5,12 @@
 #include "authenticationinapp.h"
 
 #include <QCoreApplication>
-#include <QFile>
 #include <QMetaEnum>
 #include <QRegularExpression>
 
 #include "authenticationinappsession.h"
 #include "glean/generated/metrics.h"
 #include "glean/metrictypes.h"
-#include "incrementaldecoder.h"
 #include "leakdetector.h"
 #include "logger.h"
 #include "resourceloader.h"
@@ -39,7 +37,7 @@ AuthenticationInApp::AuthenticationInApp(QObject* parent) : QObject(parent) {
   s_instance = this;
 
   connect(ResourceLoader::instance(), &ResourceLoader::cacheFlushNeeded, this,
-          [this]() { m_encodedPassword.clear(); });
+          [this]() { m_passwordIndex.reset(); });
 }
 
 AuthenticationInApp::~AuthenticationInApp() {
@@ -286,35 +284,20 @@ bool AuthenticationInApp::validatePasswordCommons(const QString& password) {
     return true;
   }
 
-  // Let's cache the encoded-password content.
-  if (m_encodedPassword.isEmpty()) {
-    QFile file(ResourceLoader::instance()->loadFile(
-        ":/resources/encodedPassword.txt"));
-    if (!file.open(QFile::ReadOnly | QFile::Text)) {
-      logger.error() << "Failed to open the encodedPassword.txt";
-      return true;
-    }
-
-    m_encodedPassword = file.readAll();
+  // Let's map the common-password index once.
+  if (!m_passwordIndex.isValid() &&
+      !m_passwordIndex.load(ResourceLoader::instance()->loadFile(
+          ":/resources/commonPasswords.idx"))) {
+    logger.error() << "Failed to load the common-password index";
+    return true;
   }
 
-  QTextStream stream(&m_encodedPassword);
-
-  IncrementalDecoder id(qApp);
-  IncrementalDecoder::Result result = id.match(stream, password);
-  switch (result) {
-    case IncrementalDecoder::MatchNotFound:
-      return true;
-    case IncrementalDecoder::MatchFound:
-      logger.info() << "Unsecure password";
-      return false;
-    case IncrementalDecoder::DecodeFailure:
-      logger.error() << "Decode failure!";
-      return true;
-    default:
-      Q_ASSERT(false);
-      return true;
+  if (m_passwordIndex.contains(password)) {
+    logger.info() << "Unsecure password";
+    return false;
   }
+
+  return true;
 }
 
 // static
@@ -8,6 +8,8 @@
 #include <QObject>
 #include <QUrl>
 
+#include "passwordindex.h"
+
 class AuthenticationInAppSession;
 
 class AuthenticationInApp final : public QObject {
@@ -181,7 +183,7 @@ class AuthenticationInApp final : public QObject {
 
   AuthenticationInAppSession* m_session = nullptr;
 
-  QByteArray m_encodedPassword;
+  PasswordIndex m_passwordIndex;
 };
 
 #endif  // AUTHENTICATIONINAPP_H
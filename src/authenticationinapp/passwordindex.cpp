@@ -0,0 +1,237 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "passwordindex.h"
+
+#include <QtEndian>
+#include <cstring>
+
+#include "leakdetector.h"
+#include "logger.h"
+
+namespace {
+Logger logger("PasswordIndex");
+
+constexpr const char INDEX_MAGIC[] = "MZPI";
+constexpr uint32_t INDEX_VERSION = 1;
+constexpr qint64 INDEX_HEADER_SIZE = 24;
+constexpr uint32_t MAX_ENTRY_LENGTH = 255;
+
+uint32_t readUint32(const uchar* ptr) {
+  return qFromLittleEndian<quint32>(ptr);
+}
+
+// Compares the input with a NUL-terminated ASCII entry, as strcmp() does.
+// Non-ASCII characters sort after any entry, so they simply never match.
+int compare(const QString& input, const char* entry) {
+  const QChar* chars = input.constData();
+  qsizetype length = input.length();
+
+  for (qsizetype i = 0; i < length; ++i) {
+    char16_t a = chars[i].unicode();
+    uchar b = static_cast<uchar>(entry[i]);
+    if (b == 0) {
+      return 1;
+    }
+
+    if (a != b) {
+      return a < b ? -1 : 1;
+    }
+  }
+
+  return entry[length] == 0 ? 0 : -1;
+}
+
+}  // namespace
+
+PasswordIndex::PasswordIndex() { MZ_COUNT_CTOR(PasswordIndex); }
+
+PasswordIndex::~PasswordIndex() { MZ_COUNT_DTOR(PasswordIndex); }
+
+bool PasswordIndex::load(const QString& fileName) {
+  reset();
+
+  m_file.setFileName(fileName);
+  if (!m_file.open(QIODevice::ReadOnly)) {
+    logger.error() << "Failed to open the password index" << fileName;
+    return false;
+  }
+
+  qint64 size = m_file.size();
+  const uchar* data = m_file.map(0, size);
+  if (!data) {
+    // Compressed resources and some file-systems cannot be mapped.
+    m_buffer = m_file.readAll();
+    m_file.close();
+
+    data = reinterpret_cast<const uchar*>(m_buffer.constData());
+    size = m_buffer.size();
+  }
+
+  if (!parse(data, size)) {
+    reset();
+    return false;
+  }
+
+  return true;
+}
+
+bool PasswordIndex::loadFromData(const QByteArray& data) {
+  reset();
+
+  m_buffer = data;
+  if (!parse(reinterpret_cast<const uchar*>(m_buffer.constData()),
+             m_buffer.size())) {
+    reset();
+    return false;
+  }
+
+  return true;
+}
+
+void PasswordIndex::reset() {
+  m_data = nullptr;
+  m_offsets = nullptr;
+  m_entries = nullptr;
+  m_count = 0;
+  m_blockCount = 0;
+  m_dataSize = 0;
+
+  // Closing the file removes the mapping, if any.
+  if (m_file.isOpen()) {
+    m_file.close();
+  }
+
+  m_buffer.clear();
+}
+
+bool PasswordIndex::parse(const uchar* data, qint64 size) {
+  if (!data || size < INDEX_HEADER_SIZE ||
+      memcmp(data, INDEX_MAGIC, 4) != 0) {
+    logger.error() << "Invalid password index header";
+    return false;
+  }
+
+  if (readUint32(data + 4) != INDEX_VERSION) {
+    logger.error() << "Unsupported password index version";
+    return false;
+  }
+
+  uint32_t count = readUint32(data + 8);
+  uint64_t blockSize = readUint32(data + 12);
+  uint32_t blockCount = readUint32(data + 16);
+  uint32_t dataSize = readUint32(data + 20);
+
+  if (blockSize == 0 || blockCount != (count + blockSize - 1) / blockSize ||
+      INDEX_HEADER_SIZE + static_cast<qint64>(blockCount) * 4 + dataSize !=
+          size) {
+    logger.error() << "Invalid password index size";
+    return false;
+  }
+
+  const uchar* offsets = data + INDEX_HEADER_SIZE;
+  const char* entries = reinterpret_cast<const char*>(
+      offsets + static_cast<qint64>(blockCount) * 4);
+
+  if (dataSize > 0 && entries[dataSize - 1] != 0) {
+    logger.error() << "Truncated password index";
+    return false;
+  }
+
+  uint32_t previous = 0;
+  for (uint32_t i = 0; i < blockCount; ++i) {
+    uint32_t offset = readUint32(offsets + i * 4);
+    if ((i == 0 && offset != 0) || (i > 0 && offset <= previous) ||
+        offset >= dataSize) {
+      logger.error() << "Invalid password index block" << i;
+      return false;
+    }
+    previous = offset;
+  }
+
+  m_data = data;
+  m_offsets = offsets;
+  m_entries = entries;
+  m_count = count;
+  m_blockCount = blockCount;
+  m_dataSize = dataSize;
+  return true;
+}
+
+const char* PasswordIndex::blockEntry(uint32_t block) const {
+  Q_ASSERT(block < m_blockCount);
+  return m_entries + readUint32(m_offsets + block * 4);
+}
+
+bool PasswordIndex::contains(const QString& input) const {
+  if (!m_data || input.isEmpty() ||
+      static_cast<uint32_t>(input.length()) > MAX_ENTRY_LENGTH) {
+    return false;
+  }
+
+  // Let's find the last block starting with an entry not greater than the
+  // input.
+  uint32_t low = 0;
+  uint32_t high = m_blockCount;
+  while (low < high) {
+    uint32_t middle = low + (high - low) / 2;
+    int result = compare(input, blockEntry(middle));
+    if (result == 0) {
+      return true;
+    }
+
+    if (result < 0) {
+      high = middle;
+    } else {
+      low = middle + 1;
+    }
+  }
+
+  if (low == 0) {
+    return false;
+  }
+
+  uint32_t block = low - 1;
+  const char* ptr = blockEntry(block);
+  const char* end = block + 1 < m_blockCount ? blockEntry(block + 1)
+                                             : m_entries + m_dataSize;
+
+  // The entries of the block are rebuilt, one by one, in this buffer.
+  char entry[MAX_ENTRY_LENGTH + 1];
+
+  uint32_t length = qstrnlen(ptr, end - ptr);
+  if (ptr + length >= end || length > MAX_ENTRY_LENGTH) {
+    logger.error() << "Corrupted password index block" << block;
+    return false;
+  }
+
+  memcpy(entry, ptr, length + 1);
+  ptr += length + 1;
+
+  while (ptr < end) {
+    uint32_t shared = static_cast<uchar>(*ptr++);
+    uint32_t suffix = qstrnlen(ptr, end - ptr);
+    if (shared > length || ptr + suffix >= end ||
+        shared + suffix > MAX_ENTRY_LENGTH) {
+      logger.error() << "Corrupted password index block" << block;
+      return false;
+    }
+
+    memcpy(entry + shared, ptr, suffix + 1);
+    length = shared + suffix;
+    ptr += suffix + 1;
+
+    int result = compare(input, entry);
+    if (result == 0) {
+      return true;
+    }
+
+    // Entries are sorted: we have gone past the input.
+    if (result < 0) {
+      return false;
+    }
+  }
+
+  return false;
+}
@@ -0,0 +1,56 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef PASSWORDINDEX_H
+#define PASSWORDINDEX_H
+
+#include <QByteArray>
+#include <QFile>
+
+// Read-only view of the common-password index generated at build time by
+// scripts/utils/generate_password_index.py. The entries are sorted and grouped
+// in front-coded blocks: a lookup is a binary search over the first entry of
+// each block followed by a scan of a single block. Lookups do not allocate.
+
+class PasswordIndex final {
+  Q_DISABLE_COPY_MOVE(PasswordIndex)
+
+ public:
+  PasswordIndex();
+  ~PasswordIndex();
+
+  // Maps the index file (or reads it, if it cannot be mapped).
+  bool load(const QString& fileName);
+
+  // Uses an in-memory index. The data is shared, not copied.
+  bool loadFromData(const QByteArray& data);
+
+  void reset();
+
+  bool isValid() const { return m_data != nullptr; }
+
+  uint32_t count() const { return m_count; }
+
+  bool contains(const QString& input) const;
+
+ private:
+  bool parse(const uchar* data, qint64 size);
+
+  // Returns the first entry of the block, stored in full.
+  const char* blockEntry(uint32_t block) const;
+
+ private:
+  QFile m_file;
+  QByteArray m_buffer;
+
+  const uchar* m_data = nullptr;
+  const uchar* m_offsets = nullptr;
+  const char* m_entries = nullptr;
+
+  uint32_t m_count = 0;
+  uint32_t m_blockCount = 0;
+  uint32_t m_dataSize = 0;
+};
+
+#endif  // PASSWORDINDEX_H
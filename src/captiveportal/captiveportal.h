@@ -10,6 +10,13 @@
 
 constexpr int32_t CAPTIVEPORTAL_LOOKUPTIMER = 5000;
 
+// Delay before the next address is tried, if the previous attempts have not
+// answered yet. This is the "Connection Attempt Delay" of RFC 8305.
+constexpr int32_t CAPTIVEPORTAL_ATTEMPT_DELAY_MSEC = 250;
+
+// How long a network without captive portal is remembered.
+constexpr int64_t CAPTIVEPORTAL_NO_PORTAL_TTL_MSEC = 30 * 60 * 1000;
+
 constexpr const char* CAPTIVEPORTAL_HOST = "detectportal.firefox.com";
 
 constexpr const char* CAPTIVEPORTAL_REQUEST_CONTENT = "success";
@@ -59,6 +59,17 @@ void CaptivePortalDetection::networkChanged() {
     // portal
     return;
   }
+
+  // A reconnection to a network recently found without captive portal does
+  // not need a new check. The instabilities of the connection are always
+  // checked: a portal can show up on a known network too.
+  if (m_noPortalNetworks.isNoPortalNetwork(
+          vpn->networkWatcher()->currentNetworkId())) {
+    logger.debug() << "No captive portal on this network recently";
+    m_impl.reset();
+    return;
+  }
+
   logger.debug() << "Current Network Changed, checking for Portal";
   detectCaptivePortal();
 }
@@ -121,6 +132,9 @@ void CaptivePortalDetection::detectCaptivePortal() {
     return;
   }
 
+  // The network checked, to remember it if there is no captive portal.
+  m_networkId = vpn->networkWatcher()->currentNetworkId();
+
   logger.debug() << "Captive portal detection started";
 
 #if defined(MZ_LINUX) || defined(MZ_MACOS) || defined(MZ_WINDOWS)
@@ -155,6 +169,8 @@ void CaptivePortalDetection::detectionCompleted(
   m_shouldRun = false;
   switch (detected) {
     case CaptivePortalRequest::CaptivePortalResult::NoPortal:
+      m_noPortalNetworks.addNoPortalNetwork(m_networkId);
+      return;
     case CaptivePortalRequest::CaptivePortalResult::Failure:
       return;
     case CaptivePortalRequest::CaptivePortalResult::PortalDetected:
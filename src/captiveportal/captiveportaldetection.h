@@ -7,6 +7,7 @@
 
 #include <QObject>
 
+#include "captiveportalnetworkcache.h"
 #include "captiveportalrequest.h"
 
 class CaptivePortalDetectionImpl;
@@ -46,6 +47,11 @@ class CaptivePortalDetection final : public QObject {
   bool m_active = false;
   bool m_shouldRun = true;
 
+  // The network being checked, and the networks recently found without
+  // captive portal. See NetworkWatcher::currentNetworkId().
+  QString m_networkId;
+  CaptivePortalNetworkCache m_noPortalNetworks;
+
   // Don't use it directly. Use captivePortalNotifier().
   CaptivePortalNotifier* m_captivePortalNotifier = nullptr;
 
@@ -0,0 +1,38 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "captiveportalnetworkcache.h"
+
+#include "leakdetector.h"
+
+CaptivePortalNetworkCache::CaptivePortalNetworkCache(qint64 ttlMsec)
+    : m_ttlMsec(ttlMsec) {
+  MZ_COUNT_CTOR(CaptivePortalNetworkCache);
+}
+
+CaptivePortalNetworkCache::~CaptivePortalNetworkCache() {
+  MZ_COUNT_DTOR(CaptivePortalNetworkCache);
+}
+
+void CaptivePortalNetworkCache::addNoPortalNetwork(const QString& networkId) {
+  if (networkId.isEmpty()) {
+    return;
+  }
+
+  m_networks[networkId].start();
+}
+
+bool CaptivePortalNetworkCache::isNoPortalNetwork(const QString& networkId) {
+  auto network = m_networks.find(networkId);
+  if (network == m_networks.end()) {
+    return false;
+  }
+
+  if (network->hasExpired(m_ttlMsec)) {
+    m_networks.erase(network);
+    return false;
+  }
+
+  return true;
+}
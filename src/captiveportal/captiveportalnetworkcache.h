@@ -0,0 +1,37 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef CAPTIVEPORTALNETWORKCACHE_H
+#define CAPTIVEPORTALNETWORKCACHE_H
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QString>
+
+#include "captiveportal.h"
+
+// The networks recently found without captive portal, by network id. See
+// NetworkWatcher::currentNetworkId(). A network where a portal was seen is
+// never remembered: the user may sign in, and the next check must run.
+class CaptivePortalNetworkCache final {
+  Q_DISABLE_COPY_MOVE(CaptivePortalNetworkCache)
+
+ public:
+  explicit CaptivePortalNetworkCache(
+      qint64 ttlMsec = CAPTIVEPORTAL_NO_PORTAL_TTL_MSEC);
+  ~CaptivePortalNetworkCache();
+
+  // The networks without id are not remembered.
+  void addNoPortalNetwork(const QString& networkId);
+
+  // Returns true if the network has been found without captive portal less
+  // than the TTL ago. The expired networks are forgotten.
+  bool isNoPortalNetwork(const QString& networkId);
+
+ private:
+  const qint64 m_ttlMsec;
+  QHash<QString, QElapsedTimer> m_networks;
+};
+
+#endif  // CAPTIVEPORTALNETWORKCACHE_H
@@ -4,6 +4,8 @@
 
 #include "captiveportalrequest.h"
 
+#include <utility>
+
 #include "captiveportal.h"
 #include "constants.h"
 #include "leakdetector.h"
@@ -18,6 +20,11 @@ Logger logger("CaptivePortalRequest");
 
 CaptivePortalRequest::CaptivePortalRequest(Task* parent) : QObject(parent) {
   MZ_COUNT_CTOR(CaptivePortalRequest);
+
+  m_attemptTimer.setSingleShot(true);
+  m_attemptTimer.setInterval(CAPTIVEPORTAL_ATTEMPT_DELAY_MSEC);
+  connect(&m_attemptTimer, &QTimer::timeout, this,
+          &CaptivePortalRequest::nextAttempt);
 }
 
 CaptivePortalRequest::~CaptivePortalRequest() {
@@ -35,21 +42,32 @@ void CaptivePortalRequest::run() {
     emit completed(NoPortal);
     return;
   }
-  m_running = 0;
-  m_success = 0;
 
-  // We do not care which request succeeds.
-  // Let's make 1 request for any available IP addresses. The first one will
-  // delete all the others.
+  // IPv6 first, then the two families alternate. See RFC 8305, section 4.
+  qsizetype count = qMax(ipv4Addresses.count(), ipv6Addresses.count());
+  for (qsizetype i = 0; i < count; ++i) {
+    if (i < ipv6Addresses.count()) {
+      m_pendingUrls.append(QUrl(Constants::captivePortalUrl().arg(
+          QString("[%1]").arg(ipv6Addresses.at(i)))));
+    }
+    if (i < ipv4Addresses.count()) {
+      m_pendingUrls.append(
+          QUrl(Constants::captivePortalUrl().arg(ipv4Addresses.at(i))));
+    }
+  }
 
-  for (const QString& address : ipv4Addresses) {
-    QUrl url(Constants::captivePortalUrl().arg(address));
-    createRequest(url);
+  nextAttempt();
+}
+
+void CaptivePortalRequest::nextAttempt() {
+  if (m_completed || m_pendingUrls.isEmpty()) {
+    return;
   }
 
-  for (const QString& address : ipv6Addresses) {
-    QUrl url(Constants::captivePortalUrl().arg(QString("[%1]").arg(address)));
-    createRequest(url);
+  createRequest(m_pendingUrls.takeFirst());
+
+  if (!m_pendingUrls.isEmpty()) {
+    m_attemptTimer.start();
   }
 }
 
@@ -72,7 +90,7 @@ void CaptivePortalRequest::createRequest(const QUrl& url) {
             logger.info() << "Portal Detected -> Redirect to "
                           << logger.sensitive(url.toString());
             request->abort();
-            onResult(PortalDetected);
+            onResult(request, PortalDetected);
           });
   connect(
       request, &NetworkRequest::requestFailed, this,
@@ -82,7 +100,7 @@ void CaptivePortalRequest::createRequest(const QUrl& url) {
         }
 
         logger.warning() << "Captive portal request failed:" << error;
-        onResult(Failure);
+        onResult(request, Failure);
       });
 
   connect(
@@ -97,41 +115,54 @@ void CaptivePortalRequest::createRequest(const QUrl& url) {
         if (request->statusCode() != 200) {
           logger.debug() << "Captive portal detected. Expected 200, received:"
                          << request->statusCode();
-          onResult(PortalDetected);
+          onResult(request, PortalDetected);
           return;
         }
 
         if (QString(data).trimmed() == CAPTIVEPORTAL_REQUEST_CONTENT) {
           logger.debug() << "No captive portal!";
-          onResult(NoPortal);
+          onResult(request, NoPortal);
           return;
         }
 
         logger.debug() << "Captive portal detected. Content does not match.";
-        onResult(PortalDetected);
+        onResult(request, PortalDetected);
       });
 
-  m_running++;
+  m_requests.append(request);
 }
 
-void CaptivePortalRequest::onResult(CaptivePortalResult portalDetected) {
-  Q_ASSERT(m_running > 0);
-  m_running--;
-  if (portalDetected == NoPortal) {
-    m_success++;
+void CaptivePortalRequest::onResult(NetworkRequest* request,
+                                    CaptivePortalResult portalDetected) {
+  if (m_completed) {
+    return;
   }
 
-  // If any request detects a portal, we can terminate immediately.
-  if (portalDetected == PortalDetected) {
-    deleteLater();
-    emit completed(portalDetected);
-    return;
+  m_requests.removeOne(request);
+
+  // A failed attempt starts the next one without waiting for the delay.
+  if (portalDetected == Failure) {
+    if (!m_pendingUrls.isEmpty()) {
+      m_attemptTimer.stop();
+      nextAttempt();
+      return;
+    }
+
+    if (!m_requests.isEmpty()) {
+      return;
+    }
   }
 
-  // Otherwise, we are complete after all the workers have terminated.
-  if (m_running == 0) {
-    deleteLater();
-    emit completed((m_success > 0) ? NoPortal : Failure);
-    return;
+  m_completed = true;
+  m_attemptTimer.stop();
+
+  // Any answer other than a failure is definitive: the other attempts are
+  // cancelled.
+  const QList<NetworkRequest*> requests = std::exchange(m_requests, {});
+  for (NetworkRequest* other : requests) {
+    other->abort();
   }
+
+  deleteLater();
+  emit completed(portalDetected);
 }
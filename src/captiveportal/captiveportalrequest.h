@@ -5,11 +5,18 @@
 #ifndef CAPTIVEPORTALREQUEST_H
 #define CAPTIVEPORTALREQUEST_H
 
+#include <QList>
 #include <QObject>
+#include <QTimer>
 #include <QUrl>
 
+class NetworkRequest;
 class Task;
 
+// Checks the captive-portal addresses as RFC 8305 connects to a host: the
+// IPv6 and IPv4 addresses are interleaved, and a new attempt starts when
+// the previous one fails or is slow to answer. The first definitive answer
+// cancels the other attempts.
 class CaptivePortalRequest final : public QObject {
   Q_OBJECT
   Q_DISABLE_COPY_MOVE(CaptivePortalRequest)
@@ -27,13 +34,16 @@ class CaptivePortalRequest final : public QObject {
   void completed(CaptivePortalRequest::CaptivePortalResult detected);
 
  private:
+  void nextAttempt();
   void createRequest(const QUrl& url);
-  void nextStep();
-  void onResult(CaptivePortalResult portalDetected);
+  void onResult(NetworkRequest* request, CaptivePortalResult portalDetected);
 
  private:
-  int m_running = 0;
-  int m_success = 0;
+  // The attempts not started yet, in order.
+  QList<QUrl> m_pendingUrls;
+  QList<NetworkRequest*> m_requests;
+  QTimer m_attemptTimer;
+  bool m_completed = false;
 };
 
 #endif  // CAPTIVEPORTALREQUEST_H
@@ -28,11 +28,12 @@ CaptivePortalRequestTask::~CaptivePortalRequestTask() {
 }
 
 void CaptivePortalRequestTask::run() {
-  // If we can't confirm in 30s that we are not behind
-  // a captive-portal, handle this like no portal exists
+  // If we can't confirm in 30s that we are not behind a captive-portal, the
+  // detection ends without retrying. This is handled like no portal exists,
+  // but the network is not remembered as without portal.
   QTimer::singleShot(30 * 1000, this, [this]() {
     logger.error() << "CaptivePortal max timeout reached, exiting detection";
-    onResult(CaptivePortalRequest::CaptivePortalResult::NoPortal);
+    complete(CaptivePortalRequest::CaptivePortalResult::Failure);
   });
   createRequest();
 }
@@ -60,6 +61,15 @@ void CaptivePortalRequestTask::onResult(
     QTimer::singleShot(500, this, [this]() { createRequest(); });
     return;
   }
+
+  complete(portalDetected);
+}
+
+void CaptivePortalRequestTask::complete(
+    CaptivePortalRequest::CaptivePortalResult portalDetected) {
+  if (m_completed) {
+    return;
+  }
   m_completed = true;
 
   emit operationCompleted(portalDetected);
@@ -26,6 +26,7 @@ class CaptivePortalRequestTask final : public Task {
  private:
   void createRequest();
   void onResult(CaptivePortalRequest::CaptivePortalResult portalDetected);
+  void complete(CaptivePortalRequest::CaptivePortalResult portalDetected);
 
  private:
   const bool m_retryOnFailure = true;
@@ -17,6 +17,8 @@ target_sources(mozillavpn PRIVATE
     ${CMAKE_SOURCE_DIR}/src/platforms/linux/backendlogsobserver.h
     ${CMAKE_SOURCE_DIR}/src/platforms/linux/dbusclient.cpp
     ${CMAKE_SOURCE_DIR}/src/platforms/linux/dbusclient.h
+    ${CMAKE_SOURCE_DIR}/src/platforms/linux/dbuspropertycache.cpp
+    ${CMAKE_SOURCE_DIR}/src/platforms/linux/dbuspropertycache.h
     ${CMAKE_SOURCE_DIR}/src/platforms/linux/linuxappimageprovider.cpp
     ${CMAKE_SOURCE_DIR}/src/platforms/linux/linuxappimageprovider.h
     ${CMAKE_SOURCE_DIR}/src/platforms/linux/linuxapplistprovider.cpp
@@ -25,6 +27,8 @@ target_sources(mozillavpn PRIVATE
     ${CMAKE_SOURCE_DIR}/src/platforms/linux/linuxcontroller.h
     ${CMAKE_SOURCE_DIR}/src/platforms/linux/linuxdependencies.cpp
     ${CMAKE_SOURCE_DIR}/src/platforms/linux/linuxdependencies.h
+    ${CMAKE_SOURCE_DIR}/src/platforms/linux/linuxdesktopentryindex.cpp
+    ${CMAKE_SOURCE_DIR}/src/platforms/linux/linuxdesktopentryindex.h
     ${CMAKE_SOURCE_DIR}/src/platforms/linux/linuxnetworkwatcher.cpp
     ${CMAKE_SOURCE_DIR}/src/platforms/linux/linuxnetworkwatcher.h
     ${CMAKE_SOURCE_DIR}/src/platforms/linux/linuxnetworkwatcherworker.cpp
@@ -46,6 +50,8 @@ target_sources(mozillavpn PRIVATE
     ${CMAKE_SOURCE_DIR}/src/daemon/wireguardutils.h
     ${CMAKE_SOURCE_DIR}/src/platforms/linux/daemon/apptracker.cpp
     ${CMAKE_SOURCE_DIR}/src/platforms/linux/daemon/apptracker.h
+    ${CMAKE_SOURCE_DIR}/src/platforms/linux/daemon/cgroupwatcher.cpp
+    ${CMAKE_SOURCE_DIR}/src/platforms/linux/daemon/cgroupwatcher.h
     ${CMAKE_SOURCE_DIR}/src/platforms/linux/daemon/dbusservice.cpp
     ${CMAKE_SOURCE_DIR}/src/platforms/linux/daemon/dbusservice.h
     ${CMAKE_SOURCE_DIR}/src/platforms/linux/daemon/dbustypeslinux.h
@@ -80,8 +80,8 @@ target_sources(shared-sources INTERFACE
     ${CMAKE_SOURCE_DIR}/src/authenticationinapp/authenticationinapplistener.h
     ${CMAKE_SOURCE_DIR}/src/authenticationinapp/authenticationinappsession.cpp
     ${CMAKE_SOURCE_DIR}/src/authenticationinapp/authenticationinappsession.h
-    ${CMAKE_SOURCE_DIR}/src/authenticationinapp/incrementaldecoder.cpp
-    ${CMAKE_SOURCE_DIR}/src/authenticationinapp/incrementaldecoder.h
+    ${CMAKE_SOURCE_DIR}/src/authenticationinapp/passwordindex.cpp
+    ${CMAKE_SOURCE_DIR}/src/authenticationinapp/passwordindex.h
     ${CMAKE_SOURCE_DIR}/src/authenticationlistener.cpp
     ${CMAKE_SOURCE_DIR}/src/authenticationlistener.h
     ${CMAKE_SOURCE_DIR}/src/collator.cpp
@@ -150,6 +150,8 @@ target_sources(shared-sources INTERFACE
     ${CMAKE_SOURCE_DIR}/src/ipaddress.h
     ${CMAKE_SOURCE_DIR}/src/itempicker.cpp
     ${CMAKE_SOURCE_DIR}/src/itempicker.h
+    ${CMAKE_SOURCE_DIR}/src/jsonprefetch.cpp
+    ${CMAKE_SOURCE_DIR}/src/jsonprefetch.h
     ${CMAKE_SOURCE_DIR}/src/languagei18n.cpp
     ${CMAKE_SOURCE_DIR}/src/languagei18n.h
     ${CMAKE_SOURCE_DIR}/src/leakdetector.cpp
@@ -172,6 +174,8 @@ target_sources(shared-sources INTERFACE
     ${CMAKE_SOURCE_DIR}/src/networkrequest.h
     ${CMAKE_SOURCE_DIR}/src/qmlengineholder.cpp
     ${CMAKE_SOURCE_DIR}/src/qmlengineholder.h
+    ${CMAKE_SOURCE_DIR}/src/qmlitemindex.cpp
+    ${CMAKE_SOURCE_DIR}/src/qmlitemindex.h
     ${CMAKE_SOURCE_DIR}/src/qmlpath.cpp
     ${CMAKE_SOURCE_DIR}/src/qmlpath.h
     ${CMAKE_SOURCE_DIR}/src/resourceloader.cpp
@@ -213,6 +217,8 @@ target_sources(shared-sources INTERFACE
     ${CMAKE_SOURCE_DIR}/src/temporarydir.h
     ${CMAKE_SOURCE_DIR}/src/theme.cpp
     ${CMAKE_SOURCE_DIR}/src/theme.h
+    ${CMAKE_SOURCE_DIR}/src/tracer.cpp
+    ${CMAKE_SOURCE_DIR}/src/tracer.h
     ${CMAKE_SOURCE_DIR}/src/tutorial/tutorial.cpp
     ${CMAKE_SOURCE_DIR}/src/tutorial/tutorial.h
     ${CMAKE_SOURCE_DIR}/src/tutorial/tutorialstep.cpp
@@ -229,9 +235,17 @@ target_sources(shared-sources INTERFACE
     ${CMAKE_SOURCE_DIR}/src/versionutils.h
 )
 
+# Binary index of the common-password list
+include(${CMAKE_SOURCE_DIR}/scripts/cmake/passwordindex.cmake)
+generate_password_index(PASSWORD_INDEX_QRC
+    SOURCE ${CMAKE_SOURCE_DIR}/src/resources/encodedPassword.txt
+    PREFIX /resources
+    ALIAS commonPasswords.idx
+)
+
 target_sources(shared-sources INTERFACE
     ${CMAKE_SOURCE_DIR}/src/resources/license.qrc
-    ${CMAKE_SOURCE_DIR}/src/resources/resources.qrc
+    ${PASSWORD_INDEX_QRC}
 )
 
 # Signal handling for unix platforms
@@ -38,6 +38,8 @@ target_sources(mozillavpn-sources INTERFACE
     ${CMAKE_CURRENT_SOURCE_DIR}/captiveportal/captiveportaldetection.h
     ${CMAKE_CURRENT_SOURCE_DIR}/captiveportal/captiveportaldetectionimpl.cpp
     ${CMAKE_CURRENT_SOURCE_DIR}/captiveportal/captiveportaldetectionimpl.h
+    ${CMAKE_CURRENT_SOURCE_DIR}/captiveportal/captiveportalnetworkcache.cpp
+    ${CMAKE_CURRENT_SOURCE_DIR}/captiveportal/captiveportalnetworkcache.h
     ${CMAKE_CURRENT_SOURCE_DIR}/captiveportal/captiveportalnotifier.cpp
     ${CMAKE_CURRENT_SOURCE_DIR}/captiveportal/captiveportalnotifier.h
     ${CMAKE_CURRENT_SOURCE_DIR}/captiveportal/captiveportalrequest.cpp
@@ -60,6 +62,8 @@ target_sources(mozillavpn-sources INTERFACE
     ${CMAKE_CURRENT_SOURCE_DIR}/commands/commandlogin.h
     ${CMAKE_CURRENT_SOURCE_DIR}/commands/commandlogout.cpp
     ${CMAKE_CURRENT_SOURCE_DIR}/commands/commandlogout.h
+    ${CMAKE_CURRENT_SOURCE_DIR}/commands/commandprobe.cpp
+    ${CMAKE_CURRENT_SOURCE_DIR}/commands/commandprobe.h
     ${CMAKE_CURRENT_SOURCE_DIR}/commands/commandselect.cpp
     ${CMAKE_CURRENT_SOURCE_DIR}/commands/commandselect.h
     ${CMAKE_CURRENT_SOURCE_DIR}/commands/commandservers.cpp
@@ -70,6 +74,8 @@ target_sources(mozillavpn-sources INTERFACE
     ${CMAKE_CURRENT_SOURCE_DIR}/commands/commandui.h
     ${CMAKE_CURRENT_SOURCE_DIR}/commands/commandwgconf.cpp
     ${CMAKE_CURRENT_SOURCE_DIR}/commands/commandwgconf.h
+    ${CMAKE_CURRENT_SOURCE_DIR}/connectionbenchmark/benchmarkpayload.cpp
+    ${CMAKE_CURRENT_SOURCE_DIR}/connectionbenchmark/benchmarkpayload.h
     ${CMAKE_CURRENT_SOURCE_DIR}/connectionbenchmark/benchmarktask.cpp
     ${CMAKE_CURRENT_SOURCE_DIR}/connectionbenchmark/benchmarktask.h
     ${CMAKE_CURRENT_SOURCE_DIR}/connectionbenchmark/benchmarktaskping.cpp
@@ -79,8 +85,8 @@ target_sources(mozillavpn-sources INTERFACE
     ${CMAKE_CURRENT_SOURCE_DIR}/connectionbenchmark/benchmarktasktransfer.h
     ${CMAKE_CURRENT_SOURCE_DIR}/connectionbenchmark/connectionbenchmark.cpp
     ${CMAKE_CURRENT_SOURCE_DIR}/connectionbenchmark/connectionbenchmark.h
-    ${CMAKE_CURRENT_SOURCE_DIR}/connectionbenchmark/uploaddatagenerator.cpp
-    ${CMAKE_CURRENT_SOURCE_DIR}/connectionbenchmark/uploaddatagenerator.h
+    ${CMAKE_CURRENT_SOURCE_DIR}/connectionbenchmark/throughputsampler.cpp
+    ${CMAKE_CURRENT_SOURCE_DIR}/connectionbenchmark/throughputsampler.h
     ${CMAKE_CURRENT_SOURCE_DIR}/connectionhealth.cpp
     ${CMAKE_CURRENT_SOURCE_DIR}/connectionhealth.h
     ${CMAKE_CURRENT_SOURCE_DIR}/connectionmanager.cpp
@@ -118,6 +124,8 @@ target_sources(mozillavpn-sources INTERFACE
     ${CMAKE_CURRENT_SOURCE_DIR}/models/recommendedlocationmodel.h
     ${CMAKE_CURRENT_SOURCE_DIR}/models/server.cpp
     ${CMAKE_CURRENT_SOURCE_DIR}/models/server.h
+    ${CMAKE_CURRENT_SOURCE_DIR}/models/servercatalog.cpp
+    ${CMAKE_CURRENT_SOURCE_DIR}/models/servercatalog.h
     ${CMAKE_CURRENT_SOURCE_DIR}/models/servercity.cpp
     ${CMAKE_CURRENT_SOURCE_DIR}/models/servercity.h
     ${CMAKE_CURRENT_SOURCE_DIR}/models/servercountry.cpp
@@ -126,6 +134,10 @@ target_sources(mozillavpn-sources INTERFACE
     ${CMAKE_CURRENT_SOURCE_DIR}/models/servercountrymodel.h
     ${CMAKE_CURRENT_SOURCE_DIR}/models/serverdata.cpp
     ${CMAKE_CURRENT_SOURCE_DIR}/models/serverdata.h
+    ${CMAKE_CURRENT_SOURCE_DIR}/models/serverjsonreader.cpp
+    ${CMAKE_CURRENT_SOURCE_DIR}/models/serverjsonreader.h
+    ${CMAKE_CURRENT_SOURCE_DIR}/models/serverkeys.cpp
+    ${CMAKE_CURRENT_SOURCE_DIR}/models/serverkeys.h
     ${CMAKE_CURRENT_SOURCE_DIR}/models/subscriptiondata.cpp
     ${CMAKE_CURRENT_SOURCE_DIR}/models/subscriptiondata.h
     ${CMAKE_CURRENT_SOURCE_DIR}/models/supportcategorymodel.cpp
@@ -169,6 +181,8 @@ target_sources(mozillavpn-sources INTERFACE
     ${CMAKE_CURRENT_SOURCE_DIR}/serveri18n.h
     ${CMAKE_CURRENT_SOURCE_DIR}/serverlatency.cpp
     ${CMAKE_CURRENT_SOURCE_DIR}/serverlatency.h
+    ${CMAKE_CURRENT_SOURCE_DIR}/serverselection.cpp
+    ${CMAKE_CURRENT_SOURCE_DIR}/serverselection.h
     ${CMAKE_CURRENT_SOURCE_DIR}/settingswatcher.cpp
     ${CMAKE_CURRENT_SOURCE_DIR}/settingswatcher.h
     ${CMAKE_CURRENT_SOURCE_DIR}/statusicon.cpp
@@ -230,5 +244,7 @@ if(NOT CMAKE_CROSSCOMPILING)
         ${CMAKE_CURRENT_SOURCE_DIR}/server/serverconnection.h
         ${CMAKE_CURRENT_SOURCE_DIR}/server/serverhandler.cpp
         ${CMAKE_CURRENT_SOURCE_DIR}/server/serverhandler.h
+        ${CMAKE_CURRENT_SOURCE_DIR}/server/servermessage.cpp
+        ${CMAKE_CURRENT_SOURCE_DIR}/server/servermessage.h
        )
 endif()
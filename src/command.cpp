@@ -72,6 +72,9 @@ bool Command::userAuthenticated() {
 bool Command::loadModels() {
   MozillaVPN* vpn = MozillaVPN::instance();
 
+  // The device list is parsed on the thread pool while the keys are read.
+  vpn->deviceModel()->prefetchSettings();
+
   // First the keys!
   if (!vpn->keys()->fromSettings()) {
     QTextStream stream(stdout);
@@ -82,7 +85,7 @@ bool Command::loadModels() {
   vpn->serverData()->initialize();
 
   if (!vpn->deviceModel()->fromSettings(vpn->keys()) ||
-      !vpn->serverCountryModel()->fromSettings() ||
+      !vpn->serverCountryModel()->fromSettingsLazily() ||
       !vpn->user()->fromSettings() || !vpn->serverData()->fromSettings() ||
       !vpn->modelsInitialized()) {
     QTextStream stream(stdout);
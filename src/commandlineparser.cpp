@@ -122,10 +122,19 @@ bool CommandLineParser::parseOptions(QStringList& tokens,
       shortOption = false;
     }
 
-    if (!parseOption(opt, shortOption, options)) {
+    Option* o = parseOption(opt, shortOption, options);
+    if (!o) {
       return false;
     }
 
+    if (o->m_hasValue) {
+      if (tokens.length() < 2) {
+        return false;
+      }
+      o->m_value = tokens[1];
+      tokens.removeFirst();
+    }
+
     tokens.removeFirst();
   }
 
@@ -133,21 +142,21 @@ bool CommandLineParser::parseOptions(QStringList& tokens,
 }
 
 // static
-bool CommandLineParser::parseOption(const QString& option, bool shortOption,
-                                    QList<Option*>& options) {
+CommandLineParser::Option* CommandLineParser::parseOption(
+    const QString& option, bool shortOption, QList<Option*>& options) {
   for (Option* o : options) {
     if (shortOption && o->m_short == option) {
       o->m_set = true;
-      return true;
+      return o;
     }
 
     if (!shortOption && o->m_long == option) {
       o->m_set = true;
-      return true;
+      return o;
     }
   }
 
-  return false;
+  return nullptr;
 }
 
 // static
@@ -169,7 +178,8 @@ void CommandLineParser::showHelp(QObject* parent, const QString& app,
   stream << "usage: " << app;
 
   for (const Option* o : options) {
-    stream << " [-" << o->m_short << " | --" << o->m_long << "]";
+    stream << " [-" << o->m_short << " | --" << o->m_long
+           << (o->m_hasValue ? " <value>" : "") << "]";
   }
 
   if (hasCommands) {
@@ -187,6 +197,9 @@ void CommandLineParser::showHelp(QObject* parent, const QString& app,
     stream << "List of options:" << Qt::endl;
     for (const Option* o : options) {
       QString desc = QString("-%1 | --%2").arg(o->m_short, o->m_long);
+      if (o->m_hasValue) {
+        desc.append(" <value>");
+      }
       stream << "  " << desc << " ";
 
       for (qsizetype i = desc.length(); i < 20; ++i) {
@@ -18,14 +18,21 @@ class CommandLineParser final : QObject {
   ~CommandLineParser();
 
   struct Option {
-    Option(const char* a_short, const char* a_long, const char* description)
-        : m_short(a_short), m_long(a_long), m_description(description) {}
+    // An option with a value takes the following token: `-p 4`.
+    Option(const char* a_short, const char* a_long, const char* description,
+           bool hasValue = false)
+        : m_short(a_short),
+          m_long(a_long),
+          m_description(description),
+          m_hasValue(hasValue) {}
 
     const char* m_short;
     const char* m_long;
     const char* m_description;
+    bool m_hasValue;
 
     bool m_set = false;
+    QString m_value;
   };
 
   [[nodiscard]] int parse(int argc, char* argv[]);
@@ -49,8 +56,8 @@ class CommandLineParser final : QObject {
 
  private:
   static bool parseOptions(QStringList& tokens, QList<Option*>& options);
-  static bool parseOption(const QString& option, bool shortOption,
-                          QList<Option*>& options);
+  static Option* parseOption(const QString& option, bool shortOption,
+                             QList<Option*>& options);
 };
 
 #endif  // COMMANDLINEPARSER_H
@@ -0,0 +1,248 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "commandprobe.h"
+
+#include <QEventLoop>
+#include <QHash>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSet>
+#include <QTextStream>
+
+#include "commandlineparser.h"
+#include "connectionbenchmark/benchmarktasktransfer.h"
+#include "constants.h"
+#include "leakdetector.h"
+#include "models/servercity.h"
+#include "models/servercountrymodel.h"
+#include "mozillavpn.h"
+#include "serverlatency.h"
+
+// As many as the latency refresh of the app.
+constexpr int PROBE_DEFAULT_PARALLEL = 8;
+
+namespace {
+
+struct PingStats {
+  int sent = 0;
+  int lost = 0;
+};
+
+double lossRatio(const PingStats& stats) {
+  return stats.sent ? static_cast<double>(stats.lost) / stats.sent : 0;
+}
+
+// True if the filter is not set, or if it is the value.
+bool matches(const CommandLineParser::Option& filter, const QString& value) {
+  return !filter.m_set ||
+         value.compare(filter.m_value, Qt::CaseInsensitive) == 0;
+}
+
+void printLine(const QJsonObject& obj) {
+  QTextStream(stdout) << QJsonDocument(obj).toJson(QJsonDocument::Compact)
+                      << Qt::endl;
+}
+
+void runBenchmark(const QString& name,
+                  BenchmarkTaskTransfer::BenchmarkType type,
+                  const QString& url) {
+  BenchmarkTaskTransfer task(name, type, url);
+
+  QJsonObject obj;
+  obj["type"] =
+      type == BenchmarkTaskTransfer::BenchmarkDownload ? "download" : "upload";
+  QObject::connect(&task, &BenchmarkTaskTransfer::finished, &task,
+                   [&](quint64 bitsPerSec, quint64 p90BitsPerSec,
+                       double stability, bool hasUnexpectedError) {
+                     obj["bps"] = static_cast<double>(bitsPerSec);
+                     obj["p90"] = static_cast<double>(p90BitsPerSec);
+                     obj["stability"] = stability;
+                     obj["error"] = hasUnexpectedError;
+                   });
+
+  // The task can complete before the event loop starts.
+  bool completed = false;
+  QEventLoop loop;
+  QObject::connect(&task, &Task::completed, &task, [&] {
+    completed = true;
+    loop.exit();
+  });
+
+  task.run();
+  if (!completed) {
+    loop.exec();
+  }
+
+  printLine(obj);
+}
+
+}  // namespace
+
+CommandProbe::CommandProbe(QObject* parent)
+    : Command(parent, "probe", "Measure the latency of the servers.") {
+  MZ_COUNT_CTOR(CommandProbe);
+}
+
+CommandProbe::~CommandProbe() { MZ_COUNT_DTOR(CommandProbe); }
+
+int CommandProbe::run(QStringList& tokens) {
+  Q_ASSERT(!tokens.isEmpty());
+  return runCommandLineApp([&]() {
+    QString appName = tokens[0];
+
+    CommandLineParser::Option hOption = CommandLineParser::helpOption();
+    CommandLineParser::Option countryOption(
+        "c", "country", "Only the servers of this country code.", true);
+    CommandLineParser::Option cityOption(
+        "t", "city", "Only the servers of this city name or code.", true);
+    CommandLineParser::Option parallelOption(
+        "p", "parallel", "Number of servers pinged at the same time.", true);
+    CommandLineParser::Option benchmarkOption(
+        "b", "benchmark", "Measure the download and upload speed too.");
+
+    QList<CommandLineParser::Option*> options;
+    options.append(&hOption);
+    options.append(&countryOption);
+    options.append(&cityOption);
+    options.append(&parallelOption);
+    options.append(&benchmarkOption);
+
+    CommandLineParser clp;
+    if (clp.parse(tokens, options, false)) {
+      return 1;
+    }
+
+    if (!tokens.isEmpty()) {
+      return clp.unknownOption(this, appName, tokens[0], options, false);
+    }
+
+    if (hOption.m_set) {
+      clp.showHelp(this, appName, options, false, false);
+      return 0;
+    }
+
+    int parallel = PROBE_DEFAULT_PARALLEL;
+    if (parallelOption.m_set) {
+      bool ok = false;
+      parallel = parallelOption.m_value.toInt(&ok);
+      if (!ok || parallel < 1) {
+        QTextStream(stderr) << "invalid parallel value: "
+                            << parallelOption.m_value << Qt::endl;
+        return 1;
+      }
+    }
+
+    if (!userAuthenticated()) {
+      return 1;
+    }
+
+    MozillaVPN vpn;
+    if (!loadModels()) {
+      return 1;
+    }
+
+    ServerCountryModel* scm = vpn.serverCountryModel();
+
+    QList<const ServerCity*> cities;
+    QSet<QString> cityKeys;
+    for (const ServerCountry& country : scm->countries()) {
+      if (!matches(countryOption, country.code())) {
+        continue;
+      }
+
+      for (const QString& cityName : country.cities()) {
+        const ServerCity& city = scm->findCity(country.code(), cityName);
+        if (!city.initialized()) {
+          continue;
+        }
+
+        if (!matches(cityOption, city.name()) &&
+            !matches(cityOption, city.code())) {
+          continue;
+        }
+
+        cities.append(&city);
+        cityKeys.insert(city.hashKey());
+      }
+    }
+
+    if (cities.isEmpty()) {
+      QTextStream(stderr) << "no servers match the filters" << Qt::endl;
+      return 1;
+    }
+
+    // A JSON line per server, as soon as it is measured.
+    QHash<uint32_t, PingStats> pings;
+    ServerLatency* serverLatency = vpn.serverLatency();
+    QObject::connect(
+        serverLatency, &ServerLatency::serverPinged, serverLatency,
+        [&](uint32_t id, qint64 msec, int sent) {
+          PingStats& stats = pings[id];
+          stats.sent = sent;
+          stats.lost = msec < 0 ? sent : sent - 1;
+
+          const Server& server = scm->server(id);
+          QJsonObject obj;
+          obj["type"] = "server";
+          obj["country"] = server.countryCode();
+          obj["city"] = server.cityName();
+          obj["hostname"] = server.hostname();
+          obj["rtt"] = msec < 0 ? QJsonValue() : QJsonValue(msec);
+          obj["loss"] = lossRatio(stats);
+          printLine(obj);
+        });
+
+    QEventLoop loop;
+    QObject::connect(serverLatency, &ServerLatency::progressChanged,
+                     serverLatency, [&] {
+                       if (!serverLatency->isActive()) {
+                         loop.exit();
+                       }
+                     });
+
+    serverLatency->sweep(parallel, [&](const ServerCity& city) {
+      return cityKeys.contains(city.hashKey());
+    });
+    if (serverLatency->isActive()) {
+      loop.exec();
+    }
+
+    // Then a JSON line per city. The scores compare the cities with the
+    // average latency of the probed servers only.
+    for (const ServerCity* city : cities) {
+      PingStats stats;
+      for (uint32_t id : city->servers()) {
+        PingStats serverStats = pings.value(id);
+        stats.sent += serverStats.sent;
+        stats.lost += serverStats.lost;
+      }
+
+      qint64 latency = city->latency();
+
+      QJsonObject obj;
+      obj["type"] = "city";
+      obj["country"] = city->country();
+      obj["city"] = city->name();
+      obj["servers"] = city->servers().count();
+      obj["rtt"] = latency > 0 ? QJsonValue(latency) : QJsonValue();
+      obj["loss"] = lossRatio(stats);
+      obj["score"] = city->connectionScore();
+      printLine(obj);
+    }
+
+    if (benchmarkOption.m_set) {
+      runBenchmark("BenchmarkTaskDownload",
+                   BenchmarkTaskTransfer::BenchmarkDownload,
+                   Constants::benchmarkDownloadUrl());
+      runBenchmark("BenchmarkTaskUpload",
+                   BenchmarkTaskTransfer::BenchmarkUpload,
+                   Constants::benchmarkUploadUrl());
+    }
+
+    return 0;
+  });
+}
+
+static Command::RegistrationProxy<CommandProbe> s_commandProbe;
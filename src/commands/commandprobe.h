@@ -0,0 +1,18 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef COMMANDPROBE_H
+#define COMMANDPROBE_H
+
+#include "command.h"
+
+class CommandProbe final : public Command {
+ public:
+  explicit CommandProbe(QObject* parent);
+  ~CommandProbe();
+
+  int run(QStringList& tokens) override;
+};
+
+#endif  // COMMANDPROBE_H
@@ -75,8 +75,8 @@ bool CommandSelect::pickServer(const QString& hostname, QString& countryCode,
       if (!city.initialized()) {
         continue;
       }
-      for (const QString& pubkey : city.servers()) {
-        const Server& server = model->server(pubkey);
+      for (uint32_t id : city.servers()) {
+        const Server& server = model->server(id);
         if (server.hostname() == hostname) {
           countryCode = country.code();
           cityName = city.name();
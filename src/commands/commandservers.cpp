@@ -89,8 +89,8 @@ int CommandServers::run(QStringList& tokens) {
           cityObj["code"] = city.code();
 
           QJsonArray serverArray;
-          for (const QString& pubkey : city.servers()) {
-            const Server& server = vpn.serverCountryModel()->server(pubkey);
+          for (uint32_t id : city.servers()) {
+            const Server& server = vpn.serverCountryModel()->server(id);
             if (!server.initialized()) {
               continue;
             }
@@ -126,8 +126,8 @@ int CommandServers::run(QStringList& tokens) {
           }
           stream << "  - City: " << city.name() << " (" << city.code() << ")"
                  << Qt::endl;
-          for (const QString& pubkey : city.servers()) {
-            const Server& server = vpn.serverCountryModel()->server(pubkey);
+          for (uint32_t id : city.servers()) {
+            const Server& server = vpn.serverCountryModel()->server(id);
             if (!server.initialized()) {
               continue;
             }
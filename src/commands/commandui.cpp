@@ -279,6 +279,7 @@ int CommandUI::run(QStringList& tokens) {
 
     // Font loader
     FontLoader::loadFonts();
+    vpn.telemetry()->timeToFirstScreenStage("fonts");
 
     vpn.initialize();
 
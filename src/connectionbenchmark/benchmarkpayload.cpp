@@ -0,0 +1,67 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "benchmarkpayload.h"
+
+#if defined(Q_OS_WIN)
+#  include <Windows.h>
+#elif !defined(Q_OS_WASM)
+#  include <sys/mman.h>
+
+#  include <cerrno>
+#endif
+
+#include "constants.h"
+#include "logger.h"
+
+namespace {
+Logger logger("BenchmarkPayload");
+
+// The mapping lives as long as the process.
+const char* mapPayload(qint64 size) {
+#if defined(Q_OS_WIN)
+  // Windows has no shared zero page. The committed pages are charged against
+  // the commit limit, and each page is zero-filled in the working set when
+  // it is first read. The mapping is shared by all the requests, so this
+  // cost is paid at most once.
+  void* data = VirtualAlloc(nullptr, static_cast<SIZE_T>(size),
+                            MEM_RESERVE | MEM_COMMIT, PAGE_READONLY);
+  if (!data) {
+    logger.error() << "Failed to map the payload:" << GetLastError();
+    return nullptr;
+  }
+  return static_cast<const char*>(data);
+#elif defined(Q_OS_WASM)
+  // No virtual memory here: a plain zero-filled buffer.
+  static const QByteArray s_buffer(size, '\0');
+  return s_buffer.constData();
+#else
+  // On Linux, reading private anonymous pages that are never written maps
+  // the zero page of the kernel: the payload takes no physical memory. Other
+  // kernels may zero-fill each page on its first read, as Windows does.
+  void* data = mmap(nullptr, static_cast<size_t>(size), PROT_READ,
+                    MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (data == MAP_FAILED) {
+    logger.error() << "Failed to map the payload:" << errno;
+    return nullptr;
+  }
+  return static_cast<const char*>(data);
+#endif
+}
+
+}  // namespace
+
+// static
+QByteArray BenchmarkPayload::data(qint64 size) {
+  static const char* s_payload =
+      mapPayload(Constants::BENCHMARK_MAX_BYTES_UPLOAD);
+
+  if (!s_payload) {
+    return QByteArray();
+  }
+
+  return QByteArray::fromRawData(
+      s_payload,
+      qBound<qint64>(0, size, Constants::BENCHMARK_MAX_BYTES_UPLOAD));
+}
@@ -0,0 +1,24 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BENCHMARKPAYLOAD_H
+#define BENCHMARKPAYLOAD_H
+
+#include <QByteArray>
+
+// The body of the upload benchmarks: zeros, in a read-only, page-aligned
+// block that is mapped once and shared by all the requests. The requests
+// upload it through QByteArray::fromRawData(), so it is never copied.
+class BenchmarkPayload final {
+ public:
+  // Returns the first `size` bytes of the payload, at most
+  // Constants::BENCHMARK_MAX_BYTES_UPLOAD. Empty if the payload cannot be
+  // mapped.
+  static QByteArray data(qint64 size);
+
+ private:
+  BenchmarkPayload() = default;
+};
+
+#endif  // BENCHMARKPAYLOAD_H
@@ -9,29 +9,74 @@
 #include <QHostAddress>
 #include <QScopeGuard>
 
+#if defined(Q_OS_WIN)
+#  include <Windows.h>
+#elif !defined(Q_OS_WASM)
+#  include <sys/resource.h>
+#endif
+
+#include "benchmarkpayload.h"
 #include "constants.h"
 #include "leakdetector.h"
 #include "logger.h"
 #include "networkrequest.h"
-#include "uploaddatagenerator.h"
 
 namespace {
 Logger logger("BenchmarkTaskTransfer");
+
+// User and system CPU time of the whole process, or -1 if unknown.
+qint64 processCpuTimeUsec() {
+#if defined(Q_OS_WIN)
+  FILETIME creation, exit, kernel, user;
+  if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel,
+                       &user)) {
+    return -1;
+  }
+
+  // In units of 100 nanoseconds.
+  auto toUsec = [](const FILETIME& time) {
+    return ((static_cast<qint64>(time.dwHighDateTime) << 32) |
+            time.dwLowDateTime) /
+           10;
+  };
+  return toUsec(kernel) + toUsec(user);
+#elif defined(Q_OS_WASM)
+  return -1;
+#else
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) {
+    return -1;
+  }
+
+  auto toUsec = [](const timeval& time) {
+    return static_cast<qint64>(time.tv_sec) * 1000000 + time.tv_usec;
+  };
+  return toUsec(usage.ru_utime) + toUsec(usage.ru_stime);
+#endif
 }
 
+}  // namespace
+
 BenchmarkTaskTransfer::BenchmarkTaskTransfer(const QString& name,
                                              BenchmarkType type,
-                                             const QUrl& url)
+                                             const QUrl& url, int streams)
     : BenchmarkTask(name, Constants::BENCHMARK_MAX_DURATION_TRANSFER),
       m_type(type),
       m_dnsLookup(QDnsLookup::A, url.host()),
-      m_url(url) {
+      m_url(url),
+      m_streams(qMax(1, streams)),
+      m_sampler(Constants::BENCHMARK_SLICE_MSEC,
+                Constants::BENCHMARK_WARMUP_MSEC) {
   MZ_COUNT_CTOR(BenchmarkTaskTransfer);
 
   connect(this, &BenchmarkTask::stateChanged, this,
           &BenchmarkTaskTransfer::handleState);
   connect(&m_dnsLookup, &QDnsLookup::finished, this,
           &BenchmarkTaskTransfer::dnsLookupFinished);
+
+  m_sliceTimer.setInterval(Constants::BENCHMARK_SLICE_MSEC);
+  connect(&m_sliceTimer, &QTimer::timeout, this,
+          &BenchmarkTaskTransfer::sliceElapsed);
 }
 
 BenchmarkTaskTransfer::~BenchmarkTaskTransfer() {
@@ -47,18 +92,23 @@ void BenchmarkTaskTransfer::handleState(BenchmarkTask::State state) {
 #    error Check if QT added support for QDnsLookup::lookup() on Android
 #  endif
 
-    createNetworkRequest();
+    for (int i = 0; i < m_streams; ++i) {
+      createNetworkRequest();
+    }
+    startSampling();
 #else
     // Start DNS resolution
     m_dnsLookup.lookup();
 #endif
-
-    m_elapsedTimer.start();
   } else if (state == BenchmarkTask::StateInactive) {
-    for (NetworkRequest* request : m_requests) {
+    m_sliceTimer.stop();
+
+    // Aborting a request completes it synchronously: the last one reports
+    // the result.
+    const QList<NetworkRequest*> requests = m_requests;
+    for (NetworkRequest* request : requests) {
       request->abort();
     }
-    m_requests.clear();
     m_dnsLookup.abort();
   }
 }
@@ -70,21 +120,24 @@ void BenchmarkTaskTransfer::createNetworkRequest() {
   switch (m_type) {
     case BenchmarkDownload: {
       request = new NetworkRequest(this);
+      request->discardReplyBody(Constants::BENCHMARK_READ_BUFFER_SIZE);
       request->get(m_url);
       break;
     }
     case BenchmarkUpload: {
-      UploadDataGenerator* uploadData =
-          new UploadDataGenerator(Constants::BENCHMARK_MAX_BYTES_UPLOAD);
+      // The streams share the upload budget, and the payload.
+      QByteArray payload = BenchmarkPayload::data(
+          Constants::BENCHMARK_MAX_BYTES_UPLOAD / m_streams);
+      if (payload.isEmpty()) {
+        logger.error() << "Failed to generate the upload data";
+        m_hasUnexpectedError = true;
+        return;
+      }
 
-      if (!uploadData->open(UploadDataGenerator::ReadOnly)) {
-        emit finished(0, true);
-        emit completed();
-      };
       request = new NetworkRequest(this, 200);
       request->requestInternal().setHeader(QNetworkRequest::ContentTypeHeader,
                                            "application/x-www-form-urlencoded");
-      request->post(m_url, uploadData);
+      request->post(m_url, payload);
       break;
     }
   }
@@ -113,18 +166,20 @@ void BenchmarkTaskTransfer::createNetworkRequestWithRecord(
       request = new NetworkRequest(this, 200);
       request->requestInternal().setRawHeader("Host", hostname.toLocal8Bit());
       request->requestInternal().setPeerVerifyName(hostname);
+      request->discardReplyBody(Constants::BENCHMARK_READ_BUFFER_SIZE);
 
       request->get(requestUrl);
       break;
     }
     case BenchmarkUpload: {
-      UploadDataGenerator* uploadData =
-          new UploadDataGenerator(Constants::BENCHMARK_MAX_BYTES_UPLOAD);
+      QByteArray payload = BenchmarkPayload::data(
+          Constants::BENCHMARK_MAX_BYTES_UPLOAD / m_streams);
+      if (payload.isEmpty()) {
+        logger.error() << "Failed to generate the upload data";
+        m_hasUnexpectedError = true;
+        return;
+      }
 
-      if (!uploadData->open(UploadDataGenerator::ReadOnly)) {
-        emit finished(0, true);
-        emit completed();
-      };
       QUrl requestUrl(m_url);
       QString hostname = requestUrl.host();
 
@@ -142,7 +197,7 @@ void BenchmarkTaskTransfer::createNetworkRequestWithRecord(
       request->requestInternal().setRawHeader("Host", hostname.toLocal8Bit());
       request->requestInternal().setPeerVerifyName(hostname);
 
-      request->post(requestUrl, uploadData);
+      request->post(requestUrl, payload);
       break;
     }
     default: {
@@ -187,7 +242,7 @@ void BenchmarkTaskTransfer::connectNetworkRequest(NetworkRequest* request) {
 
 void BenchmarkTaskTransfer::dnsLookupFinished() {
   auto guard = qScopeGuard([&] {
-    emit finished(0, true);
+    emit finished(0, 0, 0, true);
     emit completed();
   });
 
@@ -210,13 +265,36 @@ void BenchmarkTaskTransfer::dnsLookupFinished() {
   }
 
   logger.debug() << "DNS Lookup Finished";
-  for (const QDnsHostAddressRecord& record : m_dnsLookup.hostAddressRecords()) {
+  guard.dismiss();
+
+  // The streams are spread over the records.
+  const QList<QDnsHostAddressRecord> records =
+      m_dnsLookup.hostAddressRecords();
+  for (int i = 0; i < m_streams; ++i) {
+    const QDnsHostAddressRecord& record = records.at(i % records.count());
     logger.debug() << "Host record:" << record.value().toString();
     createNetworkRequestWithRecord(record);
   }
 
+  startSampling();
+}
+
+void BenchmarkTaskTransfer::startSampling() {
+  if (m_requests.isEmpty()) {
+    emit finished(0, 0, 0, true);
+    emit completed();
+    return;
+  }
+
+  m_cpuTimeUsec = processCpuTimeUsec();
   m_elapsedTimer.start();
-  guard.dismiss();
+  m_sliceTimer.start();
+}
+
+void BenchmarkTaskTransfer::sliceElapsed() {
+  for (quint64 bitsPerSec : m_sampler.advance(m_elapsedTimer.elapsed())) {
+    emit progressed(bitsPerSec);
+  }
 }
 
 void BenchmarkTaskTransfer::transferProgressed(qint64 bytesSent,
@@ -230,12 +308,15 @@ void BenchmarkTaskTransfer::transferProgressed(qint64 bytesSent,
 #endif
 
   NetworkRequest* request = qobject_cast<NetworkRequest*>(sender());
-  if (request != nullptr) {
-    request->discardData();
+  if (request == nullptr) {
+    return;
   }
 
-  if (bytesSent > 0) {
-    m_bytesTransferred = bytesSent;
+  // The counters are per request: the streams are summed by their deltas.
+  qint64& streamBytes = m_streamBytes[request];
+  if (bytesSent > streamBytes) {
+    m_sampler.addBytes(m_elapsedTimer.elapsed(), bytesSent - streamBytes);
+    streamBytes = bytesSent;
   }
 }
 
@@ -245,18 +326,27 @@ void BenchmarkTaskTransfer::transferReady(QNetworkReply::NetworkError error,
   Q_UNUSED(data);
 
   NetworkRequest* request = qobject_cast<NetworkRequest*>(QObject::sender());
-  m_requests.removeOne(request);
+  if (!m_requests.removeOne(request)) {
+    return;
+  }
 
-  quint64 bitsPerSec = 0;
-  double msecs = static_cast<double>(m_elapsedTimer.elapsed());
-  if (m_bytesTransferred > 0 && msecs > 0) {
-    bitsPerSec = static_cast<quint64>(
-        static_cast<double>(m_bytesTransferred * 8) / (msecs / 1000.00));
+  if (error != QNetworkReply::NoError &&
+      error != QNetworkReply::OperationCanceledError &&
+      error != QNetworkReply::TimeoutError) {
+    m_hasUnexpectedError = true;
+  }
+
+  if (!m_requests.isEmpty()) {
+    return;
   }
 
-  bool hasUnexpectedError = (error != QNetworkReply::NoError &&
-                             error != QNetworkReply::OperationCanceledError &&
-                             error != QNetworkReply::TimeoutError)
+  m_sliceTimer.stop();
+  sliceElapsed();
+  m_sampler.finish(m_elapsedTimer.elapsed());
+
+  quint64 bitsPerSec = m_sampler.throughput();
+
+  bool hasUnexpectedError = m_hasUnexpectedError
 #ifndef MZ_WASM
                             || bitsPerSec == 0
 #endif
@@ -264,8 +354,17 @@ void BenchmarkTaskTransfer::transferReady(QNetworkReply::NetworkError error,
 
   logger.debug() << "Transfer completed" << bitsPerSec << "baud";
 
-  if (m_requests.isEmpty()) {
-    emit finished(bitsPerSec, hasUnexpectedError);
-    emit completed();
+  // A client that saturates its CPU spends a lot more per byte than one
+  // waiting for the tunnel.
+  qint64 cpuTimeUsec = processCpuTimeUsec();
+  if (m_cpuTimeUsec >= 0 && cpuTimeUsec >= 0 && m_sampler.totalBytes() > 0) {
+    logger.info() << "Transfer CPU time:"
+                  << (cpuTimeUsec - m_cpuTimeUsec) / 1000.0 * 1000000000 /
+                         m_sampler.totalBytes()
+                  << "msec per GB";
   }
+
+  emit finished(bitsPerSec, m_sampler.p90(), m_sampler.stability(),
+                hasUnexpectedError);
+  emit completed();
 }
@@ -7,10 +7,14 @@
 
 #include <QDnsLookup>
 #include <QElapsedTimer>
+#include <QHash>
 #include <QNetworkReply>
+#include <QTimer>
 #include <QUrl>
 
 #include "benchmarktask.h"
+#include "constants.h"
+#include "throughputsampler.h"
 
 class NetworkRequest;
 
@@ -25,12 +29,20 @@ class BenchmarkTaskTransfer : public BenchmarkTask {
     BenchmarkUpload,
   };
 
-  explicit BenchmarkTaskTransfer(const QString& name, BenchmarkType type,
-                                 const QUrl& url);
+  // The transfer runs `streams` requests in parallel, spread over the
+  // addresses of the host.
+  explicit BenchmarkTaskTransfer(
+      const QString& name, BenchmarkType type, const QUrl& url,
+      int streams = Constants::BENCHMARK_TRANSFER_STREAMS);
   virtual ~BenchmarkTaskTransfer();
 
  signals:
-  void finished(quint64 bitsPerSec, bool hasUnexpectedError);
+  // Emitted for each time slice of the transfer.
+  void progressed(quint64 bitsPerSec);
+
+  // `bitsPerSec` is the steady-state throughput, without the warm-up.
+  void finished(quint64 bitsPerSec, quint64 p90BitsPerSec, double stability,
+                bool hasUnexpectedError);
 
  private:
   void createNetworkRequest();
@@ -38,6 +50,8 @@ class BenchmarkTaskTransfer : public BenchmarkTask {
   void connectNetworkRequest(NetworkRequest* request);
   void dnsLookupFinished();
   void handleState(BenchmarkTask::State state);
+  void startSampling();
+  void sliceElapsed();
   void transferProgressed(qint64 bytesTransferred, qint64 bytesTotal,
                           QNetworkReply* reply);
   void transferReady(QNetworkReply::NetworkError error, const QByteArray& data);
@@ -47,9 +61,18 @@ class BenchmarkTaskTransfer : public BenchmarkTask {
   QDnsLookup m_dnsLookup;
   QList<NetworkRequest*> m_requests;
   const QUrl m_url;
+  const int m_streams;
+
+  // Bytes transferred so far by each request.
+  QHash<NetworkRequest*, qint64> m_streamBytes;
+  bool m_hasUnexpectedError = false;
 
-  qint64 m_bytesTransferred = 0;
+  ThroughputSampler m_sampler;
+  QTimer m_sliceTimer;
   QElapsedTimer m_elapsedTimer;
+
+  // CPU time of the process when the sampling started, or -1.
+  qint64 m_cpuTimeUsec = -1;
 };
 
 #endif  // BENCHMARKTASKTRANSFER_H
@@ -86,6 +86,7 @@ void ConnectionBenchmark::start() {
   Q_ASSERT(connectionState == ConnectionManager::StateOn);
 
   setState(StateRunning);
+  clearSeries();
 
   // Create ping benchmark
   BenchmarkTaskPing* pingTask = new BenchmarkTaskPing();
@@ -102,6 +103,8 @@ void ConnectionBenchmark::start() {
       Constants::benchmarkDownloadUrl());
   connect(downloadTask, &BenchmarkTaskTransfer::finished, this,
           &ConnectionBenchmark::downloadBenchmarked);
+  connect(downloadTask, &BenchmarkTaskTransfer::progressed, this,
+          &ConnectionBenchmark::downloadProgressed);
   connect(downloadTask->sentinel(), &BenchmarkTaskSentinel::sentinelDestroyed,
           this,
           [this, downloadTask]() { m_benchmarkTasks.removeOne(downloadTask); });
@@ -117,6 +120,8 @@ void ConnectionBenchmark::start() {
 
     connect(uploadTask, &BenchmarkTaskTransfer::finished, this,
             &ConnectionBenchmark::uploadBenchmarked);
+    connect(uploadTask, &BenchmarkTaskTransfer::progressed, this,
+            &ConnectionBenchmark::uploadProgressed);
     connect(uploadTask->sentinel(), &BenchmarkTask::destroyed, this,
             [this, uploadTask]() { m_benchmarkTasks.removeOne(uploadTask); });
     m_benchmarkTasks.append(uploadTask);
@@ -153,12 +158,30 @@ void ConnectionBenchmark::reset() {
   m_uploadBps = 0;
   m_pingLatency = 0;
 
+  m_downloadP90Bps = 0;
+  m_downloadStability = 0;
+  m_uploadP90Bps = 0;
+  m_uploadStability = 0;
+
+  clearSeries();
+
   setState(StateInitial);
 }
 
+void ConnectionBenchmark::clearSeries() {
+  m_downloadSeries.clear();
+  emit downloadSeriesChanged();
+
+  m_uploadSeries.clear();
+  emit uploadSeriesChanged();
+}
+
 void ConnectionBenchmark::downloadBenchmarked(quint64 bitsPerSec,
+                                              quint64 p90BitsPerSec,
+                                              double stability,
                                               bool hasUnexpectedError) {
-  logger.debug() << "Benchmarked download" << bitsPerSec;
+  logger.debug() << "Benchmarked download" << bitsPerSec << "p90"
+                 << p90BitsPerSec << "stability" << stability;
 
   if (hasUnexpectedError) {
     setState(StateError);
@@ -166,6 +189,8 @@ void ConnectionBenchmark::downloadBenchmarked(quint64 bitsPerSec,
   }
 
   m_downloadBps = bitsPerSec;
+  m_downloadP90Bps = p90BitsPerSec;
+  m_downloadStability = stability;
   emit downloadBpsChanged();
 
   if (!Feature::get(Feature::Feature_benchmarkUpload)->isSupported()) {
@@ -174,6 +199,11 @@ void ConnectionBenchmark::downloadBenchmarked(quint64 bitsPerSec,
   }
 }
 
+void ConnectionBenchmark::downloadProgressed(quint64 bitsPerSec) {
+  m_downloadSeries.append(bitsPerSec);
+  emit downloadSeriesChanged();
+}
+
 void ConnectionBenchmark::pingBenchmarked(quint64 pingLatency) {
   logger.debug() << "Benchmarked ping" << pingLatency;
 
@@ -182,8 +212,11 @@ void ConnectionBenchmark::pingBenchmarked(quint64 pingLatency) {
 }
 
 void ConnectionBenchmark::uploadBenchmarked(quint64 bitsPerSec,
+                                            quint64 p90BitsPerSec,
+                                            double stability,
                                             bool hasUnexpectedError) {
-  logger.debug() << "Benchmarked upload" << bitsPerSec;
+  logger.debug() << "Benchmarked upload" << bitsPerSec << "p90"
+                 << p90BitsPerSec << "stability" << stability;
 
   if (hasUnexpectedError) {
     setState(StateError);
@@ -191,6 +224,8 @@ void ConnectionBenchmark::uploadBenchmarked(quint64 bitsPerSec,
   }
 
   m_uploadBps = bitsPerSec;
+  m_uploadP90Bps = p90BitsPerSec;
+  m_uploadStability = stability;
   emit uploadBpsChanged();
 
   if (Feature::get(Feature::Feature_benchmarkUpload)->isSupported()) {
@@ -199,6 +234,11 @@ void ConnectionBenchmark::uploadBenchmarked(quint64 bitsPerSec,
   }
 }
 
+void ConnectionBenchmark::uploadProgressed(quint64 bitsPerSec) {
+  m_uploadSeries.append(bitsPerSec);
+  emit uploadSeriesChanged();
+}
+
 void ConnectionBenchmark::handleControllerState() {
   if (m_state == StateInitial || m_state == StateReady) {
     return;
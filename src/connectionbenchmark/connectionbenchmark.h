@@ -23,6 +23,22 @@ class ConnectionBenchmark final : public QObject {
   Q_PROPERTY(quint16 pingLatency READ pingLatency NOTIFY pingLatencyChanged);
   Q_PROPERTY(quint64 uploadBps READ uploadBps NOTIFY uploadBpsChanged);
 
+  // Steady-state statistics of the transfers.
+  Q_PROPERTY(
+      quint64 downloadP90Bps READ downloadP90Bps NOTIFY downloadBpsChanged);
+  Q_PROPERTY(
+      qreal downloadStability READ downloadStability NOTIFY downloadBpsChanged);
+  Q_PROPERTY(quint64 uploadP90Bps READ uploadP90Bps NOTIFY uploadBpsChanged);
+  Q_PROPERTY(
+      qreal uploadStability READ uploadStability NOTIFY uploadBpsChanged);
+
+  // The throughput of each time slice, in bits per second, updated while
+  // the transfers run.
+  Q_PROPERTY(QList<qreal> downloadSeries READ downloadSeries NOTIFY
+                 downloadSeriesChanged);
+  Q_PROPERTY(QList<qreal> uploadSeries READ uploadSeries NOTIFY
+                 uploadSeriesChanged);
+
  public:
   ConnectionBenchmark();
   ~ConnectionBenchmark();
@@ -52,19 +68,32 @@ class ConnectionBenchmark final : public QObject {
   quint16 pingLatency() const { return m_pingLatency; }
   quint64 downloadBps() const { return m_downloadBps; }
   quint64 uploadBps() const { return m_uploadBps; }
+  quint64 downloadP90Bps() const { return m_downloadP90Bps; }
+  qreal downloadStability() const { return m_downloadStability; }
+  quint64 uploadP90Bps() const { return m_uploadP90Bps; }
+  qreal uploadStability() const { return m_uploadStability; }
+  const QList<qreal>& downloadSeries() const { return m_downloadSeries; }
+  const QList<qreal>& uploadSeries() const { return m_uploadSeries; }
 
  signals:
   void downloadBpsChanged();
+  void downloadSeriesChanged();
   void pingLatencyChanged();
   void uploadBpsChanged();
+  void uploadSeriesChanged();
   void speedChanged();
   void stateChanged();
 
  private:
-  void downloadBenchmarked(quint64 bitsPerSec, bool hasUnexpectedError);
+  void downloadBenchmarked(quint64 bitsPerSec, quint64 p90BitsPerSec,
+                           double stability, bool hasUnexpectedError);
+  void downloadProgressed(quint64 bitsPerSec);
   void pingBenchmarked(quint64 pingLatencyLatency);
-  void uploadBenchmarked(quint64 bitsPerSec, bool hasUnexpectedError);
+  void uploadBenchmarked(quint64 bitsPerSec, quint64 p90BitsPerSec,
+                         double stability, bool hasUnexpectedError);
+  void uploadProgressed(quint64 bitsPerSec);
 
+  void clearSeries();
   void handleControllerState();
   void handleStabilityChange();
   void setConnectionSpeed();
@@ -81,6 +110,14 @@ class ConnectionBenchmark final : public QObject {
   quint64 m_downloadBps = 0;
   quint16 m_pingLatency = 0;
   quint64 m_uploadBps = 0;
+
+  quint64 m_downloadP90Bps = 0;
+  qreal m_downloadStability = 0;
+  quint64 m_uploadP90Bps = 0;
+  qreal m_uploadStability = 0;
+
+  QList<qreal> m_downloadSeries;
+  QList<qreal> m_uploadSeries;
 };
 
 #endif  // CONNECTIONBENCHMARK_H
@@ -0,0 +1,116 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "throughputsampler.h"
+
+#include <QtMath>
+#include <algorithm>
+
+ThroughputSampler::ThroughputSampler(qint64 sliceMsec, qint64 warmupMsec)
+    : m_sliceMsec(sliceMsec), m_warmupMsec(warmupMsec) {
+  Q_ASSERT(m_sliceMsec > 0);
+}
+
+void ThroughputSampler::addBytes(qint64 msec, qint64 bytes) {
+  if (bytes <= 0) {
+    return;
+  }
+
+  m_totalBytes += bytes;
+
+  // Late bytes of a closed slice are counted in the first open one.
+  qsizetype index = qMax<qsizetype>(0, msec / m_sliceMsec - m_slices.count());
+  if (m_pendingBytes.count() <= index) {
+    m_pendingBytes.resize(index + 1);
+  }
+  m_pendingBytes[index] += bytes;
+}
+
+QList<quint64> ThroughputSampler::advance(qint64 msec) {
+  QList<quint64> closed;
+
+  while ((m_slices.count() + 1) * m_sliceMsec <= msec) {
+    qint64 bytes = m_pendingBytes.isEmpty() ? 0 : m_pendingBytes.takeFirst();
+    quint64 rate = bitsPerSec(bytes, m_sliceMsec);
+    m_slices.append(rate);
+    closed.append(rate);
+  }
+
+  m_endMsec = qMax(m_endMsec, msec);
+  return closed;
+}
+
+void ThroughputSampler::finish(qint64 msec) {
+  advance(msec);
+
+  // The last partial slice is too short to be meaningful, but its bytes are
+  // part of the total.
+  m_pendingBytes.clear();
+}
+
+quint64 ThroughputSampler::bitsPerSec(qint64 bytes, qint64 msec) const {
+  if (msec <= 0) {
+    return 0;
+  }
+
+  return static_cast<quint64>(static_cast<double>(bytes) * 8 * 1000 / msec);
+}
+
+QList<quint64> ThroughputSampler::steadySlices() const {
+  qsizetype warmupSlices = (m_warmupMsec + m_sliceMsec - 1) / m_sliceMsec;
+  if (warmupSlices >= m_slices.count()) {
+    return QList<quint64>();
+  }
+
+  return m_slices.mid(warmupSlices);
+}
+
+quint64 ThroughputSampler::throughput() const {
+  QList<quint64> slices = steadySlices();
+  if (slices.isEmpty()) {
+    return bitsPerSec(m_totalBytes, m_endMsec);
+  }
+
+  double sum = 0;
+  for (quint64 slice : slices) {
+    sum += slice;
+  }
+  return static_cast<quint64>(sum / slices.count());
+}
+
+quint64 ThroughputSampler::p90() const {
+  QList<quint64> slices = steadySlices();
+  if (slices.isEmpty()) {
+    return throughput();
+  }
+
+  // Nearest-rank percentile.
+  std::sort(slices.begin(), slices.end());
+  qsizetype rank = qCeil(slices.count() * 0.9);
+  return slices.at(qBound<qsizetype>(1, rank, slices.count()) - 1);
+}
+
+double ThroughputSampler::stability() const {
+  QList<quint64> slices = steadySlices();
+  if (slices.count() < 2) {
+    return 0;
+  }
+
+  double mean = 0;
+  for (quint64 slice : slices) {
+    mean += slice;
+  }
+  mean /= slices.count();
+  if (mean <= 0) {
+    return 0;
+  }
+
+  double variance = 0;
+  for (quint64 slice : slices) {
+    variance += (slice - mean) * (slice - mean);
+  }
+  variance /= slices.count();
+
+  return qBound(0.0, 1 - qSqrt(variance) / mean, 1.0);
+}
@@ -0,0 +1,59 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef THROUGHPUTSAMPLER_H
+#define THROUGHPUTSAMPLER_H
+
+#include <QList>
+
+// Aggregates the bytes transferred by parallel streams into fixed time
+// slices. The slices of the warm-up window (TCP slow-start, TLS handshakes)
+// are excluded from the steady-state statistics.
+class ThroughputSampler final {
+ public:
+  ThroughputSampler(qint64 sliceMsec, qint64 warmupMsec);
+
+  // Adds bytes transferred at `msec` since the beginning of the transfer.
+  void addBytes(qint64 msec, qint64 bytes);
+
+  // Closes the slices ended before `msec` and returns their throughput in
+  // bits per second.
+  QList<quint64> advance(qint64 msec);
+
+  // Closes all the slices, ending the transfer at `msec`.
+  void finish(qint64 msec);
+
+  // The throughput of each closed slice, warm-up included.
+  const QList<quint64>& slices() const { return m_slices; }
+
+  qint64 totalBytes() const { return m_totalBytes; }
+
+  // Average throughput after the warm-up. If the transfer is too short to
+  // have steady slices, this is the average of the whole transfer.
+  quint64 throughput() const;
+
+  // The 90th percentile of the steady slices.
+  quint64 p90() const;
+
+  // Between 0 (erratic) and 1 (constant): 1 minus the coefficient of
+  // variation of the steady slices. 0 if there are less than 2 of them.
+  double stability() const;
+
+ private:
+  QList<quint64> steadySlices() const;
+  quint64 bitsPerSec(qint64 bytes, qint64 msec) const;
+
+ private:
+  const qint64 m_sliceMsec;
+  const qint64 m_warmupMsec;
+
+  // Bytes of the slices not closed yet, starting from m_slices.count().
+  QList<qint64> m_pendingBytes;
+  QList<quint64> m_slices;
+
+  qint64 m_totalBytes = 0;
+  qint64 m_endMsec = 0;
+};
+
+#endif  // THROUGHPUTSAMPLER_H
@@ -28,11 +28,13 @@
 #include "rfc/rfc4291.h"
 #include "serveri18n.h"
 #include "serverlatency.h"
+#include "serverselection.h"
 #include "settingsholder.h"
 #include "tasks/controlleraction/taskcontrolleraction.h"
 #include "tasks/function/taskfunction.h"
 #include "tasks/heartbeat/taskheartbeat.h"
 #include "taskscheduler.h"
+#include "tracer.h"
 #include "tutorial/tutorial.h"
 
 #if defined(MZ_LINUX)
@@ -97,9 +99,11 @@ ConnectionManager::ConnectionManager() {
           &ConnectionManager::handshakeTimeout);
 
   LogHandler::instance()->registerLogSerializer(this);
+  LogHandler::instance()->registerLogSerializer(Tracer::instance());
 }
 
 ConnectionManager::~ConnectionManager() {
+  LogHandler::instance()->unregisterLogSerializer(Tracer::instance());
   LogHandler::instance()->unregisterLogSerializer(this);
   MZ_COUNT_DTOR(ConnectionManager);
 }
@@ -345,6 +349,10 @@ void ConnectionManager::activateInternal(
   logger.debug() << "Activation internal";
   Q_ASSERT(m_impl);
 
+  QString traceId = Tracer::instance()->startTrace();
+  m_activationStart = Tracer::now();
+  TraceSpan span("ConnectionManager::activateInternal");
+
   clearConnectedTime();
   m_handshakeTimer.stop();
   m_activationQueue.clear();
@@ -354,7 +362,8 @@ void ConnectionManager::activateInternal(
               !m_serverData.exitServerPublicKey().isEmpty()
           ? MozillaVPN::instance()->serverCountryModel()->server(
                 m_serverData.exitServerPublicKey())
-          : Server::weightChooser(m_serverData.exitServers());
+          : ServerSelection::choose(m_serverData.exitServers(),
+                                    MozillaVPN::instance()->serverLatency());
   if (!exitServer.initialized()) {
     logger.error() << "Empty exit server list in state" << m_state;
     serverUnavailable();
@@ -378,6 +387,7 @@ void ConnectionManager::activateInternal(
   exitConfig.m_serverPort = exitServer.choosePort();
   exitConfig.m_allowedIPAddressRanges = getAllowedIPAddressRanges(exitServer);
   exitConfig.m_dnsServer = DNSHelper::getDNS(exitServer.ipv4Gateway());
+  exitConfig.m_traceId = traceId;
 #if defined(MZ_ANDROID) || defined(MZ_IOS)
   exitConfig.m_installationId = settingsHolder->installationId();
 #endif
@@ -414,7 +424,8 @@ void ConnectionManager::activateInternal(
                 !m_serverData.entryServerPublicKey().isEmpty()
             ? MozillaVPN::instance()->serverCountryModel()->server(
                   m_serverData.entryServerPublicKey())
-            : Server::weightChooser(m_serverData.entryServers());
+            : ServerSelection::choose(m_serverData.entryServers(),
+                                      MozillaVPN::instance()->serverLatency());
 
     if (!entryServer.initialized()) {
       logger.error() << "Empty entry server list in state" << m_state;
@@ -431,6 +442,7 @@ void ConnectionManager::activateInternal(
     entryConfig.m_serverIpv6AddrIn = entryServer.ipv6AddrIn();
     entryConfig.m_serverPort = entryServer.choosePort();
     entryConfig.m_hopType = InterfaceConfig::MultiHopEntry;
+    entryConfig.m_traceId = traceId;
     entryConfig.m_allowedIPAddressRanges.append(
         IPAddress(exitServer.ipv4AddrIn()));
     entryConfig.m_allowedIPAddressRanges.append(
@@ -455,7 +467,8 @@ void ConnectionManager::activateInternal(
                 !m_serverData.entryServerPublicKey().isEmpty()
             ? MozillaVPN::instance()->serverCountryModel()->server(
                   m_serverData.entryServerPublicKey())
-            : Server::weightChooser(m_serverData.entryServers());
+            : ServerSelection::choose(m_serverData.entryServers(),
+                                      MozillaVPN::instance()->serverLatency());
 
     if (!entryServer.initialized()) {
       logger.error() << "Empty entry server list in state" << m_state;
@@ -492,6 +505,7 @@ void ConnectionManager::clearConnectedTime() {
 QList<IPAddress> ConnectionManager::getAllowedIPAddressRanges(
     const Server& exitServer) {
   logger.debug() << "Computing the allowed IP addresses";
+  TraceSpan span("ConnectionManager::getAllowedIPAddressRanges");
 
   QList<IPAddress> list;
 
@@ -566,6 +580,7 @@ void ConnectionManager::activateNext() {
 
   logger.debug() << "Activating peer" << logger.keys(config.m_serverPublicKey);
   m_handshakeTimer.start(HANDSHAKE_TIMEOUT_SEC * 1000);
+  m_handshakeStart = Tracer::now();
   m_impl->activate(config, stateToReason(m_state));
 
   // Move to the confirming state if we are awaiting any connection handshakes.
@@ -643,6 +658,9 @@ void ConnectionManager::connected(const QString& pubkey,
     logger.warning() << "Unexpected handshake: public key mismatch.";
     return;
   } else {
+    Tracer::instance()->addSpan("ConnectionManager::handshake",
+                                m_handshakeStart, Tracer::now());
+
     // Start the next connection if there is more work to do.
     m_activationQueue.removeFirst();
     if (!m_activationQueue.isEmpty()) {
@@ -657,6 +675,12 @@ void ConnectionManager::connected(const QString& pubkey,
   m_connectionRetry = 0;
   emit connectionRetryChanged();
 
+  if (m_activationStart) {
+    Tracer::instance()->addSpan("ConnectionManager::activation",
+                                m_activationStart, Tracer::now());
+    m_activationStart = 0;
+  }
+
   // We have succesfully completed all pending connections.
   logger.debug() << "Connected from state:" << m_state;
   setState(StateOn);
@@ -221,6 +221,11 @@ class ConnectionManager : public QObject, public LogSerializer {
   QList<InterfaceConfig> m_activationQueue;
   int m_connectionRetry = 0;
 
+  // Monotonic timestamps of the current activation, in microseconds. See
+  // Tracer.
+  qint64 m_activationStart = 0;
+  qint64 m_handshakeStart = 0;
+
   QScopedPointer<ControllerImpl> m_impl;
   bool m_portalDetected = false;
 
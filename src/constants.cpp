@@ -9,6 +9,7 @@
 #include <QString>
 #include <QtGlobal>
 
+#include "feature.h"
 #include "settingsholder.h"
 #include "version.h"
 
@@ -36,6 +37,9 @@ void Constants::setStaging() {
     s_stagingServerAddress = SettingsHolder::instance()->stagingServerAddress();
   }
   Q_ASSERT(!s_stagingServerAddress.isEmpty());
+
+  // Some features are only supported, or only flippable, in staging.
+  Feature::supportInputsChanged();
 }
 
 void Constants::setVersionOverride(const QString& versionOverride) {
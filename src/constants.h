@@ -152,6 +152,13 @@ PRODBETAEXPR(QString, fxaApiBaseUrl, "https://api.accounts.firefox.com",
 constexpr uint32_t BENCHMARK_MAX_BYTES_UPLOAD = 10485760;  // 10 Megabyte
 constexpr uint32_t BENCHMARK_MAX_DURATION_PING = 3000;
 constexpr uint32_t BENCHMARK_MAX_DURATION_TRANSFER = 15000;
+// Parallel streams of the transfer benchmarks, and how their throughput is
+// sampled: per slice, ignoring the first msecs (TCP slow-start).
+constexpr uint32_t BENCHMARK_TRANSFER_STREAMS = 4;
+constexpr uint32_t BENCHMARK_SLICE_MSEC = 100;
+constexpr uint32_t BENCHMARK_WARMUP_MSEC = 2000;
+// Bytes of each download buffered by Qt before the socket is drained.
+constexpr uint32_t BENCHMARK_READ_BUFFER_SIZE = 262144;  // 256 Kilobyte
 constexpr uint32_t BENCHMARK_THRESHOLD_SPEED_FAST = 25000000;    // 25 Megabit
 constexpr uint32_t BENCHMARK_THRESHOLD_SPEED_MEDIUM = 10000000;  // 10 Megabit
 
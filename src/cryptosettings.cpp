@@ -4,6 +4,9 @@
 
 #include "cryptosettings.h"
 
+#include <QCborStreamReader>
+#include <QCborStreamWriter>
+#include <QCborValue>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonValue>
@@ -14,6 +17,7 @@
 
 constexpr int NONCE_SIZE = 12;
 constexpr int MAC_SIZE = 16;
+constexpr int HEADER_SIZE = NONCE_SIZE + MAC_SIZE;
 
 namespace {
 
@@ -21,6 +25,10 @@ Logger logger("CryptoSettings");
 
 uint64_t lastNonce = 0;
 
+// Size of the last file read or written. The settings rarely change much
+// between two writes: the next buffer is allocated with this size.
+qsizetype lastFileSize = 0;
+
 }  // namespace
 
 // static
@@ -31,15 +39,29 @@ bool CryptoSettings::readFile(QIODevice& device, QSettings::SettingsMap& map) {
     return false;
   }
 
-  switch ((CryptoSettings::Version)version.at(0)) {
+  CryptoSettings::Version fileVersion =
+      (CryptoSettings::Version)version.at(0);
+  switch (fileVersion) {
     case NoEncryption:
       return readJsonFile(device, map);
     case EncryptionChachaPolyV1:
-      return readEncryptedChachaPolyV1File(device, map);
+    case EncryptionChachaPolyV2:
+      break;
     default:
       logger.error() << "Unsupported version";
       return false;
   }
+
+  uint8_t key[CRYPTO_SETTINGS_KEY_SIZE];
+  if (!getKey(key)) {
+    logger.error() << "Something went wrong reading the key";
+    return false;
+  }
+
+  if (fileVersion == EncryptionChachaPolyV1) {
+    return readEncryptedChachaPolyV1File(device, map, key);
+  }
+  return readEncryptedChachaPolyV2File(device, map, key);
 }
 
 // static
@@ -64,57 +86,93 @@ bool CryptoSettings::readJsonFile(QIODevice& device,
 
 // static
 bool CryptoSettings::readEncryptedChachaPolyV1File(
-    QIODevice& device, QSettings::SettingsMap& map) {
-  QByteArray nonce = device.read(NONCE_SIZE);
-  if (nonce.length() != NONCE_SIZE) {
-    logger.error() << "Failed to read the nonce";
+    QIODevice& device, QSettings::SettingsMap& map,
+    const uint8_t key[CRYPTO_SETTINGS_KEY_SIZE]) {
+  QByteArray data = device.readAll();
+  if (!decryptInPlace(EncryptionChachaPolyV1, data, key)) {
     return false;
   }
 
-  QByteArray mac = device.read(MAC_SIZE);
-  if (mac.length() != MAC_SIZE) {
-    logger.error() << "Failed to read the MAC";
+  QJsonDocument json = QJsonDocument::fromJson(QByteArray::fromRawData(
+      data.constData() + HEADER_SIZE, data.length() - HEADER_SIZE));
+  if (!json.isObject()) {
+    logger.error() << "Invalid content read from the JSON file";
     return false;
   }
 
-  QByteArray ciphertext = device.readAll();
-  if (ciphertext.length() == 0) {
-    logger.error() << "Failed to read the ciphertext";
+  QJsonObject obj = json.object();
+  for (QJsonObject::const_iterator i = obj.constBegin(); i != obj.constEnd();
+       ++i) {
+    map.insert(i.key(), i.value().toVariant());
+  }
+
+  return true;
+}
+
+// static
+bool CryptoSettings::readEncryptedChachaPolyV2File(
+    QIODevice& device, QSettings::SettingsMap& map,
+    const uint8_t key[CRYPTO_SETTINGS_KEY_SIZE]) {
+  QByteArray data = device.readAll();
+  if (!decryptInPlace(EncryptionChachaPolyV2, data, key)) {
     return false;
   }
 
-  uint8_t key[CRYPTO_SETTINGS_KEY_SIZE];
-  if (!getKey(key)) {
-    logger.error() << "Something went wrong reading the key";
+  QCborStreamReader reader(data.constData() + HEADER_SIZE,
+                           data.length() - HEADER_SIZE);
+  if (!reader.isMap() || !reader.enterContainer()) {
+    logger.error() << "Invalid content read from the CBOR file";
     return false;
   }
 
-  QByteArray version(1, EncryptionChachaPolyV1);
-  QByteArray content(ciphertext.length(), 0x00);
-  uint32_t result = Hacl_Chacha20Poly1305_32_aead_decrypt(
-      key, (uint8_t*)nonce.data(), static_cast<uint32_t>(version.length()),
-      (uint8_t*)version.data(), static_cast<uint32_t>(ciphertext.length()),
-      (uint8_t*)content.data(), (uint8_t*)ciphertext.data(),
-      (uint8_t*)mac.data());
-  if (result != 0) {
+  while (reader.lastError() == QCborError::NoError && reader.hasNext()) {
+    QCborValue key = QCborValue::fromCbor(reader);
+    if (!key.isString()) {
+      logger.error() << "Invalid key read from the CBOR file";
+      return false;
+    }
+
+    QCborValue value = QCborValue::fromCbor(reader);
+    map.insert(key.toString(), value.toVariant());
+  }
+
+  if (reader.lastError() != QCborError::NoError || !reader.leaveContainer()) {
+    logger.error() << "Invalid content read from the CBOR file:"
+                   << reader.lastError().toString();
     return false;
   }
 
-  QJsonDocument json = QJsonDocument::fromJson(content);
-  if (!json.isObject()) {
-    logger.error() << "Invalid content read from the JSON file";
+  return true;
+}
+
+// static
+bool CryptoSettings::decryptInPlace(
+    Version version, QByteArray& data,
+    const uint8_t key[CRYPTO_SETTINGS_KEY_SIZE]) {
+  if (data.length() <= HEADER_SIZE) {
+    logger.error() << "Failed to read the ciphertext";
     return false;
   }
 
-  QJsonObject obj = json.object();
-  for (QJsonObject::const_iterator i = obj.constBegin(); i != obj.constEnd();
-       ++i) {
-    map.insert(i.key(), i.value().toVariant());
+  uint8_t* nonce = reinterpret_cast<uint8_t*>(data.data());
+  uint8_t* mac = nonce + NONCE_SIZE;
+  uint8_t* payload = mac + MAC_SIZE;
+  uint8_t aad = version;
+
+  // The MAC is checked before the decryption: the ciphertext can be
+  // replaced by the plaintext.
+  uint32_t result = Hacl_Chacha20Poly1305_32_aead_decrypt(
+      const_cast<uint8_t*>(key), nonce, sizeof(aad), &aad,
+      static_cast<uint32_t>(data.length() - HEADER_SIZE), payload, payload,
+      mac);
+  if (result != 0) {
+    return false;
   }
 
   Q_ASSERT(NONCE_SIZE > sizeof(lastNonce));
-  memcpy(&lastNonce, nonce.data(), sizeof(lastNonce));
+  memcpy(&lastNonce, nonce, sizeof(lastNonce));
 
+  lastFileSize = data.length();
   return true;
 }
 
@@ -132,8 +190,22 @@ bool CryptoSettings::writeFile(QIODevice& device,
   switch (version) {
     case NoEncryption:
       return writeJsonFile(device, map);
-    case EncryptionChachaPolyV1:
-      return writeEncryptedChachaPolyV1File(device, map);
+    case EncryptionChachaPolyV2: {
+      logger.debug() << "Incrementing nonce:" << lastNonce;
+      if (++lastNonce == UINT64_MAX) {
+        logger.debug() << "Reset the nonce and the key.";
+        resetKey();
+        lastNonce = 0;
+      }
+
+      uint8_t key[CRYPTO_SETTINGS_KEY_SIZE];
+      if (!getKey(key)) {
+        logger.debug() << "Invalid key";
+        return false;
+      }
+
+      return writeEncryptedChachaPolyV2File(device, map, key);
+    }
     default:
       logger.error() << "Unsupported version.";
       return false;
@@ -171,61 +243,55 @@ bool CryptoSettings::writeJsonFile(QIODevice& device,
 }
 
 // static
-bool CryptoSettings::writeEncryptedChachaPolyV1File(
-    QIODevice& device, const QSettings::SettingsMap& map) {
+bool CryptoSettings::writeEncryptedChachaPolyV2File(
+    QIODevice& device, const QSettings::SettingsMap& map,
+    const uint8_t key[CRYPTO_SETTINGS_KEY_SIZE]) {
   logger.debug() << "Write encrypted file";
 
-  QJsonObject obj;
-  for (QSettings::SettingsMap::ConstIterator i = map.begin(); i != map.end();
-       ++i) {
-    obj.insert(i.key(), QJsonValue::fromVariant(i.value()));
-  }
-
-  QJsonDocument json;
-  json.setObject(obj);
-  QByteArray content = json.toJson(QJsonDocument::Compact);
-
-  logger.debug() << "Incrementing nonce:" << lastNonce;
-  if (++lastNonce == UINT64_MAX) {
-    logger.debug() << "Reset the nonce and the key.";
-    resetKey();
-    lastNonce = 0;
+  // The header is filled by the encryption. The settings are encoded after
+  // it, in the same buffer.
+  QByteArray data(HEADER_SIZE, 0x00);
+  data.reserve(qMax(lastFileSize, static_cast<qsizetype>(HEADER_SIZE)));
+
+  {
+    QCborStreamWriter writer(&data);
+    writer.startMap(map.count());
+    for (QSettings::SettingsMap::ConstIterator i = map.begin();
+         i != map.end(); ++i) {
+      writer.append(i.key());
+      QCborValue::fromVariant(i.value()).toCbor(writer);
+    }
+    writer.endMap();
   }
 
-  Q_ASSERT(NONCE_SIZE > sizeof(lastNonce));
-  QByteArray nonce(NONCE_SIZE, 0x00);
-  memcpy(nonce.data(), &lastNonce, sizeof(lastNonce));
+  encryptInPlace(EncryptionChachaPolyV2, data, key);
 
-  uint8_t key[CRYPTO_SETTINGS_KEY_SIZE];
-  if (!getKey(key)) {
-    logger.debug() << "Invalid key";
+  if (device.write(data) != data.length()) {
+    logger.error() << "Failed to write the content";
     return false;
   }
 
-  QByteArray version(1, EncryptionChachaPolyV1);
-  QByteArray ciphertext(content.length(), 0x00);
-  QByteArray mac(MAC_SIZE, 0x00);
-
-  Hacl_Chacha20Poly1305_32_aead_encrypt(
-      key, (uint8_t*)nonce.data(), static_cast<uint32_t>(version.length()),
-      (uint8_t*)version.data(), static_cast<uint32_t>(content.length()),
-      (uint8_t*)content.data(), (uint8_t*)ciphertext.data(),
-      (uint8_t*)mac.data());
+  lastFileSize = data.length();
+  return true;
+}
 
-  if (device.write(nonce) != nonce.length()) {
-    logger.error() << "Failed to write the nonce";
-    return false;
-  }
+// static
+void CryptoSettings::encryptInPlace(
+    Version version, QByteArray& data,
+    const uint8_t key[CRYPTO_SETTINGS_KEY_SIZE]) {
+  Q_ASSERT(data.length() >= HEADER_SIZE);
 
-  if (device.write(mac) != mac.length()) {
-    logger.error() << "Failed to write the MAC";
-    return false;
-  }
+  uint8_t* nonce = reinterpret_cast<uint8_t*>(data.data());
+  uint8_t* mac = nonce + NONCE_SIZE;
+  uint8_t* payload = mac + MAC_SIZE;
+  uint8_t aad = version;
 
-  if (device.write(ciphertext) != ciphertext.length()) {
-    logger.error() << "Failed to write the cipher";
-    return false;
-  }
+  Q_ASSERT(NONCE_SIZE > sizeof(lastNonce));
+  memset(nonce, 0, NONCE_SIZE);
+  memcpy(nonce, &lastNonce, sizeof(lastNonce));
 
-  return true;
+  Hacl_Chacha20Poly1305_32_aead_encrypt(
+      const_cast<uint8_t*>(key), nonce, sizeof(aad), &aad,
+      static_cast<uint32_t>(data.length() - HEADER_SIZE), payload, payload,
+      mac);
 }
@@ -14,6 +14,8 @@ class CryptoSettings final {
   enum Version {
     NoEncryption,
     EncryptionChachaPolyV1,
+    // As V1, but the settings are encoded in CBOR instead of JSON.
+    EncryptionChachaPolyV2,
   };
 
   static bool readFile(QIODevice& device, QSettings::SettingsMap& map);
@@ -26,14 +28,33 @@ class CryptoSettings final {
   static Version getSupportedVersion();
   static bool writeVersion(QIODevice& device, Version version);
 
+  // The encrypted formats do not depend on the key provider: the key is
+  // retrieved by readFile() and writeFile().
   static bool readJsonFile(QIODevice& device, QSettings::SettingsMap& map);
-  static bool readEncryptedChachaPolyV1File(QIODevice& device,
-                                            QSettings::SettingsMap& map);
+  static bool readEncryptedChachaPolyV1File(
+      QIODevice& device, QSettings::SettingsMap& map,
+      const uint8_t key[CRYPTO_SETTINGS_KEY_SIZE]);
+  static bool readEncryptedChachaPolyV2File(
+      QIODevice& device, QSettings::SettingsMap& map,
+      const uint8_t key[CRYPTO_SETTINGS_KEY_SIZE]);
 
   static bool writeJsonFile(QIODevice& device,
                             const QSettings::SettingsMap& map);
-  static bool writeEncryptedChachaPolyV1File(QIODevice& device,
-                                             const QSettings::SettingsMap& map);
+  static bool writeEncryptedChachaPolyV2File(
+      QIODevice& device, const QSettings::SettingsMap& map,
+      const uint8_t key[CRYPTO_SETTINGS_KEY_SIZE]);
+
+  // The encrypted files start with the nonce and the MAC, followed by the
+  // ciphertext. These operate on the whole file, without the version, and
+  // replace the payload in place.
+  static bool decryptInPlace(Version version, QByteArray& data,
+                             const uint8_t key[CRYPTO_SETTINGS_KEY_SIZE]);
+  static void encryptInPlace(Version version, QByteArray& data,
+                             const uint8_t key[CRYPTO_SETTINGS_KEY_SIZE]);
+
+#ifdef UNIT_TEST
+  friend class TestCryptoSettings;
+#endif
 };
 
 #endif  // CRYPTOSETTINGS_H
@@ -15,6 +15,7 @@
 #include "leakdetector.h"
 #include "logger.h"
 #include "loghandler.h"
+#include "tracer.h"
 
 constexpr const char* JSON_ALLOWEDIPADDRESSRANGES = "allowedIPAddressRanges";
 constexpr int HANDSHAKE_POLL_MSEC = 250;
@@ -69,6 +70,11 @@ bool Daemon::activate(const InterfaceConfig& config) {
   // If the activation abort's for any reason `the `activationFailure` signal is
   // emitted.
   logger.debug() << "Activating interface";
+  if (!config.m_traceId.isEmpty()) {
+    Tracer::instance()->setTraceId(config.m_traceId);
+  }
+  TraceSpan span("Daemon::activate");
+
   auto emit_failure_guard = qScopeGuard([this] { emit activationFailure(); });
 
   if (m_connections.contains(config.m_hopType)) {
@@ -141,14 +147,18 @@ bool Daemon::activate(const InterfaceConfig& config) {
   }
 
   // set routing
-  for (const IPAddress& ip : config.m_allowedIPAddressRanges) {
-    if (!wgutils()->updateRoutePrefix(ip)) {
-      logger.debug() << "Routing configuration failed for"
-                     << logger.sensitive(ip.toString());
-      return false;
+  {
+    TraceSpan routingSpan("Daemon::routing");
+    for (const IPAddress& ip : config.m_allowedIPAddressRanges) {
+      if (!wgutils()->updateRoutePrefix(ip)) {
+        logger.debug() << "Routing configuration failed for"
+                       << logger.sensitive(ip.toString());
+        return false;
+      }
     }
   }
 
+  TraceSpan runSpan("Daemon::run");
   bool status = run(Up, config);
   logger.debug() << "Connection status:" << status;
   if (status) {
@@ -329,6 +339,8 @@ bool Daemon::parseConfig(const QJsonObject& obj, InterfaceConfig& config) {
   if (!parseStringList(obj, "vpnDisabledApps", config.m_vpnDisabledApps)) {
     return false;
   }
+
+  config.m_traceId = obj.value("traceId").toString();
   return true;
 }
 
@@ -447,6 +459,12 @@ QJsonObject Daemon::getStatus() {
   QJsonObject json;
   logger.debug() << "Status request";
 
+  // The spans recorded since the previous request are sent to the client.
+  QJsonArray trace = Tracer::instance()->takeEvents();
+  if (!trace.isEmpty()) {
+    json.insert("trace", trace);
+  }
+
   if (!wgutils()->interfaceExists() || m_connections.isEmpty()) {
     json.insert("connected", QJsonValue(false));
     return json;
@@ -493,6 +511,9 @@ void Daemon::checkHandshake() {
         continue;
       }
       if (status.m_handshake != 0) {
+        Tracer::instance()->addSpan("Daemon::handshake",
+                                    connection.m_activationTime,
+                                    Tracer::now());
         connection.m_date.setMSecsSinceEpoch(status.m_handshake);
         emit connected(status.m_pubkey);
       }
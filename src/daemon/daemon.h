@@ -11,6 +11,7 @@
 #include "dnsutils.h"
 #include "interfaceconfig.h"
 #include "iputils.h"
+#include "tracer.h"
 #include "wireguardutils.h"
 
 class Daemon : public QObject {
@@ -76,9 +77,14 @@ class Daemon : public QObject {
   class ConnectionState {
    public:
     ConnectionState(){};
-    ConnectionState(const InterfaceConfig& config) { m_config = config; }
+    ConnectionState(const InterfaceConfig& config)
+        : m_activationTime(Tracer::now()) {
+      m_config = config;
+    }
     QDateTime m_date;
     InterfaceConfig m_config;
+    // Monotonic timestamp, in microseconds. See Tracer.
+    qint64 m_activationTime = 0;
   };
   QMap<InterfaceConfig::HopType, ConnectionState> m_connections;
   QTimer m_handshakeTimer;
@@ -17,6 +17,16 @@ namespace {
 Logger logger("Feature");
 QMap<QString, Feature*>* s_featuresHashtable = nullptr;
 QList<Feature*>* s_featuresList = nullptr;
+
+// The features of featurelist.h, by index, and their cached support.
+Feature* s_features[Feature::FeatureCount] = {};
+std::bitset<Feature::FeatureCount> s_supported;
+// The features whose support is computed on every call.
+std::bitset<Feature::FeatureCount> s_uncached;
+// False when a feature has been flipped since the support was resolved.
+bool s_supportResolved = false;
+// False until the support is resolved for the first time.
+bool s_supportComputed = false;
 }  // namespace
 
 // static
@@ -29,10 +39,40 @@ void Feature::maybeInitialize() {
 
 #define FEATURE(id, name, flippableOn, flippableOff, otherFeatureDependencies, \
                 callback)                                                      \
-  new Feature(#id, name, flippableOn, flippableOff, otherFeatureDependencies,  \
-              callback);
+  s_features[Feature_##id] =                                                   \
+      new Feature(#id, name, flippableOn, flippableOff,                        \
+                  otherFeatureDependencies, callback);                         \
+  s_features[Feature_##id]->m_index = Feature_##id;                            \
+  s_uncached.set(Feature_##id, FeatureCallback_isVolatile(callback));
 #include "featurelist.h"
 #undef FEATURE
+
+    resolveVolatility();
+  }
+}
+
+// static
+void Feature::resolveVolatility() {
+  // A feature depending on an uncached feature cannot be cached either.
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (const Feature* feature : s_features) {
+      if (!feature || s_uncached.test(feature->m_index)) {
+        continue;
+      }
+
+      for (const QString& featureID : feature->m_featureDependencies) {
+        const Feature* dependency =
+            s_featuresHashtable->value(featureID, nullptr);
+        if (dependency && dependency->m_index != FeatureCount &&
+            s_uncached.test(dependency->m_index)) {
+          s_uncached.set(feature->m_index);
+          changed = true;
+          break;
+        }
+      }
+    }
   }
 }
 
@@ -81,6 +121,11 @@ Feature::Feature(const QString& id, const QString& name,
 Feature::~Feature() {
   s_featuresHashtable->remove(m_id);
   s_featuresList->removeAll(this);
+
+  if (m_index != FeatureCount) {
+    s_features[m_index] = nullptr;
+    s_supportResolved = false;
+  }
 }
 
 // static
@@ -96,6 +141,16 @@ const Feature* Feature::getOrNull(const QString& featureID) {
   return s_featuresHashtable->value(featureID, nullptr);
 }
 
+// static
+const Feature* Feature::get(Id featureID) {
+  Q_ASSERT(featureID >= 0 && featureID < FeatureCount);
+  maybeInitialize();
+
+  const Feature* feature = s_features[featureID];
+  Q_ASSERT(feature);
+  return feature;
+}
+
 // static
 const Feature* Feature::get(const QString& featureID) {
   maybeInitialize();
@@ -135,13 +190,18 @@ bool Feature::isFlippedOff(bool ignoreCache) const {
 }
 
 bool Feature::isSupported(bool ignoreCache) const {
+  if (!ignoreCache && m_index != FeatureCount && !s_uncached.test(m_index)) {
+    if (!s_supportResolved) {
+      resolveSupport();
+    }
+    return s_supported.test(m_index);
+  }
+
   if (isFlippedOn(ignoreCache)) {
-    logger.debug() << "Flipped On" << m_id;
     return true;
   }
 
   if (isFlippedOff(ignoreCache)) {
-    logger.debug() << "Flipped Off" << m_id;
     return false;
   }
 
@@ -163,6 +223,103 @@ bool Feature::isSupportedIgnoringFlip() const {
   return true;
 }
 
+// static
+void Feature::resolveSupport() {
+  maybeInitialize();
+
+  SupportBits supported;
+  SupportBits resolved;
+  for (const Feature* feature : s_features) {
+    if (feature) {
+      feature->resolveSupport(supported, resolved);
+    }
+  }
+
+  s_supported = supported;
+  s_supportResolved = true;
+  s_supportComputed = true;
+}
+
+bool Feature::resolveSupport(SupportBits& supported,
+                             SupportBits& resolved) const {
+  if (m_index != FeatureCount && resolved.test(m_index)) {
+    return supported.test(m_index);
+  }
+
+  bool value;
+  if (isFlippedOn()) {
+    value = true;
+  } else if (isFlippedOff()) {
+    value = false;
+  } else {
+    value = m_callback();
+    for (const QString& featureID : m_featureDependencies) {
+      if (!value) {
+        break;
+      }
+
+      const Feature* feature = s_featuresHashtable->value(featureID, nullptr);
+      Q_ASSERT(feature);
+      value = feature && feature->resolveSupport(supported, resolved);
+    }
+  }
+
+  if (m_index != FeatureCount) {
+    supported.set(m_index, value);
+    resolved.set(m_index);
+  }
+  return value;
+}
+
+// static
+void Feature::updateSupport(const Feature* skip) {
+  SupportBits previous = s_supported;
+  bool wasComputed = s_supportComputed;
+  resolveSupport();
+
+  if (!wasComputed) {
+    // Nobody has seen the previous values.
+    return;
+  }
+
+  SupportBits changed = previous ^ s_supported;
+  for (int i = 0; changed.any() && i < FeatureCount; ++i) {
+    if (!changed.test(i)) {
+      continue;
+    }
+
+    changed.reset(i);
+    if (s_features[i] && s_features[i] != skip) {
+      emit s_features[i]->supportedChanged();
+    }
+  }
+}
+
+// static
+void Feature::supportInputsChanged() {
+  if (!s_featuresHashtable) {
+    // Nothing has been resolved yet.
+    return;
+  }
+
+  updateSupport(nullptr);
+}
+
+void Feature::setState(State state) {
+  if (m_state == state) {
+    return;
+  }
+
+  m_state = state;
+  s_supportResolved = false;
+
+  if (state == FlippedOn) {
+    logger.debug() << "Flipped On" << m_id;
+  } else if (state == FlippedOff) {
+    logger.debug() << "Flipped Off" << m_id;
+  }
+}
+
 void Feature::maybeFlipOnOrOff() {
   SettingsHolder* settingsHolder = SettingsHolder::instance();
   Q_ASSERT(settingsHolder);
@@ -198,13 +355,14 @@ void Feature::maybeFlipOnOrOff() {
   }
 
   if (newState != FlippedOn) {
-    m_state = newState;
+    setState(newState);
+    updateSupport(this);
     emit supportedChanged();
     return;
   }
 
   // Let's set it before checking other features to break cycles.
-  m_state = newState;
+  setState(newState);
 
   QList<Feature*> featuresToFlipOnAndCheck;
   for (const QString& featureID : m_featureDependencies) {
@@ -217,7 +375,7 @@ void Feature::maybeFlipOnOrOff() {
       logger.debug() << "Unable to activate feature" << id()
                      << "because feature" << feature->id()
                      << "cannot be enabled in dev mode";
-      m_state = DefaultValue;
+      setState(DefaultValue);
       return;
     }
 
@@ -241,12 +399,13 @@ void Feature::maybeFlipOnOrOff() {
         logger.debug() << "Unable to activate feature" << id()
                        << "because feature" << feature->id()
                        << "cannot be enabled";
-        m_state = DefaultValue;
+        setState(DefaultValue);
         return;
       }
     }
   }
 
+  updateSupport(this);
   emit supportedChanged();
 }
 
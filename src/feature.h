@@ -7,16 +7,21 @@
 
 #include <QApplication>
 #include <QObject>
+#include <bitset>
 
 class Feature : public QObject {
   Q_OBJECT
 
  public:
+  // Compile-time index of the features listed in featurelist.h.
+  enum Id : int {
 #define FEATURE(id, name, flippableOn, flippableOff, otherFeatureDependencies, \
                 callback)                                                      \
-  static constexpr const char* Feature_##id = #id;
+  Feature_##id,
 #include "featurelist.h"
 #undef FEATURE
+    FeatureCount,
+  };
 
   Q_PROPERTY(QString id MEMBER m_id CONSTANT)
   Q_PROPERTY(QString name MEMBER m_name CONSTANT)
@@ -38,6 +43,9 @@ class Feature : public QObject {
  public:
   static const QList<Feature*>& getAll();
 
+  // Returns the feature from featurelist.h with this index.
+  static const Feature* get(Id featureID);
+
   // Returns a Pointer to the Feature with id, crashes client if
   // feature does not exist :)
   static const Feature* get(const QString& featureID);
@@ -61,6 +69,10 @@ class Feature : public QObject {
 
   QString id() const { return m_id; }
 
+  // The support callbacks read state from outside of the features, like the
+  // staging mode. Resolves the cached support again when it changes.
+  static void supportInputsChanged();
+
  signals:
   // This signal is emitted if the underlying factors for support changed e.g
   // Controller support level for features depending on this or if the feature
@@ -71,6 +83,20 @@ class Feature : public QObject {
   static void maybeInitialize();
   void maybeFlipOnOrOff();
 
+  using SupportBits = std::bitset<FeatureCount>;
+
+  // The support of the features of featurelist.h is resolved once, for all of
+  // them, and cached until a feature is flipped on or off. The features with
+  // a volatile callback, and the ones depending on them, are not cached. See
+  // FeatureCallback_isVolatile().
+  static void resolveSupport();
+  static void resolveVolatility();
+  bool resolveSupport(SupportBits& supported, SupportBits& resolved) const;
+
+  // Resolves the support again, and notifies the features whose support has
+  // changed, except `skip` which takes care of its own notification.
+  static void updateSupport(const Feature* skip);
+
   // Returns true if this feature is flipped on via settings
   bool isFlippedOn(bool ignoreCache = false) const;
 
@@ -107,6 +133,11 @@ class Feature : public QObject {
     FlippedOff,
   };
   State m_state = DefaultValue;
+  void setState(State state);
+
+  // Index in featurelist.h, or FeatureCount for features created at runtime
+  // (tests only), whose support is not cached.
+  Id m_index = FeatureCount;
 
 #ifdef UNIT_TEST
   friend class TestAddonIndex;
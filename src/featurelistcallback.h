@@ -175,6 +175,18 @@ bool FeatureCallback_shareLogs() {
 #endif
 }
 
+// Returns true if the callback can return a different value at runtime,
+// without any notification. The support of these features is not cached.
+bool FeatureCallback_isVolatile(bool (*callback)()) {
+#if defined(MZ_WINDOWS)
+  // A conflicting split-tunnel driver can be installed at any time.
+  return callback == FeatureCallback_splitTunnel;
+#else
+  Q_UNUSED(callback);
+  return false;
+#endif
+}
+
 bool FeatureCallback_webPurchase() {
 #if defined(MZ_IOS) || defined(MZ_ANDROID) || defined(MZ_WASM)
   return false;
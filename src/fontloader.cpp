@@ -5,23 +5,67 @@
 #include "fontloader.h"
 
 #include <QDir>
+#include <QElapsedTimer>
+#include <QFileInfo>
 #include <QFontDatabase>
+#include <QHash>
 
 #include "logger.h"
 #include "resourceloader.h"
 
 namespace {
 Logger logger("FontLoader");
+
+// The registered fonts, by file name. The bundled fonts and the ones fetched
+// at runtime share it, so that a font is never added twice.
+QHash<QString, int> s_fontIds;
+
+QStringList bundledFontFiles() {
+  QDir dir(ResourceLoader::instance()->loadDir(":/nebula/resources/fonts"));
+
+  QStringList files;
+  for (const QString& file : dir.entryList(QDir::Files)) {
+    files.append(dir.filePath(file));
+  }
+  return files;
 }
 
+}  // namespace
+
 // static
 void FontLoader::loadFonts() {
-  QDir dir(ResourceLoader::instance()->loadDir(":/nebula/resources/fonts"));
-  QStringList files = dir.entryList();
-  for (const QString& file : files) {
-    logger.debug() << "Loading font:" << file;
-    int id =
-        QFontDatabase::addApplicationFont(":/nebula/resources/fonts/" + file);
+  QElapsedTimer timer;
+  timer.start();
+
+  for (const QString& file : bundledFontFiles()) {
+    QString name = QFileInfo(file).fileName();
+    if (s_fontIds.contains(name)) {
+      continue;
+    }
+
+    logger.debug() << "Loading font:" << name;
+    int id = QFontDatabase::addApplicationFont(file);
     logger.debug() << "Result:" << id;
+
+    s_fontIds.insert(name, id);
   }
+
+  logger.debug() << "Fonts loaded in" << timer.elapsed() << "msec";
+}
+
+#ifdef UNIT_TEST
+// static
+QStringList FontLoader::fontFiles() { return bundledFontFiles(); }
+#endif
+
+// static
+void FontLoader::loadFontFromData(const QString& name, const QByteArray& data) {
+  if (s_fontIds.contains(name)) {
+    return;
+  }
+
+  int id = QFontDatabase::addApplicationFontFromData(data);
+  logger.debug() << "Loading font:" << name << id;
+
+  s_fontIds.insert(name, id);
 }
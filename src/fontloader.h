@@ -5,9 +5,23 @@
 #ifndef FONTLOADER_H
 #define FONTLOADER_H
 
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+
 class FontLoader final {
  public:
+  // Registers every bundled font. The main theme uses all of them for the
+  // whole UI, whatever the language.
   static void loadFonts();
+
+  // For the fonts that are fetched at runtime, as on WASM.
+  static void loadFontFromData(const QString& name, const QByteArray& data);
+
+#ifdef UNIT_TEST
+  // The bundled font files registered by loadFonts().
+  static QStringList fontFiles();
+#endif
 };
 
 #endif  // FONTLOADER_H
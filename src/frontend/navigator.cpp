@@ -6,6 +6,7 @@
 
 #include <QCoreApplication>
 #include <QQuickItem>
+#include <algorithm>
 
 #include "app.h"
 #include "errorhandler.h"
@@ -22,6 +23,14 @@ namespace {
 Navigator* s_instance = nullptr;
 Logger logger("Navigator");
 
+// The next screens are compiled when no navigation happened for this long.
+constexpr int PRECOMPILE_IDLE_MSEC = 500;
+
+// The budget of cached components of the temporary screens. The least
+// recently used ones are released first. The persistent screens keep their
+// item alive, so their components are not counted.
+constexpr int MAX_CACHED_COMPONENTS = 8;
+
 struct Layer {
   enum Type {
     eStackView,
@@ -62,6 +71,12 @@ struct ScreenData {
   // The cache of the QML component.
   QQmlComponent* m_qmlComponent = nullptr;
 
+  // When the component was last used, for the eviction of the cache.
+  quint64 m_lastUsed = 0;
+
+  // The screens that are likely reached from this one.
+  QVector<int> m_nextScreens;
+
   // List of stack views, or views registered by this screen.
   QList<Layer> m_layers;
 
@@ -80,6 +95,19 @@ struct ScreenData {
 // The list of screens.
 QList<ScreenData> s_screens;
 
+// Incremented each time a component is used.
+quint64 s_componentUses = 0;
+
+ScreenData* findScreen(int screenId) {
+  for (ScreenData& screen : s_screens) {
+    if (screen.m_screen == screenId) {
+      return &screen;
+    }
+  }
+
+  return nullptr;
+}
+
 bool computeScreen(const ScreenData& screen, int* requestedScreen) {
   if (screen.m_priorityGetter(requestedScreen) < 0) {
     return false;
@@ -115,6 +143,47 @@ void maybeGenerateComponent(Navigator* navigator, ScreenData* screen) {
     Q_ASSERT(!qmlComponent->isError());
     screen->m_qmlComponent = qmlComponent;
   }
+
+  screen->m_lastUsed = ++s_componentUses;
+}
+
+int evictableComponents() {
+  int count = 0;
+  for (const ScreenData& screen : s_screens) {
+    if (screen.m_qmlComponent &&
+        screen.m_loadPolicy == Navigator::LoadTemporarily) {
+      ++count;
+    }
+  }
+  return count;
+}
+
+void evictComponents(QQmlComponent* currentComponent) {
+  int count = evictableComponents();
+  while (count > MAX_CACHED_COMPONENTS) {
+    ScreenData* leastUsed = nullptr;
+    for (ScreenData& screen : s_screens) {
+      if (!screen.m_qmlComponent ||
+          screen.m_qmlComponent == currentComponent ||
+          screen.m_qmlComponent->isLoading() ||
+          screen.m_loadPolicy != Navigator::LoadTemporarily) {
+        continue;
+      }
+
+      if (!leastUsed || screen.m_lastUsed < leastUsed->m_lastUsed) {
+        leastUsed = &screen;
+      }
+    }
+
+    if (!leastUsed) {
+      return;
+    }
+
+    logger.debug() << "Release the component of screen" << leastUsed->m_screen;
+    leastUsed->m_qmlComponent->deleteLater();
+    leastUsed->m_qmlComponent = nullptr;
+    --count;
+  }
 }
 
 };  // namespace
@@ -129,6 +198,11 @@ Navigator* Navigator::instance() {
 
 Navigator::Navigator(QObject* parent) : QObject(parent) {
   MZ_COUNT_CTOR(Navigator);
+
+  m_precompileTimer.setSingleShot(true);
+  m_precompileTimer.setInterval(PRECOMPILE_IDLE_MSEC);
+  connect(&m_precompileTimer, &QTimer::timeout, this,
+          &Navigator::precompileNextScreen);
 }
 
 Navigator::~Navigator() { MZ_COUNT_DTOR(Navigator); }
@@ -237,7 +311,69 @@ void Navigator::loadScreen(int screen, LoadPolicy loadPolicy,
   m_currentComponent = component;
   m_currentLoadingFlags = loadingFlags;
 
+  // The navigation is timed until the loader has created the screen: see
+  // screenLoaded().
+  m_precompileTimer.stop();
+  m_navigationTimer.start();
+  m_navigationPrecompiled = component->isReady();
+
   emit currentComponentChanged();
+
+  evictComponents(m_currentComponent);
+}
+
+void Navigator::screenLoaded(QQmlComponent* component) {
+  // A newer navigation is pending, or a screen has been reloaded outside of
+  // a navigation.
+  if (component != m_currentComponent || !m_navigationTimer.isValid()) {
+    return;
+  }
+
+  qint64 msec = m_navigationTimer.elapsed();
+  m_navigationTimer.invalidate();
+
+  logger.debug() << "Screen" << m_currentScreen << "shown in" << msec
+                 << "msec" << (m_navigationPrecompiled ? "(precompiled)" : "");
+  emit navigationCompleted(m_currentScreen, msec, m_navigationPrecompiled);
+
+  m_precompileTimer.start();
+}
+
+void Navigator::precompileNextScreen() {
+  ScreenData* currentScreen = findScreen(m_currentScreen);
+  if (!currentScreen) {
+    return;
+  }
+
+  for (int nextScreenId : currentScreen->m_nextScreens) {
+    // The app state is not checked: the next screen is often reached from
+    // another state.
+    ScreenData* screen = findScreen(nextScreenId);
+    if (!screen || screen->m_qmlComponent ||
+        screen->m_priorityGetter(&nextScreenId) < 0) {
+      continue;
+    }
+
+    // Precompiling must not evict the components already in the budget.
+    if (screen->m_loadPolicy == LoadTemporarily &&
+        evictableComponents() >= MAX_CACHED_COMPONENTS) {
+      continue;
+    }
+
+    logger.debug() << "Precompile screen" << nextScreenId;
+    maybeGenerateComponent(this, screen);
+
+    // One component at a time: the next one waits for this one.
+    QQmlComponent* component = screen->m_qmlComponent;
+    if (component->isLoading()) {
+      connect(
+          component, &QQmlComponent::statusChanged, this,
+          [this]() { m_precompileTimer.start(); }, Qt::SingleShotConnection);
+    } else {
+      m_precompileTimer.start();
+    }
+    return;
+  }
 }
 
 void Navigator::addStackView(int requestedScreen, const QVariant& stackView) {
@@ -396,6 +532,51 @@ void Navigator::registerScreen(int screenId, LoadPolicy loadPolicy,
                               requiresAppState, priorityGetter, quitBlocked));
 }
 
+// static
+void Navigator::registerNextScreens(int screenId,
+                                    const QVector<int>& screens) {
+  ScreenData* screen = findScreen(screenId);
+  Q_ASSERT(screen);
+
+  screen->m_nextScreens = screens;
+}
+
+#ifdef UNIT_TEST
+// static
+QList<int> Navigator::cachedScreens() {
+  QList<const ScreenData*> screens;
+  for (const ScreenData& screen : s_screens) {
+    if (screen.m_qmlComponent) {
+      screens.append(&screen);
+    }
+  }
+
+  std::sort(screens.begin(), screens.end(),
+            [](const ScreenData* a, const ScreenData* b) {
+              return a->m_lastUsed < b->m_lastUsed;
+            });
+
+  QList<int> screenIds;
+  for (const ScreenData* screen : screens) {
+    screenIds.append(screen->m_screen);
+  }
+  return screenIds;
+}
+
+void Navigator::unregisterScreens() {
+  for (ScreenData& screen : s_screens) {
+    delete screen.m_qmlComponent;
+  }
+
+  s_screens.clear();
+  m_screenHistory.clear();
+  m_currentScreen = -1;
+  m_currentComponent = nullptr;
+  m_navigationTimer.invalidate();
+  m_precompileTimer.stop();
+}
+#endif
+
 void Navigator::reloadCurrentScreen() {
   requestScreen(m_currentScreen, ForceReloadAll);
 }
@@ -5,8 +5,10 @@
 #ifndef NAVIGATOR_H
 #define NAVIGATOR_H
 
+#include <QElapsedTimer>
 #include <QObject>
 #include <QQmlComponent>
+#include <QTimer>
 
 class NavigatorReloader;
 class QQuickItem;
@@ -62,6 +64,10 @@ class Navigator final : public QObject {
 
   Q_INVOKABLE bool eventHandled();
 
+  // Called by the screen loader once the screen of `component` is created.
+  // It ends the timing of the navigation.
+  Q_INVOKABLE void screenLoaded(QQmlComponent* component);
+
   /**
    * @brief Request's the Load of the current screen with
    * ForceReloadAll policy
@@ -78,10 +84,27 @@ class Navigator final : public QObject {
                              int8_t (*priorityGetter)(int*),
                              bool (*quitBlocked)());
 
+  // The screens that are likely reached from `screenId`. Their components
+  // are compiled while the app is idle, so that the first visit does not wait
+  // for the QML compilation.
+  static void registerNextScreens(int screenId, const QVector<int>& screens);
+
+#ifdef UNIT_TEST
+  // The screens whose component is cached, the least recently used first.
+  static QList<int> cachedScreens();
+
+  // Removes all the screens, and releases their components.
+  void unregisterScreens();
+#endif
+
  signals:
   void goBack(QQuickItem* item);
   void currentComponentChanged();
 
+  // Emitted when the screen of a navigation is created. `precompiled` is true
+  // if its component was ready when the navigation started.
+  void navigationCompleted(int screen, qint64 msec, bool precompiled);
+
  private:
   explicit Navigator(QObject* parent);
 
@@ -91,6 +114,8 @@ class Navigator final : public QObject {
 
   void removeItem(QObject* obj);
 
+  void precompileNextScreen();
+
  private:
   int m_currentScreen = -1;
   LoadPolicy m_currentLoadPolicy = LoadTemporarily;
@@ -100,6 +125,11 @@ class Navigator final : public QObject {
   QList<int> m_screenHistory;
 
   QList<NavigatorReloader*> m_reloaders;
+
+  QElapsedTimer m_navigationTimer;
+  bool m_navigationPrecompiled = false;
+
+  QTimer m_precompileTimer;
 };
 
 #endif  // NAVIGATOR_H
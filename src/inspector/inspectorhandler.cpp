@@ -37,6 +37,7 @@
 #include "qmlengineholder.h"
 #include "settingsholder.h"
 #include "task.h"
+#include "tracer.h"
 #include "urlopener.h"
 #include "utils.h"
 
@@ -235,6 +236,26 @@ static QList<InspectorCommand> s_commands{
                        return obj;
                      }},
 
+    InspectorCommand{
+        "query_many", "Query the tree for a JSON array of paths", 1,
+        [](InspectorHandler*, const QList<QByteArray>& arguments) {
+          QJsonObject obj;
+
+          QJsonDocument json = QJsonDocument::fromJson(arguments[1]);
+          if (!json.isArray()) {
+            obj["error"] = "A JSON array of paths is expected";
+            return obj;
+          }
+
+          QJsonArray values;
+          for (const QJsonValue& path : json.array()) {
+            values.append(!!InspectorUtils::queryObject(path.toString()));
+          }
+
+          obj["value"] = values;
+          return obj;
+        }},
+
     InspectorCommand{
         "query_property", "Retrieve a property value from an object", 2,
         [](InspectorHandler*, const QList<QByteArray>& arguments) {
@@ -595,6 +616,15 @@ static QList<InspectorCommand> s_commands{
                        return QJsonObject();
                      }},
 
+    InspectorCommand{"activation_trace",
+                     "Retrieve the activation spans as a Chrome trace", 0,
+                     [](InspectorHandler*, const QList<QByteArray>&) {
+                       QJsonObject obj;
+                       obj["value"] = QString::fromUtf8(
+                           Tracer::instance()->toChromeTrace());
+                       return obj;
+                     }},
+
     InspectorCommand{"set_version_override", "Override the version string", 1,
                      [](InspectorHandler*, const QList<QByteArray>& arguments) {
                        QString versionOverride = QString(arguments[1]);
@@ -658,6 +688,9 @@ InspectorHandler::InspectorHandler(QObject* parent) : QObject(parent) {
           &QNetworkAccessManager::finished, this,
           &InspectorHandler::networkRequestFinished);
 
+  connect(Navigator::instance(), &Navigator::navigationCompleted, this,
+          &InspectorHandler::navigationCompleted);
+
   if (s_constructorCallback) {
     s_constructorCallback(this);
   }
@@ -713,6 +746,16 @@ void InspectorHandler::logEntryAdded(const QByteArray& log) {
   send(QJsonDocument(obj).toJson(QJsonDocument::Compact));
 }
 
+void InspectorHandler::navigationCompleted(int screen, qint64 msec,
+                                           bool precompiled) {
+  QJsonObject obj;
+  obj["type"] = "navigation";
+  obj["screen"] = screen;
+  obj["msec"] = msec;
+  obj["precompiled"] = precompiled;
+  send(QJsonDocument(obj).toJson(QJsonDocument::Compact));
+}
+
 void InspectorHandler::networkRequestFinished(QNetworkReply* reply) {
   if (!s_forwardNetwork) {
     return;
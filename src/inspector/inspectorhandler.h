@@ -50,6 +50,7 @@ class InspectorHandler : public QObject {
  private:
   void addonLoadCompleted();
   void logEntryAdded(const QByteArray& log);
+  void navigationCompleted(int screen, qint64 msec, bool precompiled);
   void networkRequestFinished(QNetworkReply* reply);
 };
 
@@ -4,12 +4,39 @@
 
 #include "inspectorutils.h"
 
+#include <QHash>
+#include <QPointer>
 #include <QQmlApplicationEngine>
 #include <QQuickItem>
 
 #include "qmlengineholder.h"
+#include "qmlitemindex.h"
 #include "qmlpath.h"
 
+namespace {
+// The functional tests poll the same few paths over and over.
+constexpr int QMLPATH_CACHE_SIZE = 256;
+QHash<QString, QmlPath> s_qmlPaths;
+
+QPointer<QmlItemIndex> s_itemIndex;
+}  // namespace
+
+// static
+QmlItemIndex* InspectorUtils::itemIndex() {
+  QQmlApplicationEngine* engine = qobject_cast<QQmlApplicationEngine*>(
+      QmlEngineHolder::instance()->engine());
+  if (!engine) {
+    return nullptr;
+  }
+
+  // The index is owned by the engine.
+  if (!s_itemIndex || s_itemIndex->parent() != engine) {
+    s_itemIndex = new QmlItemIndex(engine);
+  }
+
+  return s_itemIndex;
+}
+
 // static
 QObject* InspectorUtils::findObject(const QString& name) {
   QStringList parts = name.split("/");
@@ -22,15 +49,20 @@ QObject* InspectorUtils::findObject(const QString& name) {
     return nullptr;
   }
 
-  for (QObject* rootObject : engine->rootObjects()) {
-    if (!rootObject) {
-      continue;
-    }
+  // An unambiguous name does not need a walk of the object tree.
+  QList<QQuickItem*> candidates = itemIndex()->items(parts[0]);
+  if (candidates.length() == 1) {
+    parent = candidates.first();
+  }
 
-    parent = rootObject->findChild<QQuickItem*>(parts[0]);
+  for (QObject* rootObject : engine->rootObjects()) {
     if (parent) {
       break;
     }
+
+    if (rootObject) {
+      parent = rootObject->findChild<QQuickItem*>(parts[0]);
+    }
   }
 
   if (!parent) {
@@ -79,17 +111,25 @@ QObject* InspectorUtils::findObject(const QString& name) {
   return parent;
 }
 
+// static
 QObject* InspectorUtils::queryObject(const QString& path) {
-  QmlPath qmlPath(path);
-  if (!qmlPath.isValid()) {
-    return nullptr;
-  }
-
   QQmlApplicationEngine* engine = qobject_cast<QQmlApplicationEngine*>(
       QmlEngineHolder::instance()->engine());
   if (!engine) {
     return nullptr;
   }
 
-  return qmlPath.evaluate(engine);
+  auto i = s_qmlPaths.constFind(path);
+  if (i == s_qmlPaths.cend()) {
+    if (s_qmlPaths.size() >= QMLPATH_CACHE_SIZE) {
+      s_qmlPaths.clear();
+    }
+    i = s_qmlPaths.insert(path, QmlPath(path));
+  }
+
+  if (!i->isValid()) {
+    return nullptr;
+  }
+
+  return i->evaluate(engine, itemIndex());
 }
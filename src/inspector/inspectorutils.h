@@ -7,11 +7,16 @@
 
 #include <QObject>
 
+class QmlItemIndex;
+
 class InspectorUtils final {
  public:
   static QObject* findObject(const QString& name);
 
   static QObject* queryObject(const QString& path);
+
+ private:
+  static QmlItemIndex* itemIndex();
 };
 
 #endif  // INSPECTORUTILS_H
@@ -34,6 +34,8 @@ class InterfaceConfig {
   int m_serverPort = 0;
   QList<IPAddress> m_allowedIPAddressRanges;
   QStringList m_vpnDisabledApps;
+  // Used to merge the spans of the client and of the daemon. See Tracer.
+  QString m_traceId;
 #if defined(MZ_ANDROID) || defined(MZ_IOS)
   QString m_installationId;
 #endif
@@ -0,0 +1,50 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "jsonprefetch.h"
+
+#include <QPromise>
+#include <QThreadPool>
+#include <memory>
+#include <utility>
+
+#include "leakdetector.h"
+
+JsonPrefetch::JsonPrefetch() { MZ_COUNT_CTOR(JsonPrefetch); }
+
+JsonPrefetch::~JsonPrefetch() { MZ_COUNT_DTOR(JsonPrefetch); }
+
+void JsonPrefetch::start(const QByteArray& json) {
+#if QT_CONFIG(thread)
+  if (json.isEmpty()) {
+    return;
+  }
+
+  // The job owns the promise: the prefetch can go away before it runs.
+  auto promise = std::make_shared<QPromise<QJsonDocument>>();
+  promise->start();
+
+  m_json = json;
+  m_future = promise->future();
+
+  QThreadPool::globalInstance()->start([promise, json]() {
+    promise->addResult(QJsonDocument::fromJson(json));
+    promise->finish();
+  });
+#else
+  Q_UNUSED(json);
+#endif
+}
+
+QJsonDocument JsonPrefetch::take(const QByteArray& json) {
+  QByteArray prefetched = std::exchange(m_json, QByteArray());
+  QFuture<QJsonDocument> future =
+      std::exchange(m_future, QFuture<QJsonDocument>());
+
+  if (!prefetched.isEmpty() && prefetched == json) {
+    return future.result();
+  }
+
+  return QJsonDocument::fromJson(json);
+}
@@ -0,0 +1,33 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef JSONPREFETCH_H
+#define JSONPREFETCH_H
+
+#include <QByteArray>
+#include <QFuture>
+#include <QJsonDocument>
+
+// Parses a JSON blob on the thread pool, so that independent models can read
+// their settings concurrently at startup. The model then takes the document
+// on its own thread.
+class JsonPrefetch final {
+  Q_DISABLE_COPY_MOVE(JsonPrefetch)
+
+ public:
+  JsonPrefetch();
+  ~JsonPrefetch();
+
+  void start(const QByteArray& json);
+
+  // Returns the document of `json`. The prefetched one is used if it matches,
+  // otherwise `json` is parsed synchronously.
+  QJsonDocument take(const QByteArray& json);
+
+ private:
+  QByteArray m_json;
+  QFuture<QJsonDocument> m_future;
+};
+
+#endif  // JSONPREFETCH_H
@@ -5,19 +5,159 @@
 #include "leakdetector.h"
 
 #include <QHash>
+#include <QList>
 #include <QMutex>
 #include <QObject>
+#include <QPair>
 #include <QTextStream>
+#include <atomic>
 
 #ifdef MZ_DEBUG
-static QMutex s_leakDetector;
+namespace {
+
+using Key = QPair<const char*, void*>;
+
+struct Entry {
+  // Constructions minus destructions. An object destroyed by another thread
+  // than the one which created it leaves a positive balance in the first
+  // table and a negative one in the second: they cancel out when merged.
+  int32_t balance = 0;
+  uint32_t size = 0;
+};
+
+struct Shard {
+  // Only contended while a report is generated.
+  QMutex mutex;
+  QHash<Key, Entry> entries;
+
+  // The same type name can have a different pointer in each translation
+  // unit. This maps each of them to the first one seen for the name. Only
+  // used by the owning thread.
+  QHash<const char*, const char*> typeNames;
+};
+
+QMutex s_leakDetector;
+
+// Registered shards, and the entries of the threads which have exited.
+QList<Shard*> s_shards;
+QHash<Key, Entry> s_retired;
+QHash<QByteArray, const char*> s_typeNames;
+
+std::atomic<uint32_t> s_sampling{1};
+
+thread_local Shard* t_shard = nullptr;
+thread_local bool t_exited = false;
+
+void record(QHash<Key, Entry>& entries, const Key& key, int32_t delta,
+            uint32_t size) {
+  Entry& entry = entries[key];
+  entry.balance += delta;
+  entry.size = size;
+  if (entry.balance == 0) {
+    entries.remove(key);
+  }
+}
+
+void mergeInto(QHash<Key, Entry>& target, const QHash<Key, Entry>& source) {
+  for (auto i = source.constBegin(); i != source.constEnd(); ++i) {
+    record(target, i.key(), i->balance, i->size);
+  }
+}
+
+// Moves the entries of the thread to the retired table when it exits.
+struct ShardOwner {
+  ~ShardOwner() {
+    if (!t_shard) {
+      return;
+    }
+
+    QMutexLocker lock(&s_leakDetector);
+    s_shards.removeAll(t_shard);
+    mergeInto(s_retired, t_shard->entries);
+
+    delete t_shard;
+    t_shard = nullptr;
+    t_exited = true;
+  }
+};
+
+thread_local ShardOwner t_shardOwner;
+
+Shard* currentShard() {
+  if (t_shard || t_exited) {
+    return t_shard;
+  }
+
+  // Let's make sure that the shard is retired when the thread exits.
+  (void)&t_shardOwner;
+
+  t_shard = new Shard();
+
+  QMutexLocker lock(&s_leakDetector);
+  s_shards.append(t_shard);
+  return t_shard;
+}
+
+const char* canonicalTypeName(Shard* shard, const char* typeName) {
+  const char* canonical = shard->typeNames.value(typeName);
+  if (canonical) {
+    return canonical;
+  }
+
+  {
+    QMutexLocker lock(&s_leakDetector);
+    QByteArray name(typeName);
+    canonical = s_typeNames.value(name);
+    if (!canonical) {
+      canonical = typeName;
+      s_typeNames.insert(name, canonical);
+    }
+  }
+
+  shard->typeNames.insert(typeName, canonical);
+  return canonical;
+}
 
-QHash<QString, QHash<void*, uint32_t>> s_leaks;
+bool sampled(void* ptr) {
+  uint32_t sampling = s_sampling.load(std::memory_order_relaxed);
+  return sampling <= 1 || (qHash(ptr) % sampling) == 0;
+}
+
+void logObject(void* ptr, const char* typeName, uint32_t size, int32_t delta) {
+  if (!sampled(ptr)) {
+    return;
+  }
+
+  Shard* shard = currentShard();
+  if (!shard) {
+    // The thread is exiting: its entries go directly to the retired table.
+    QMutexLocker lock(&s_leakDetector);
+    QByteArray name(typeName);
+    const char* canonical = s_typeNames.value(name, typeName);
+    record(s_retired, Key(canonical, ptr), delta, size);
+    return;
+  }
+
+  // The type names are only used by this thread: no lock is needed.
+  Key key(canonicalTypeName(shard, typeName), ptr);
+
+  QMutexLocker lock(&shard->mutex);
+  record(shard->entries, key, delta, size);
+}
+
+}  // namespace
 #endif
 
 LeakDetector::LeakDetector() {
 #ifndef MZ_DEBUG
   qFatal("LeakDetector _must_ be created in debug builds only!");
+#else
+  bool ok = false;
+  int sampling =
+      qEnvironmentVariableIntValue("MVPN_LEAKDETECTOR_SAMPLING", &ok);
+  if (ok && sampling > 1) {
+    s_sampling = sampling;
+  }
 #endif
 }
 
@@ -27,8 +167,15 @@ LeakDetector::~LeakDetector() {
 
   out << "== MZ  - Leak report ===================" << Qt::endl;
 
+  uint32_t sampling = s_sampling.load();
+  if (sampling > 1) {
+    out << "Sampling 1 object in " << sampling << Qt::endl;
+  }
+
+  QHash<QString, QHash<void*, uint32_t>> leaks = liveObjects();
+
   bool hasLeaks = false;
-  for (auto i = s_leaks.begin(); i != s_leaks.end(); ++i) {
+  for (auto i = leaks.begin(); i != leaks.end(); ++i) {
     QString className = i.key();
 
     if (i->size() == 0) {
@@ -51,25 +198,33 @@ LeakDetector::~LeakDetector() {
 
 #ifdef MZ_DEBUG
 void LeakDetector::logCtor(void* ptr, const char* typeName, uint32_t size) {
-  QMutexLocker lock(&s_leakDetector);
-
-  QString type(typeName);
-  if (!s_leaks.contains(type)) {
-    s_leaks.insert(type, QHash<void*, uint32_t>());
-  }
-
-  s_leaks[type].insert(ptr, size);
+  logObject(ptr, typeName, size, 1);
 }
 
 void LeakDetector::logDtor(void* ptr, const char* typeName, uint32_t size) {
-  QMutexLocker lock(&s_leakDetector);
+  logObject(ptr, typeName, size, -1);
+}
+
+// static
+QHash<QString, QHash<void*, uint32_t>> LeakDetector::liveObjects() {
+  QHash<Key, Entry> merged;
+
+  {
+    QMutexLocker lock(&s_leakDetector);
+    merged = s_retired;
+    for (Shard* shard : s_shards) {
+      QMutexLocker shardLock(&shard->mutex);
+      mergeInto(merged, shard->entries);
+    }
+  }
 
-  QString type(typeName);
-  Q_ASSERT(s_leaks.contains(type));
+  QHash<QString, QHash<void*, uint32_t>> result;
+  for (auto i = merged.constBegin(); i != merged.constEnd(); ++i) {
+    // A negative balance is a destruction without construction.
+    Q_ASSERT(i->balance > 0);
+    result[QString(i.key().first)].insert(i.key().second, i->size);
+  }
 
-  QHash<void*, uint32_t>& leak = s_leaks[type];
-  Q_ASSERT(leak.contains(ptr));
-  Q_ASSERT(leak[ptr] == size);
-  leak.remove(ptr);
+  return result;
 }
 #endif
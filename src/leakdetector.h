@@ -5,6 +5,7 @@
 #ifndef LEAKDETECTOR_H
 #define LEAKDETECTOR_H
 
+#include <QHash>
 #include <QObject>
 
 #ifdef MZ_DEBUG
@@ -27,6 +28,13 @@
 #  define MZ_COUNT_DTOR(_type)
 #endif
 
+// Each thread records its objects in its own table, keyed by the type name
+// pointer and the object pointer: no global lock is taken and no string is
+// built when an object is created or destroyed. The tables are merged when
+// the report is generated.
+//
+// Set MVPN_LEAKDETECTOR_SAMPLING=N to track only about one object in N.
+
 class LeakDetector {
  public:
   LeakDetector();
@@ -35,6 +43,9 @@ class LeakDetector {
 #ifdef MZ_DEBUG
   static void logCtor(void* ptr, const char* typeName, uint32_t size);
   static void logDtor(void* ptr, const char* typeName, uint32_t size);
+
+  // Returns the objects still alive, by type name, merging all the threads.
+  static QHash<QString, QHash<void*, uint32_t>> liveObjects();
 #endif
 };
 
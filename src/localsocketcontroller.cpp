@@ -21,6 +21,7 @@
 #include "models/keys.h"
 #include "models/server.h"
 #include "settingsholder.h"
+#include "tracer.h"
 
 // How many times do we try to reconnect.
 constexpr int MAX_CONNECTION_RETRY = 10;
@@ -240,6 +241,10 @@ void LocalSocketController::parseCommand(const QByteArray& command) {
 
   logger.debug() << "Parse command:" << type;
 
+  if (type == "status" && obj.contains("trace")) {
+    Tracer::instance()->importEvents(obj.value("trace").toArray());
+  }
+
   if (m_daemonState == eInitializing && type == "status") {
     m_daemonState = eReady;
 
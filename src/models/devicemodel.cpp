@@ -46,7 +46,7 @@ bool DeviceModel::fromJson(const Keys* keys, const QByteArray& s) {
     return true;
   }
 
-  if (!fromJsonInternal(keys, s)) {
+  if (!fromJsonInternal(keys, QJsonDocument::fromJson(s))) {
     return false;
   }
 
@@ -61,7 +61,7 @@ bool DeviceModel::fromSettings(const Keys* keys) {
   logger.debug() << "Reading the device list from settings";
 
   const QByteArray& json = settingsHolder->devices();
-  if (json.isEmpty() || !fromJsonInternal(keys, json)) {
+  if (json.isEmpty() || !fromJsonInternal(keys, m_prefetch.take(json))) {
     return false;
   }
 
@@ -69,6 +69,10 @@ bool DeviceModel::fromSettings(const Keys* keys) {
   return true;
 }
 
+void DeviceModel::prefetchSettings() {
+  m_prefetch.start(SettingsHolder::instance()->devices());
+}
+
 namespace {
 
 bool sortCallback(const Device& a, const Device& b, const Keys* keys) {
@@ -85,7 +89,8 @@ bool sortCallback(const Device& a, const Device& b, const Keys* keys) {
 
 }  // anonymous namespace
 
-bool DeviceModel::fromJsonInternal(const Keys* keys, const QByteArray& json) {
+bool DeviceModel::fromJsonInternal(const Keys* keys,
+                                   const QJsonDocument& doc) {
   beginResetModel();
 
   // Maybe we have to refresh the device list during a removal operation. If
@@ -102,7 +107,6 @@ bool DeviceModel::fromJsonInternal(const Keys* keys, const QByteArray& json) {
   m_devices.clear();
   m_removedDevices.clear();
 
-  QJsonDocument doc = QJsonDocument::fromJson(json);
   if (!doc.isObject()) {
     return false;
   }
@@ -8,6 +8,7 @@
 #include <QAbstractListModel>
 
 #include "device.h"
+#include "jsonprefetch.h"
 #include "loghandler.h"
 
 class Keys;
@@ -33,6 +34,10 @@ class DeviceModel final : public QAbstractListModel, public LogSerializer {
 
   [[nodiscard]] bool fromSettings(const Keys* keys);
 
+  // Starts parsing the device list of the settings in the background. See
+  // JsonPrefetch.
+  void prefetchSettings();
+
   bool initialized() const { return !m_rawJson.isEmpty(); }
 
   void writeSettings();
@@ -72,7 +77,8 @@ class DeviceModel final : public QAbstractListModel, public LogSerializer {
   void changed();
 
  private:
-  [[nodiscard]] bool fromJsonInternal(const Keys* keys, const QByteArray& json);
+  [[nodiscard]] bool fromJsonInternal(const Keys* keys,
+                                      const QJsonDocument& doc);
 
   bool removeRows(int row, int count,
                   const QModelIndex& parent = QModelIndex()) override;
@@ -80,6 +86,8 @@ class DeviceModel final : public QAbstractListModel, public LogSerializer {
  private:
   QByteArray m_rawJson;
 
+  JsonPrefetch m_prefetch;
+
   QList<Device> m_devices;
 
   // This list contains the list of devices that are about to be removed.
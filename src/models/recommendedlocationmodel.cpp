@@ -6,6 +6,7 @@
 
 #include <QCoreApplication>
 #include <QPointer>
+#include <algorithm>
 
 #include "leakdetector.h"
 #include "location.h"
@@ -19,6 +20,10 @@ Logger logger("RecommendedLocationModel");
 
 constexpr int REFRESH_TIMER_MSEC = 2000;
 constexpr unsigned int DEFAULT_ENTRIES = 5;
+
+bool sameCoordinate(double a, double b) {
+  return (qIsNaN(a) && qIsNaN(b)) || a == b;
+}
 }  // namespace
 
 // static
@@ -83,46 +88,88 @@ QList<const ServerCity*> RecommendedLocationModel::recommendedLocationsRaw(
 // static
 QList<QPointer<ServerCity>> RecommendedLocationModel::recommendedLocations(
     unsigned int maxResults) {
+  QList<QPointer<ServerCity>> cityResults;
+  if (maxResults == 0) {
+    return cityResults;
+  }
+
   double latencyScale = MozillaVPN::instance()->serverLatency()->avgLatency();
   if (latencyScale < 100.0) {
     latencyScale = 100.0;
   }
 
-  QVector<QPointer<ServerCity>> cityResults;
-  QVector<double> rankResults;
-  cityResults.reserve(maxResults + 1);
-  rankResults.reserve(maxResults + 1);
+  RecommendedLocationModel* model = instance();
+  model->maybeResetDistances();
+
+  QList<Candidate>& heap = model->m_candidates;
+  heap.clear();
+
+  // The heap keeps the worst of the best candidates on top.
+  auto compare = [](const Candidate& a, const Candidate& b) {
+    return a.m_ranking > b.m_ranking;
+  };
 
   for (const ServerCity& city :
        MozillaVPN::instance()->serverCountryModel()->cities()) {
     double cityRanking = city.connectionScore() * 256.0;
 
     // For tiebreaking, use the geographic distance and latency.
-    double distance = MozillaVPN::instance()->location()->distance(
-        city.latitude(), city.longitude());
     cityRanking -= city.latency() / latencyScale;
-    cityRanking -= distance;
+    cityRanking -= model->cityDistance(city);
 
-    // Insert into the result list
-    qsizetype i;
-    for (i = 0; i < rankResults.count(); i++) {
-      if (rankResults[i] < cityRanking) {
-        break;
-      }
-    }
-    if (i < static_cast<qsizetype>(maxResults)) {
-      rankResults.insert(i, cityRanking);
-      cityResults.insert(i, QPointer((ServerCity*)&city));
+    if (heap.count() < static_cast<qsizetype>(maxResults)) {
+      heap.append(Candidate{cityRanking, &city});
+      std::push_heap(heap.begin(), heap.end(), compare);
+      continue;
     }
-    if (rankResults.count() > static_cast<qsizetype>(maxResults)) {
-      rankResults.resize(maxResults);
-      cityResults.resize(maxResults);
+
+    if (cityRanking > heap.first().m_ranking) {
+      std::pop_heap(heap.begin(), heap.end(), compare);
+      heap.last() = Candidate{cityRanking, &city};
+      std::push_heap(heap.begin(), heap.end(), compare);
     }
   }
 
+  // Best candidates first.
+  std::sort_heap(heap.begin(), heap.end(), compare);
+
+  cityResults.reserve(heap.count());
+  for (const Candidate& candidate : heap) {
+    cityResults.append(QPointer(const_cast<ServerCity*>(candidate.m_city)));
+  }
+
   return cityResults;
 }
 
+void RecommendedLocationModel::maybeResetDistances() {
+  const QByteArray& digest =
+      MozillaVPN::instance()->serverCountryModel()->digest();
+  const Location* location = MozillaVPN::instance()->location();
+
+  if (m_distancesDigest == digest &&
+      sameCoordinate(m_distancesLatitude, location->latitude()) &&
+      sameCoordinate(m_distancesLongitude, location->longitude())) {
+    return;
+  }
+
+  m_distances.clear();
+  m_distancesDigest = digest;
+  m_distancesLatitude = location->latitude();
+  m_distancesLongitude = location->longitude();
+}
+
+double RecommendedLocationModel::cityDistance(const ServerCity& city) {
+  auto i = m_distances.constFind(city.hashKey());
+  if (i != m_distances.cend()) {
+    return i.value();
+  }
+
+  double distance = MozillaVPN::instance()->location()->distance(
+      city.latitude(), city.longitude());
+  m_distances.insert(city.hashKey(), distance);
+  return distance;
+}
+
 QHash<int, QByteArray> RecommendedLocationModel::roleNames() const {
   QHash<int, QByteArray> roles;
   roles[CityRole] = "city";
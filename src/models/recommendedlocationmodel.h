@@ -6,9 +6,11 @@
 #define RECOMMENDEDLOCATIONMODEL_H
 
 #include <QAbstractListModel>
+#include <QByteArray>
 #include <QPointer>
 #include <QSet>
 #include <QTimer>
+#include <QtNumeric>
 
 #include "servercity.h"
 
@@ -48,9 +50,27 @@ class RecommendedLocationModel final : public QAbstractListModel {
   void maybeRefreshModel();
   void refreshModel();
 
+  void maybeResetDistances();
+  double cityDistance(const ServerCity& city);
+
  private:
   QList<QPointer<ServerCity>> m_recommendedCities;
   QTimer m_timer;
+
+  // Distances from the user location, keyed by ServerCity::hashKey(). They
+  // are valid for the server list and the location they were computed for.
+  QHash<QString, double> m_distances;
+  QByteArray m_distancesDigest;
+  double m_distancesLatitude = qQNaN();
+  double m_distancesLongitude = qQNaN();
+
+  struct Candidate {
+    double m_ranking;
+    const ServerCity* m_city;
+  };
+
+  // Heap of the best candidates, kept here to reuse its storage.
+  QList<Candidate> m_candidates;
 };
 
 #endif  // RECOMMENDEDLOCATIONMODEL_H
@@ -11,6 +11,8 @@
 #include <QRandomGenerator>
 
 #include "leakdetector.h"
+#include "servercatalog.h"
+#include "serverkeys.h"
 
 Server::Server() { MZ_COUNT_CTOR(Server); }
 
@@ -35,6 +37,7 @@ Server& Server::operator=(const Server& other) {
   m_ipv6Gateway = other.m_ipv6Gateway;
   m_portRanges = other.m_portRanges;
   m_publicKey = other.m_publicKey;
+  m_id = other.m_id;
   m_weight = other.m_weight;
   m_socksName = other.m_socksName;
   m_multihopPort = other.m_multihopPort;
@@ -124,6 +127,7 @@ bool Server::fromJson(const QJsonObject& obj) {
   m_ipv6Gateway = ipv6Gateway.toString();
   m_portRanges.swap(prList);
   m_publicKey = publicKey.toString();
+  m_id = ServerKeys::intern(m_publicKey);
   m_weight = weight.toInt();
   m_socksName = socks5_name.toString();
   m_multihopPort = multihop_port.toInt();
@@ -131,11 +135,32 @@ bool Server::fromJson(const QJsonObject& obj) {
   return true;
 }
 
+bool Server::fromCatalog(const ServerCatalog& catalog, uint32_t index) {
+  return fromRecord(catalog.server(index));
+}
+
+bool Server::fromRecord(ServerCatalog::ServerRecord record) {
+  m_hostname = record.hostname;
+  m_ipv4AddrIn = record.ipv4AddrIn;
+  m_ipv4Gateway = record.ipv4Gateway;
+  m_ipv6AddrIn = record.ipv6AddrIn;
+  m_ipv6Gateway = record.ipv6Gateway;
+  m_portRanges.swap(record.portRanges);
+  m_publicKey = record.publicKey;
+  m_id = ServerKeys::intern(m_publicKey);
+  m_weight = record.weight;
+  m_socksName = record.socksName;
+  m_multihopPort = record.multihopPort;
+
+  return true;
+}
+
 bool Server::fromMultihop(const Server& exit, const Server& entry) {
   m_hostname = exit.m_hostname;
   m_ipv4Gateway = exit.m_ipv4Gateway;
   m_ipv6Gateway = exit.m_ipv6Gateway;
   m_publicKey = exit.m_publicKey;
+  m_id = exit.m_id;
   m_socksName = exit.m_socksName;
   m_multihopPort = exit.m_multihopPort;
 
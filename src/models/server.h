@@ -9,6 +9,9 @@
 #include <QPair>
 #include <QString>
 
+#include "servercatalog.h"
+#include "serverkeys.h"
+
 class QJsonObject;
 
 class Server final {
@@ -20,6 +23,8 @@ class Server final {
   ~Server();
 
   [[nodiscard]] bool fromJson(const QJsonObject& obj);
+  [[nodiscard]] bool fromCatalog(const ServerCatalog& catalog, uint32_t index);
+  [[nodiscard]] bool fromRecord(ServerCatalog::ServerRecord record);
   bool fromMultihop(const Server& exit, const Server& entry);
 
   static const Server& weightChooser(const QList<Server>& servers);
@@ -38,12 +43,19 @@ class Server final {
 
   const QString& publicKey() const { return m_publicKey; }
 
+  // Interned id of the public key. See ServerKeys.
+  uint32_t id() const { return m_id; }
+
   const QString& socksName() const { return m_socksName; }
 
   uint32_t weight() const { return m_weight; }
 
   uint32_t choosePort() const;
 
+  const QList<QPair<uint32_t, uint32_t>>& portRanges() const {
+    return m_portRanges;
+  }
+
   uint32_t multihopPort() const { return m_multihopPort; }
 
   const QString& countryCode() const { return m_countryCode; }
@@ -69,6 +81,7 @@ class Server final {
   QString m_ipv6Gateway;
   QList<QPair<uint32_t, uint32_t>> m_portRanges;
   QString m_publicKey;
+  uint32_t m_id = ServerKeys::Invalid;
   QString m_socksName;
   uint32_t m_weight = 0;
   uint32_t m_multihopPort = 0;
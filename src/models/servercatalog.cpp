@@ -0,0 +1,439 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "servercatalog.h"
+
+#include <QCryptographicHash>
+#include <QtEndian>
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+#include "leakdetector.h"
+#include "logger.h"
+#include "server.h"
+#include "servercity.h"
+#include "servercountry.h"
+
+namespace {
+Logger logger("ServerCatalog");
+
+constexpr const char SNAPSHOT_MAGIC[] = "MZSC";
+constexpr uint32_t SNAPSHOT_VERSION = 1;
+
+constexpr qint64 DIGEST_SIZE = 32;
+constexpr qint64 SOURCE_DIGEST_OFFSET = 32;
+constexpr qint64 PAYLOAD_DIGEST_OFFSET = SOURCE_DIGEST_OFFSET + DIGEST_SIZE;
+constexpr qint64 HEADER_SIZE = PAYLOAD_DIGEST_OFFSET + DIGEST_SIZE;
+
+constexpr qint64 COUNTRY_RECORD_SIZE = 4 * 4;
+constexpr qint64 CITY_RECORD_SIZE = 4 * 4 + 2 * 8;
+constexpr qint64 SERVER_RECORD_SIZE = 11 * 4;
+constexpr qint64 PORT_RANGE_RECORD_SIZE = 2 * 4;
+
+uint32_t readUint32(const uchar* ptr) {
+  return qFromLittleEndian<quint32>(ptr);
+}
+
+double readDouble(const uchar* ptr) {
+  return std::bit_cast<double>(qFromLittleEndian<quint64>(ptr));
+}
+
+void appendUint32(QByteArray& data, uint32_t value) {
+  uchar buffer[sizeof(quint32)];
+  qToLittleEndian<quint32>(value, buffer);
+  data.append(reinterpret_cast<const char*>(buffer), sizeof(buffer));
+}
+
+void appendDouble(QByteArray& data, double value) {
+  uchar buffer[sizeof(quint64)];
+  qToLittleEndian<quint64>(std::bit_cast<quint64>(value), buffer);
+  data.append(reinterpret_cast<const char*>(buffer), sizeof(buffer));
+}
+
+QByteArray sha256(QByteArrayView data) {
+  return QCryptographicHash::hash(data, QCryptographicHash::Sha256);
+}
+
+// Deduplicated strings, referenced by offset.
+class StringTable final {
+ public:
+  uint32_t add(const QString& string) {
+    auto i = m_offsets.constFind(string);
+    if (i != m_offsets.cend()) {
+      return i.value();
+    }
+
+    uint32_t offset = static_cast<uint32_t>(m_data.size());
+    QByteArray utf8 = string.toUtf8();
+    appendUint32(m_data, static_cast<uint32_t>(utf8.size()));
+    m_data.append(utf8);
+
+    m_offsets.insert(string, offset);
+    return offset;
+  }
+
+  const QByteArray& data() const { return m_data; }
+
+ private:
+  QHash<QString, uint32_t> m_offsets;
+  QByteArray m_data;
+};
+
+}  // namespace
+
+ServerCatalog::ServerCatalog() { MZ_COUNT_CTOR(ServerCatalog); }
+
+ServerCatalog::~ServerCatalog() { MZ_COUNT_DTOR(ServerCatalog); }
+
+// static
+QByteArray ServerCatalog::serialize(const QByteArray& source,
+                                    const QList<ServerCountry>& countries,
+                                    const QHash<QString, ServerCity>& cities,
+                                    const QHash<uint32_t, Server>& servers) {
+  QHash<QString, QList<const Server*>> cityServers;
+  for (const Server& server : servers) {
+    cityServers[ServerCity::hashKey(server.countryCode(), server.cityName())]
+        .append(&server);
+  }
+
+  StringTable strings;
+  QByteArray countryTable;
+  QByteArray cityTable;
+  QByteArray serverTable;
+  QByteArray portRangeTable;
+  uint32_t cityCount = 0;
+  uint32_t serverCount = 0;
+  uint32_t portRangeCount = 0;
+
+  for (const ServerCountry& country : countries) {
+    uint32_t firstCity = cityCount;
+
+    for (const QString& cityName : country.cities()) {
+      auto i = cities.constFind(ServerCity::hashKey(country.code(), cityName));
+      if (i == cities.cend()) {
+        continue;
+      }
+      const ServerCity& city = i.value();
+
+      // The servers listed by the city come first, in order. The others (the
+      // city could be hidden) follow, sorted by id.
+      QList<const Server*> unlisted = cityServers.value(city.hashKey());
+      QList<const Server*> cityServerList;
+      for (uint32_t id : city.servers()) {
+        auto server = std::find_if(
+            unlisted.begin(), unlisted.end(),
+            [id](const Server* server) { return server->id() == id; });
+        if (server != unlisted.end()) {
+          cityServerList.append(*server);
+          unlisted.erase(server);
+        }
+      }
+      std::sort(unlisted.begin(), unlisted.end(),
+                [](const Server* a, const Server* b) {
+                  return a->id() < b->id();
+                });
+      cityServerList.append(unlisted);
+
+      appendUint32(cityTable, strings.add(city.name()));
+      appendUint32(cityTable, strings.add(city.code()));
+      appendUint32(cityTable, serverCount);
+      appendUint32(cityTable, static_cast<uint32_t>(cityServerList.count()));
+      appendDouble(cityTable, city.latitude());
+      appendDouble(cityTable, city.longitude());
+      ++cityCount;
+
+      for (const Server* server : cityServerList) {
+        appendUint32(serverTable, strings.add(server->hostname()));
+        appendUint32(serverTable, strings.add(server->ipv4AddrIn()));
+        appendUint32(serverTable, strings.add(server->ipv4Gateway()));
+        appendUint32(serverTable, strings.add(server->ipv6AddrIn()));
+        appendUint32(serverTable, strings.add(server->ipv6Gateway()));
+        appendUint32(serverTable, strings.add(server->publicKey()));
+        appendUint32(serverTable, strings.add(server->socksName()));
+        appendUint32(serverTable, server->weight());
+        appendUint32(serverTable, server->multihopPort());
+        appendUint32(serverTable, portRangeCount);
+        appendUint32(serverTable,
+                     static_cast<uint32_t>(server->portRanges().count()));
+        ++serverCount;
+
+        for (const QPair<uint32_t, uint32_t>& range : server->portRanges()) {
+          appendUint32(portRangeTable, range.first);
+          appendUint32(portRangeTable, range.second);
+          ++portRangeCount;
+        }
+      }
+    }
+
+    appendUint32(countryTable, strings.add(country.name()));
+    appendUint32(countryTable, strings.add(country.code()));
+    appendUint32(countryTable, firstCity);
+    appendUint32(countryTable, cityCount - firstCity);
+  }
+
+  QByteArray payload;
+  payload.reserve(countryTable.size() + cityTable.size() + serverTable.size() +
+                  portRangeTable.size() + strings.data().size());
+  payload.append(countryTable);
+  payload.append(cityTable);
+  payload.append(serverTable);
+  payload.append(portRangeTable);
+  payload.append(strings.data());
+
+  QByteArray snapshot;
+  snapshot.reserve(HEADER_SIZE + payload.size());
+  snapshot.append(SNAPSHOT_MAGIC, 4);
+  appendUint32(snapshot, SNAPSHOT_VERSION);
+  appendUint32(snapshot, static_cast<uint32_t>(countries.count()));
+  appendUint32(snapshot, cityCount);
+  appendUint32(snapshot, serverCount);
+  appendUint32(snapshot, portRangeCount);
+  appendUint32(snapshot, static_cast<uint32_t>(strings.data().size()));
+  appendUint32(snapshot, 0);
+  snapshot.append(sha256(source));
+  snapshot.append(sha256(payload));
+  snapshot.append(payload);
+  return snapshot;
+}
+
+bool ServerCatalog::load(const QString& fileName) {
+  reset();
+
+  m_file.setFileName(fileName);
+  if (!m_file.open(QIODevice::ReadOnly)) {
+    logger.debug() << "No server snapshot";
+    return false;
+  }
+
+  qint64 size = m_file.size();
+  const uchar* data = m_file.map(0, size);
+  if (!data) {
+    m_buffer = m_file.readAll();
+    m_file.close();
+
+    data = reinterpret_cast<const uchar*>(m_buffer.constData());
+    size = m_buffer.size();
+  }
+
+  if (!parse(data, size)) {
+    reset();
+    return false;
+  }
+
+  return true;
+}
+
+bool ServerCatalog::loadFromData(const QByteArray& data) {
+  reset();
+
+  m_buffer = data;
+  if (!parse(reinterpret_cast<const uchar*>(m_buffer.constData()),
+             m_buffer.size())) {
+    reset();
+    return false;
+  }
+
+  return true;
+}
+
+void ServerCatalog::reset() {
+  m_data = nullptr;
+  m_countries = nullptr;
+  m_cities = nullptr;
+  m_servers = nullptr;
+  m_portRanges = nullptr;
+  m_strings = nullptr;
+  m_countryCount = 0;
+  m_cityCount = 0;
+  m_serverCount = 0;
+  m_portRangeCount = 0;
+  m_stringTableSize = 0;
+
+  // Closing the file removes the mapping, if any.
+  if (m_file.isOpen()) {
+    m_file.close();
+  }
+
+  m_buffer.clear();
+}
+
+bool ServerCatalog::parse(const uchar* data, qint64 size) {
+  if (!data || size < HEADER_SIZE || memcmp(data, SNAPSHOT_MAGIC, 4) != 0) {
+    logger.error() << "Invalid server snapshot header";
+    return false;
+  }
+
+  if (readUint32(data + 4) != SNAPSHOT_VERSION) {
+    logger.warning() << "Unsupported server snapshot version";
+    return false;
+  }
+
+  uint32_t countryCount = readUint32(data + 8);
+  uint32_t cityCount = readUint32(data + 12);
+  uint32_t serverCount = readUint32(data + 16);
+  uint32_t portRangeCount = readUint32(data + 20);
+  uint32_t stringTableSize = readUint32(data + 24);
+
+  qint64 expectedSize = HEADER_SIZE;
+  expectedSize += static_cast<qint64>(countryCount) * COUNTRY_RECORD_SIZE;
+  expectedSize += static_cast<qint64>(cityCount) * CITY_RECORD_SIZE;
+  expectedSize += static_cast<qint64>(serverCount) * SERVER_RECORD_SIZE;
+  expectedSize += static_cast<qint64>(portRangeCount) * PORT_RANGE_RECORD_SIZE;
+  expectedSize += stringTableSize;
+  if (expectedSize != size) {
+    logger.error() << "Invalid server snapshot size";
+    return false;
+  }
+
+  const uchar* payload = data + HEADER_SIZE;
+  QByteArray digest = sha256(QByteArrayView(payload, size - HEADER_SIZE));
+  if (memcmp(data + PAYLOAD_DIGEST_OFFSET, digest.constData(), DIGEST_SIZE) !=
+      0) {
+    logger.error() << "Corrupted server snapshot";
+    return false;
+  }
+
+  m_countries = payload;
+  m_cities = m_countries + countryCount * COUNTRY_RECORD_SIZE;
+  m_servers = m_cities + cityCount * CITY_RECORD_SIZE;
+  m_portRanges = m_servers + serverCount * SERVER_RECORD_SIZE;
+  m_strings = m_portRanges + portRangeCount * PORT_RANGE_RECORD_SIZE;
+  m_stringTableSize = stringTableSize;
+
+  // The checksum protects from corruption, not from bugs in the writer: let's
+  // validate the references once, so that the accessors don't have to.
+  for (uint32_t i = 0; i < countryCount; ++i) {
+    const uchar* record = m_countries + i * COUNTRY_RECORD_SIZE;
+    quint64 end = quint64(readUint32(record + 8)) + readUint32(record + 12);
+    if (!validString(readUint32(record)) ||
+        !validString(readUint32(record + 4)) || end > cityCount) {
+      logger.error() << "Invalid server snapshot country" << i;
+      return false;
+    }
+  }
+
+  for (uint32_t i = 0; i < cityCount; ++i) {
+    const uchar* record = m_cities + i * CITY_RECORD_SIZE;
+    quint64 end = quint64(readUint32(record + 8)) + readUint32(record + 12);
+    if (!validString(readUint32(record)) ||
+        !validString(readUint32(record + 4)) || end > serverCount) {
+      logger.error() << "Invalid server snapshot city" << i;
+      return false;
+    }
+  }
+
+  for (uint32_t i = 0; i < serverCount; ++i) {
+    const uchar* record = m_servers + i * SERVER_RECORD_SIZE;
+    for (int field = 0; field < 7; ++field) {
+      if (!validString(readUint32(record + field * 4))) {
+        logger.error() << "Invalid server snapshot server" << i;
+        return false;
+      }
+    }
+
+    quint64 end = quint64(readUint32(record + 36)) + readUint32(record + 40);
+    if (end > portRangeCount) {
+      logger.error() << "Invalid server snapshot server" << i;
+      return false;
+    }
+  }
+
+  for (uint32_t i = 0; i < portRangeCount; ++i) {
+    const uchar* record = m_portRanges + i * PORT_RANGE_RECORD_SIZE;
+    if (readUint32(record) > readUint32(record + 4)) {
+      logger.error() << "Invalid server snapshot port range" << i;
+      return false;
+    }
+  }
+
+  m_data = data;
+  m_countryCount = countryCount;
+  m_cityCount = cityCount;
+  m_serverCount = serverCount;
+  m_portRangeCount = portRangeCount;
+  return true;
+}
+
+bool ServerCatalog::validString(uint32_t offset) const {
+  if (quint64(offset) + 4 > m_stringTableSize) {
+    return false;
+  }
+  return quint64(offset) + 4 + readUint32(m_strings + offset) <=
+         m_stringTableSize;
+}
+
+QString ServerCatalog::string(uint32_t offset) const {
+  Q_ASSERT(validString(offset));
+  return QString::fromUtf8(
+      reinterpret_cast<const char*>(m_strings + offset + 4),
+      readUint32(m_strings + offset));
+}
+
+bool ServerCatalog::matches(const QByteArray& source) const {
+  if (!m_data) {
+    return false;
+  }
+
+  QByteArray digest = sha256(source);
+  return memcmp(m_data + SOURCE_DIGEST_OFFSET, digest.constData(),
+                DIGEST_SIZE) == 0;
+}
+
+ServerCatalog::CountryRecord ServerCatalog::country(uint32_t index) const {
+  Q_ASSERT(index < m_countryCount);
+  const uchar* record = m_countries + index * COUNTRY_RECORD_SIZE;
+
+  CountryRecord country;
+  country.name = string(readUint32(record));
+  country.code = string(readUint32(record + 4));
+  country.firstCity = readUint32(record + 8);
+  country.cityCount = readUint32(record + 12);
+  return country;
+}
+
+ServerCatalog::CityRecord ServerCatalog::city(uint32_t index) const {
+  Q_ASSERT(index < m_cityCount);
+  const uchar* record = m_cities + index * CITY_RECORD_SIZE;
+
+  CityRecord city;
+  city.name = string(readUint32(record));
+  city.code = string(readUint32(record + 4));
+  city.firstServer = readUint32(record + 8);
+  city.serverCount = readUint32(record + 12);
+  city.latitude = readDouble(record + 16);
+  city.longitude = readDouble(record + 24);
+  return city;
+}
+
+QString ServerCatalog::serverPublicKey(uint32_t index) const {
+  Q_ASSERT(index < m_serverCount);
+  return string(readUint32(m_servers + index * SERVER_RECORD_SIZE + 20));
+}
+
+ServerCatalog::ServerRecord ServerCatalog::server(uint32_t index) const {
+  Q_ASSERT(index < m_serverCount);
+  const uchar* record = m_servers + index * SERVER_RECORD_SIZE;
+
+  ServerRecord server;
+  server.hostname = string(readUint32(record));
+  server.ipv4AddrIn = string(readUint32(record + 4));
+  server.ipv4Gateway = string(readUint32(record + 8));
+  server.ipv6AddrIn = string(readUint32(record + 12));
+  server.ipv6Gateway = string(readUint32(record + 16));
+  server.publicKey = string(readUint32(record + 20));
+  server.socksName = string(readUint32(record + 24));
+  server.weight = readUint32(record + 28);
+  server.multihopPort = readUint32(record + 32);
+
+  uint32_t firstPortRange = readUint32(record + 36);
+  uint32_t portRangeCount = readUint32(record + 40);
+  server.portRanges.reserve(portRangeCount);
+  for (uint32_t i = 0; i < portRangeCount; ++i) {
+    const uchar* range =
+        m_portRanges + (firstPortRange + i) * PORT_RANGE_RECORD_SIZE;
+    server.portRanges.append({readUint32(range), readUint32(range + 4)});
+  }
+  return server;
+}
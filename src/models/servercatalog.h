@@ -0,0 +1,126 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef SERVERCATALOG_H
+#define SERVERCATALOG_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QHash>
+#include <QList>
+#include <QPair>
+#include <QString>
+
+class Server;
+class ServerCity;
+class ServerCountry;
+
+// Binary snapshot of the server list, used to skip the JSON parsing at
+// startup. The data is stored in columns: one table of fixed-width records
+// for the countries, one for the cities and one for the servers, with each
+// country and city referencing a contiguous range of the next table. Strings
+// are stored once, in a shared string table.
+//
+// Layout (all integers are little-endian):
+//   header:  "MZSC" version countryCount cityCount serverCount portRangeCount
+//            stringTableSize reserved (uint32 each)
+//            SHA-256 of the JSON the snapshot was generated from
+//            SHA-256 of everything after the header
+//   countries: name code firstCity cityCount (uint32 each)
+//   cities:    name code firstServer serverCount (uint32 each)
+//              latitude longitude (IEEE 754 double each)
+//   servers:   hostname ipv4AddrIn ipv4Gateway ipv6AddrIn ipv6Gateway
+//              publicKey socksName weight multihopPort firstPortRange
+//              portRangeCount (uint32 each)
+//   port ranges: first last (uint32 each)
+//   strings:   uint32 length followed by the UTF-8 bytes. Strings are
+//              referenced by their offset in this table.
+
+class ServerCatalog final {
+  Q_DISABLE_COPY_MOVE(ServerCatalog)
+
+ public:
+  struct CountryRecord {
+    QString name;
+    QString code;
+    uint32_t firstCity = 0;
+    uint32_t cityCount = 0;
+  };
+
+  struct CityRecord {
+    QString name;
+    QString code;
+    double latitude = 0;
+    double longitude = 0;
+    uint32_t firstServer = 0;
+    uint32_t serverCount = 0;
+  };
+
+  struct ServerRecord {
+    QString hostname;
+    QString ipv4AddrIn;
+    QString ipv4Gateway;
+    QString ipv6AddrIn;
+    QString ipv6Gateway;
+    QString publicKey;
+    QString socksName;
+    uint32_t weight = 0;
+    uint32_t multihopPort = 0;
+    QList<QPair<uint32_t, uint32_t>> portRanges;
+  };
+
+  ServerCatalog();
+  ~ServerCatalog();
+
+  // Generates the snapshot of a server list parsed from the `source` JSON.
+  static QByteArray serialize(const QByteArray& source,
+                              const QList<ServerCountry>& countries,
+                              const QHash<QString, ServerCity>& cities,
+                              const QHash<uint32_t, Server>& servers);
+
+  // Maps the snapshot file (or reads it, if it cannot be mapped).
+  bool load(const QString& fileName);
+
+  bool loadFromData(const QByteArray& data);
+
+  void reset();
+
+  bool isValid() const { return m_data != nullptr; }
+
+  // Returns true if the snapshot has been generated from this JSON.
+  bool matches(const QByteArray& source) const;
+
+  uint32_t countryCount() const { return m_countryCount; }
+  uint32_t cityCount() const { return m_cityCount; }
+  uint32_t serverCount() const { return m_serverCount; }
+
+  CountryRecord country(uint32_t index) const;
+  CityRecord city(uint32_t index) const;
+  ServerRecord server(uint32_t index) const;
+  QString serverPublicKey(uint32_t index) const;
+
+ private:
+  bool parse(const uchar* data, qint64 size);
+  bool validString(uint32_t offset) const;
+  QString string(uint32_t offset) const;
+
+ private:
+  QFile m_file;
+  QByteArray m_buffer;
+
+  const uchar* m_data = nullptr;
+  const uchar* m_countries = nullptr;
+  const uchar* m_cities = nullptr;
+  const uchar* m_servers = nullptr;
+  const uchar* m_portRanges = nullptr;
+  const uchar* m_strings = nullptr;
+
+  uint32_t m_countryCount = 0;
+  uint32_t m_cityCount = 0;
+  uint32_t m_serverCount = 0;
+  uint32_t m_portRangeCount = 0;
+  uint32_t m_stringTableSize = 0;
+};
+
+#endif  // SERVERCATALOG_H
@@ -7,6 +7,7 @@
 #include <QJsonArray>
 #include <QJsonObject>
 #include <QJsonValue>
+#include <QStringList>
 
 #include "constants.h"
 #include "feature.h"
@@ -14,7 +15,9 @@
 #include "location.h"
 #include "mozillavpn.h"
 #include "servercountrymodel.h"
+#include "servercatalog.h"
 #include "serveri18n.h"
+#include "serverkeys.h"
 #include "serverlatency.h"
 
 // Latency threshold for excellent connections, set intentionally very low.
@@ -40,6 +43,7 @@ ServerCity& ServerCity::operator=(const ServerCity& other) {
   m_name = other.m_name;
   m_code = other.m_code;
   m_country = other.m_country;
+  m_hashKey = other.m_hashKey;
   m_latitude = other.m_latitude;
   m_longitude = other.m_longitude;
   m_servers = other.m_servers;
@@ -75,7 +79,7 @@ bool ServerCity::fromJson(const QJsonObject& obj, const QString& country) {
     return false;
   }
 
-  QList<QString> servers;
+  QList<uint32_t> servers;
   if (!Constants::inProduction() || !name.toString().contains("BETA")) {
     QJsonArray serversArray = serversValue.toArray();
     for (const QJsonValue& serverValue : serversArray) {
@@ -89,7 +93,7 @@ bool ServerCity::fromJson(const QJsonObject& obj, const QString& country) {
         return false;
       }
 
-      servers.append(pubkeyValue.toString());
+      servers.append(ServerKeys::intern(pubkeyValue.toString()));
     }
   }
 
@@ -104,6 +108,45 @@ bool ServerCity::fromJson(const QJsonObject& obj, const QString& country) {
   return true;
 }
 
+bool ServerCity::fromCatalog(const ServerCatalog& catalog, uint32_t index,
+                             const QString& country) {
+  ServerCatalog::CityRecord record = catalog.city(index);
+
+  QStringList publicKeys;
+  publicKeys.reserve(record.serverCount);
+  for (uint32_t i = 0; i < record.serverCount; ++i) {
+    publicKeys.append(catalog.serverPublicKey(record.firstServer + i));
+  }
+
+  return fromRecord(record, publicKeys, country);
+}
+
+bool ServerCity::fromRecord(const ServerCatalog::CityRecord& record,
+                            const QStringList& publicKeys,
+                            const QString& country) {
+  if (record.name.isEmpty()) {
+    return false;
+  }
+
+  QList<uint32_t> servers;
+  if (!Constants::inProduction() || !record.name.contains("BETA")) {
+    servers.reserve(publicKeys.count());
+    for (const QString& publicKey : publicKeys) {
+      servers.append(ServerKeys::intern(publicKey));
+    }
+  }
+
+  m_name = record.name;
+  m_code = record.code;
+  m_country = country;
+  m_hashKey = hashKey(m_country, m_name);
+  m_latitude = record.latitude;
+  m_longitude = record.longitude;
+  m_servers.swap(servers);
+
+  return true;
+}
+
 // static
 QString ServerCity::hashKey(const QString& country, const QString cityName) {
   return cityName + "," + country;
@@ -114,21 +157,7 @@ const QString ServerCity::localizedName() const {
 }
 
 qint64 ServerCity::latency() const {
-  ServerLatency* serverLatency = MozillaVPN::instance()->serverLatency();
-  int numLatencySamples = 0;
-  qint64 sumLatencyMsec = 0;
-  for (const QString& pubkey : m_servers) {
-    qint64 rtt = serverLatency->getLatency(pubkey);
-    if (rtt > 0) {
-      sumLatencyMsec += rtt;
-      numLatencySamples++;
-    }
-  }
-
-  if (numLatencySamples == 0) {
-    return 0;
-  }
-  return (sumLatencyMsec + numLatencySamples - 1) / numLatencySamples;
+  return MozillaVPN::instance()->serverLatency()->cityLatency(this);
 }
 
 int ServerCity::connectionScore() const {
@@ -8,8 +8,10 @@
 #include <QList>
 #include <QObject>
 #include <QString>
+#include <QStringList>
 
 #include "server.h"
+#include "servercatalog.h"
 
 class QJsonObject;
 
@@ -31,6 +33,11 @@ class ServerCity final : public QObject {
   ~ServerCity();
 
   [[nodiscard]] bool fromJson(const QJsonObject& obj, const QString& country);
+  [[nodiscard]] bool fromCatalog(const ServerCatalog& catalog, uint32_t index,
+                                 const QString& country);
+  [[nodiscard]] bool fromRecord(const ServerCatalog::CityRecord& record,
+                                const QStringList& publicKeys,
+                                const QString& country);
 
   bool initialized() const { return !m_name.isEmpty(); }
 
@@ -56,7 +63,8 @@ class ServerCity final : public QObject {
 
   qint64 latency() const;
 
-  const QList<QString> servers() const { return m_servers; }
+  // Interned ids of the servers of this city. See ServerKeys.
+  const QList<uint32_t>& servers() const { return m_servers; }
 
  signals:
   void scoreChanged() const;
@@ -69,7 +77,7 @@ class ServerCity final : public QObject {
   double m_latitude;
   double m_longitude;
 
-  QList<QString> m_servers;
+  QList<uint32_t> m_servers;
 };
 
 #endif  // SERVERCITY_H
@@ -11,6 +11,7 @@
 
 #include "collator.h"
 #include "leakdetector.h"
+#include "servercatalog.h"
 #include "serverdata.h"
 #include "serveri18n.h"
 
@@ -73,6 +74,29 @@ bool ServerCountry::fromJson(const QJsonObject& countryObj) {
   return true;
 }
 
+bool ServerCountry::fromCatalog(const ServerCatalog& catalog, uint32_t index) {
+  ServerCatalog::CountryRecord record = catalog.country(index);
+
+  QList<QString> cityNames;
+  cityNames.reserve(record.cityCount);
+  for (uint32_t i = 0; i < record.cityCount; ++i) {
+    cityNames.append(catalog.city(record.firstCity + i).name);
+  }
+
+  return fromRecord(record, std::move(cityNames));
+}
+
+bool ServerCountry::fromRecord(const ServerCatalog::CountryRecord& record,
+                               QList<QString> cityNames) {
+  m_name = record.name;
+  m_code = record.code;
+  m_cities.swap(cityNames);
+
+  sortCities();
+
+  return true;
+}
+
 namespace {
 
 bool sortCityCallback(const QString& a, const QString& b,
@@ -8,6 +8,7 @@
 #include <QList>
 #include <QString>
 
+#include "servercatalog.h"
 #include "servercity.h"
 
 class QJsonObject;
@@ -20,6 +21,9 @@ class ServerCountry final {
   ~ServerCountry();
 
   [[nodiscard]] bool fromJson(const QJsonObject& obj);
+  [[nodiscard]] bool fromCatalog(const ServerCatalog& catalog, uint32_t index);
+  [[nodiscard]] bool fromRecord(const ServerCatalog::CountryRecord& record,
+                                QList<QString> cityNames);
 
   const QString& name() const { return m_name; }
 
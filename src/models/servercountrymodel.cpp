@@ -4,10 +4,13 @@
 
 #include "servercountrymodel.h"
 
-#include <QJsonArray>
-#include <QJsonDocument>
-#include <QJsonObject>
+#include <QCryptographicHash>
+#include <QDir>
+#include <QElapsedTimer>
 #include <QRandomGenerator>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <utility>
 
 #include "collator.h"
 #include "constants.h"
@@ -16,16 +19,40 @@
 #include "logger.h"
 #include "mozillavpn.h"
 #include "recommendedlocationmodel.h"
+#include "servercatalog.h"
 #include "servercountry.h"
 #include "serverdata.h"
 #include "serveri18n.h"
+#include "serverjsonreader.h"
+#include "serverkeys.h"
 #include "serverlatency.h"
 #include "settingsholder.h"
 
 namespace {
 Logger logger("ServerCountryModel");
+
+constexpr const char* SNAPSHOT_FILENAME = "servers.snapshot";
+
+QString snapshotFolder() {
+#ifdef MZ_WASM
+  // https://wiki.qt.io/Qt_for_WebAssembly#Files_and_local_file_system_access
+  return "/";
+#elif defined(UNIT_TEST)
+  return QStandardPaths::writableLocation(QStandardPaths::TempLocation);
+#else
+  return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+#endif
+}
+
+QString snapshotFileName() {
+  return QDir(snapshotFolder()).filePath(SNAPSHOT_FILENAME);
 }
 
+QByteArray jsonDigest(const QByteArray& json) {
+  return QCryptographicHash::hash(json, QCryptographicHash::Sha256);
+}
+}  // namespace
+
 ServerCountryModel::ServerCountryModel() { MZ_COUNT_CTOR(ServerCountryModel); }
 
 ServerCountryModel::~ServerCountryModel() { MZ_COUNT_DTOR(ServerCountryModel); }
@@ -37,18 +64,83 @@ bool ServerCountryModel::fromSettings() {
   logger.debug() << "Reading the server list from settings";
 
   const QByteArray json = settingsHolder->servers();
-  if (json.isEmpty() || !fromJsonInternal(json)) {
+  if (json.isEmpty()) {
     return false;
   }
 
-  m_rawJson = json;
+  if (!fromSnapshot(json)) {
+    if (!fromJsonInternal(json)) {
+      return false;
+    }
+
+    writeSnapshot(json);
+  }
+
+  m_digest = jsonDigest(json);
   return true;
 }
 
+bool ServerCountryModel::fromSettingsLazily() {
+  SettingsHolder* settingsHolder = SettingsHolder::instance();
+  Q_ASSERT(settingsHolder);
+
+  const QByteArray json = settingsHolder->servers();
+  if (json.isEmpty()) {
+    return false;
+  }
+
+  // The snapshot is only written for a valid list: a list matching it can
+  // be read later. Any other list is read, and validated, now.
+  ServerCatalog catalog;
+  if (!catalog.load(snapshotFileName()) || !catalog.matches(json)) {
+    return fromSettings();
+  }
+
+  logger.debug() << "Deferring the server list from settings";
+
+  m_digest.clear();
+  m_pendingJson = json;
+
+  // The views are bound to the empty model: the list is read once the
+  // startup is done, and they are notified by a model reset. The C++
+  // accessors read it earlier if they need it.
+  QMetaObject::invokeMethod(
+      this, [this]() { maybeHydrate(); }, Qt::QueuedConnection);
+  return true;
+}
+
+void ServerCountryModel::maybeHydrate() const {
+  if (m_pendingJson.isEmpty()) {
+    return;
+  }
+
+  const QByteArray json = std::exchange(m_pendingJson, QByteArray());
+
+  QElapsedTimer timer;
+  timer.start();
+
+  // The reset is notified: the views bound to the empty model need it.
+  ServerCountryModel* model = const_cast<ServerCountryModel*>(this);
+
+  if (!model->fromSnapshot(json)) {
+    if (!model->fromJsonInternal(json)) {
+      // The model stays uninitialized until the next server list fetch.
+      logger.error() << "Invalid server list in the settings";
+      return;
+    }
+
+    writeSnapshot(json);
+  }
+
+  model->m_digest = jsonDigest(json);
+  logger.debug() << "Server list read in" << timer.elapsed() << "msec";
+}
+
 bool ServerCountryModel::fromJson(const QByteArray& s) {
   logger.debug() << "Reading from JSON";
 
-  if (!s.isEmpty() && m_rawJson == s) {
+  const QByteArray digest = jsonDigest(s);
+  if (!s.isEmpty() && (m_pendingJson == s || m_digest == digest)) {
     logger.debug() << "Nothing has changed";
     return true;
   }
@@ -57,7 +149,9 @@ bool ServerCountryModel::fromJson(const QByteArray& s) {
     return false;
   }
 
-  m_rawJson = s;
+  writeSnapshot(s);
+
+  m_digest = digest;
   emit changed();
   return true;
 }
@@ -65,75 +159,133 @@ bool ServerCountryModel::fromJson(const QByteArray& s) {
 bool ServerCountryModel::fromJsonInternal(const QByteArray& s) {
   beginResetModel();
 
-  m_rawJson = "";
+  m_digest.clear();
+  m_pendingJson.clear();
   m_countries.clear();
   m_cities.clear();
   m_servers.clear();
 
-  QJsonDocument doc = QJsonDocument::fromJson(s);
-  if (!doc.isObject()) {
+  // The list is streamed: only one country at a time is held besides the
+  // model itself.
+  auto loadCountry = [this](ServerJsonReader::Country& countryRecord) {
+    if (countryRecord.cities.isEmpty()) {
+      return true;
+    }
+
+    QList<QString> cityNames;
+    cityNames.reserve(countryRecord.cities.count());
+    for (const ServerJsonReader::City& cityRecord : countryRecord.cities) {
+      cityNames.append(cityRecord.record.name);
+    }
+
+    ServerCountry country;
+    if (!country.fromRecord(countryRecord.record, std::move(cityNames))) {
+      return false;
+    }
+
+    for (ServerJsonReader::City& cityRecord : countryRecord.cities) {
+      QStringList publicKeys;
+      publicKeys.reserve(cityRecord.servers.count());
+      for (const ServerCatalog::ServerRecord& record : cityRecord.servers) {
+        publicKeys.append(record.publicKey);
+      }
+
+      ServerCity city;
+      if (!city.fromRecord(cityRecord.record, publicKeys, country.code())) {
+        return false;
+      }
+      m_cities[city.hashKey()] = city;
+
+      for (ServerCatalog::ServerRecord& record : cityRecord.servers) {
+        Server server(country.code(), city.name());
+        if (!server.fromRecord(std::move(record))) {
+          return false;
+        }
+        m_servers[server.id()] = server;
+      }
+    }
+
+    m_countries.append(country);
+    return true;
+  };
+
+  if (!ServerJsonReader::read(s, loadCountry)) {
+    m_countries.clear();
+    m_cities.clear();
+    m_servers.clear();
+    endResetModel();
     return false;
   }
 
-  QJsonObject obj = doc.object();
+  sortCountries();
+
+  endResetModel();
+
+  return true;
+}
+
+bool ServerCountryModel::fromSnapshot(const QByteArray& data) {
+  ServerCatalog catalog;
+  if (!catalog.load(snapshotFileName())) {
+    return false;
+  }
 
-  QJsonValue countries = obj.value("countries");
-  if (!countries.isArray()) {
+  if (!catalog.matches(data)) {
+    logger.debug() << "The server snapshot is outdated";
     return false;
   }
 
-  QJsonArray countriesArray = countries.toArray();
-  for (const QJsonValue& countryValue : countriesArray) {
-    if (!countryValue.isObject()) {
-      return false;
-    }
+  logger.debug() << "Reading the server list from the snapshot";
 
-    QJsonObject countryObj = countryValue.toObject();
+  beginResetModel();
 
-    ServerCountry country;
-    if (!country.fromJson(countryObj)) {
-      return false;
-    }
+  m_digest.clear();
+  m_pendingJson.clear();
+  m_countries.clear();
+  m_cities.clear();
+  m_servers.clear();
 
-    if (country.cities().isEmpty()) {
+  bool ok = true;
+  for (uint32_t i = 0; ok && i < catalog.countryCount(); ++i) {
+    ServerCountry country;
+    ok = country.fromCatalog(catalog, i);
+    if (!ok || country.cities().isEmpty()) {
       continue;
     }
 
     m_countries.append(country);
 
-    QJsonValue cities = countryObj.value("cities");
-    if (!cities.isArray()) {
-      return false;
-    }
-
-    QJsonArray cityArray = cities.toArray();
-    for (const QJsonValue& cityValue : cityArray) {
-      if (!cityValue.isObject()) {
-        return false;
-      }
-      QJsonObject cityObj = cityValue.toObject();
-      QJsonValue servers = cityObj.value("servers");
-      if (!servers.isArray()) {
-        return false;
-      }
+    ServerCatalog::CountryRecord record = catalog.country(i);
+    for (uint32_t j = 0; ok && j < record.cityCount; ++j) {
+      uint32_t cityIndex = record.firstCity + j;
 
       ServerCity city;
-      if (!city.fromJson(cityObj, country.code())) {
-        return false;
+      ok = city.fromCatalog(catalog, cityIndex, country.code());
+      if (!ok) {
+        continue;
       }
       m_cities[city.hashKey()] = city;
 
-      QJsonArray serverArray = servers.toArray();
-      for (const QJsonValue& serverValue : serverArray) {
+      ServerCatalog::CityRecord cityRecord = catalog.city(cityIndex);
+      for (uint32_t k = 0; ok && k < cityRecord.serverCount; ++k) {
         Server server(country.code(), city.name());
-        if (!server.fromJson(serverValue.toObject())) {
-          return false;
+        ok = server.fromCatalog(catalog, cityRecord.firstServer + k);
+        if (ok) {
+          m_servers[server.id()] = server;
         }
-        m_servers[server.publicKey()] = server;
       }
     }
   }
 
+  if (!ok) {
+    logger.error() << "Invalid server snapshot";
+    m_countries.clear();
+    m_cities.clear();
+    m_servers.clear();
+    endResetModel();
+    return false;
+  }
+
   sortCountries();
 
   endResetModel();
@@ -141,6 +293,25 @@ bool ServerCountryModel::fromJsonInternal(const QByteArray& s) {
   return true;
 }
 
+void ServerCountryModel::writeSnapshot(const QByteArray& data) const {
+  QDir folder(snapshotFolder());
+  if (!folder.exists() && !folder.mkpath(".")) {
+    logger.warning() << "Unable to create the server snapshot folder";
+    return;
+  }
+
+  QSaveFile file(folder.filePath(SNAPSHOT_FILENAME));
+  if (!file.open(QIODevice::WriteOnly)) {
+    logger.warning() << "Unable to open the server snapshot";
+    return;
+  }
+
+  file.write(ServerCatalog::serialize(data, m_countries, m_cities, m_servers));
+  if (!file.commit()) {
+    logger.warning() << "Unable to write the server snapshot";
+  }
+}
+
 QHash<int, QByteArray> ServerCountryModel::roleNames() const {
   QHash<int, QByteArray> roles;
   roles[NameRole] = "name";
@@ -202,11 +373,14 @@ QStringList ServerCountryModel::pickBest() const {
 bool ServerCountryModel::exists(const QString& countryCode,
                                 const QString& cityName) const {
   logger.debug() << "Check if the server is still valid.";
+  maybeHydrate();
   return m_cities.contains(ServerCity::hashKey(countryCode, cityName));
 }
 
 const ServerCity& ServerCountryModel::findCity(const QString& countryCode,
                                                const QString& cityName) const {
+  maybeHydrate();
+
   auto index = m_cities.constFind(ServerCity::hashKey(countryCode, cityName));
   if (index == m_cities.end()) {
     static const ServerCity emptycity;
@@ -217,7 +391,13 @@ const ServerCity& ServerCountryModel::findCity(const QString& countryCode,
 }
 
 const Server& ServerCountryModel::server(const QString& pubkey) const {
-  auto iterator = m_servers.constFind(pubkey);
+  return server(ServerKeys::find(pubkey));
+}
+
+const Server& ServerCountryModel::server(uint32_t id) const {
+  maybeHydrate();
+
+  auto iterator = m_servers.constFind(id);
   if (iterator != m_servers.constEnd()) {
     return iterator.value();
   }
@@ -228,6 +408,8 @@ const Server& ServerCountryModel::server(const QString& pubkey) const {
 
 const QString ServerCountryModel::countryName(
     const QString& countryCode) const {
+  maybeHydrate();
+
   for (const ServerCountry& country : m_countries) {
     if (country.code() == countryCode) {
       return country.name();
@@ -238,6 +420,8 @@ const QString ServerCountryModel::countryName(
 }
 
 void ServerCountryModel::retranslate() {
+  maybeHydrate();
+
   beginResetModel();
   sortCountries();
   endResetModel();
@@ -248,13 +432,15 @@ void ServerCountryModel::setCooldownForAllServersInACity(
   logger.debug() << "Set cooldown for all servers for: "
                  << logger.sensitive(countryCode) << logger.sensitive(cityCode);
 
+  maybeHydrate();
+
   for (const ServerCity& city : m_cities) {
     if (city.code() != cityCode) {
       continue;
     }
-    for (const QString& pubkey : city.servers()) {
+    for (uint32_t id : city.servers()) {
       MozillaVPN::instance()->serverLatency()->setCooldown(
-          pubkey, Constants::SERVER_UNRESPONSIVE_COOLDOWN_SEC);
+          id, Constants::SERVER_UNRESPONSIVE_COOLDOWN_SEC);
     }
   }
 }
@@ -30,9 +30,23 @@ class ServerCountryModel final : public QAbstractListModel {
 
   [[nodiscard]] bool fromSettings();
 
+  // As fromSettings(), but a list matching the snapshot is only read after
+  // the startup, or when the C++ accessors first need it. This keeps the
+  // catalog out of the startup path. The other lists are read now.
+  [[nodiscard]] bool fromSettingsLazily();
+
   [[nodiscard]] bool fromJson(const QByteArray& data);
 
-  bool initialized() const { return !m_rawJson.isEmpty(); }
+  bool initialized() const {
+    return !m_digest.isEmpty() || !m_pendingJson.isEmpty();
+  }
+
+  // SHA-256 of the JSON of the current server list. Empty until the list is
+  // read.
+  const QByteArray& digest() const {
+    maybeHydrate();
+    return m_digest;
+  }
 
   QStringList pickBest() const;
 
@@ -40,13 +54,20 @@ class ServerCountryModel final : public QAbstractListModel {
   const ServerCity& findCity(const QString& countryCode,
                              const QString& cityName) const;
 
+  const Server& server(uint32_t id) const;
   const Server& server(const QString& pubkey) const;
 
   const QString countryName(const QString& countryCode) const;
 
-  const QHash<QString, ServerCity>& cities() const { return m_cities; }
+  const QHash<QString, ServerCity>& cities() const {
+    maybeHydrate();
+    return m_cities;
+  }
 
-  const QList<ServerCountry>& countries() const { return m_countries; }
+  const QList<ServerCountry>& countries() const {
+    maybeHydrate();
+    return m_countries;
+  }
 
   void retranslate();
   void setCooldownForAllServersInACity(const QString& countryCode,
@@ -56,6 +77,8 @@ class ServerCountryModel final : public QAbstractListModel {
 
   QHash<int, QByteArray> roleNames() const override;
 
+  // The views do not read the deferred list: they are notified by a model
+  // reset when it is read.
   int rowCount(const QModelIndex&) const override {
     return static_cast<int>(m_countries.length());
   }
@@ -68,14 +91,27 @@ class ServerCountryModel final : public QAbstractListModel {
  private:
   [[nodiscard]] bool fromJsonInternal(const QByteArray& data);
 
+  // The binary snapshot of the server list lets us skip the JSON parsing at
+  // startup. See ServerCatalog.
+  [[nodiscard]] bool fromSnapshot(const QByteArray& data);
+  void writeSnapshot(const QByteArray& data) const;
+
   void sortCountries();
 
+  void maybeHydrate() const;
+
  private:
-  QByteArray m_rawJson;
+  // SHA-256 of the JSON of the current server list. The JSON itself is not
+  // kept: the list is only compared against the next one.
+  QByteArray m_digest;
+
+  // The JSON that has not been read yet. See fromSettingsLazily().
+  mutable QByteArray m_pendingJson;
 
   QList<ServerCountry> m_countries;
   QHash<QString, ServerCity> m_cities;
-  QHash<QString, Server> m_servers;
+  // Keyed by the interned id of the public key. See ServerKeys.
+  QHash<uint32_t, Server> m_servers;
 };
 
 #endif  // SERVERCOUNTRYMODEL_H
@@ -280,9 +280,9 @@ QList<Server> ServerData::getServerList(const QString& countryCode,
   QList<Server> results;
   qint64 now = QDateTime::currentSecsSinceEpoch();
 
-  for (const QString& pubkey : city.servers()) {
-    const Server& server = scm->server(pubkey);
-    if (server.initialized() && (serverLatency->getCooldown(pubkey) <= now)) {
+  for (uint32_t id : city.servers()) {
+    const Server& server = scm->server(id);
+    if (server.initialized() && (serverLatency->getCooldown(id) <= now)) {
       results.append(server);
     }
   }
@@ -0,0 +1,618 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "serverjsonreader.h"
+
+#include <QString>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+// As QJsonDocument.
+constexpr int MAX_NESTING_DEPTH = 1024;
+
+// A pull parser over a JSON buffer. Each method consumes one token (or one
+// value) and returns false if the JSON is invalid at this point.
+class JsonCursor final {
+ public:
+  explicit JsonCursor(const QByteArray& json)
+      : m_pos(json.constData()), m_end(json.constData() + json.size()) {}
+
+  bool failed() const { return m_failed; }
+
+  bool enterObject() { return enter('{'); }
+  bool enterArray() { return enter('['); }
+
+  // Moves to the next member of the current object, and reads its key.
+  // Returns false at the end of the object, or on error.
+  bool nextMember(bool* first, QString* key) {
+    if (!next('}', first)) {
+      return false;
+    }
+
+    if (!readString(key)) {
+      return false;
+    }
+
+    skipWhitespace();
+    if (m_pos == m_end || *m_pos != ':') {
+      return fail();
+    }
+    ++m_pos;
+    return true;
+  }
+
+  // Moves to the next element of the current array. Returns false at the
+  // end of the array, or on error.
+  bool nextElement(bool* first) { return next(']', first); }
+
+  bool readString(QString* value);
+  bool readNumber(double* value);
+  bool skipValue();
+
+  bool atEnd() {
+    skipWhitespace();
+    return !m_failed && m_pos == m_end;
+  }
+
+ private:
+  bool fail() {
+    m_failed = true;
+    return false;
+  }
+
+  void skipWhitespace() {
+    while (m_pos != m_end &&
+           (*m_pos == ' ' || *m_pos == '\t' || *m_pos == '\n' ||
+            *m_pos == '\r')) {
+      ++m_pos;
+    }
+  }
+
+  bool enter(char token) {
+    skipWhitespace();
+    if (m_failed || m_pos == m_end || *m_pos != token ||
+        m_depth >= MAX_NESTING_DEPTH) {
+      return fail();
+    }
+
+    ++m_pos;
+    ++m_depth;
+    return true;
+  }
+
+  bool next(char closeToken, bool* first) {
+    if (m_failed) {
+      return false;
+    }
+
+    skipWhitespace();
+    if (m_pos == m_end) {
+      return fail();
+    }
+
+    if (*m_pos == closeToken) {
+      ++m_pos;
+      --m_depth;
+      return false;
+    }
+
+    if (!*first) {
+      if (*m_pos != ',') {
+        return fail();
+      }
+      ++m_pos;
+    }
+
+    *first = false;
+    return true;
+  }
+
+  bool skipLiteral(const char* literal) {
+    for (; *literal; ++literal, ++m_pos) {
+      if (m_pos == m_end || *m_pos != *literal) {
+        return fail();
+      }
+    }
+    return true;
+  }
+
+  bool readHex(char16_t* value) {
+    if (m_end - m_pos < 4) {
+      return fail();
+    }
+
+    *value = 0;
+    for (int i = 0; i < 4; ++i, ++m_pos) {
+      char c = *m_pos;
+      int digit;
+      if (c >= '0' && c <= '9') {
+        digit = c - '0';
+      } else if (c >= 'a' && c <= 'f') {
+        digit = c - 'a' + 10;
+      } else if (c >= 'A' && c <= 'F') {
+        digit = c - 'A' + 10;
+      } else {
+        return fail();
+      }
+      *value = static_cast<char16_t>(*value * 16 + digit);
+    }
+    return true;
+  }
+
+  bool skipDigits() {
+    const char* start = m_pos;
+    while (m_pos != m_end && *m_pos >= '0' && *m_pos <= '9') {
+      ++m_pos;
+    }
+    return m_pos != start;
+  }
+
+ private:
+  const char* m_pos;
+  const char* m_end;
+  int m_depth = 0;
+  bool m_failed = false;
+};
+
+bool JsonCursor::readString(QString* value) {
+  skipWhitespace();
+  if (m_failed || m_pos == m_end || *m_pos != '"') {
+    return fail();
+  }
+  ++m_pos;
+
+  value->clear();
+
+  // The unescaped runs are decoded at once.
+  const char* run = m_pos;
+  while (true) {
+    if (m_pos == m_end) {
+      return fail();
+    }
+
+    char c = *m_pos;
+    if (static_cast<unsigned char>(c) < 0x20) {
+      return fail();
+    }
+
+    if (c == '"') {
+      value->append(QString::fromUtf8(run, m_pos - run));
+      ++m_pos;
+      return true;
+    }
+
+    if (c != '\\') {
+      ++m_pos;
+      continue;
+    }
+
+    value->append(QString::fromUtf8(run, m_pos - run));
+    if (++m_pos == m_end) {
+      return fail();
+    }
+
+    switch (*m_pos++) {
+      case '"':
+        value->append(u'"');
+        break;
+      case '\\':
+        value->append(u'\\');
+        break;
+      case '/':
+        value->append(u'/');
+        break;
+      case 'b':
+        value->append(u'\b');
+        break;
+      case 'f':
+        value->append(u'\f');
+        break;
+      case 'n':
+        value->append(u'\n');
+        break;
+      case 'r':
+        value->append(u'\r');
+        break;
+      case 't':
+        value->append(u'\t');
+        break;
+      case 'u': {
+        // Surrogate pairs are two escapes: QString keeps UTF-16 anyway.
+        char16_t unit;
+        if (!readHex(&unit)) {
+          return false;
+        }
+        value->append(QChar(unit));
+        break;
+      }
+      default:
+        return fail();
+    }
+
+    run = m_pos;
+  }
+}
+
+bool JsonCursor::readNumber(double* value) {
+  skipWhitespace();
+  if (m_failed) {
+    return false;
+  }
+
+  const char* start = m_pos;
+  if (m_pos != m_end && *m_pos == '-') {
+    ++m_pos;
+  }
+
+  // No leading zeros.
+  if (m_pos != m_end && *m_pos == '0') {
+    ++m_pos;
+  } else if (!skipDigits()) {
+    return fail();
+  }
+
+  if (m_pos != m_end && *m_pos == '.') {
+    ++m_pos;
+    if (!skipDigits()) {
+      return fail();
+    }
+  }
+
+  if (m_pos != m_end && (*m_pos == 'e' || *m_pos == 'E')) {
+    ++m_pos;
+    if (m_pos != m_end && (*m_pos == '+' || *m_pos == '-')) {
+      ++m_pos;
+    }
+    if (!skipDigits()) {
+      return fail();
+    }
+  }
+
+  bool ok = false;
+  *value = QByteArray::fromRawData(start, m_pos - start).toDouble(&ok);
+  return ok || fail();
+}
+
+bool JsonCursor::skipValue() {
+  skipWhitespace();
+  if (m_failed || m_pos == m_end) {
+    return fail();
+  }
+
+  switch (*m_pos) {
+    case '{': {
+      if (!enterObject()) {
+        return false;
+      }
+
+      bool first = true;
+      QString key;
+      while (nextMember(&first, &key)) {
+        if (!skipValue()) {
+          return false;
+        }
+      }
+      return !m_failed;
+    }
+
+    case '[': {
+      if (!enterArray()) {
+        return false;
+      }
+
+      bool first = true;
+      while (nextElement(&first)) {
+        if (!skipValue()) {
+          return false;
+        }
+      }
+      return !m_failed;
+    }
+
+    case '"': {
+      QString value;
+      return readString(&value);
+    }
+
+    case 't':
+      return skipLiteral("true");
+
+    case 'f':
+      return skipLiteral("false");
+
+    case 'n':
+      return skipLiteral("null");
+
+    default: {
+      double value;
+      return readNumber(&value);
+    }
+  }
+}
+
+// As QJsonValue::toInt(): a number that is not an integer is 0.
+int toInt(double value) {
+  if (value < std::numeric_limits<int>::min() ||
+      value > std::numeric_limits<int>::max() || std::trunc(value) != value) {
+    return 0;
+  }
+
+  return static_cast<int>(value);
+}
+
+// The optional members keep their default value if they have another type,
+// as the QJsonValue conversions.
+bool readOptionalString(JsonCursor& cursor, QString* value) {
+  QString string;
+  // The type is only known by reading the value.
+  JsonCursor lookahead = cursor;
+  if (lookahead.readString(&string)) {
+    cursor = lookahead;
+    *value = string;
+    return true;
+  }
+
+  value->clear();
+  return cursor.skipValue();
+}
+
+bool readOptionalInt(JsonCursor& cursor, int* value) {
+  double number;
+  JsonCursor lookahead = cursor;
+  if (lookahead.readNumber(&number)) {
+    cursor = lookahead;
+    *value = toInt(number);
+    return true;
+  }
+
+  *value = 0;
+  return cursor.skipValue();
+}
+
+bool readPortRanges(JsonCursor& cursor,
+                    QList<QPair<uint32_t, uint32_t>>* portRanges) {
+  if (!cursor.enterArray()) {
+    return false;
+  }
+
+  bool first = true;
+  while (cursor.nextElement(&first)) {
+    if (!cursor.enterArray()) {
+      return false;
+    }
+
+    double ports[2];
+    int count = 0;
+    bool firstPort = true;
+    while (cursor.nextElement(&firstPort)) {
+      if (count == 2 || !cursor.readNumber(&ports[count])) {
+        return false;
+      }
+      ++count;
+    }
+
+    if (cursor.failed() || count != 2) {
+      return false;
+    }
+
+    portRanges->append(
+        QPair<uint32_t, uint32_t>(toInt(ports[0]), toInt(ports[1])));
+  }
+
+  return !cursor.failed();
+}
+
+enum ServerMember : uint32_t {
+  ServerHostname = 1 << 0,
+  ServerIpv4AddrIn = 1 << 1,
+  ServerIpv4Gateway = 1 << 2,
+  ServerIpv6Gateway = 1 << 3,
+  ServerPublicKey = 1 << 4,
+  ServerWeight = 1 << 5,
+  ServerPortRanges = 1 << 6,
+  ServerRequired = (1 << 7) - 1,
+};
+
+bool readServer(JsonCursor& cursor, ServerCatalog::ServerRecord* server) {
+  if (!cursor.enterObject()) {
+    return false;
+  }
+
+  uint32_t members = 0;
+  bool first = true;
+  QString key;
+  while (cursor.nextMember(&first, &key)) {
+    bool ok;
+    if (key == "hostname") {
+      ok = cursor.readString(&server->hostname);
+      members |= ServerHostname;
+    } else if (key == "ipv4_addr_in") {
+      ok = cursor.readString(&server->ipv4AddrIn);
+      members |= ServerIpv4AddrIn;
+    } else if (key == "ipv4_gateway") {
+      ok = cursor.readString(&server->ipv4Gateway);
+      members |= ServerIpv4Gateway;
+    } else if (key == "ipv6_addr_in") {
+      // Missing in the lists migrated from iOS.
+      ok = readOptionalString(cursor, &server->ipv6AddrIn);
+    } else if (key == "ipv6_gateway") {
+      ok = cursor.readString(&server->ipv6Gateway);
+      members |= ServerIpv6Gateway;
+    } else if (key == "public_key") {
+      ok = cursor.readString(&server->publicKey);
+      members |= ServerPublicKey;
+    } else if (key == "weight") {
+      double weight;
+      ok = cursor.readNumber(&weight);
+      server->weight = toInt(weight);
+      members |= ServerWeight;
+    } else if (key == "port_ranges") {
+      server->portRanges.clear();
+      ok = readPortRanges(cursor, &server->portRanges);
+      members |= ServerPortRanges;
+    } else if (key == "socks5_name") {
+      ok = readOptionalString(cursor, &server->socksName);
+    } else if (key == "multihop_port") {
+      int port;
+      ok = readOptionalInt(cursor, &port);
+      server->multihopPort = port;
+    } else {
+      ok = cursor.skipValue();
+    }
+
+    if (!ok) {
+      return false;
+    }
+  }
+
+  return !cursor.failed() && members == ServerRequired;
+}
+
+enum CityMember : uint32_t {
+  CityName = 1 << 0,
+  CityCode = 1 << 1,
+  CityLatitude = 1 << 2,
+  CityLongitude = 1 << 3,
+  CityServers = 1 << 4,
+  CityRequired = (1 << 5) - 1,
+};
+
+bool readCity(JsonCursor& cursor, ServerJsonReader::City* city) {
+  if (!cursor.enterObject()) {
+    return false;
+  }
+
+  uint32_t members = 0;
+  bool first = true;
+  QString key;
+  while (cursor.nextMember(&first, &key)) {
+    bool ok;
+    if (key == "name") {
+      ok = cursor.readString(&city->record.name);
+      members |= CityName;
+    } else if (key == "code") {
+      ok = cursor.readString(&city->record.code);
+      members |= CityCode;
+    } else if (key == "latitude") {
+      ok = cursor.readNumber(&city->record.latitude);
+      members |= CityLatitude;
+    } else if (key == "longitude") {
+      ok = cursor.readNumber(&city->record.longitude);
+      members |= CityLongitude;
+    } else if (key == "servers") {
+      city->servers.clear();
+      ok = cursor.enterArray();
+
+      bool firstServer = true;
+      while (ok && cursor.nextElement(&firstServer)) {
+        ServerCatalog::ServerRecord server;
+        ok = readServer(cursor, &server);
+        city->servers.append(std::move(server));
+      }
+
+      ok = ok && !cursor.failed();
+      members |= CityServers;
+    } else {
+      ok = cursor.skipValue();
+    }
+
+    if (!ok) {
+      return false;
+    }
+  }
+
+  city->record.serverCount = static_cast<uint32_t>(city->servers.count());
+  return !cursor.failed() && members == CityRequired;
+}
+
+enum CountryMember : uint32_t {
+  CountryName = 1 << 0,
+  CountryCode = 1 << 1,
+  CountryCities = 1 << 2,
+  CountryRequired = (1 << 3) - 1,
+};
+
+bool readCountry(JsonCursor& cursor, ServerJsonReader::Country* country) {
+  if (!cursor.enterObject()) {
+    return false;
+  }
+
+  uint32_t members = 0;
+  bool first = true;
+  QString key;
+  while (cursor.nextMember(&first, &key)) {
+    bool ok;
+    if (key == "name") {
+      ok = cursor.readString(&country->record.name);
+      members |= CountryName;
+    } else if (key == "code") {
+      ok = cursor.readString(&country->record.code);
+      members |= CountryCode;
+    } else if (key == "cities") {
+      country->cities.clear();
+      ok = cursor.enterArray();
+
+      bool firstCity = true;
+      while (ok && cursor.nextElement(&firstCity)) {
+        ServerJsonReader::City city;
+        ok = readCity(cursor, &city) && !city.record.name.isEmpty();
+        country->cities.append(std::move(city));
+      }
+
+      ok = ok && !cursor.failed();
+      members |= CountryCities;
+    } else {
+      ok = cursor.skipValue();
+    }
+
+    if (!ok) {
+      return false;
+    }
+  }
+
+  country->record.cityCount = static_cast<uint32_t>(country->cities.count());
+  return !cursor.failed() && members == CountryRequired;
+}
+
+}  // namespace
+
+// static
+bool ServerJsonReader::read(
+    const QByteArray& json,
+    const std::function<bool(Country& country)>& callback) {
+  JsonCursor cursor(json);
+  if (!cursor.enterObject()) {
+    return false;
+  }
+
+  bool hasCountries = false;
+  bool first = true;
+  QString key;
+  while (cursor.nextMember(&first, &key)) {
+    if (key != "countries") {
+      if (!cursor.skipValue()) {
+        return false;
+      }
+      continue;
+    }
+
+    if (!cursor.enterArray()) {
+      return false;
+    }
+
+    bool firstCountry = true;
+    while (cursor.nextElement(&firstCountry)) {
+      Country country;
+      if (!readCountry(cursor, &country) || !callback(country)) {
+        return false;
+      }
+    }
+
+    hasCountries = true;
+  }
+
+  return cursor.atEnd() && hasCountries;
+}
@@ -0,0 +1,40 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef SERVERJSONREADER_H
+#define SERVERJSONREADER_H
+
+#include <QByteArray>
+#include <QList>
+#include <functional>
+
+#include "servercatalog.h"
+
+// Streaming reader of the server list. The records are built directly from
+// the tokens of the JSON: no QJsonDocument is created, and only one country
+// is held at a time. The validation is the one of the JSON loaders of
+// Server, ServerCity and ServerCountry.
+class ServerJsonReader final {
+ public:
+  struct City {
+    ServerCatalog::CityRecord record;
+    QList<ServerCatalog::ServerRecord> servers;
+  };
+
+  struct Country {
+    ServerCatalog::CountryRecord record;
+    QList<City> cities;
+  };
+
+  // Calls `callback` for each country, as soon as it is read. Returns false
+  // if the JSON is invalid or if the callback returns false: the countries
+  // reported so far must then be discarded.
+  static bool read(const QByteArray& json,
+                   const std::function<bool(Country& country)>& callback);
+
+ private:
+  ServerJsonReader() = default;
+};
+
+#endif  // SERVERJSONREADER_H
@@ -0,0 +1,48 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "serverkeys.h"
+
+#include <QHash>
+#include <QList>
+
+namespace {
+
+// The servers are only loaded on the main thread: the table needs no lock.
+QHash<QString, uint32_t> s_ids;
+QList<QString> s_keys;
+
+}  // namespace
+
+// static
+uint32_t ServerKeys::intern(const QString& publicKey) {
+  auto i = s_ids.constFind(publicKey);
+  if (i != s_ids.cend()) {
+    return i.value();
+  }
+
+  Q_ASSERT(s_keys.count() < Invalid);
+  uint32_t id = static_cast<uint32_t>(s_keys.count());
+  s_keys.append(publicKey);
+  s_ids.insert(publicKey, id);
+  return id;
+}
+
+// static
+uint32_t ServerKeys::find(const QString& publicKey) {
+  return s_ids.value(publicKey, Invalid);
+}
+
+// static
+QString ServerKeys::publicKey(uint32_t id) {
+  if (id >= static_cast<uint32_t>(s_keys.count())) {
+    return QString();
+  }
+  return s_keys.at(id);
+}
+
+// static
+uint32_t ServerKeys::count() {
+  return static_cast<uint32_t>(s_keys.count());
+}
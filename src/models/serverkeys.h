@@ -0,0 +1,37 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef SERVERKEYS_H
+#define SERVERKEYS_H
+
+#include <QString>
+#include <limits>
+
+// Interning table for the server public keys. Each key is assigned a dense
+// 32-bit id the first time it is seen; ids are never reused or released for
+// the whole life of the process, so per-server data can be stored in plain
+// vectors indexed by id. The base64 form is only needed at the boundaries
+// (QML, daemon configuration, logs).
+
+class ServerKeys final {
+ public:
+  static constexpr uint32_t Invalid = std::numeric_limits<uint32_t>::max();
+
+  // Returns the id of the key, assigning a new one if needed.
+  static uint32_t intern(const QString& publicKey);
+
+  // Returns the id of the key, or Invalid if it has never been interned.
+  static uint32_t find(const QString& publicKey);
+
+  // Returns the key of the id, or an empty string for unknown ids.
+  static QString publicKey(uint32_t id);
+
+  // Number of ids assigned so far. Valid ids are in [0, count()).
+  static uint32_t count();
+
+ private:
+  ServerKeys() = delete;
+};
+
+#endif  // SERVERKEYS_H
@@ -35,7 +35,7 @@ bool SubscriptionData::fromJson(const QByteArray& json) {
     return true;
   }
 
-  if (!fromJsonInternal(json)) {
+  if (!fromJsonInternal(QJsonDocument::fromJson(json))) {
     return false;
   }
 
@@ -50,8 +50,8 @@ bool SubscriptionData::fromSettings() {
 
   logger.debug() << "Reading the subscription data from settings";
 
-  const QByteArray& json = settingsHolder->devices();
-  if (json.isEmpty() || !fromJsonInternal(json)) {
+  const QByteArray& json = settingsHolder->subscriptionData();
+  if (json.isEmpty() || !fromJsonInternal(m_prefetch.take(json))) {
     return false;
   }
 
@@ -59,10 +59,13 @@ bool SubscriptionData::fromSettings() {
   return true;
 }
 
-bool SubscriptionData::fromJsonInternal(const QByteArray& json) {
+void SubscriptionData::prefetchSettings() {
+  m_prefetch.start(SettingsHolder::instance()->subscriptionData());
+}
+
+bool SubscriptionData::fromJsonInternal(const QJsonDocument& doc) {
   resetData();
 
-  QJsonDocument doc = QJsonDocument::fromJson(json);
   if (!doc.isObject()) {
     return false;
   }
@@ -7,6 +7,8 @@
 
 #include <QObject>
 
+#include "jsonprefetch.h"
+
 class SubscriptionData final : public QObject {
   Q_OBJECT
   Q_DISABLE_COPY_MOVE(SubscriptionData)
@@ -62,6 +64,10 @@ class SubscriptionData final : public QObject {
 
   [[nodiscard]] bool fromSettings();
 
+  // Starts parsing the subscription data of the settings in the background.
+  // See JsonPrefetch.
+  void prefetchSettings();
+
   void resetData();
 
   void writeSettings();
@@ -70,7 +76,7 @@ class SubscriptionData final : public QObject {
   void changed();
 
  private:
-  bool fromJsonInternal(const QByteArray& json);
+  bool fromJsonInternal(const QJsonDocument& doc);
 
   bool parseSubscriptionDataIap(const QJsonObject& subscriptionData);
   bool parseSubscriptionDataWeb(const QJsonObject& subscriptionData);
@@ -78,6 +84,8 @@ class SubscriptionData final : public QObject {
  private:
   QByteArray m_rawJson;
 
+  JsonPrefetch m_prefetch;
+
   TypeSubscription m_type = SubscriptionUnknown;
   TypeStatus m_status = Inactive;
   quint64 m_createdAt = 0;
@@ -297,12 +297,19 @@ void MozillaVPN::initialize() {
 
   SettingsWatcher::instance();
 
+  m_private->m_telemetry.timeToFirstScreenStage("components");
+
   if (!settingsHolder->hasToken()) {
     return;
   }
 
   logger.debug() << "We have a valid token";
 
+  // The independent models parse their settings on the thread pool while the
+  // user and the keys are read.
+  m_private->m_deviceModel.prefetchSettings();
+  m_private->m_subscriptionData.prefetchSettings();
+
   if (!m_private->m_user.fromSettings()) {
     logger.error() << "No user data found";
     return;
@@ -326,7 +333,10 @@ void MozillaVPN::initialize() {
     return;
   }
 
-  if (!m_private->m_serverCountryModel.fromSettings()) {
+  m_private->m_telemetry.timeToFirstScreenStage("keys");
+
+  // A server list already validated is read after the startup.
+  if (!m_private->m_serverCountryModel.fromSettingsLazily()) {
     logger.error() << "No server list found";
     settingsHolder->clear();
     return;
@@ -338,6 +348,8 @@ void MozillaVPN::initialize() {
     return;
   }
 
+  m_private->m_telemetry.timeToFirstScreenStage("devices");
+
   if (!checkCurrentDevice()) {
     return;
   }
@@ -350,6 +362,8 @@ void MozillaVPN::initialize() {
     // We do not care about SubscriptionData settings.
   }
 
+  m_private->m_telemetry.timeToFirstScreenStage("subscription");
+
   if (!modelsInitialized()) {
     logger.error() << "Models not initialized yet";
     settingsHolder->clear();
@@ -359,12 +373,18 @@ void MozillaVPN::initialize() {
   Q_ASSERT(!m_private->m_serverData.hasServerData());
   if (!m_private->m_serverData.fromSettings()) {
     QStringList list = m_private->m_serverCountryModel.pickBest();
-    Q_ASSERT(list.length() >= 2);
+    if (list.length() < 2) {
+      logger.error() << "No server available";
+      settingsHolder->clear();
+      return;
+    }
 
     m_private->m_serverData.update(list[0], list[1]);
     Q_ASSERT(m_private->m_serverData.hasServerData());
   }
 
+  m_private->m_telemetry.timeToFirstScreenStage("serverData");
+
   scheduleRefreshDataTasks();
   setUserState(UserAuthenticated);
   maybeStateMain();
@@ -1775,6 +1795,25 @@ void MozillaVPN::registerNavigatorScreens() {
       QVector<int>{App::StateOnboarding}, [](int*) -> int8_t { return 0; },
       []() -> bool { return false; });
 
+  // The screens that are compiled in advance.
+  Navigator::registerNextScreens(
+      MozillaVPN::ScreenInitialize,
+      QVector<int>{MozillaVPN::ScreenAuthenticationInApp,
+                   MozillaVPN::ScreenAuthenticating});
+  Navigator::registerNextScreens(MozillaVPN::ScreenTelemetryPolicy,
+                                 QVector<int>{MozillaVPN::ScreenHome});
+  Navigator::registerNextScreens(MozillaVPN::ScreenOnboarding,
+                                 QVector<int>{MozillaVPN::ScreenHome});
+  Navigator::registerNextScreens(
+      MozillaVPN::ScreenHome,
+      QVector<int>{MozillaVPN::ScreenSettings, MozillaVPN::ScreenMessaging,
+                   MozillaVPN::ScreenGetHelp});
+  Navigator::registerNextScreens(
+      MozillaVPN::ScreenSettings,
+      QVector<int>{MozillaVPN::ScreenGetHelp, MozillaVPN::ScreenTipsAndTricks});
+  Navigator::registerNextScreens(MozillaVPN::ScreenGetHelp,
+                                 QVector<int>{MozillaVPN::ScreenViewLogs});
+
   connect(ErrorHandler::instance(), &ErrorHandler::noSubscriptionFound,
           Navigator::instance(), []() {
             Navigator::instance()->requestScreen(
@@ -200,7 +200,11 @@ void NetworkRequest::replyFinished() {
   logger.debug() << "Network reply received - status:" << status
                  << "- expected:" << expect;
 
-  m_replyData.append(m_reply->readAll());
+  if (m_discardReplyBody) {
+    m_reply->skip(m_reply->bytesAvailable());
+  } else {
+    m_replyData.append(m_reply->readAll());
+  }
   processData(m_reply->error(), m_reply->errorString(), status, m_replyData);
 }
 
@@ -236,13 +240,11 @@ void NetworkRequest::processData(QNetworkReply::NetworkError error,
   emit requestCompleted(data);
 }
 
-qint64 NetworkRequest::discardData() {
-  qint64 bytes = m_replyData.count();
-  if (m_reply != nullptr) {
-    bytes += m_reply->skip(m_reply->bytesAvailable());
-  }
-  m_replyData.clear();
-  return bytes;
+void NetworkRequest::discardReplyBody(qint64 readBufferSize) {
+  Q_ASSERT(!m_reply);
+
+  m_discardReplyBody = true;
+  m_readBufferSize = readBufferSize;
 }
 
 bool NetworkRequest::isRedirect() const {
@@ -324,8 +326,16 @@ void NetworkRequest::handleReply(QNetworkReply* reply) {
           &NetworkRequest::replyFinished);
 
   m_replyData.clear();
-  connect(m_reply, &QIODevice::readyRead, this,
-          [&]() { m_replyData.append(m_reply->readAll()); });
+  if (m_discardReplyBody) {
+    // Qt stops reading from the socket when its buffer is full: skipping
+    // drains the buffer without accumulating the body anywhere.
+    m_reply->setReadBufferSize(m_readBufferSize);
+    connect(m_reply, &QIODevice::readyRead, this,
+            [&]() { m_reply->skip(m_reply->bytesAvailable()); });
+  } else {
+    connect(m_reply, &QIODevice::readyRead, this,
+            [&]() { m_replyData.append(m_reply->readAll()); });
+  }
 
 #ifndef QT_NO_SSL
   connect(m_reply, &QNetworkReply::sslErrors, this, &NetworkRequest::sslErrors);
@@ -62,7 +62,10 @@ class NetworkRequest final : public QObject {
                    const QString& errorString, int status,
                    const QByteArray& data);
 
-  qint64 discardData();
+  // The body of the reply is drained as it arrives and it is not stored:
+  // Qt buffers at most `readBufferSize` bytes, and the completion signals
+  // report an empty body. To be called before the request starts.
+  void discardReplyBody(qint64 readBufferSize);
 
  private:
   void getResource();
@@ -113,6 +116,8 @@ class NetworkRequest final : public QObject {
 
   QNetworkReply* m_reply = nullptr;
   QByteArray m_replyData;
+  bool m_discardReplyBody = false;
+  qint64 m_readBufferSize = 0;
   int m_expectedStatusCode = 0;
 #ifdef MZ_WASM
   // In wasm network request, m_reply is null. So we need to store the "status
@@ -72,7 +72,10 @@ void NetworkWatcher::initialize() {
   connect(m_impl, &NetworkWatcherImpl::unsecuredNetwork, this,
           &NetworkWatcher::unsecuredNetwork);
   connect(m_impl, &NetworkWatcherImpl::networkChanged, this,
-          &NetworkWatcher::networkChange);
+          [this](const QString& newBSSID) {
+            m_networkId = newBSSID;
+            emit networkChange();
+          });
 
   m_impl->initialize();
 
@@ -106,6 +109,8 @@ void NetworkWatcher::settingsChanged() {
   } else {
     logger.debug() << "Stopping Network Watcher";
     m_impl->stop();
+    // Not tracked anymore.
+    m_networkId.clear();
   }
 }
 
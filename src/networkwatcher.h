@@ -28,6 +28,10 @@ class NetworkWatcher final : public QObject {
 
   QString getCurrentTransport();
 
+  // BSSID of the current wifi network, or an empty string if unknown or
+  // disconnected. Not all the platforms report it.
+  const QString& currentNetworkId() const { return m_networkId; }
+
  signals:
   void networkChange();
 
@@ -45,6 +49,8 @@ class NetworkWatcher final : public QObject {
 
   QMap<QString, QElapsedTimer> m_networks;
 
+  QString m_networkId;
+
   // This is used to connect NotificationHandler lazily.
   bool m_firstNotification = true;
 };
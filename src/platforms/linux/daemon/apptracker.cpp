@@ -12,6 +12,7 @@
 #include <QtDBus/QtDBus>
 
 #include "../linuxdependencies.h"
+#include "cgroupwatcher.h"
 #include "dbustypeslinux.h"
 #include "leakdetector.h"
 #include "logger.h"
@@ -23,10 +24,44 @@ constexpr const char* DBUS_SYSTEMD_SERVICE = "org.freedesktop.systemd1";
 constexpr const char* DBUS_SYSTEMD_PATH = "/org/freedesktop/systemd1";
 constexpr const char* DBUS_SYSTEMD_MANAGER = "org.freedesktop.systemd1.Manager";
 constexpr const char* DBUS_SYSTEMD_UNIT = "org.freedesktop.systemd1.Unit";
+constexpr const char* DBUS_PROPERTIES = "org.freedesktop.DBus.Properties";
 
 namespace {
 Logger logger("AppTracker");
 QString s_cgroupMount;
+
+// Returns the object path of a systemd unit, as GetUnit() would, without a
+// round trip: systemd escapes any character other than [A-Za-z0-9] as "_xx".
+// See sd_bus_path_encode().
+QString unitObjectPath(const QString& unit) {
+  QString path("/org/freedesktop/systemd1/unit/");
+  const QByteArray name = unit.toUtf8();
+  if (name.isEmpty()) {
+    return path + "_";
+  }
+
+  for (int i = 0; i < name.length(); ++i) {
+    char c = name.at(i);
+    if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+        (i > 0 && c >= '0' && c <= '9')) {
+      path.append(QLatin1Char(c));
+    } else {
+      path.append(QString("_%1").arg(static_cast<uchar>(c), 2, 16,
+                                     QLatin1Char('0')));
+    }
+  }
+
+  return path;
+}
+
+QDBusMessage propertyGet(const QString& path, const QString& interface,
+                         const QString& name) {
+  QDBusMessage message = QDBusMessage::createMethodCall(
+      DBUS_SYSTEMD_SERVICE, path, DBUS_PROPERTIES, "Get");
+  message << interface << name;
+  return message;
+}
+
 }  // namespace
 
 AppTracker::AppTracker(QObject* parent) : QObject(parent) {
@@ -35,6 +70,13 @@ AppTracker::AppTracker(QObject* parent) : QObject(parent) {
 
   /* Monitor for changes to the user's application control groups. */
   s_cgroupMount = LinuxDependencies::findCgroup2Path();
+  if (!s_cgroupMount.isEmpty()) {
+    m_cgroupWatcher = new CgroupWatcher(s_cgroupMount, this);
+    connect(m_cgroupWatcher, &CgroupWatcher::scopeCreated, this,
+            &AppTracker::scopeCreated);
+    connect(m_cgroupWatcher, &CgroupWatcher::scopeRemoved, this,
+            &AppTracker::scopeRemoved);
+  }
 }
 
 AppTracker::~AppTracker() {
@@ -79,22 +121,33 @@ void AppTracker::userCreated(uint userid, const QString& xdgRuntimePath) {
   }
 
   // Watch the user's control groups for new application scopes.
-  m_systemdInterface =
-      new QDBusInterface(DBUS_SYSTEMD_SERVICE, DBUS_SYSTEMD_PATH,
-                         DBUS_SYSTEMD_MANAGER, connection, this);
-  QVariant qv = m_systemdInterface->property("ControlGroup");
-  if (!s_cgroupMount.isEmpty() && qv.type() == QVariant::String) {
-    QString userCgroupPath = s_cgroupMount + qv.toString();
-    logger.debug() << "Monitoring Control Groups v2 at:" << userCgroupPath;
+  m_busName = connection.name();
+
+  QDBusPendingCallWatcher* watcher = new QDBusPendingCallWatcher(
+      connection.asyncCall(propertyGet(DBUS_SYSTEMD_PATH, DBUS_SYSTEMD_MANAGER,
+                                       "ControlGroup")),
+      this);
+  connect(watcher, &QDBusPendingCallWatcher::finished, this,
+          &AppTracker::controlGroupFetched);
+}
+
+void AppTracker::controlGroupFetched(QDBusPendingCallWatcher* call) {
+  call->deleteLater();
 
-    connect(&m_cgroupWatcher, SIGNAL(directoryChanged(QString)), this,
-            SLOT(cgroupsChanged(QString)));
+  QDBusPendingReply<QDBusVariant> reply = *call;
+  if (reply.isError()) {
+    logger.warning() << "Failed to fetch the user's control group:"
+                     << reply.error().message();
+    return;
+  }
 
-    m_cgroupWatcher.addPath(userCgroupPath);
-    m_cgroupWatcher.addPath(userCgroupPath + "/app.slice");
+  QVariant qv = reply.value().variant();
+  if (m_cgroupWatcher && qv.type() == QVariant::String) {
+    QString userCgroupPath = s_cgroupMount + qv.toString();
+    logger.debug() << "Monitoring Control Groups v2 at:" << userCgroupPath;
 
-    cgroupsChanged(userCgroupPath);
-    cgroupsChanged(userCgroupPath + "/app.slice");
+    m_cgroupWatcher->watchDirectory(userCgroupPath);
+    m_cgroupWatcher->watchDirectory(userCgroupPath + "/app.slice");
   }
 }
 
@@ -134,18 +187,26 @@ void AppTracker::appHeuristicMatch(AppData* data) {
   }
 
   // Query the systemd unit for its SourcePath property, which is set to the
-  // desktop file's full path on KDE
+  // desktop file's full path on KDE. The application is reported as launched
+  // when the reply comes.
+  QDBusConnection connection(m_busName);
+  if (!connection.isConnected()) {
+    data->reported = true;
+    emit appLaunched(data->cgroup, data->appId, data->rootpid);
+    return;
+  }
+
   QString unit = QFileInfo(data->cgroup).fileName();
-  QDBusReply<QDBusObjectPath> objPath =
-      m_systemdInterface->call("GetUnit", unit);
+  QDBusPendingCallWatcher* watcher = new QDBusPendingCallWatcher(
+      connection.asyncCall(
+          propertyGet(unitObjectPath(unit), DBUS_SYSTEMD_UNIT, "SourcePath")),
+      this);
 
-  QDBusInterface interface(DBUS_SYSTEMD_SERVICE, objPath.value().path(),
-                           DBUS_SYSTEMD_UNIT, m_systemdInterface->connection(),
-                           this);
-  QString source = interface.property("SourcePath").toString();
-  if (!source.isEmpty() && source.endsWith(".desktop")) {
-    data->appId = source;
-  }
+  QString cgroup = data->cgroup;
+  connect(watcher, &QDBusPendingCallWatcher::finished, this,
+          [this, cgroup](QDBusPendingCallWatcher* call) {
+            appSourceFetched(cgroup, call);
+          });
 
   // TODO: Some comparison between the .desktop file and the directory name
   // of the control group is also very likely to produce viable application
@@ -154,64 +215,49 @@ void AppTracker::appHeuristicMatch(AppData* data) {
   // them.
 }
 
-void AppTracker::cgroupsChanged(const QString& directory) {
-  QDir dir(directory);
-  QDir mountpoint(s_cgroupMount);
-  QFileInfoList newScopes = dir.entryInfoList(
-      QStringList{"*.scope", "*@autostart.service"}, QDir::Dirs);
-  QStringList oldScopes = m_runningApps.keys();
-
-  // Figure out what has been added.
-  for (const QFileInfo& scope : newScopes) {
-    // We need the path starting from the Cgroupv2 mount point.
-    QString path = mountpoint.relativeFilePath(scope.canonicalFilePath());
-    if (!path.startsWith('/')) {
-      path.prepend('/');
-    }
-
-    if (oldScopes.removeAll(path) == 0) {
-      // This is a new scope, let's add it.
-      logger.debug() << "Control group created:" << path;
-      AppData* data = new AppData(path);
+void AppTracker::appSourceFetched(const QString& cgroup,
+                                  QDBusPendingCallWatcher* call) {
+  call->deleteLater();
 
-      m_runningApps[path] = data;
-      appHeuristicMatch(data);
+  // The control group may have gone away, or have been replaced, in the
+  // meantime.
+  AppData* data = m_runningApps.value(cgroup);
+  if (!data || data->reported) {
+    return;
+  }
 
-      emit appLaunched(data->cgroup, data->appId, data->rootpid);
+  QDBusPendingReply<QDBusVariant> reply = *call;
+  if (!reply.isError()) {
+    QString source = reply.value().variant().toString();
+    if (!source.isEmpty() && source.endsWith(".desktop")) {
+      data->appId = source;
     }
   }
 
-  // Anything left, if it shares the same root directory, has been removed.
-  for (const QString& scope : oldScopes) {
-    QFileInfo scopeInfo(s_cgroupMount + scope);
-    if (scopeInfo.absolutePath() == directory) {
-      logger.debug() << "Control group removed:" << scope;
-      Q_ASSERT(m_runningApps.contains(scope));
-      AppData* data = m_runningApps.take(scope);
+  data->reported = true;
+  emit appLaunched(data->cgroup, data->appId, data->rootpid);
+}
 
-      emit appTerminated(data->cgroup, data->appId);
-      delete data;
-    }
+void AppTracker::scopeCreated(const QString& cgroup) {
+  if (m_runningApps.contains(cgroup)) {
+    return;
   }
+
+  AppData* data = new AppData(cgroup, m_cgroupWatcher);
+  m_runningApps[cgroup] = data;
+  appHeuristicMatch(data);
 }
 
-QList<int> AppData::pids() const {
-  QList<int> results;
-  QFile cgroupProcs(s_cgroupMount + cgroup + "/cgroup.procs");
-
-  if (cgroupProcs.open(QIODevice::ReadOnly | QIODevice::Text)) {
-    while (true) {
-      QString line = QString::fromLocal8Bit(cgroupProcs.readLine());
-      if (line.isEmpty()) {
-        break;
-      }
-      int pid = line.trimmed().toInt();
-      if (pid != 0) {
-        results.append(pid);
-      }
-    }
-    cgroupProcs.close();
+void AppTracker::scopeRemoved(const QString& cgroup) {
+  AppData* data = m_runningApps.take(cgroup);
+  if (!data) {
+    return;
   }
 
-  return results;
+  if (data->reported) {
+    emit appTerminated(data->cgroup, data->appId);
+  }
+  delete data;
 }
+
+QList<int> AppData::pids() const { return m_watcher->pids(cgroup); }
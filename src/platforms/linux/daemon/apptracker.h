@@ -5,17 +5,20 @@
 #ifndef APPTRACKER_H
 #define APPTRACKER_H
 
-#include <QFileSystemWatcher>
 #include <QHash>
 #include <QString>
 
 #include "leakdetector.h"
 
-class QDBusInterface;
+class CgroupWatcher;
+class QDBusPendingCallWatcher;
 
 class AppData {
  public:
-  AppData(const QString& path) : cgroup(path) { MZ_COUNT_CTOR(AppData); }
+  AppData(const QString& path, CgroupWatcher* watcher)
+      : cgroup(path), m_watcher(watcher) {
+    MZ_COUNT_CTOR(AppData);
+  }
   ~AppData() { MZ_COUNT_DTOR(AppData); }
 
   QList<int> pids() const;
@@ -23,6 +26,12 @@ class AppData {
   const QString cgroup;
   QString appId;
   int rootpid = 0;
+
+  // Set when appLaunched() has been emitted for this control group.
+  bool reported = false;
+
+ private:
+  CgroupWatcher* m_watcher;
 };
 
 class AppTracker final : public QObject {
@@ -49,16 +58,21 @@ class AppTracker final : public QObject {
                       qlonglong pid, const QStringList& uris,
                       const QVariantMap& extra);
 
-  void cgroupsChanged(const QString& directory);
+  void scopeCreated(const QString& cgroup);
+  void scopeRemoved(const QString& cgroup);
 
  private:
+  void controlGroupFetched(QDBusPendingCallWatcher* call);
   void appHeuristicMatch(AppData* data);
+  void appSourceFetched(const QString& cgroup, QDBusPendingCallWatcher* call);
 
  private:
   // Monitoring of the user's control groups.
-  QString m_cgroupMount;
-  QFileSystemWatcher m_cgroupWatcher;
-  QDBusInterface* m_systemdInterface = nullptr;
+  CgroupWatcher* m_cgroupWatcher = nullptr;
+
+  // The name of the connection to the user's session bus. All the requests to
+  // systemd are asynchronous: the daemon never waits for the user's session.
+  QString m_busName;
 
   // The set of applications that we have tracked.
   QHash<QString, AppData*> m_runningApps;
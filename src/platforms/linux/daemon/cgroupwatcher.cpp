@@ -0,0 +1,225 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "cgroupwatcher.h"
+
+#include <errno.h>
+#include <string.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSet>
+#include <QSocketNotifier>
+
+#include "leakdetector.h"
+#include "logger.h"
+
+constexpr uint32_t DIRECTORY_EVENTS =
+    IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR;
+
+namespace {
+Logger logger("CgroupWatcher");
+}
+
+CgroupWatcher::CgroupWatcher(const QString& mountPoint, QObject* parent)
+    : QObject(parent) {
+  MZ_COUNT_CTOR(CgroupWatcher);
+
+  m_mountPoint = QFileInfo(mountPoint).canonicalFilePath();
+  if (m_mountPoint.endsWith('/')) {
+    m_mountPoint.chop(1);
+  }
+
+  m_inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (m_inotify < 0) {
+    logger.error() << "Failed to create the inotify instance:"
+                   << strerror(errno);
+    return;
+  }
+
+  m_notifier = new QSocketNotifier(m_inotify, QSocketNotifier::Read, this);
+  connect(m_notifier, &QSocketNotifier::activated, this,
+          &CgroupWatcher::readEvents);
+}
+
+CgroupWatcher::~CgroupWatcher() {
+  MZ_COUNT_DTOR(CgroupWatcher);
+
+  // Closing the inotify instance removes all the watches.
+  if (m_inotify >= 0) {
+    close(m_inotify);
+  }
+}
+
+// static
+bool CgroupWatcher::isScope(const QString& name) {
+  return name.endsWith(".scope") || name.endsWith("@autostart.service");
+}
+
+bool CgroupWatcher::watchDirectory(const QString& directory) {
+  if (m_inotify < 0) {
+    return false;
+  }
+
+  // We need the path starting from the mount point.
+  QString path = QFileInfo(directory).canonicalFilePath();
+  if (path.isEmpty() ||
+      (path != m_mountPoint && !path.startsWith(m_mountPoint + '/'))) {
+    logger.warning() << "Not a control group:" << directory;
+    return false;
+  }
+
+  QString relative = path.mid(m_mountPoint.length());
+  for (const QString& watched : m_directories) {
+    if (watched == relative) {
+      return true;
+    }
+  }
+
+  int wd = inotify_add_watch(m_inotify, qPrintable(path), DIRECTORY_EVENTS);
+  if (wd < 0) {
+    logger.warning() << "Failed to watch" << directory << strerror(errno);
+    return false;
+  }
+
+  logger.debug() << "Watching control groups in:" << relative;
+  m_directories.insert(wd, relative);
+
+  rescan(relative);
+  return true;
+}
+
+QList<int> CgroupWatcher::pids(const QString& cgroup) const {
+  QList<int> results;
+
+  QFile cgroupProcs(m_mountPoint + cgroup + "/cgroup.procs");
+  if (!cgroupProcs.open(QIODevice::ReadOnly)) {
+    return results;
+  }
+
+  // A single read: the file is generated by the kernel when opened.
+  const QList<QByteArray> lines = cgroupProcs.readAll().split('\n');
+  for (const QByteArray& line : lines) {
+    int pid = line.trimmed().toInt();
+    if (pid != 0) {
+      results.append(pid);
+    }
+  }
+
+  return results;
+}
+
+void CgroupWatcher::readEvents() {
+  alignas(struct inotify_event) char buffer[4096];
+  bool overflow = false;
+
+  while (true) {
+    ssize_t length = read(m_inotify, buffer, sizeof(buffer));
+    if (length <= 0) {
+      if (length < 0 && errno != EAGAIN && errno != EINTR) {
+        logger.error() << "Failed to read inotify events:" << strerror(errno);
+      }
+      break;
+    }
+
+    for (char* ptr = buffer; ptr < buffer + length;) {
+      const struct inotify_event* event =
+          reinterpret_cast<const struct inotify_event*>(ptr);
+      ptr += sizeof(struct inotify_event) + event->len;
+
+      if (event->mask & IN_Q_OVERFLOW) {
+        overflow = true;
+        continue;
+      }
+
+      auto directory = m_directories.constFind(event->wd);
+      if (directory == m_directories.constEnd()) {
+        continue;
+      }
+
+      if (event->mask & IN_IGNORED) {
+        // The directory itself has been removed. Its scopes are gone too.
+        QString path = directory.value();
+        m_directories.remove(event->wd);
+        for (const QString& cgroup : m_scopes.keys()) {
+          if (m_scopes.value(cgroup) == path) {
+            removeScope(cgroup);
+          }
+        }
+        continue;
+      }
+
+      if (!(event->mask & IN_ISDIR) || event->len == 0) {
+        continue;
+      }
+
+      QString name = QString::fromLocal8Bit(event->name);
+      if (!isScope(name)) {
+        continue;
+      }
+
+      if (event->mask & (IN_CREATE | IN_MOVED_TO)) {
+        addScope(directory.value(), name);
+      } else if (event->mask & (IN_DELETE | IN_MOVED_FROM)) {
+        removeScope(directory.value() + '/' + name);
+      }
+    }
+  }
+
+  // Some events have been lost: let's compare the directories with the index.
+  if (overflow) {
+    logger.warning() << "Inotify queue overflow";
+    for (const QString& directory : m_directories.values()) {
+      rescan(directory);
+    }
+  }
+}
+
+void CgroupWatcher::rescan(const QString& directory) {
+  QDir dir(m_mountPoint + directory);
+  const QStringList entries =
+      dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot | QDir::NoSymLinks);
+
+  QSet<QString> found;
+  for (const QString& name : entries) {
+    if (!isScope(name)) {
+      continue;
+    }
+
+    found.insert(name);
+    addScope(directory, name);
+  }
+
+  const QStringList cgroups = m_scopes.keys();
+  for (const QString& cgroup : cgroups) {
+    if (m_scopes.value(cgroup) == directory &&
+        !found.contains(cgroup.mid(directory.length() + 1))) {
+      removeScope(cgroup);
+    }
+  }
+}
+
+void CgroupWatcher::addScope(const QString& directory, const QString& name) {
+  QString cgroup = directory + '/' + name;
+  if (m_scopes.contains(cgroup)) {
+    return;
+  }
+
+  logger.debug() << "Control group created:" << cgroup;
+
+  m_scopes.insert(cgroup, directory);
+  emit scopeCreated(cgroup);
+}
+
+void CgroupWatcher::removeScope(const QString& cgroup) {
+  if (!m_scopes.remove(cgroup)) {
+    return;
+  }
+
+  logger.debug() << "Control group removed:" << cgroup;
+  emit scopeRemoved(cgroup);
+}
@@ -0,0 +1,72 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef CGROUPWATCHER_H
+#define CGROUPWATCHER_H
+
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QString>
+
+class QSocketNotifier;
+
+// Tracks the application scopes created in a set of control group
+// directories. The directories are listed once, when they are added, and then
+// followed with inotify: the creation or the removal of a scope costs a
+// single event, regardless of the number of running applications.
+//
+// Control groups are identified by their path relative to the mount point,
+// which is a parameter so that a fake tree in a temporary directory can be
+// used in place of the cgroup2 file-system.
+
+class CgroupWatcher final : public QObject {
+  Q_OBJECT
+  Q_DISABLE_COPY_MOVE(CgroupWatcher)
+
+ public:
+  explicit CgroupWatcher(const QString& mountPoint, QObject* parent = nullptr);
+  ~CgroupWatcher();
+
+  bool isValid() const { return m_inotify >= 0; }
+
+  // Starts watching the directory (an absolute path under the mount point).
+  // The scopes it already contains are reported immediately.
+  bool watchDirectory(const QString& directory);
+
+  bool contains(const QString& cgroup) const {
+    return m_scopes.contains(cgroup);
+  }
+  QStringList scopes() const { return m_scopes.keys(); }
+
+  // Returns the PIDs of a control group, read from cgroup.procs. They are not
+  // cached: cgroup.events only reports the populated and empty transitions,
+  // not the processes forking or exiting in a running scope.
+  QList<int> pids(const QString& cgroup) const;
+
+  static bool isScope(const QString& name);
+
+ signals:
+  void scopeCreated(const QString& cgroup);
+  void scopeRemoved(const QString& cgroup);
+
+ private:
+  void readEvents();
+  void rescan(const QString& directory);
+  void addScope(const QString& directory, const QString& name);
+  void removeScope(const QString& cgroup);
+
+ private:
+  QString m_mountPoint;
+  int m_inotify = -1;
+  QSocketNotifier* m_notifier = nullptr;
+
+  // Watch descriptors of the directories, and the directories they watch.
+  QHash<int, QString> m_directories;
+
+  // The scopes, and the directory containing them.
+  QHash<QString, QString> m_scopes;
+};
+
+#endif  // CGROUPWATCHER_H
@@ -278,18 +278,19 @@ bool DBusService::firewallApp(const QString& appName, const QString& state) {
 
   logger.debug() << "Setting" << appName << "to firewall state" << state;
 
-  // Update the split tunnelling state for any running apps.
+  // Update the split tunnelling state for any running apps, all at once.
+  QStringList cgroups;
   for (auto i = m_appTracker->begin(); i != m_appTracker->end(); i++) {
     const AppData* data = *i;
-    if (data->appId != appName) {
-      continue;
-    }
-    if (state == APP_STATE_EXCLUDED) {
-      m_wgutils->excludeCgroup(data->cgroup);
-    } else {
-      m_wgutils->resetCgroup(data->cgroup);
+    if (data->appId == appName) {
+      cgroups.append(data->cgroup);
     }
   }
+  if (state == APP_STATE_EXCLUDED) {
+    m_wgutils->excludeCgroups(cgroups);
+  } else {
+    m_wgutils->resetCgroups(cgroups);
+  }
 
   // Update the list of apps to exclude from the VPN.
   if (state != APP_STATE_EXCLUDED) {
@@ -5,6 +5,7 @@
 #include "wireguardutilslinux.h"
 
 #include <arpa/inet.h>
+#include <fcntl.h>
 #include <linux/fib_rules.h>
 #include <linux/netlink.h>
 #include <linux/rtnetlink.h>
@@ -17,13 +18,16 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <QElapsedTimer>
 #include <QFile>
 #include <QHostAddress>
 #include <QScopeGuard>
+#include <QSet>
 
 #include "leakdetector.h"
 #include "logger.h"
 #include "platforms/linux/linuxdependencies.h"
+#include "tracer.h"
 
 // Import wireguard C library for Linux
 #if defined(__cplusplus)
@@ -52,6 +56,12 @@ constexpr const char* VPN_BLOCK_CGROUP = "/mozvpn.block";
 constexpr uint32_t VPN_EXCLUDE_CLASS_ID = 0x00110011;
 constexpr uint32_t VPN_BLOCK_CLASS_ID = 0x00220022;
 
+/* Processes forked while a control group is migrated can be missed. The list
+ * of processes is read again until no new one shows up, at most this many
+ * times.
+ */
+constexpr int CGROUP_MIGRATION_PASSES = 4;
+
 static void nlmsg_append_attr(struct nlmsghdr* nlmsg, size_t maxlen,
                               int attrtype, const void* attrdata,
                               size_t attrlen);
@@ -133,6 +143,8 @@ bool WireguardUtilsLinux::interfaceExists() {
 };
 
 bool WireguardUtilsLinux::addInterface(const InterfaceConfig& config) {
+  TraceSpan span("WireguardUtilsLinux::addInterface");
+
   int code = wg_add_device(WG_INTERFACE);
   if (code != 0) {
     logger.error() << "Adding interface failed:" << strerror(-code);
@@ -194,6 +206,8 @@ bool WireguardUtilsLinux::addInterface(const InterfaceConfig& config) {
 }
 
 bool WireguardUtilsLinux::updatePeer(const InterfaceConfig& config) {
+  TraceSpan span("WireguardUtilsLinux::updatePeer");
+
   wg_device* device = static_cast<wg_device*>(calloc(1, sizeof(*device)));
   if (!device) {
     logger.error() << "Allocation failure";
@@ -361,6 +375,7 @@ QList<WireguardUtils::PeerStatus> WireguardUtilsLinux::getPeerStatus() {
 }
 
 bool WireguardUtilsLinux::updateRoutePrefix(const IPAddress& prefix) {
+  TraceSpan span("WireguardUtilsLinux::updateRoutePrefix");
   logger.debug() << "Adding route to" << prefix.toString();
 
   const int flags = NLM_F_REQUEST | NLM_F_CREATE | NLM_F_REPLACE | NLM_F_ACK;
@@ -710,57 +725,128 @@ bool WireguardUtilsLinux::setupCgroupClass(const QString& path,
   return true;
 }
 
+// static
+QList<int> WireguardUtilsLinux::readCgroupProcs(const QString& path) {
+  QList<int> pids;
+
+  // The file is generated by the kernel when opened: let's read it at once.
+  QFile procs(path + "/cgroup.procs");
+  if (!procs.open(QIODevice::ReadOnly)) {
+    return pids;
+  }
+
+  const QList<QByteArray> lines = procs.readAll().split('\n');
+  for (const QByteArray& line : lines) {
+    int pid = line.trimmed().toInt();
+    if (pid > 0) {
+      pids.append(pid);
+    }
+  }
+  return pids;
+}
+
 // static
 bool WireguardUtilsLinux::moveCgroupProcs(const QString& src,
                                           const QString& dest) {
-  QFile srcProcs(src + "/cgroup.procs");
-  FILE* fp = fopen(qPrintable(dest + "/cgroup.procs"), "w");
-  if (!fp) {
+  int fd = open(qPrintable(dest + "/cgroup.procs"), O_WRONLY | O_CLOEXEC);
+  if (fd < 0) {
+    logger.error() << "Failed to open" << dest << strerror(errno);
     return false;
   }
-  auto guard = qScopeGuard([&] { fclose(fp); });
+  auto guard = qScopeGuard([&] { close(fd); });
 
-  if (!srcProcs.open(QIODevice::ReadOnly | QIODevice::Text)) {
-    return false;
-  }
-  while (true) {
-    QString line = QString::fromLocal8Bit(srcProcs.readLine());
-    if (line.isEmpty()) {
+  QSet<int> moved;
+  for (int pass = 0; pass < CGROUP_MIGRATION_PASSES; ++pass) {
+    bool found = false;
+    for (int pid : readCgroupProcs(src)) {
+      if (moved.contains(pid)) {
+        continue;
+      }
+      found = true;
+      moved.insert(pid);
+
+      // The kernel accepts a single PID per write, but there is no need for
+      // the stdio buffering and the flush that came with it.
+      char buffer[16];
+      int length = snprintf(buffer, sizeof(buffer), "%d", pid);
+      if ((write(fd, buffer, length) < 0) && (errno != ESRCH)) {
+        logger.debug() << "Failed to move PID" << pid << strerror(errno);
+      }
+    }
+
+    if (!found) {
       break;
     }
-    fputs(qPrintable(line), fp);
-    fflush(fp);
   }
-  srcProcs.close();
+
+  logger.debug() << "Moved" << moved.count() << "processes to" << dest;
   return true;
 }
 
 void WireguardUtilsLinux::excludeCgroup(const QString& cgroup) {
-  logger.info() << "Excluding traffic from" << cgroup;
+  excludeCgroups(QStringList{cgroup});
+}
+
+void WireguardUtilsLinux::excludeCgroups(const QStringList& cgroups) {
+  if (cgroups.isEmpty()) {
+    return;
+  }
+
+  TraceSpan span("WireguardUtilsLinux::excludeCgroups");
+  QElapsedTimer timer;
+  timer.start();
+
   if (m_cgroupVersion == 1) {
-    // Add all PIDs from the unified cgroup to the net_cls exclusion cgroup.
-    moveCgroupProcs(m_cgroupUnified + cgroup,
-                    m_cgroupNetClass + VPN_EXCLUDE_CGROUP);
+    // Add all PIDs from the unified cgroups to the net_cls exclusion cgroup.
+    for (const QString& cgroup : cgroups) {
+      qint64 start = timer.nsecsElapsed();
+      moveCgroupProcs(m_cgroupUnified + cgroup,
+                      m_cgroupNetClass + VPN_EXCLUDE_CGROUP);
+      logger.info() << "Excluded traffic from" << cgroup << "in"
+                    << (timer.nsecsElapsed() - start) / 1000 << "us";
+    }
   } else if (m_cgroupVersion == 2) {
-    QByteArray cgpath = cgroup.toLocal8Bit();
-    GoString goCgroup = {.p = cgpath.constData(),
-                         .n = (ptrdiff_t)cgpath.length()};
-    NetfilterMarkCgroupV2(goCgroup);
+    // The rules match the cgroup of the sockets: no process is moved, and all
+    // the rules are added with a single netfilter transaction.
+    QByteArray cgpaths = cgroups.join('\n').toLocal8Bit();
+    GoString goCgroups = {.p = cgpaths.constData(),
+                          .n = (ptrdiff_t)cgpaths.length()};
+    NetfilterMarkCgroupsV2(goCgroups);
+    logger.info() << "Excluded traffic from" << cgroups << "in"
+                  << timer.nsecsElapsed() / 1000 << "us";
   } else {
     Q_ASSERT(m_cgroupVersion == 0);
   }
 }
 
 void WireguardUtilsLinux::resetCgroup(const QString& cgroup) {
-  logger.info() << "Permitting traffic from" << cgroup;
+  resetCgroups(QStringList{cgroup});
+}
+
+void WireguardUtilsLinux::resetCgroups(const QStringList& cgroups) {
+  if (cgroups.isEmpty()) {
+    return;
+  }
+
+  TraceSpan span("WireguardUtilsLinux::resetCgroups");
+  QElapsedTimer timer;
+  timer.start();
+
   if (m_cgroupVersion == 1) {
-    // Add all PIDs from the unified cgroup to the net_cls default cgroup.
-    moveCgroupProcs(m_cgroupUnified + cgroup, m_cgroupNetClass);
+    // Add all PIDs from the unified cgroups to the net_cls default cgroup.
+    for (const QString& cgroup : cgroups) {
+      qint64 start = timer.nsecsElapsed();
+      moveCgroupProcs(m_cgroupUnified + cgroup, m_cgroupNetClass);
+      logger.info() << "Permitted traffic from" << cgroup << "in"
+                    << (timer.nsecsElapsed() - start) / 1000 << "us";
+    }
   } else if (m_cgroupVersion == 2) {
-    QByteArray cgpath = cgroup.toLocal8Bit();
-    GoString goCgroup = {.p = cgpath.constData(),
-                         .n = (ptrdiff_t)cgpath.length()};
-    NetfilterResetCgroupV2(goCgroup);
+    QByteArray cgpaths = cgroups.join('\n').toLocal8Bit();
+    GoString goCgroups = {.p = cgpaths.constData(),
+                          .n = (ptrdiff_t)cgpaths.length()};
+    NetfilterResetCgroupsV2(goCgroups);
+    logger.info() << "Permitted traffic from" << cgroups << "in"
+                  << timer.nsecsElapsed() / 1000 << "us";
   } else {
     Q_ASSERT(m_cgroupVersion == 0);
   }
@@ -34,6 +34,11 @@ class WireguardUtilsLinux final : public WireguardUtils {
 
   void excludeCgroup(const QString& cgroup);
   void resetCgroup(const QString& cgroup);
+
+  // Apply the exclusion to many control groups at once: with cgroups v2 this
+  // is a single netfilter transaction.
+  void excludeCgroups(const QStringList& cgroups);
+  void resetCgroups(const QStringList& cgroups);
   void resetAllCgroups();
 
  private:
@@ -44,6 +49,7 @@ class WireguardUtilsLinux final : public WireguardUtils {
   bool rtmSendRoute(int action, int flags, int type, const IPAddress& prefix);
   bool rtmIncludePeer(int action, int flags, const IPAddress& prefix);
   static bool setupCgroupClass(const QString& path, unsigned long classid);
+  static QList<int> readCgroupProcs(const QString& path);
   static bool moveCgroupProcs(const QString& src, const QString& dest);
   static bool buildAllowedIp(struct wg_allowedip*, const IPAddress& prefix);
 
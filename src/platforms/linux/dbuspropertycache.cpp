@@ -0,0 +1,168 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "dbuspropertycache.h"
+
+#include <QDBusMessage>
+#include <QDBusPendingCallWatcher>
+#include <QDBusPendingReply>
+
+#include "leakdetector.h"
+#include "logger.h"
+
+constexpr const char* DBUS_PROPERTIES = "org.freedesktop.DBus.Properties";
+
+namespace {
+Logger logger("DBusPropertyCache");
+}
+
+DBusPropertyCache::DBusPropertyCache(const QDBusConnection& connection,
+                                     const QString& service,
+                                     const QString& interface,
+                                     QObject* parent)
+    : QObject(parent),
+      m_connection(connection),
+      m_service(service),
+      m_interface(interface) {
+  MZ_COUNT_CTOR(DBusPropertyCache);
+}
+
+DBusPropertyCache::~DBusPropertyCache() {
+  MZ_COUNT_DTOR(DBusPropertyCache);
+
+  for (auto i = m_objects.constBegin(); i != m_objects.constEnd(); ++i) {
+    m_connection.disconnect(
+        m_service, i.key(), DBUS_PROPERTIES, "PropertiesChanged", this,
+        SLOT(dbusPropertiesChanged(QString, QVariantMap, QStringList)));
+  }
+}
+
+void DBusPropertyCache::watch(const QString& path) {
+  if (m_objects.contains(path)) {
+    return;
+  }
+
+  m_objects.insert(path, Object());
+
+  // Let's subscribe before fetching, so that no change can be missed.
+  if (!m_connection.connect(
+          m_service, path, DBUS_PROPERTIES, "PropertiesChanged", this,
+          SLOT(dbusPropertiesChanged(QString, QVariantMap, QStringList)))) {
+    logger.warning() << "Failed to watch the properties of" << path;
+  }
+
+  fetch(path);
+}
+
+void DBusPropertyCache::unwatch(const QString& path) {
+  if (!m_objects.remove(path)) {
+    return;
+  }
+
+  m_connection.disconnect(
+      m_service, path, DBUS_PROPERTIES, "PropertiesChanged", this,
+      SLOT(dbusPropertiesChanged(QString, QVariantMap, QStringList)));
+}
+
+bool DBusPropertyCache::isReady(const QString& path) const {
+  auto i = m_objects.constFind(path);
+  return i != m_objects.constEnd() && i->m_ready;
+}
+
+QVariant DBusPropertyCache::property(const QString& path,
+                                     const QString& name) const {
+  auto i = m_objects.constFind(path);
+  if (i == m_objects.constEnd()) {
+    return QVariant();
+  }
+  return i->m_properties.value(name);
+}
+
+void DBusPropertyCache::fetch(const QString& path) {
+  Q_ASSERT(m_objects.contains(path));
+  Object& object = m_objects[path];
+  object.m_pendingChanges.clear();
+  object.m_fetching = true;
+  uint32_t generation = ++object.m_generation;
+
+  QDBusMessage message = QDBusMessage::createMethodCall(
+      m_service, path, DBUS_PROPERTIES, "GetAll");
+  message << m_interface;
+
+  QDBusPendingCallWatcher* watcher =
+      new QDBusPendingCallWatcher(m_connection.asyncCall(message), this);
+  connect(watcher, &QDBusPendingCallWatcher::finished, this,
+          [this, path, generation](QDBusPendingCallWatcher* call) {
+            call->deleteLater();
+
+            auto i = m_objects.find(path);
+            if (i == m_objects.end() || i->m_generation != generation) {
+              // Unwatched or fetched again in the meantime.
+              return;
+            }
+
+            fetchCompleted(path, call);
+          });
+}
+
+void DBusPropertyCache::fetchCompleted(const QString& path,
+                                       QDBusPendingCallWatcher* call) {
+  Object& object = m_objects[path];
+  object.m_fetching = false;
+
+  QDBusPendingReply<QVariantMap> reply = *call;
+  if (reply.isError()) {
+    logger.warning() << "Failed to fetch the properties of" << path
+                     << reply.error().message();
+    object.m_pendingChanges.clear();
+    return;
+  }
+
+  // Changes received while the call was pending are more recent than the
+  // reply.
+  QVariantMap properties = reply.value();
+  for (auto i = object.m_pendingChanges.constBegin();
+       i != object.m_pendingChanges.constEnd(); ++i) {
+    properties.insert(i.key(), i.value());
+  }
+  object.m_pendingChanges.clear();
+
+  object.m_properties = properties;
+  object.m_ready = true;
+
+  emit propertiesChanged(path, properties.keys());
+}
+
+void DBusPropertyCache::dbusPropertiesChanged(const QString& interface,
+                                              const QVariantMap& changed,
+                                              const QStringList& invalidated) {
+  if (interface != m_interface) {
+    return;
+  }
+
+  QString path = message().path();
+  auto i = m_objects.find(path);
+  if (i == m_objects.end()) {
+    return;
+  }
+
+  for (auto j = changed.constBegin(); j != changed.constEnd(); ++j) {
+    i->m_properties.insert(j.key(), j.value());
+    if (i->m_fetching) {
+      i->m_pendingChanges.insert(j.key(), j.value());
+    }
+  }
+
+  if (!invalidated.isEmpty()) {
+    // The new values are not part of the signal: let's fetch them all.
+    for (const QString& name : invalidated) {
+      i->m_properties.remove(name);
+    }
+    fetch(path);
+  }
+
+  if (i->m_ready && !changed.isEmpty()) {
+    emit propertiesChanged(path, changed.keys());
+  }
+}
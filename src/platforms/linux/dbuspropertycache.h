@@ -0,0 +1,77 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef DBUSPROPERTYCACHE_H
+#define DBUSPROPERTYCACHE_H
+
+#include <QDBusConnection>
+#include <QDBusContext>
+#include <QHash>
+#include <QObject>
+#include <QVariantMap>
+
+class QDBusPendingCallWatcher;
+
+// Keeps a copy of the properties of a set of D-Bus objects implementing the
+// same interface. The properties of each object are fetched asynchronously,
+// with a single GetAll() call, and then kept up to date by the
+// PropertiesChanged signal: reading them never blocks on the bus.
+//
+// The connection is a parameter so that a mock service on the session bus
+// can be used instead of the real one.
+
+class DBusPropertyCache final : public QObject, protected QDBusContext {
+  Q_OBJECT
+  Q_DISABLE_COPY_MOVE(DBusPropertyCache)
+
+ public:
+  DBusPropertyCache(const QDBusConnection& connection, const QString& service,
+                    const QString& interface, QObject* parent = nullptr);
+  ~DBusPropertyCache();
+
+  void watch(const QString& path);
+  void unwatch(const QString& path);
+
+  bool isWatched(const QString& path) const { return m_objects.contains(path); }
+  QStringList paths() const { return m_objects.keys(); }
+
+  // Returns true once the properties of the object have been fetched.
+  bool isReady(const QString& path) const;
+
+  QVariant property(const QString& path, const QString& name) const;
+
+ signals:
+  // Emitted when the properties of an object have been fetched (in which
+  // case `names` contains all of them) and when some of them change.
+  void propertiesChanged(const QString& path, const QStringList& names);
+
+ private slots:
+  void dbusPropertiesChanged(const QString& interface,
+                             const QVariantMap& changed,
+                             const QStringList& invalidated);
+
+ private:
+  void fetch(const QString& path);
+  void fetchCompleted(const QString& path, QDBusPendingCallWatcher* call);
+
+ private:
+  QDBusConnection m_connection;
+  const QString m_service;
+  const QString m_interface;
+
+  struct Object {
+    QVariantMap m_properties;
+    // The changes received while a fetch is pending. They are more recent
+    // than its reply.
+    QVariantMap m_pendingChanges;
+    bool m_fetching = false;
+    bool m_ready = false;
+    // Bumped by each fetch, to ignore the replies of the previous ones.
+    uint32_t m_generation = 0;
+  };
+
+  QHash<QString, Object> m_objects;
+};
+
+#endif  // DBUSPROPERTYCACHE_H
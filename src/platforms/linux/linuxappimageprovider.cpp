@@ -4,18 +4,19 @@
 
 #include "linuxappimageprovider.h"
 
-#include <QDir>
-#include <QDirIterator>
+#include <QFileInfo>
 #include <QIcon>
-#include <QProcessEnvironment>
-#include <QSettings>
+#include <QImageReader>
+#include <QMutexLocker>
+#include <QPixmap>
 #include <QString>
 
 #include "leakdetector.h"
+#include "linuxdesktopentryindex.h"
 #include "logger.h"
 
-constexpr const char* PIXMAP_FALLBACK_PATH = "/usr/share/pixmaps/";
-constexpr const char* DESKTOP_ICON_LOCATION = "/usr/share/icons/";
+// Cost of the icon cache, in KB of decoded pixels.
+constexpr int ICON_CACHE_MAX_COST_KB = 8 * 1024;
 
 namespace {
 Logger logger("LinuxAppImageProvider");
@@ -23,58 +24,65 @@ Logger logger("LinuxAppImageProvider");
 
 LinuxAppImageProvider::LinuxAppImageProvider(QObject* parent)
     : AppImageProvider(parent, QQuickImageProvider::Image,
-                       QQmlImageProviderBase::ForceAsynchronousImageLoading) {
+                       QQmlImageProviderBase::ForceAsynchronousImageLoading),
+      m_index(LinuxDesktopEntryIndex::instance()) {
   MZ_COUNT_CTOR(LinuxAppImageProvider);
 
-  QStringList searchPaths = QIcon::fallbackSearchPaths();
-
-  QProcessEnvironment pe = QProcessEnvironment::systemEnvironment();
-  if (pe.contains("XDG_DATA_DIRS")) {
-    QStringList parts = pe.value("XDG_DATA_DIRS").split(":");
-    for (const QString& part : parts) {
-      addFallbackPaths(part + "/icons", searchPaths);
-    }
-  } else {
-    addFallbackPaths(DESKTOP_ICON_LOCATION, searchPaths);
-  }
-
-  if (pe.contains("HOME")) {
-    addFallbackPaths(pe.value("HOME") + "/.local/share/icons", searchPaths);
-  }
-
-  searchPaths << PIXMAP_FALLBACK_PATH;
-  QIcon::setFallbackSearchPaths(searchPaths);
+  // The icon search paths are set by the index, when it is created.
+  m_cache.setMaxCost(ICON_CACHE_MAX_COST_KB);
 }
 
 LinuxAppImageProvider::~LinuxAppImageProvider() {
   MZ_COUNT_DTOR(LinuxAppImageProvider);
 }
 
-void LinuxAppImageProvider::addFallbackPaths(const QString& iconDir,
-                                             QStringList& searchPaths) {
-  searchPaths << iconDir;
-
-  QDirIterator iter(iconDir, QDir::Dirs | QDir::NoDotAndDotDot);
-  while (iter.hasNext()) {
-    QFileInfo fileinfo(iter.next());
-    logger.debug() << "Adding QIcon fallback:" << fileinfo.absoluteFilePath();
-    searchPaths << fileinfo.absoluteFilePath();
+// static
+QImage LinuxAppImageProvider::loadIcon(const QString& name,
+                                       const QSize& requestedSize) {
+  // Icons given by path are decoded at the requested size.
+  if (QFileInfo(name).isAbsolute()) {
+    QImageReader reader(name);
+    QSize size = reader.size();
+    if (requestedSize.isValid() && size.isValid()) {
+      size.scale(requestedSize, Qt::KeepAspectRatio);
+      reader.setScaledSize(size);
+    }
+    return reader.read();
   }
-}
-
-// from QQuickImageProvider
-QImage LinuxAppImageProvider::requestImage(const QString& id, QSize* size,
-                                           const QSize& requestedSize) {
-  QSettings entry(id, QSettings::IniFormat);
-  entry.beginGroup("Desktop Entry");
-  QString name = entry.value("Icon").toString();
 
   QIcon icon = QIcon::fromTheme(name);
   QPixmap pixmap = icon.pixmap(requestedSize);
-  size->setHeight(pixmap.height());
-  size->setWidth(pixmap.width());
   logger.debug() << "Loaded icon" << icon.name() << "size:" << pixmap.width()
                  << "x" << pixmap.height();
 
   return pixmap.toImage();
 }
+
+// from QQuickImageProvider
+QImage LinuxAppImageProvider::requestImage(const QString& id, QSize* size,
+                                           const QSize& requestedSize) {
+  QString key = QString("%1@%2x%3")
+                    .arg(id)
+                    .arg(requestedSize.width())
+                    .arg(requestedSize.height());
+
+  {
+    QMutexLocker lock(&m_cacheMutex);
+    const QImage* cached = m_cache.object(key);
+    if (cached) {
+      *size = cached->size();
+      return *cached;
+    }
+  }
+
+  QImage image = loadIcon(m_index->iconName(id), requestedSize);
+  *size = image.size();
+
+  if (!image.isNull()) {
+    QMutexLocker lock(&m_cacheMutex);
+    m_cache.insert(key, new QImage(image),
+                   qMax<qsizetype>(1, image.sizeInBytes() / 1024));
+  }
+
+  return image;
+}
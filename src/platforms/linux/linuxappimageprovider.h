@@ -5,8 +5,14 @@
 #ifndef LINUXAPPIMAGEPROVIDER_H
 #define LINUXAPPIMAGEPROVIDER_H
 
+#include <QCache>
+#include <QImage>
+#include <QMutex>
+
 #include "appimageprovider.h"
 
+class LinuxDesktopEntryIndex;
+
 class LinuxAppImageProvider final : public AppImageProvider {
  public:
   LinuxAppImageProvider(QObject* parent);
@@ -15,8 +21,15 @@ class LinuxAppImageProvider final : public AppImageProvider {
                       const QSize& requestedSize) override;
 
  private:
-  static void addFallbackPaths(const QString& dataDir,
-                               QStringList& fallbackPaths);
+  static QImage loadIcon(const QString& name, const QSize& requestedSize);
+
+ private:
+  LinuxDesktopEntryIndex* m_index = nullptr;
+
+  // The icons are requested from the image loading threads.
+  QMutex m_cacheMutex;
+  // Decoded icons, keyed by desktop entry and requested size.
+  QCache<QString, QImage> m_cache;
 };
 
 #endif  // LINUXAPPIMAGEPROVIDER_H
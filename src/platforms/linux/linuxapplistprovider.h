@@ -8,7 +8,8 @@
 #include <applistprovider.h>
 
 #include <QObject>
-#include <QProcess>
+
+class LinuxDesktopEntryIndex;
 
 class LinuxAppListProvider final : public AppListProvider {
   Q_OBJECT
@@ -18,8 +19,7 @@ class LinuxAppListProvider final : public AppListProvider {
   void getApplicationList() override;
 
  private:
-  void fetchEntries(const QString& dataDir, QMap<QString, QString>& map,
-                    const QSet<QString>& desktopEnv);
+  LinuxDesktopEntryIndex* m_index = nullptr;
 };
 
 #endif  // LINUXAPPLISTPROVIDER_H
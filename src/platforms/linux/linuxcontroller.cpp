@@ -5,6 +5,7 @@
 #include "linuxcontroller.h"
 
 #include <QDBusPendingCallWatcher>
+#include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonValue>
@@ -20,6 +21,7 @@
 #include "models/device.h"
 #include "models/keys.h"
 #include "models/server.h"
+#include "tracer.h"
 
 namespace {
 Logger logger("LinuxController");
@@ -72,7 +74,14 @@ void LinuxController::activate(const InterfaceConfig& config,
                                ConnectionManager::Reason reason) {
   Q_UNUSED(reason);
 
-  connect(m_dbus->activate(config), &QDBusPendingCallWatcher::finished, this,
+  // The DBus round-trip, including the activation in the daemon.
+  qint64 start = Tracer::now();
+  QDBusPendingCallWatcher* watcher = m_dbus->activate(config);
+  connect(watcher, &QDBusPendingCallWatcher::finished, this, [start]() {
+    Tracer::instance()->addSpan("LinuxController::activate", start,
+                                Tracer::now());
+  });
+  connect(watcher, &QDBusPendingCallWatcher::finished, this,
           &LinuxController::operationCompleted);
 
   logger.debug() << "LinuxController activated";
@@ -134,6 +143,10 @@ void LinuxController::checkStatusCompleted(QDBusPendingCallWatcher* call) {
   Q_ASSERT(json.isObject());
 
   QJsonObject obj = json.object();
+  if (obj.contains("trace")) {
+    Tracer::instance()->importEvents(obj.value("trace").toArray());
+  }
+
   Q_ASSERT(obj.contains("connected"));
   QJsonValue statusValue = obj.value("connected");
   Q_ASSERT(statusValue.isBool());
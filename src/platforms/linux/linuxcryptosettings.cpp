@@ -165,7 +165,7 @@ CryptoSettings::Version CryptoSettings::getSupportedVersion() {
       }
     }
 
-    s_keyVersion = CryptoSettings::EncryptionChachaPolyV1;
+    s_keyVersion = CryptoSettings::EncryptionChachaPolyV2;
   }
 
   return s_keyVersion;
@@ -0,0 +1,471 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "linuxdesktopentryindex.h"
+
+#include <QCoreApplication>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QIcon>
+#include <QMutexLocker>
+#include <QProcessEnvironment>
+#include <QPromise>
+#include <QSaveFile>
+#include <QSet>
+#include <QStandardPaths>
+#include <QThreadPool>
+#include <memory>
+
+#include "leakdetector.h"
+#include "logger.h"
+
+constexpr const char* DATA_DIRS_FALLBACK = "/usr/local/share/:/usr/share/";
+constexpr const char* CONFIG_DIRS_FALLBACK = "/etc/xdg/autostart/";
+constexpr const char* PIXMAP_FALLBACK_PATH = "/usr/share/pixmaps/";
+constexpr const char* DESKTOP_ICON_LOCATION = "/usr/share/icons/";
+
+constexpr const char* CACHE_FILENAME = "desktopentries.cache";
+constexpr quint32 CACHE_VERSION = 2;
+
+// Batches the changes of the watched folders, as an installation touches
+// several of them.
+constexpr int WATCHER_DELAY_MSEC = 1000;
+
+namespace {
+Logger logger("LinuxDesktopEntryIndex");
+
+LinuxDesktopEntryIndex* s_instance = nullptr;
+
+QString cacheFileName() {
+  return QDir(QStandardPaths::writableLocation(
+                  QStandardPaths::CacheLocation))
+      .filePath(CACHE_FILENAME);
+}
+
+QStringList applicationFolders(const QProcessEnvironment& pe) {
+  QStringList folders;
+
+  QString dataDirs = pe.value("XDG_DATA_DIRS", DATA_DIRS_FALLBACK);
+  for (const QString& part : dataDirs.split(":")) {
+    folders.append(part.trimmed() + "/applications");
+  }
+
+  if (pe.contains("XDG_DATA_HOME")) {
+    folders.append(pe.value("XDG_DATA_HOME") + "/applications");
+  } else if (pe.contains("HOME")) {
+    folders.append(pe.value("HOME") + "/.local/share/applications");
+  }
+
+  return folders;
+}
+
+QStringList autostartFolders(const QProcessEnvironment& pe) {
+  QStringList folders;
+
+  QString configDirs = pe.value("XDG_CONFIG_DIRS", CONFIG_DIRS_FALLBACK);
+  for (const QString& part : configDirs.split(":")) {
+    folders.append(part.trimmed() + "/autostart");
+  }
+
+  if (pe.contains("XDG_CONFIG_HOME")) {
+    folders.append(pe.value("XDG_CONFIG_HOME") + "/autostart");
+  } else if (pe.contains("HOME")) {
+    folders.append(pe.value("HOME") + "/.config/autostart");
+  }
+
+  return folders;
+}
+
+void addIconSearchPaths(const QString& iconDir, QStringList& searchPaths) {
+  searchPaths << iconDir;
+
+  QDirIterator iter(iconDir, QDir::Dirs | QDir::NoDotAndDotDot);
+  while (iter.hasNext()) {
+    searchPaths << QFileInfo(iter.next()).absoluteFilePath();
+  }
+}
+
+QStringList iconSearchPaths(const QProcessEnvironment& pe) {
+  QStringList searchPaths;
+
+  if (pe.contains("XDG_DATA_DIRS")) {
+    QStringList parts = pe.value("XDG_DATA_DIRS").split(":");
+    for (const QString& part : parts) {
+      addIconSearchPaths(part + "/icons", searchPaths);
+    }
+  } else {
+    addIconSearchPaths(DESKTOP_ICON_LOCATION, searchPaths);
+  }
+
+  if (pe.contains("HOME")) {
+    addIconSearchPaths(pe.value("HOME") + "/.local/share/icons", searchPaths);
+  }
+
+  searchPaths << PIXMAP_FALLBACK_PATH;
+  return searchPaths;
+}
+
+void scanFolder(const QString& folder, bool autostart,
+                const QHash<QString, LinuxDesktopEntryIndex::Entry>& previous,
+                LinuxDesktopEntryIndex::Scan& scan) {
+  QFileInfo folderInfo(folder);
+  if (!folderInfo.isDir()) {
+    return;
+  }
+
+  scan.folders.append(folderInfo.absoluteFilePath());
+
+  QDirIterator folders(folder, QDir::Dirs | QDir::NoDotAndDotDot,
+                       QDirIterator::Subdirectories);
+  while (folders.hasNext()) {
+    scan.folders.append(QFileInfo(folders.next()).absoluteFilePath());
+  }
+
+  QDirIterator files(folder, QStringList() << "*.desktop", QDir::Files,
+                     QDirIterator::Subdirectories);
+  while (files.hasNext()) {
+    QFileInfo fileInfo(files.next());
+    const QString path = fileInfo.absoluteFilePath();
+    const qint64 lastModified = fileInfo.lastModified().toMSecsSinceEpoch();
+
+    // Only the new and modified entries are parsed.
+    auto i = previous.constFind(path);
+    if (i != previous.constEnd() && i->lastModified == lastModified &&
+        i->autostart == autostart) {
+      scan.entries.insert(path, *i);
+      continue;
+    }
+
+    LinuxDesktopEntryIndex::Entry entry;
+    if (!LinuxDesktopEntryIndex::parseDesktopEntry(path, &entry)) {
+      continue;
+    }
+
+    entry.autostart = autostart;
+    entry.lastModified = lastModified;
+    scan.entries.insert(path, entry);
+  }
+}
+
+LinuxDesktopEntryIndex::Scan scanFolders(
+    const QHash<QString, LinuxDesktopEntryIndex::Entry>& previous) {
+  QProcessEnvironment pe = QProcessEnvironment::systemEnvironment();
+
+  LinuxDesktopEntryIndex::Scan scan;
+  for (const QString& folder : applicationFolders(pe)) {
+    scanFolder(folder, false, previous, scan);
+  }
+  for (const QString& folder : autostartFolders(pe)) {
+    scanFolder(folder, true, previous, scan);
+  }
+
+  scan.folders.removeDuplicates();
+  scan.iconSearchPaths = iconSearchPaths(pe);
+  return scan;
+}
+
+QSet<QString> currentDesktop() {
+  QProcessEnvironment pe = QProcessEnvironment::systemEnvironment();
+  if (!pe.contains("XDG_CURRENT_DESKTOP")) {
+    return QSet<QString>();
+  }
+
+  const QStringList parts = pe.value("XDG_CURRENT_DESKTOP").split(":");
+  return QSet<QString>(parts.begin(), parts.end());
+}
+
+}  // namespace
+
+// static
+LinuxDesktopEntryIndex* LinuxDesktopEntryIndex::instance() {
+  if (!s_instance) {
+    new LinuxDesktopEntryIndex(qApp);
+  }
+
+  Q_ASSERT(s_instance);
+  return s_instance;
+}
+
+LinuxDesktopEntryIndex::LinuxDesktopEntryIndex(QObject* parent)
+    : QObject(parent) {
+  MZ_COUNT_CTOR(LinuxDesktopEntryIndex);
+
+  Q_ASSERT(!s_instance);
+  s_instance = this;
+
+  m_watcherTimer.setSingleShot(true);
+  m_watcherTimer.setInterval(WATCHER_DELAY_MSEC);
+  connect(&m_watcherTimer, &QTimer::timeout, this,
+          &LinuxDesktopEntryIndex::refresh);
+  connect(&m_watcher, &QFileSystemWatcher::directoryChanged, &m_watcherTimer,
+          qOverload<>(&QTimer::start));
+
+  readCache();
+
+  // The icon search paths are set before any icon is requested, and before
+  // the image provider threads use them. Without a cache, they are computed
+  // in place: this only lists the top level of the icon folders.
+  if (m_iconSearchPaths.isEmpty()) {
+    m_iconSearchPaths =
+        iconSearchPaths(QProcessEnvironment::systemEnvironment());
+  }
+  QIcon::setFallbackSearchPaths(QIcon::fallbackSearchPaths() +
+                                m_iconSearchPaths);
+}
+
+LinuxDesktopEntryIndex::~LinuxDesktopEntryIndex() {
+  MZ_COUNT_DTOR(LinuxDesktopEntryIndex);
+
+  Q_ASSERT(s_instance == this);
+  s_instance = nullptr;
+}
+
+QMap<QString, QString> LinuxDesktopEntryIndex::applications() const {
+  static const QSet<QString> desktopEnv = currentDesktop();
+
+  QMutexLocker lock(&m_mutex);
+
+  QMap<QString, QString> out;
+  for (auto i = m_entries.constBegin(); i != m_entries.constEnd(); ++i) {
+    const Entry& entry = i.value();
+    if (!entry.visible) {
+      continue;
+    }
+    if (!entry.notShowIn.isEmpty() &&
+        desktopEnv.intersects(
+            QSet<QString>(entry.notShowIn.begin(), entry.notShowIn.end()))) {
+      continue;
+    }
+    if (!entry.onlyShowIn.isEmpty() &&
+        !desktopEnv.intersects(
+            QSet<QString>(entry.onlyShowIn.begin(), entry.onlyShowIn.end()))) {
+      continue;
+    }
+
+    out[i.key()] = entry.autostart ? entry.name + " (autostart)" : entry.name;
+  }
+
+  return out;
+}
+
+// static
+bool LinuxDesktopEntryIndex::parseDesktopEntry(const QString& fileName,
+                                               Entry* entry) {
+  QFile file(fileName);
+  if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+    return false;
+  }
+
+  bool inGroup = false;
+  bool application = false;
+  bool hidden = false;
+
+  while (!file.atEnd()) {
+    QByteArray line = file.readLine().trimmed();
+    if (line.isEmpty() || line.startsWith('#')) {
+      continue;
+    }
+
+    if (line.startsWith('[')) {
+      if (inGroup) {
+        break;
+      }
+      inGroup = line == "[Desktop Entry]";
+      continue;
+    }
+
+    qsizetype separator = line.indexOf('=');
+    if (!inGroup || separator < 0) {
+      continue;
+    }
+
+    QByteArray key = line.left(separator).trimmed();
+    QString value = QString::fromUtf8(line.mid(separator + 1).trimmed());
+
+    if (key == "Type") {
+      application = value == "Application";
+    } else if (key == "NoDisplay" || key == "Hidden") {
+      hidden |= value == "true";
+    } else if (key == "Name") {
+      entry->name = value;
+    } else if (key == "Icon") {
+      entry->icon = value;
+    } else if (key == "NotShowIn") {
+      entry->notShowIn = value.split(";", Qt::SkipEmptyParts);
+    } else if (key == "OnlyShowIn") {
+      entry->onlyShowIn = value.split(";", Qt::SkipEmptyParts);
+    }
+  }
+
+  entry->visible = application && !hidden;
+  return true;
+}
+
+QString LinuxDesktopEntryIndex::iconName(const QString& desktopEntry) const {
+  {
+    QMutexLocker lock(&m_mutex);
+    auto i = m_entries.constFind(desktopEntry);
+    if (i != m_entries.constEnd()) {
+      return i->icon;
+    }
+  }
+
+  // Not indexed yet.
+  Entry entry;
+  if (!parseDesktopEntry(desktopEntry, &entry)) {
+    return QString();
+  }
+
+  return entry.icon;
+}
+
+void LinuxDesktopEntryIndex::refresh() {
+  if (m_scan.isRunning()) {
+    m_refreshPending = true;
+    return;
+  }
+
+  logger.debug() << "Scanning the desktop entries";
+
+  Scan previous;
+  {
+    QMutexLocker lock(&m_mutex);
+    previous.entries = m_entries;
+  }
+  previous.iconSearchPaths = m_iconSearchPaths;
+
+  // The job owns the promise: the index can go away before it runs.
+  auto promise = std::make_shared<QPromise<Scan>>();
+  promise->start();
+  m_scan = promise->future();
+
+  QThreadPool::globalInstance()->start([promise, previous]() {
+    Scan scan = scanFolders(previous.entries);
+    if (scan.entries != previous.entries ||
+        scan.iconSearchPaths != previous.iconSearchPaths) {
+      writeCache(scan);
+    }
+
+    promise->addResult(scan);
+    promise->finish();
+  });
+
+  m_scan.then(this, [this](const Scan& scan) { scanCompleted(scan); });
+}
+
+void LinuxDesktopEntryIndex::scanCompleted(const Scan& scan) {
+  logger.debug() << "Desktop entries scanned:" << scan.entries.count();
+
+  bool modified;
+  {
+    QMutexLocker lock(&m_mutex);
+    modified = !m_loaded || m_entries != scan.entries;
+    m_entries = scan.entries;
+  }
+  m_loaded = true;
+
+  // Keeps the watched folders in sync with the scanned ones.
+  QStringList watched = m_watcher.directories();
+  QSet<QString> watchedSet(watched.begin(), watched.end());
+  QSet<QString> scannedSet(scan.folders.begin(), scan.folders.end());
+
+  QStringList removed = (watchedSet - scannedSet).values();
+  if (!removed.isEmpty()) {
+    m_watcher.removePaths(removed);
+  }
+
+  QStringList added = (scannedSet - watchedSet).values();
+  if (!added.isEmpty()) {
+    m_watcher.addPaths(added);
+  }
+
+  // The new icon search paths are used from the next session: the image
+  // provider threads could be reading them now.
+  m_iconSearchPaths = scan.iconSearchPaths;
+
+  if (modified) {
+    emit changed();
+  }
+
+  if (m_refreshPending) {
+    m_refreshPending = false;
+    refresh();
+  }
+}
+
+void LinuxDesktopEntryIndex::readCache() {
+  QFile file(cacheFileName());
+  if (!file.open(QIODevice::ReadOnly)) {
+    return;
+  }
+
+  QDataStream stream(&file);
+
+  quint32 version = 0;
+  qint32 count = 0;
+  stream >> version >> count;
+  if (version != CACHE_VERSION || count < 0) {
+    logger.debug() << "Ignoring an outdated desktop entry cache";
+    return;
+  }
+
+  QStringList searchPaths;
+  stream >> searchPaths;
+
+  QHash<QString, Entry> entries;
+  entries.reserve(count);
+  for (qint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i) {
+    QString path;
+    Entry entry;
+    stream >> path >> entry.name >> entry.icon >> entry.notShowIn >>
+        entry.onlyShowIn >> entry.visible >> entry.autostart >>
+        entry.lastModified;
+    entries.insert(path, entry);
+  }
+
+  if (stream.status() != QDataStream::Ok) {
+    logger.warning() << "Invalid desktop entry cache";
+    return;
+  }
+
+  m_iconSearchPaths = searchPaths;
+
+  QMutexLocker lock(&m_mutex);
+  m_entries.swap(entries);
+  m_loaded = true;
+}
+
+// static
+void LinuxDesktopEntryIndex::writeCache(const Scan& scan) {
+  QString fileName = cacheFileName();
+  if (!QDir().mkpath(QFileInfo(fileName).absolutePath())) {
+    logger.warning() << "Unable to create the desktop entry cache folder";
+    return;
+  }
+
+  QSaveFile file(fileName);
+  if (!file.open(QIODevice::WriteOnly)) {
+    logger.warning() << "Unable to open the desktop entry cache";
+    return;
+  }
+
+  QDataStream stream(&file);
+  stream << CACHE_VERSION << static_cast<qint32>(scan.entries.count())
+         << scan.iconSearchPaths;
+  for (auto i = scan.entries.constBegin(); i != scan.entries.constEnd();
+       ++i) {
+    const Entry& entry = i.value();
+    stream << i.key() << entry.name << entry.icon << entry.notShowIn
+           << entry.onlyShowIn << entry.visible << entry.autostart
+           << entry.lastModified;
+  }
+
+  if (!file.commit()) {
+    logger.warning() << "Unable to write the desktop entry cache";
+  }
+}
@@ -0,0 +1,96 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef LINUXDESKTOPENTRYINDEX_H
+#define LINUXDESKTOPENTRYINDEX_H
+
+#include <QFileSystemWatcher>
+#include <QFuture>
+#include <QHash>
+#include <QMap>
+#include <QMutex>
+#include <QObject>
+#include <QStringList>
+#include <QTimer>
+
+// Index of the desktop entries of the XDG data and config folders, shared by
+// the app list and the app icon providers. The folders are scanned on a
+// worker thread. Only the entries modified since the previous scan are
+// parsed, and the index is kept on disk between sessions. The folders are
+// watched, to rescan them when an application is installed or removed.
+class LinuxDesktopEntryIndex final : public QObject {
+  Q_OBJECT
+  Q_DISABLE_COPY_MOVE(LinuxDesktopEntryIndex)
+
+ public:
+  struct Entry {
+    QString name;
+    QString icon;
+    QStringList notShowIn;
+    QStringList onlyShowIn;
+    // Visible applications, without the desktop environment filters.
+    bool visible = false;
+    bool autostart = false;
+    qint64 lastModified = 0;
+
+    bool operator==(const Entry& other) const = default;
+  };
+
+  struct Scan {
+    QHash<QString, Entry> entries;
+    QStringList folders;
+    QStringList iconSearchPaths;
+  };
+
+  // Must be called from the main thread first.
+  static LinuxDesktopEntryIndex* instance();
+
+  ~LinuxDesktopEntryIndex();
+
+  // True once the entries have been read from the disk cache or scanned.
+  bool isLoaded() const { return m_loaded; }
+
+  // The visible applications for the current desktop environment, mapped
+  // from the path of their desktop entry to their name.
+  QMap<QString, QString> applications() const;
+
+  // The icon of a desktop entry. Thread-safe.
+  QString iconName(const QString& desktopEntry) const;
+
+  // Reads the keys of the "Desktop Entry" group that the index needs. This is
+  // a lot cheaper than QSettings, which also parses the other groups.
+  static bool parseDesktopEntry(const QString& fileName, Entry* entry);
+
+  // Rescans the folders in the background. `changed` is emitted when done,
+  // if the entries have changed.
+  void refresh();
+
+ signals:
+  void changed();
+
+ private:
+  explicit LinuxDesktopEntryIndex(QObject* parent);
+
+  void scanCompleted(const Scan& scan);
+
+  void readCache();
+  static void writeCache(const Scan& scan);
+
+ private:
+  mutable QMutex m_mutex;
+  QHash<QString, Entry> m_entries;
+  bool m_loaded = false;
+
+  QFuture<Scan> m_scan;
+  bool m_refreshPending = false;
+
+  // The icon search paths of the disk cache, or computed at construction.
+  // Set on QIcon once, from the main thread.
+  QStringList m_iconSearchPaths;
+
+  QFileSystemWatcher m_watcher;
+  QTimer m_watcherTimer;
+};
+
+#endif  // LINUXDESKTOPENTRYINDEX_H
@@ -40,6 +40,8 @@ void LinuxNetworkWatcher::initialize() {
 
   connect(m_worker, &LinuxNetworkWatcherWorker::unsecuredNetwork, this,
           &LinuxNetworkWatcher::unsecuredNetwork);
+  connect(m_worker, &LinuxNetworkWatcherWorker::networkChanged, this,
+          &LinuxNetworkWatcher::networkChanged);
 
   // Let's wait a few seconds to allow the UI to be fully loaded and shown.
   // This is not strictly needed, but it's better for user experience because
@@ -6,6 +6,7 @@
 
 #include <QtDBus/QtDBus>
 
+#include "dbuspropertycache.h"
 #include "leakdetector.h"
 #include "logger.h"
 
@@ -34,6 +35,10 @@
   (NM_802_11_AP_SEC_PAIR_WEP40 | NM_802_11_AP_SEC_PAIR_WEP104)
 
 constexpr const char* DBUS_NETWORKMANAGER = "org.freedesktop.NetworkManager";
+constexpr const char* DBUS_NM_DEVICE = "org.freedesktop.NetworkManager.Device";
+constexpr const char* DBUS_NM_WIRELESS =
+    "org.freedesktop.NetworkManager.Device.Wireless";
+constexpr const char* DBUS_NM_AP = "org.freedesktop.NetworkManager.AccessPoint";
 
 namespace {
 Logger logger("LinuxNetworkWatcherWorker");
@@ -73,96 +78,184 @@ void LinuxNetworkWatcherWorker::initialize() {
   // documentation:
   // https://developer.gnome.org/NetworkManager/stable/gdbus-org.freedesktop.NetworkManager.html
 
-  QDBusInterface nm(DBUS_NETWORKMANAGER, "/org/freedesktop/NetworkManager",
-                    DBUS_NETWORKMANAGER, QDBusConnection::systemBus());
-  if (!nm.isValid()) {
-    logger.error()
-        << "Failed to connect to the network manager via system dbus";
+  QDBusConnection bus = QDBusConnection::systemBus();
+  if (!bus.isConnected()) {
+    logger.error() << "Failed to connect to the system dbus";
     return;
   }
 
-  QDBusMessage msg = nm.call("GetDevices");
-  QDBusArgument arg = msg.arguments().at(0).value<QDBusArgument>();
-  if (arg.currentType() != QDBusArgument::ArrayType) {
-    logger.error() << "Expected an array of devices";
+  m_devices =
+      new DBusPropertyCache(bus, DBUS_NETWORKMANAGER, DBUS_NM_DEVICE, this);
+  connect(m_devices, &DBusPropertyCache::propertiesChanged, this,
+          &LinuxNetworkWatcherWorker::devicePropertiesChanged);
+
+  m_wirelessDevices =
+      new DBusPropertyCache(bus, DBUS_NETWORKMANAGER, DBUS_NM_WIRELESS, this);
+  connect(m_wirelessDevices, &DBusPropertyCache::propertiesChanged, this,
+          &LinuxNetworkWatcherWorker::wirelessPropertiesChanged);
+
+  m_accessPoints =
+      new DBusPropertyCache(bus, DBUS_NETWORKMANAGER, DBUS_NM_AP, this);
+  connect(m_accessPoints, &DBusPropertyCache::propertiesChanged, this,
+          &LinuxNetworkWatcherWorker::accessPointPropertiesChanged);
+
+  QDBusMessage message = QDBusMessage::createMethodCall(
+      DBUS_NETWORKMANAGER, "/org/freedesktop/NetworkManager",
+      DBUS_NETWORKMANAGER, "GetDevices");
+
+  QDBusPendingCallWatcher* watcher =
+      new QDBusPendingCallWatcher(bus.asyncCall(message), this);
+  connect(watcher, &QDBusPendingCallWatcher::finished, this,
+          &LinuxNetworkWatcherWorker::devicesFetched);
+}
+
+void LinuxNetworkWatcherWorker::devicesFetched(QDBusPendingCallWatcher* call) {
+  call->deleteLater();
+
+  QDBusPendingReply<QList<QDBusObjectPath>> reply = *call;
+  if (reply.isError()) {
+    logger.error() << "Failed to retrieve the network devices:"
+                   << reply.error().message();
     return;
   }
 
-  QList<QDBusObjectPath> paths = qdbus_cast<QList<QDBusObjectPath> >(arg);
+  const QList<QDBusObjectPath> paths = reply.value();
+  if (paths.isEmpty()) {
+    logger.warning() << "No network devices found";
+    return;
+  }
+
+  // The properties of all the devices are fetched in parallel. The
+  // non-wireless ones are discarded when their type is known.
   for (const QDBusObjectPath& path : paths) {
-    QString devicePath = path.path();
-    QDBusInterface device(DBUS_NETWORKMANAGER, devicePath,
-                          "org.freedesktop.NetworkManager.Device",
-                          QDBusConnection::systemBus());
-    if (device.property("DeviceType").toInt() != NM_DEVICE_TYPE_WIFI) {
-      continue;
-    }
+    m_devices->watch(path.path());
+  }
+}
+
+void LinuxNetworkWatcherWorker::devicePropertiesChanged(
+    const QString& path, const QStringList& names) {
+  if (!names.contains("DeviceType")) {
+    return;
+  }
 
-    logger.debug() << "Found a wifi device:" << devicePath;
-    m_devicePaths.append(devicePath);
+  // The type of a device does not change: we don't need to follow it.
+  int type = m_devices->property(path, "DeviceType").toInt();
+  m_devices->unwatch(path);
 
-    // Here we monitor the changes.
-    QDBusConnection::systemBus().connect(
-        DBUS_NETWORKMANAGER, devicePath, "org.freedesktop.DBus.Properties",
-        "PropertiesChanged", this,
-        SLOT(propertyChanged(QString, QVariantMap, QStringList)));
+  if (type != NM_DEVICE_TYPE_WIFI) {
+    return;
   }
 
-  if (m_devicePaths.isEmpty()) {
-    logger.warning() << "No wifi devices found";
+  logger.debug() << "Found a wifi device:" << path;
+  m_devicePaths.append(path);
+
+  // Here we monitor the changes.
+  m_wirelessDevices->watch(path);
+}
+
+void LinuxNetworkWatcherWorker::wirelessPropertiesChanged(
+    const QString& path, const QStringList& names) {
+  Q_UNUSED(path);
+
+  if (!names.contains("ActiveAccessPoint")) {
+    logger.debug() << "Access point did not changed. Ignoring the changes";
     return;
   }
 
+  // Only the active access points are cached.
+  QStringList activePaths;
+  for (const QString& devicePath : m_devicePaths) {
+    QString accessPointPath = activeAccessPoint(devicePath);
+    if (!accessPointPath.isEmpty()) {
+      activePaths.append(accessPointPath);
+    }
+  }
+
+  for (const QString& accessPointPath : m_accessPoints->paths()) {
+    if (!activePaths.contains(accessPointPath)) {
+      m_accessPoints->unwatch(accessPointPath);
+    }
+  }
+
+  for (const QString& accessPointPath : activePaths) {
+    m_accessPoints->watch(accessPointPath);
+  }
+
   // We could be already be activated.
   checkDevices();
 }
 
-void LinuxNetworkWatcherWorker::propertyChanged(QString interface,
-                                                QVariantMap properties,
-                                                QStringList list) {
-  Q_UNUSED(list);
+void LinuxNetworkWatcherWorker::accessPointPropertiesChanged(
+    const QString& path, const QStringList& names) {
+  Q_UNUSED(path);
 
-  logger.debug() << "Properties changed for interface" << interface;
-
-  if (!properties.contains("ActiveAccessPoint")) {
-    logger.debug() << "Access point did not changed. Ignoring the changes";
+  // The signal strength changes often: let's ignore it.
+  if (!names.contains("RsnFlags") && !names.contains("WpaFlags")) {
     return;
   }
 
   checkDevices();
 }
 
+QString LinuxNetworkWatcherWorker::activeAccessPoint(
+    const QString& devicePath) const {
+  QString path = m_wirelessDevices->property(devicePath, "ActiveAccessPoint")
+                     .value<QDBusObjectPath>()
+                     .path();
+
+  // NetworkManager uses "/" when there is no active access point.
+  if (path == "/") {
+    return QString();
+  }
+
+  return path;
+}
+
 void LinuxNetworkWatcherWorker::checkDevices() {
   logger.debug() << "Checking devices";
 
+  if (!m_wirelessDevices || !m_accessPoints) {
+    return;
+  }
+
+  QString activeBssid;
+  // A device or an active access point whose properties are not fetched yet.
+  bool pending = false;
   for (const QString& devicePath : m_devicePaths) {
-    QDBusInterface wifiDevice(DBUS_NETWORKMANAGER, devicePath,
-                              "org.freedesktop.NetworkManager.Device.Wireless",
-                              QDBusConnection::systemBus());
+    if (!m_wirelessDevices->isReady(devicePath)) {
+      pending = true;
+      continue;
+    }
 
     // Check the access point path
-    QString accessPointPath = wifiDevice.property("ActiveAccessPoint")
-                                  .value<QDBusObjectPath>()
-                                  .path();
+    QString accessPointPath = activeAccessPoint(devicePath);
     if (accessPointPath.isEmpty()) {
       logger.warning() << "No access point found";
       continue;
     }
 
-    QDBusInterface ap(DBUS_NETWORKMANAGER, accessPointPath,
-                      "org.freedesktop.NetworkManager.AccessPoint",
-                      QDBusConnection::systemBus());
+    if (!m_accessPoints->isReady(accessPointPath)) {
+      // We will be back here when the properties are fetched.
+      pending = true;
+      continue;
+    }
 
-    QVariant rsnFlags = ap.property("RsnFlags");
-    QVariant wpaFlags = ap.property("WpaFlags");
+    QVariant rsnFlags = m_accessPoints->property(accessPointPath, "RsnFlags");
+    QVariant wpaFlags = m_accessPoints->property(accessPointPath, "WpaFlags");
     if (!rsnFlags.isValid() || !wpaFlags.isValid()) {
       // We are probably not connected.
       continue;
     }
 
+    QString bssid =
+        m_accessPoints->property(accessPointPath, "HwAddress").toString();
+    if (activeBssid.isEmpty()) {
+      activeBssid = bssid;
+    }
+
     if (!checkUnsecureFlags(rsnFlags.toInt(), wpaFlags.toInt())) {
-      QString ssid = ap.property("Ssid").toString();
-      QString bssid = ap.property("HwAddress").toString();
+      QString ssid =
+          m_accessPoints->property(accessPointPath, "Ssid").toString();
 
       // We have found 1 unsecured network. We don't need to check other wifi
       // network devices.
@@ -174,4 +267,16 @@ void LinuxNetworkWatcherWorker::checkDevices() {
       break;
     }
   }
+
+  // Without a BSSID, the network is only reported as gone when no device has
+  // an active access point. An access point whose properties are still being
+  // fetched does not count as a disconnection.
+  if (activeBssid.isEmpty() && pending) {
+    return;
+  }
+
+  if (activeBssid != m_activeBssid) {
+    m_activeBssid = activeBssid;
+    emit networkChanged(activeBssid);
+  }
 }
@@ -9,6 +9,8 @@
 #include <QObject>
 #include <QVariant>
 
+class DBusPropertyCache;
+class QDBusPendingCallWatcher;
 class QThread;
 
 class LinuxNetworkWatcherWorker final : public QObject {
@@ -23,19 +25,35 @@ class LinuxNetworkWatcherWorker final : public QObject {
 
  signals:
   void unsecuredNetwork(const QString& networkName, const QString& networkId);
+  void networkChanged(const QString& bssid);
 
  public slots:
   void initialize();
 
- private slots:
-  void propertyChanged(QString interface, QVariantMap properties,
-                       QStringList list);
+ private:
+  void devicesFetched(QDBusPendingCallWatcher* call);
+  void devicePropertiesChanged(const QString& path, const QStringList& names);
+  void wirelessPropertiesChanged(const QString& path,
+                                 const QStringList& names);
+  void accessPointPropertiesChanged(const QString& path,
+                                    const QStringList& names);
+
+  QString activeAccessPoint(const QString& devicePath) const;
 
  private:
   // We collect the list of DBus wifi network device paths during the
-  // initialization. When a property of them changes, we check if the access
-  // point is active and unsecure.
+  // initialization. The properties of the devices and of their active access
+  // points are cached and kept up to date by NetworkManager's signals: when
+  // they change, we check if the access point is active and unsecure without
+  // any further DBus round trip.
   QStringList m_devicePaths;
+
+  DBusPropertyCache* m_devices = nullptr;
+  DBusPropertyCache* m_wirelessDevices = nullptr;
+  DBusPropertyCache* m_accessPoints = nullptr;
+
+  // BSSID of the active access point, if any.
+  QString m_activeBssid;
 };
 
 #endif  // LINUXNETWORKWATCHERWORKER_H
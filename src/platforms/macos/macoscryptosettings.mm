@@ -137,7 +137,7 @@ CryptoSettings::Version CryptoSettings::getSupportedVersion() {
   uint8_t key[CRYPTO_SETTINGS_KEY_SIZE];
   if (getKey(key)) {
     logger.debug() << "Encryption supported!";
-    return CryptoSettings::EncryptionChachaPolyV1;
+    return CryptoSettings::EncryptionChachaPolyV2;
   }
 #endif
 
@@ -5,23 +5,16 @@
 #include <emscripten/bind.h>
 #include <emscripten/emscripten.h>
 
-#include <QFontDatabase>
-
-#include "logger.h"
-
-namespace {
-Logger logger("WasmFontLoader");
-}  // namespace
+#include "fontloader.h"
 
 EMSCRIPTEN_KEEPALIVE void mzLoadFont(emscripten::val fontName,
                                      emscripten::val buffer) {
   std::string fontNameStr = fontName.as<std::string>();
   std::string bufferStr = buffer.as<std::string>();
 
-  int id = QFontDatabase::addApplicationFontFromData(
+  FontLoader::loadFontFromData(
+      QString::fromStdString(fontNameStr),
       QByteArray(bufferStr.c_str(), bufferStr.length()));
-  logger.debug() << "Loading font:"
-                 << QByteArray(fontNameStr.c_str(), fontNameStr.length()) << id;
 }
 
 EMSCRIPTEN_BINDINGS(MZFontLoader) {
@@ -87,5 +87,5 @@ bool CryptoSettings::getKey(uint8_t key[CRYPTO_SETTINGS_KEY_SIZE]) {
 
 // static
 CryptoSettings::Version CryptoSettings::getSupportedVersion() {
-  return CryptoSettings::EncryptionChachaPolyV1;
+  return CryptoSettings::EncryptionChachaPolyV2;
 }
@@ -77,6 +77,16 @@ void WindowsNetworkWatcher::processWlan(PWLAN_NOTIFICATION_DATA data) {
     return;
   }
 
+  // The current network is unknown until the next connection: a BSSID kept
+  // from the previous network would be stale.
+  if (data->NotificationCode == wlan_notification_msm_disconnected) {
+    if (!m_lastBSSID.isEmpty()) {
+      m_lastBSSID.clear();
+      emit networkChanged(QString());
+    }
+    return;
+  }
+
   if (data->NotificationCode != wlan_notification_msm_connected) {
     logger.debug() << "Wlan unprocessed code: " << data->NotificationCode;
     return;
@@ -0,0 +1,147 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "qmlitemindex.h"
+
+#include <QQmlApplicationEngine>
+#include <QQuickItem>
+#include <QQuickWindow>
+
+#include "leakdetector.h"
+
+QmlItemIndex::QmlItemIndex(QQmlApplicationEngine* engine) : QObject(engine) {
+  MZ_COUNT_CTOR(QmlItemIndex);
+  Q_ASSERT(engine);
+
+  for (QObject* object : engine->rootObjects()) {
+    addRootObject(object);
+  }
+
+  connect(engine, &QQmlApplicationEngine::objectCreated, this,
+          [this](QObject* object, const QUrl&) {
+            if (object) {
+              addRootObject(object);
+            }
+          });
+}
+
+QmlItemIndex::~QmlItemIndex() { MZ_COUNT_DTOR(QmlItemIndex); }
+
+void QmlItemIndex::addRootObject(QObject* object) {
+  Q_ASSERT(object);
+
+  QQuickItem* item = qobject_cast<QQuickItem*>(object);
+  if (item) {
+    track(item);
+    return;
+  }
+
+  QQuickWindow* window = qobject_cast<QQuickWindow*>(object);
+  if (window) {
+    track(window->contentItem());
+  }
+
+  for (QObject* child : object->children()) {
+    QQuickItem* item = qobject_cast<QQuickItem*>(child);
+    if (item) {
+      track(item);
+    }
+  }
+}
+
+void QmlItemIndex::track(QQuickItem* item) {
+  if (!item || m_tracked.contains(item)) {
+    return;
+  }
+
+  QString name = item->objectName();
+  m_tracked.insert(item, Entry{item, name});
+  if (!name.isEmpty()) {
+    m_items[name].append(item);
+  }
+
+  connect(item, &QObject::destroyed, this, &QmlItemIndex::untrack);
+  connect(item, &QObject::objectNameChanged, this,
+          [this, item]() { rename(item); });
+  connect(item, &QQuickItem::childrenChanged, this,
+          [this, item]() { m_dirty.insert(item); });
+
+  for (QQuickItem* child : item->childItems()) {
+    track(child);
+  }
+
+  track(item->property("contentItem").value<QQuickItem*>());
+}
+
+void QmlItemIndex::untrack(QObject* object) {
+  // The object is being destroyed: it is not a QQuickItem anymore.
+  auto i = m_tracked.find(object);
+  if (i == m_tracked.end()) {
+    return;
+  }
+
+  if (!i->m_name.isEmpty()) {
+    QList<QQuickItem*>& list = m_items[i->m_name];
+    list.removeOne(i->m_item);
+    if (list.isEmpty()) {
+      m_items.remove(i->m_name);
+    }
+  }
+
+  m_dirty.remove(object);
+  m_tracked.erase(i);
+}
+
+void QmlItemIndex::rename(QQuickItem* item) {
+  auto i = m_tracked.find(item);
+  Q_ASSERT(i != m_tracked.end());
+
+  if (!i->m_name.isEmpty()) {
+    QList<QQuickItem*>& list = m_items[i->m_name];
+    list.removeOne(item);
+    if (list.isEmpty()) {
+      m_items.remove(i->m_name);
+    }
+  }
+
+  i->m_name = item->objectName();
+  if (!i->m_name.isEmpty()) {
+    m_items[i->m_name].append(item);
+  }
+}
+
+void QmlItemIndex::flush() {
+  QSet<QObject*> dirty;
+  dirty.swap(m_dirty);
+
+  for (QObject* object : dirty) {
+    auto i = m_tracked.constFind(object);
+    if (i == m_tracked.cend()) {
+      continue;
+    }
+
+    QQuickItem* item = i->m_item;
+    for (QQuickItem* child : item->childItems()) {
+      track(child);
+    }
+
+    track(item->property("contentItem").value<QQuickItem*>());
+  }
+}
+
+QList<QQuickItem*> QmlItemIndex::items(const QString& name) {
+  flush();
+  return m_items.value(name);
+}
+
+QSet<QQuickItem*> QmlItemIndex::itemsAndAncestors(const QString& name) {
+  QSet<QQuickItem*> set;
+  for (QQuickItem* item : items(name)) {
+    while (item && !set.contains(item)) {
+      set.insert(item);
+      item = item->parentItem();
+    }
+  }
+  return set;
+}
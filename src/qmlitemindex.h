@@ -0,0 +1,69 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef QMLITEMINDEX_H
+#define QMLITEMINDEX_H
+
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QSet>
+
+class QQmlApplicationEngine;
+class QQuickItem;
+
+/**
+ * @brief objectName index of the QML item tree
+ *
+ * The items are tracked starting from the root objects of the engine. New
+ * items are discovered through the `childrenChanged` signal of their parent
+ * and forgotten when destroyed. The discovery is lazy: the changed subtrees
+ * are walked only when the index is queried.
+ *
+ * QmlPath uses the index to skip the subtrees that do not contain any item
+ * with the requested name.
+ */
+class QmlItemIndex final : public QObject {
+  Q_OBJECT
+  Q_DISABLE_COPY_MOVE(QmlItemIndex)
+
+ public:
+  explicit QmlItemIndex(QQmlApplicationEngine* engine);
+  ~QmlItemIndex();
+
+  /**
+   * @brief returns the items with the given objectName, in no particular
+   * order.
+   */
+  QList<QQuickItem*> items(const QString& name);
+
+  /**
+   * @brief returns the items with the given objectName plus all their visual
+   * ancestors.
+   */
+  QSet<QQuickItem*> itemsAndAncestors(const QString& name);
+
+ private:
+  void addRootObject(QObject* object);
+
+  void track(QQuickItem* item);
+  void untrack(QObject* object);
+  void rename(QQuickItem* item);
+
+  void flush();
+
+ private:
+  struct Entry {
+    QQuickItem* m_item;
+    QString m_name;
+  };
+
+  QHash<QObject*, Entry> m_tracked;
+  QHash<QString, QList<QQuickItem*>> m_items;
+
+  // Tracked items with new children, not walked yet.
+  QSet<QObject*> m_dirty;
+};
+
+#endif  // QMLITEMINDEX_H
@@ -10,6 +10,8 @@
 #include <QRegularExpression>
 #include <QTest>
 
+#include "qmlitemindex.h"
+
 QmlPath::QmlPath(const QString& path) {
   if (path.isEmpty()) {
     return;
@@ -133,7 +135,8 @@ bool QmlPath::parsePath(const QChar*& input, qsizetype& size,
   return true;
 }
 
-QQuickItem* QmlPath::evaluate(QQmlApplicationEngine* engine) const {
+QQuickItem* QmlPath::evaluate(QQmlApplicationEngine* engine,
+                              QmlItemIndex* index) const {
   if (!engine) {
     return nullptr;
   }
@@ -157,12 +160,13 @@ QQuickItem* QmlPath::evaluate(QQmlApplicationEngine* engine) const {
     }
   }
 
-  return evaluateItems(nullptr, list, m_blocks.cbegin());
+  return evaluateItems(nullptr, list, m_blocks.cbegin(), index);
 }
 
 QQuickItem* QmlPath::evaluateItems(QQuickItem* currentItem,
                                    const QList<QQuickItem*>& items,
-                                   QList<Data>::const_iterator i) const {
+                                   QList<Data>::const_iterator i,
+                                   QmlItemIndex* index) const {
   if (i == m_blocks.cend()) {
     return currentItem;
   }
@@ -182,9 +186,16 @@ QQuickItem* QmlPath::evaluateItems(QQuickItem* currentItem,
       }
     }
 
-    if (i->m_nested) {
+    if (i->m_nested && index) {
+      QSet<QQuickItem*> subtrees = index->itemsAndAncestors(i->m_key);
+      if (!subtrees.isEmpty()) {
+        for (QQuickItem* item : items) {
+          results.append(findItems(item, i->m_key, &subtrees));
+        }
+      }
+    } else if (i->m_nested) {
       for (QQuickItem* item : items) {
-        results.append(findItems(item, i->m_key));
+        results.append(findItems(item, i->m_key, nullptr));
       }
     }
   }
@@ -202,7 +213,8 @@ QQuickItem* QmlPath::evaluateItems(QQuickItem* currentItem,
   }
 
   for (QQuickItem* result : results) {
-    QQuickItem* item = evaluateItems(result, collectChildItems(result), i + 1);
+    QQuickItem* item =
+        evaluateItems(result, collectChildItems(result), i + 1, index);
     if (item) return item;
   }
 
@@ -223,14 +235,19 @@ QList<QQuickItem*> QmlPath::collectChildItems(QQuickItem* item) {
 }
 
 // static
-QList<QQuickItem*> QmlPath::findItems(QQuickItem* item, const QString& key) {
+QList<QQuickItem*> QmlPath::findItems(QQuickItem* item, const QString& key,
+                                      const QSet<QQuickItem*>* subtrees) {
   QList<QQuickItem*> list;
 
   for (QQuickItem* child : collectChildItems(item)) {
+    if (subtrees && !subtrees->contains(child)) {
+      continue;
+    }
+
     if (child->objectName() == key) {
       list.append(child);
     }
-    list.append(findItems(child, key));
+    list.append(findItems(child, key, subtrees));
   }
 
   return list;
@@ -3,9 +3,11 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
 
 #include <QObject>
+#include <QSet>
 
 class QQmlApplicationEngine;
 class QQuickItem;
+class QmlItemIndex;
 
 /**
  * @brief Filter a QML tree using an XPath-like syntax
@@ -29,6 +31,9 @@ class QQuickItem;
  *   `propertyName` and value set to `propertyValue`.
  *
  * Paths blocks can be concatenated: `/abc//foo[1]{p=42}/bar`
+ *
+ * When a QmlItemIndex is passed to `evaluate`, recursive searches only visit
+ * the subtrees containing an item with the requested name.
  */
 class QmlPath final {
   struct Filter {
@@ -57,7 +62,8 @@ class QmlPath final {
 
   bool isValid() const { return !m_blocks.isEmpty(); }
 
-  QQuickItem* evaluate(QQmlApplicationEngine* engine) const;
+  QQuickItem* evaluate(QQmlApplicationEngine* engine,
+                       QmlItemIndex* index = nullptr) const;
 
  private:
   static bool parsePath(const QChar*& input, qsizetype& size,
@@ -65,11 +71,14 @@ class QmlPath final {
 
   QQuickItem* evaluateItems(QQuickItem* currentItem,
                             const QList<QQuickItem*>& items,
-                            QList<Data>::const_iterator i) const;
+                            QList<Data>::const_iterator i,
+                            QmlItemIndex* index) const;
 
   static QList<QQuickItem*> collectChildItems(QQuickItem* item);
 
-  static QList<QQuickItem*> findItems(QQuickItem* item, const QString& key);
+  // When `subtrees` is set, only the items it contains are visited.
+  static QList<QQuickItem*> findItems(QQuickItem* item, const QString& key,
+                                      const QSet<QQuickItem*>* subtrees);
 
   static QList<QQuickItem*> filterByIndex(const QList<QQuickItem*>& items,
                                           const Filter& filter);
@@ -20,6 +20,7 @@
 #include "models/servercountrymodel.h"
 #include "models/serverdata.h"
 #include "mozillavpn.h"
+#include "servermessage.h"
 #include "settingsholder.h"
 
 constexpr uint32_t MAX_MSG_SIZE = 1024 * 1024;
@@ -54,8 +55,8 @@ void serializeServerCountry(ServerCountryModel* model, QJsonObject& obj) {
       cityObj["longitude"] = city.longitude();
 
       QJsonArray servers;
-      for (const QString& pubkey : city.servers()) {
-        const Server& server = model->server(pubkey);
+      for (uint32_t id : city.servers()) {
+        const Server& server = model->server(id);
         if (!server.initialized()) {
           continue;
         }
@@ -90,7 +91,7 @@ void serializeServerCountry(ServerCountryModel* model, QJsonObject& obj) {
   obj["countries"] = countries;
 }
 
-QJsonObject serializeStatus() {
+QJsonObject generateStatus() {
   MozillaVPN* vpn = MozillaVPN::instance();
 
   QJsonObject locationObj;
@@ -129,6 +130,30 @@ QJsonObject serializeStatus() {
   return obj;
 }
 
+// The server list is only changed by a fetch of the list: it is serialized
+// once and shared by all the connections.
+ServerResponseCache s_serversCache("servers", []() {
+  QJsonObject servers;
+  serializeServerCountry(MozillaVPN::instance()->serverCountryModel(),
+                         servers);
+
+  QJsonObject obj;
+  obj["servers"] = servers;
+  return obj;
+});
+
+QJsonObject s_status;
+bool s_statusValid = false;
+
+const QJsonObject& serializeStatus() {
+  if (!s_statusValid) {
+    s_status = generateStatus();
+    s_statusValid = true;
+  }
+
+  return s_status;
+}
+
 static QList<RequestType> s_types{
     RequestType{"activate",
                 [](const QJsonObject&) {
@@ -136,17 +161,6 @@ static QList<RequestType> s_types{
                   return QJsonObject();
                 }},
 
-    RequestType{"servers",
-                [](const QJsonObject&) {
-                  QJsonObject servers;
-                  serializeServerCountry(
-                      MozillaVPN::instance()->serverCountryModel(), servers);
-
-                  QJsonObject obj;
-                  obj["servers"] = servers;
-                  return obj;
-                }},
-
     RequestType{"disabled_apps",
                 [](const QJsonObject&) {
                   QJsonArray apps;
@@ -193,6 +207,14 @@ ServerConnection::ServerConnection(QObject* parent, QTcpSocket* connection)
   connect(vpn, &MozillaVPN::stateChanged, this, &ServerConnection::writeState);
   connect(vpn->connectionManager(), &ConnectionManager::stateChanged, this,
           &ServerConnection::writeState);
+
+  // Location changes are only pushed to the subscribed connections. The
+  // others have never received them.
+  connect(vpn->serverData(), &ServerData::changed, this, [this]() {
+    if (m_subscribed) {
+      writeState();
+    }
+  });
 }
 
 ServerConnection::~ServerConnection() {
@@ -249,20 +271,52 @@ void ServerConnection::readData() {
   }
 }
 
+// static
+void ServerConnection::invalidateServerList() { s_serversCache.invalidate(); }
+
+// static
+void ServerConnection::invalidateStatus() { s_statusValid = false; }
+
 void ServerConnection::writeData(const QByteArray& data) {
-  uint32_t length = (uint32_t)data.length();
-  char* rawLength = reinterpret_cast<char*>(&length);
+  writeFrame(ServerMessage::frame(data));
+}
 
-  if (m_connection->write(rawLength, sizeof(uint32_t)) != sizeof(uint32_t) ||
-      m_connection->write(data.constData(), length) != length) {
+void ServerConnection::writeFrame(const QByteArray& frame) {
+  if (m_connection->write(frame) != frame.length()) {
     m_connection->close();
   }
 }
 
 void ServerConnection::writeState() {
-  QJsonObject obj = serializeStatus();
-  obj["t"] = "status";
+  const QJsonObject& status = serializeStatus();
 
+  if (!m_subscribed) {
+    QJsonObject obj = status;
+    obj["t"] = "status";
+    writeData(QJsonDocument(obj).toJson(QJsonDocument::Compact));
+    return;
+  }
+
+  QJsonObject delta = ServerMessage::delta(m_lastStatus, status);
+  if (delta.isEmpty()) {
+    return;
+  }
+
+  m_lastStatus = status;
+
+  QJsonObject obj;
+  obj["t"] = "status_delta";
+  obj["status"] = delta;
+  writeData(QJsonDocument(obj).toJson(QJsonDocument::Compact));
+}
+
+void ServerConnection::subscribe() {
+  m_subscribed = true;
+  m_lastStatus = serializeStatus();
+
+  QJsonObject obj;
+  obj["t"] = "subscribe";
+  obj["status"] = m_lastStatus;
   writeData(QJsonDocument(obj).toJson(QJsonDocument::Compact));
 }
 
@@ -282,6 +336,16 @@ void ServerConnection::processMessage(const QByteArray& message) {
   QJsonObject obj = json.object();
   QString typeName = obj["t"].toString();
 
+  if (typeName == "servers") {
+    writeFrame(s_serversCache.frame(obj));
+    return;
+  }
+
+  if (typeName == "subscribe") {
+    subscribe();
+    return;
+  }
+
   for (const RequestType& type : s_types) {
     if (typeName == type.m_name) {
       QJsonObject responseObj = type.m_callback(obj);
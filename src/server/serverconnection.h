@@ -6,6 +6,7 @@
 #define SERVERCONNECTION_H
 
 #include <QByteArray>
+#include <QJsonObject>
 #include <QObject>
 
 class QTcpSocket;
@@ -18,11 +19,20 @@ class ServerConnection final : public QObject {
   ServerConnection(QObject* parent, QTcpSocket* connection);
   ~ServerConnection();
 
+  // The server list and the status are serialized once and shared by all the
+  // connections until these are called.
+  static void invalidateServerList();
+  static void invalidateStatus();
+
  private:
   void readData();
   void writeData(const QByteArray& data);
+  void writeFrame(const QByteArray& frame);
 
+  // Pushes the status: in full for the legacy clients, or only the changed
+  // fields for the subscribed ones.
   void writeState();
+  void subscribe();
   void writeInvalidRequest();
 
   void processMessage(const QByteArray& message);
@@ -42,6 +52,9 @@ class ServerConnection final : public QObject {
 
   QByteArray m_buffer;
   uint32_t m_messageLength = 0;
+
+  bool m_subscribed = false;
+  QJsonObject m_lastStatus;
 };
 
 #endif  // SERVERCONNECTION_H
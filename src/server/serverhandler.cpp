@@ -7,8 +7,12 @@
 #include <QHostAddress>
 #include <QTcpSocket>
 
+#include "connectionmanager.h"
 #include "leakdetector.h"
 #include "logger.h"
+#include "models/servercountrymodel.h"
+#include "models/serverdata.h"
+#include "mozillavpn.h"
 #include "serverconnection.h"
 
 namespace {
@@ -29,6 +33,20 @@ ServerHandler::ServerHandler() {
 
   connect(this, &ServerHandler::newConnection, this,
           &ServerHandler::newConnectionReceived);
+
+  // These are connected before any connection exists, so that the caches are
+  // invalidated before the connections push the new status.
+  MozillaVPN* vpn = MozillaVPN::instance();
+  connect(vpn->serverCountryModel(), &ServerCountryModel::changed, this,
+          &ServerConnection::invalidateServerList);
+  connect(vpn, &MozillaVPN::stateChanged, this,
+          &ServerConnection::invalidateStatus);
+  connect(vpn->connectionManager(), &ConnectionManager::stateChanged, this,
+          &ServerConnection::invalidateStatus);
+  connect(vpn->serverData(), &ServerData::changed, this,
+          &ServerConnection::invalidateStatus);
+  connect(vpn, &App::userStateChanged, this,
+          &ServerConnection::invalidateStatus);
 }
 
 ServerHandler::~ServerHandler() { MZ_COUNT_DTOR(ServerHandler); }
@@ -0,0 +1,76 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "servermessage.h"
+
+#include <QJsonDocument>
+#include <QJsonValue>
+
+// static
+QByteArray ServerMessage::frame(const QByteArray& message) {
+  uint32_t length = static_cast<uint32_t>(message.length());
+
+  QByteArray frame;
+  frame.reserve(sizeof(uint32_t) + message.length());
+  frame.append(reinterpret_cast<const char*>(&length), sizeof(uint32_t));
+  frame.append(message);
+  return frame;
+}
+
+// static
+QJsonObject ServerMessage::delta(const QJsonObject& previous,
+                                 const QJsonObject& current) {
+  QJsonObject delta;
+
+  for (auto i = current.constBegin(); i != current.constEnd(); ++i) {
+    if (previous.value(i.key()) != i.value()) {
+      delta.insert(i.key(), i.value());
+    }
+  }
+
+  for (auto i = previous.constBegin(); i != previous.constEnd(); ++i) {
+    if (!current.contains(i.key())) {
+      delta.insert(i.key(), QJsonValue::Null);
+    }
+  }
+
+  return delta;
+}
+
+ServerResponseCache::ServerResponseCache(
+    const QString& type, std::function<QJsonObject()>&& generator)
+    : m_type(type), m_generator(std::move(generator)) {}
+
+QByteArray ServerResponseCache::frame(const QJsonObject& request) {
+  QJsonValue knownVersion = request.value("version");
+  if (knownVersion.isDouble() &&
+      static_cast<uint32_t>(knownVersion.toDouble()) == m_version) {
+    QJsonObject obj;
+    obj["t"] = m_type;
+    obj["version"] = static_cast<double>(m_version);
+    obj["unchanged"] = true;
+    return ServerMessage::frame(
+        QJsonDocument(obj).toJson(QJsonDocument::Compact));
+  }
+
+  if (m_frame.isEmpty()) {
+    QJsonObject obj = m_generator();
+    obj["t"] = m_type;
+    obj["version"] = static_cast<double>(m_version);
+    m_frame = ServerMessage::frame(
+        QJsonDocument(obj).toJson(QJsonDocument::Compact));
+  }
+
+  return m_frame;
+}
+
+void ServerResponseCache::invalidate() {
+  // Nobody has seen the current version: no need to bump it.
+  if (m_frame.isEmpty()) {
+    return;
+  }
+
+  m_frame.clear();
+  ++m_version;
+}
@@ -0,0 +1,58 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef SERVERMESSAGE_H
+#define SERVERMESSAGE_H
+
+#include <QByteArray>
+#include <QJsonObject>
+#include <QString>
+#include <functional>
+
+// Helpers for the messages exchanged with the browser extension.
+
+class ServerMessage final {
+ public:
+  // Prefixes the message with its length, as a native-endian uint32_t, as
+  // expected on the socket.
+  static QByteArray frame(const QByteArray& message);
+
+  // Returns the top-level fields of `current` that differ from `previous`.
+  // Fields that have been removed are reported as null.
+  static QJsonObject delta(const QJsonObject& previous,
+                           const QJsonObject& current);
+
+ private:
+  ServerMessage() = delete;
+};
+
+// A response serialized and framed once, and then reused until invalidate()
+// is called. The response carries a version, bumped by each invalidation, so
+// that a client sending back the version it has already seen receives a small
+// "unchanged" response instead.
+class ServerResponseCache final {
+  Q_DISABLE_COPY_MOVE(ServerResponseCache)
+
+ public:
+  ServerResponseCache(const QString& type,
+                      std::function<QJsonObject()>&& generator);
+  ~ServerResponseCache() = default;
+
+  uint32_t version() const { return m_version; }
+
+  // Returns the framed response for a request, which may contain the version
+  // already known by the client.
+  QByteArray frame(const QJsonObject& request);
+
+  void invalidate();
+
+ private:
+  const QString m_type;
+  std::function<QJsonObject()> m_generator;
+
+  uint32_t m_version = 1;
+  QByteArray m_frame;
+};
+
+#endif  // SERVERMESSAGE_H
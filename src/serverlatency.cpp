@@ -36,29 +36,33 @@ namespace {
 Logger logger("ServerLatency");
 }
 
-ServerLatency::ServerLatency() { MZ_COUNT_CTOR(ServerLatency); }
+ServerLatency::ServerLatency() {
+  MZ_COUNT_CTOR(ServerLatency);
+
+  connect(&m_pingTimeout, &QTimer::timeout, this,
+          &ServerLatency::maybeSendPings);
+
+  m_progressDelayTimer.setSingleShot(true);
+  connect(&m_progressDelayTimer, &QTimer::timeout, this,
+          [this]() { emit progressChanged(); });
+}
 
 ServerLatency::~ServerLatency() { MZ_COUNT_DTOR(ServerLatency); }
 
 void ServerLatency::initialize() {
   MozillaVPN* vpn = MozillaVPN::instance();
 
+  connect(vpn->serverCountryModel(), &ServerCountryModel::changed, this,
+          &ServerLatency::resetCityStats);
   connect(vpn->serverCountryModel(), &ServerCountryModel::changed, this,
           &ServerLatency::start);
 
   connect(vpn->connectionManager(), &ConnectionManager::stateChanged, this,
           &ServerLatency::stateChanged);
 
-  connect(&m_pingTimeout, &QTimer::timeout, this,
-          &ServerLatency::maybeSendPings);
-
   m_refreshTimer.setSingleShot(true);
   connect(&m_refreshTimer, &QTimer::timeout, this, &ServerLatency::start);
 
-  m_progressDelayTimer.setSingleShot(true);
-  connect(&m_progressDelayTimer, &QTimer::timeout, this,
-          [this]() { emit progressChanged(); });
-
   const Feature* feature = Feature::get(Feature::Feature_serverConnectionScore);
   connect(feature, &Feature::supportedChanged, this, &ServerLatency::start);
   if (feature->isSupported()) {
@@ -84,8 +88,19 @@ void ServerLatency::start() {
     return;
   }
 
-  m_sequence = 0;
   m_wantRefresh = false;
+  sweep(SERVER_LATENCY_MAX_PARALLEL);
+}
+
+void ServerLatency::sweep(
+    int parallel, const std::function<bool(const ServerCity&)>& filter) {
+  MozillaVPN* vpn = MozillaVPN::instance();
+  if (m_pingSender != nullptr) {
+    return;
+  }
+
+  m_sequence = 0;
+  m_maxParallel = qMax(1, parallel);
   m_pingSender = PingSenderFactory::create(QHostAddress(), this);
 
   connect(m_pingSender, SIGNAL(recvPing(quint16)), this,
@@ -102,6 +117,9 @@ void ServerLatency::start() {
       double distance =
           vpn->location()->distance(city.latitude(), city.longitude());
       Q_ASSERT(city.initialized());
+      if (filter && !filter(city)) {
+        continue;
+      }
 
       // Search for where in the list to insert this city's servers.
       auto i = m_pingSendQueue.begin();
@@ -113,9 +131,9 @@ void ServerLatency::start() {
       }
 
       // Insert the servers into the list.
-      for (const QString& pubkey : city.servers()) {
+      for (uint32_t id : city.servers()) {
         ServerPingRecord rec = {
-            pubkey, city.country(), city.name(), 0, 0, distance, 0};
+            id, city.country(), city.name(), 0, 0, distance, 0};
         i = m_pingSendQueue.insert(i, rec);
       }
     }
@@ -143,18 +161,21 @@ void ServerLatency::maybeSendPings() {
     if ((record.timestamp + SERVER_LATENCY_TIMEOUT_MSEC) > now) {
       break;
     }
-    logger.debug() << "Server" << logger.keys(record.publicKey) << "timeout"
-                   << record.retries;
-
-    // Send a retry.
-    if (record.retries < SERVER_LATENCY_MAX_RETRIES) {
+    logger.debug() << "Server"
+                   << logger.keys(ServerKeys::publicKey(record.serverId))
+                   << "timeout" << record.retries;
+
+    // Send a retry, or give up on the server.
+    if (record.retries >= SERVER_LATENCY_MAX_RETRIES) {
+      emit serverPinged(record.serverId, -1, record.retries + 1);
+    } else {
       ServerPingRecord retry = record;
       retry.retries++;
       retry.sequence = m_sequence++;
       retry.timestamp = now;
       m_pingReplyList.append(retry);
 
-      const Server& server = scm->server(retry.publicKey);
+      const Server& server = scm->server(retry.serverId);
       m_pingSender->sendPing(QHostAddress(server.ipv4AddrIn()), retry.sequence);
     }
 
@@ -163,7 +184,7 @@ void ServerLatency::maybeSendPings() {
   }
 
   // Generate new pings until we reach our max number of parallel pings.
-  while (m_pingReplyList.count() < SERVER_LATENCY_MAX_PARALLEL) {
+  while (m_pingReplyList.count() < m_maxParallel) {
     if (m_pingSendQueue.isEmpty()) {
       break;
     }
@@ -174,7 +195,7 @@ void ServerLatency::maybeSendPings() {
     record.retries = 0;
     m_pingReplyList.append(record);
 
-    const Server& server = scm->server(record.publicKey);
+    const Server& server = scm->server(record.serverId);
     m_pingSender->sendPing(QHostAddress(server.ipv4AddrIn()), record.sequence);
   }
 
@@ -227,8 +248,14 @@ void ServerLatency::refresh() {
 
 void ServerLatency::clear() {
   m_latency.clear();
+  m_latencyCount = 0;
   m_sumLatencyMsec = 0;
 
+  for (CityStats& stats : m_cityStats) {
+    stats.latencySum = 0;
+    stats.latencyCount = 0;
+  }
+
   emit progressChanged();
 }
 
@@ -257,7 +284,8 @@ void ServerLatency::recvPing(quint16 sequence) {
 
     qint64 latency(now - record.timestamp);
     if (latency <= std::numeric_limits<uint>::max()) {
-      setLatency(record.publicKey, latency);
+      setLatency(record.serverId, latency);
+      emit serverPinged(record.serverId, latency, record.retries + 1);
 
       const ServerCity& city =
           scm->findCity(record.countryCode, record.cityName);
@@ -277,16 +305,50 @@ void ServerLatency::criticalPingError() {
 }
 
 qint64 ServerLatency::avgLatency() const {
-  if (m_latency.isEmpty()) {
+  if (m_latencyCount == 0) {
+    return 0;
+  }
+  return (m_sumLatencyMsec + m_latencyCount - 1) / m_latencyCount;
+}
+
+qint64 ServerLatency::getLatency(uint32_t id) const {
+  if (id >= static_cast<quint64>(m_latency.count())) {
     return 0;
   }
-  return (m_sumLatencyMsec + m_latency.count() - 1) / m_latency.count();
+  return qMax<qint64>(m_latency.at(id), 0);
 }
 
-void ServerLatency::setLatency(const QString& pubkey, qint64 msec) {
-  m_sumLatencyMsec -= m_latency[pubkey];
+void ServerLatency::setLatency(uint32_t id, qint64 msec) {
+  if (id == ServerKeys::Invalid) {
+    return;
+  }
+
+  if (id >= static_cast<quint64>(m_latency.count())) {
+    m_latency.resize(static_cast<qsizetype>(id) + 1, -1);
+  }
+
+  qint64& latency = m_latency[id];
+  if (latency < 0) {
+    latency = 0;
+    m_latencyCount++;
+  }
+
+  if (id < static_cast<quint64>(m_serverCities.count()) &&
+      !m_serverCities.at(id).isEmpty()) {
+    CityStats& stats = m_cityStats[m_serverCities.at(id)];
+    if (latency > 0) {
+      stats.latencySum -= latency;
+      stats.latencyCount--;
+    }
+    if (msec > 0) {
+      stats.latencySum += msec;
+      stats.latencyCount++;
+    }
+  }
+
+  m_sumLatencyMsec -= latency;
   m_sumLatencyMsec += msec;
-  m_latency[pubkey] = msec;
+  latency = msec;
 }
 
 double ServerLatency::progress() const {
@@ -298,16 +360,32 @@ double ServerLatency::progress() const {
   return 1.0 - (remaining / m_pingSendTotal);
 }
 
-void ServerLatency::setCooldown(const QString& publicKey, qint64 timeout) {
-  if (timeout <= 0) {
-    m_cooldown.remove(publicKey);
-  } else {
-    m_cooldown[publicKey] = QDateTime::currentSecsSinceEpoch() + timeout;
+qint64 ServerLatency::getCooldown(uint32_t id) const {
+  if (id >= static_cast<quint64>(m_cooldown.count())) {
+    return 0;
+  }
+  return m_cooldown.at(id);
+}
+
+void ServerLatency::setCooldown(uint32_t id, qint64 timeout) {
+  if (id == ServerKeys::Invalid) {
+    return;
+  }
+
+  qint64 now = QDateTime::currentSecsSinceEpoch();
+  if (id >= static_cast<quint64>(m_cooldown.count())) {
+    m_cooldown.resize(static_cast<qsizetype>(id) + 1, 0);
+  }
+  m_cooldown[id] = timeout <= 0 ? 0 : now + timeout;
+
+  if (id < static_cast<quint64>(m_serverCities.count()) &&
+      !m_serverCities.at(id).isEmpty()) {
+    updateCityCooldown(m_cityStats[m_serverCities.at(id)], now);
   }
 
   // Emit signals that the connection score may have changed.
   ServerCountryModel* scm = MozillaVPN::instance()->serverCountryModel();
-  const Server& server = scm->server(publicKey);
+  const Server& server = scm->server(id);
   const ServerCity& city =
       scm->findCity(server.countryCode(), server.cityName());
   if (city.initialized()) {
@@ -317,14 +395,8 @@ void ServerLatency::setCooldown(const QString& publicKey, qint64 timeout) {
 
 int ServerLatency::baseCityScore(const ServerCity* city,
                                  const QString& originCountry) const {
-  qint64 now = QDateTime::currentSecsSinceEpoch();
   int score = Poor;
-  int activeServerCount = 0;
-  for (const QString& pubkey : city->servers()) {
-    if (getCooldown(pubkey) <= now) {
-      activeServerCount++;
-    }
-  }
+  int activeServerCount = cityActiveServerCount(city);
 
   // Ensure there is at least one reachable server.
   if (activeServerCount == 0) {
@@ -347,3 +419,75 @@ int ServerLatency::baseCityScore(const ServerCity* city,
   }
   return score;
 }
+
+qint64 ServerLatency::cityLatency(const ServerCity* city) const {
+  const CityStats& stats = cityStats(city);
+  if (stats.latencyCount == 0) {
+    return 0;
+  }
+  return (stats.latencySum + stats.latencyCount - 1) / stats.latencyCount;
+}
+
+int ServerLatency::cityActiveServerCount(const ServerCity* city) const {
+  CityStats& stats = cityStats(city);
+
+  // Some cooldowns have expired since the last update.
+  qint64 now = QDateTime::currentSecsSinceEpoch();
+  if (stats.cooldownCount > 0 && stats.cooldownExpiry <= now) {
+    updateCityCooldown(stats, now);
+  }
+
+  return static_cast<int>(stats.servers.count()) - stats.cooldownCount;
+}
+
+ServerLatency::CityStats& ServerLatency::cityStats(
+    const ServerCity* city) const {
+  Q_ASSERT(city);
+
+  auto i = m_cityStats.find(city->hashKey());
+  if (i != m_cityStats.end() && (i->servers.isSharedWith(city->servers()) ||
+                                 i->servers == city->servers())) {
+    return *i;
+  }
+
+  // First use of this city: let's aggregate the data of its servers.
+  CityStats stats;
+  stats.servers = city->servers();
+  for (uint32_t id : stats.servers) {
+    qint64 rtt = getLatency(id);
+    if (rtt > 0) {
+      stats.latencySum += rtt;
+      stats.latencyCount++;
+    }
+
+    if (id >= static_cast<quint64>(m_serverCities.count())) {
+      m_serverCities.resize(static_cast<qsizetype>(id) + 1);
+    }
+    m_serverCities[id] = city->hashKey();
+  }
+
+  updateCityCooldown(stats, QDateTime::currentSecsSinceEpoch());
+  return *m_cityStats.insert(city->hashKey(), stats);
+}
+
+void ServerLatency::updateCityCooldown(CityStats& stats, qint64 now) const {
+  stats.cooldownCount = 0;
+  stats.cooldownExpiry = 0;
+
+  for (uint32_t id : stats.servers) {
+    qint64 cooldown = getCooldown(id);
+    if (cooldown <= now) {
+      continue;
+    }
+
+    if (stats.cooldownCount == 0 || cooldown < stats.cooldownExpiry) {
+      stats.cooldownExpiry = cooldown;
+    }
+    stats.cooldownCount++;
+  }
+}
+
+void ServerLatency::resetCityStats() {
+  m_cityStats.clear();
+  m_serverCities.clear();
+}
@@ -8,7 +8,9 @@
 #include <QDateTime>
 #include <QObject>
 #include <QTimer>
+#include <functional>
 
+#include "models/serverkeys.h"
 #include "pingsender.h"
 #include "task.h"
 
@@ -43,34 +45,71 @@ class ServerLatency final : public QObject {
   double progress() const;
 
   qint64 avgLatency() const;
+  qint64 getLatency(uint32_t id) const;
   qint64 getLatency(const QString& pubkey) const {
-    return m_latency.value(pubkey);
-  };
-  void setLatency(const QString& pubkey, qint64 msec);
+    return getLatency(ServerKeys::find(pubkey));
+  }
+  void setLatency(uint32_t id, qint64 msec);
+  void setLatency(const QString& pubkey, qint64 msec) {
+    setLatency(ServerKeys::intern(pubkey), msec);
+  }
 
+  qint64 getCooldown(uint32_t id) const;
   qint64 getCooldown(const QString& pubkey) const {
-    return m_cooldown.value(pubkey);
+    return getCooldown(ServerKeys::find(pubkey));
+  }
+  void setCooldown(uint32_t id, qint64 timeout);
+  void setCooldown(const QString& pubkey, qint64 timeout) {
+    setCooldown(ServerKeys::intern(pubkey), timeout);
   }
-  void setCooldown(const QString& pubkey, qint64 timeout);
 
   void initialize();
   void start();
   void stop();
 
+  // Pings the servers of the cities accepted by `filter`, at most `parallel`
+  // at a time. Unlike start(), this ignores the feature and the connection
+  // state: the `probe` command runs it without a controller.
+  void sweep(int parallel,
+             const std::function<bool(const ServerCity&)>& filter = nullptr);
+
   Q_INVOKABLE void refresh();
 
   int baseCityScore(const ServerCity* city, const QString& originCountry) const;
 
+  // Average latency of the servers of a city, 0 if none has been measured.
+  qint64 cityLatency(const ServerCity* city) const;
+
+  // Number of servers of a city which are not on cooldown.
+  int cityActiveServerCount(const ServerCity* city) const;
+
  signals:
   void progressChanged();
 
+  // A server replied after `sent` pings, or did not reply to any of them if
+  // `msec` is negative.
+  void serverPinged(uint32_t id, qint64 msec, int sent);
+
  private:
   void maybeSendPings();
   void clear();
 
+  struct CityStats {
+    QList<uint32_t> servers;
+    qint64 latencySum = 0;
+    int latencyCount = 0;
+    int cooldownCount = 0;
+    // Earliest expiration of the cooldowns counted in cooldownCount.
+    qint64 cooldownExpiry = 0;
+  };
+
+  CityStats& cityStats(const ServerCity* city) const;
+  void updateCityCooldown(CityStats& stats, qint64 now) const;
+  void resetCityStats();
+
  private:
   struct ServerPingRecord {
-    QString publicKey;
+    uint32_t serverId;
     QString countryCode;
     QString cityName;
     quint64 timestamp;
@@ -83,12 +122,24 @@ class ServerLatency final : public QObject {
   QList<ServerPingRecord> m_pingSendQueue;
   QList<ServerPingRecord> m_pingReplyList;
   qsizetype m_pingSendTotal = 0;
-
-  QHash<QString, qint64> m_latency;
-  QHash<QString, qint64> m_cooldown;
+  int m_maxParallel = 0;
+
+  // Indexed by the interned server id. See ServerKeys. A negative latency
+  // means that the server has not been measured yet, a zero cooldown that the
+  // server is not on cooldown.
+  QList<qint64> m_latency;
+  QList<qint64> m_cooldown;
+  qsizetype m_latencyCount = 0;
   qint64 m_sumLatencyMsec = 0;
   QDateTime m_lastUpdateTime;
 
+  // Per-city aggregates of m_latency and m_cooldown, keyed by
+  // ServerCity::hashKey(). They are built on first use and then kept in sync
+  // by setLatency() and setCooldown(). m_serverCities maps the server ids to
+  // the city hash keys.
+  mutable QHash<QString, CityStats> m_cityStats;
+  mutable QList<QString> m_serverCities;
+
   QTimer m_pingTimeout;
   QTimer m_refreshTimer;
   QTimer m_progressDelayTimer;
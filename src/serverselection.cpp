@@ -0,0 +1,148 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "serverselection.h"
+
+#include <QDateTime>
+#include <QRandomGenerator>
+
+#include "constants.h"
+#include "models/server.h"
+#include "serverlatency.h"
+#include "settingsholder.h"
+
+namespace {
+
+// Weighted random pick, skipping the `excluded` index. Servers with a zero
+// weight can still be picked when all the weights are zero.
+qsizetype weightedPick(const QList<ServerSelection::Candidate>& candidates,
+                       qsizetype excluded, QRandomGenerator* generator) {
+  quint64 weightSum = 0;
+  qsizetype available = 0;
+  for (qsizetype i = 0; i < candidates.length(); ++i) {
+    if (i != excluded) {
+      weightSum += candidates[i].weight;
+      ++available;
+    }
+  }
+
+  if (available == 0) {
+    return -1;
+  }
+
+  if (weightSum == 0) {
+    qsizetype r = generator->bounded(available);
+    for (qsizetype i = 0; i < candidates.length(); ++i) {
+      if (i != excluded && r-- == 0) {
+        return i;
+      }
+    }
+  }
+
+  quint64 r = generator->bounded(weightSum);
+  for (qsizetype i = 0; i < candidates.length(); ++i) {
+    if (i == excluded) {
+      continue;
+    }
+
+    if (r < candidates[i].weight) {
+      return i;
+    }
+
+    r -= candidates[i].weight;
+  }
+
+  Q_ASSERT(false);
+  return -1;
+}
+
+// Returns true if `a` should be preferred to `b`. Unmeasured servers are
+// assumed to be as fast as the average of the measured candidates, but a
+// measured server wins a tie: its latency is known, not guessed.
+bool isBetter(const ServerSelection::Candidate& a,
+              const ServerSelection::Candidate& b, qint64 defaultLatency) {
+  if (a.recentFailure != b.recentFailure) {
+    return !a.recentFailure;
+  }
+
+  qint64 latencyA = a.latency < 0 ? defaultLatency : a.latency;
+  qint64 latencyB = b.latency < 0 ? defaultLatency : b.latency;
+  if (latencyA != latencyB) {
+    return latencyA < latencyB;
+  }
+
+  bool measuredA = a.latency >= 0;
+  bool measuredB = b.latency >= 0;
+  if (measuredA != measuredB) {
+    return measuredA;
+  }
+
+  return a.weight > b.weight;
+}
+
+}  // namespace
+
+// static
+qsizetype ServerSelection::choose(Policy policy,
+                                  const QList<Candidate>& candidates,
+                                  QRandomGenerator* generator) {
+  Q_ASSERT(generator);
+
+  qsizetype first = weightedPick(candidates, -1, generator);
+  if (policy != PowerOfTwoChoices || candidates.length() < 2) {
+    return first;
+  }
+
+  qsizetype second = weightedPick(candidates, first, generator);
+  Q_ASSERT(second >= 0);
+
+  qint64 latencySum = 0;
+  qint64 latencyCount = 0;
+  for (const Candidate& candidate : candidates) {
+    if (candidate.latency >= 0) {
+      latencySum += candidate.latency;
+      ++latencyCount;
+    }
+  }
+  qint64 defaultLatency = latencyCount ? latencySum / latencyCount : 0;
+
+  return isBetter(candidates[second], candidates[first], defaultLatency)
+             ? second
+             : first;
+}
+
+// static
+const Server& ServerSelection::choose(const QList<Server>& servers,
+                                      const ServerLatency* serverLatency) {
+  static const Server emptyServer;
+  Q_ASSERT(!emptyServer.initialized());
+
+  Policy policy = static_cast<Policy>(
+      SettingsHolder::instance()->serverSelectionPolicy());
+  if (policy != PowerOfTwoChoices || !serverLatency) {
+    return Server::weightChooser(servers);
+  }
+
+  // The servers on cooldown have already been filtered out: an expired
+  // cooldown tells us that the server has failed recently.
+  qint64 now = QDateTime::currentSecsSinceEpoch();
+  qint64 recentFailureSince =
+      now - Constants::SERVER_UNRESPONSIVE_COOLDOWN_SEC;
+
+  QList<Candidate> candidates;
+  candidates.reserve(servers.length());
+  for (const Server& server : servers) {
+    qint64 latency = serverLatency->getLatency(server.id());
+    qint64 cooldown = serverLatency->getCooldown(server.id());
+
+    Candidate candidate;
+    candidate.weight = server.weight();
+    candidate.latency = latency > 0 ? latency : -1;
+    candidate.recentFailure = cooldown > recentFailureSince;
+    candidates.append(candidate);
+  }
+
+  qsizetype index = choose(policy, candidates, QRandomGenerator::global());
+  return index < 0 ? emptyServer : servers[index];
+}
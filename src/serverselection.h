@@ -0,0 +1,50 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef SERVERSELECTION_H
+#define SERVERSELECTION_H
+
+#include <QList>
+
+class QRandomGenerator;
+class Server;
+class ServerLatency;
+
+// Picks the server to connect to, among the servers of a city.
+class ServerSelection final {
+ public:
+  // Stored in the serverSelectionPolicy setting.
+  enum Policy {
+    // Weighted random pick: the measured latencies are ignored.
+    WeightedRandom = 0,
+
+    // Two distinct servers are picked with the weighted random policy, and
+    // the best one is used: the load is still spread following the weights,
+    // but the slowest servers of the city are avoided. In a city with only
+    // two servers, the same pair is always compared: the best server is then
+    // always used, and the load is not spread at all.
+    PowerOfTwoChoices = 1,
+  };
+
+  struct Candidate {
+    uint32_t weight = 0;
+    // Negative if the server has not been measured yet.
+    qint64 latency = -1;
+    // The server has failed a handshake recently.
+    bool recentFailure = false;
+  };
+
+  // Returns the index of the chosen candidate, or -1 if the list is empty.
+  static qsizetype choose(Policy policy, const QList<Candidate>& candidates,
+                          QRandomGenerator* generator);
+
+  // Chooses a server using the policy stored in the settings.
+  static const Server& choose(const QList<Server>& servers,
+                              const ServerLatency* serverLatency);
+
+ private:
+  ServerSelection() = delete;
+};
+
+#endif  // SERVERSELECTION_H
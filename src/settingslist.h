@@ -511,6 +511,17 @@ SETTING_BYTEARRAY(serverData,        // getter
                   true               // sensitive (do not log)
 )
 
+SETTING_INT(serverSelectionPolicy,        // getter
+            setServerSelectionPolicy,     // setter
+            removeServerSelectionPolicy,  // remover
+            hasServerSelectionPolicy,     // has
+            "serverSelectionPolicy",      // key
+            1,      // default value: ServerSelection::PowerOfTwoChoices
+            true,   // user setting
+            false,  // remove when reset
+            false   // sensitive (do not log)
+)
+
 SETTING_BOOL(serverSwitchNotification,        // getter
              setServerSwitchNotification,     // setter
              removeServerSwitchNotification,  // remover
@@ -58,14 +58,38 @@ StatusIcon::StatusIcon() {
 StatusIcon::~StatusIcon() { MZ_COUNT_DTOR(StatusIcon); }
 
 const QIcon& StatusIcon::icon() {
-  if (m_icon.isNull()) {
-    m_icon = drawStatusIndicator();
-    Q_ASSERT(!m_icon.isNull());
+  if (!m_icon.isNull()) {
+    return m_icon;
+  }
+
+  IconKey key = currentIconKey();
+  auto i = m_iconAtlas.constFind(key);
+  if (i == m_iconAtlas.constEnd()) {
+    QColor color;
+    if (key.second != 0) {
+      color = QColor::fromRgba(key.second);
+    }
+    i = m_iconAtlas.insert(key, drawStatusIndicator(key.first, color));
   }
 
+  m_icon = i.value();
+  Q_ASSERT(!m_icon.isNull());
   return m_icon;
 }
 
+StatusIcon::IconKey StatusIcon::currentIconKey() {
+  QString frame = iconString();
+
+  // Only draw a status indicator if the VPN is connected
+  QColor color;
+  if (MozillaVPN::instance()->connectionManager()->state() ==
+      ConnectionManager::StateOn) {
+    color = indicatorColor();
+  }
+
+  return IconKey(frame, color.isValid() ? color.rgba() : 0);
+}
+
 void StatusIcon::activateAnimation() {
   logger.debug() << "Activate animation";
   m_animatedIconIndex = 0;
@@ -151,22 +175,26 @@ const QColor StatusIcon::indicatorColor() const {
 void StatusIcon::refreshNeeded() {
   logger.debug() << "Refresh needed";
 
-  if (!m_icon.isNull()) {
-    m_icon = QIcon();
+  // The icon is only updated when its frame or its indicator color change:
+  // the tray does not upload the same icon again.
+  IconKey key = currentIconKey();
+  if (key == m_iconKey) {
+    return;
   }
+
+  m_iconKey = key;
+  m_icon = QIcon();
   emit iconUpdateNeeded();
 }
 
-QIcon StatusIcon::drawStatusIndicator() {
+QIcon StatusIcon::drawStatusIndicator(const QString& frame,
+                                      const QColor& color) const {
   logger.debug() << "Get icon from URL";
 
   // Create pixmap so that we can paint on the original resource.
-  QPixmap iconPixmap = QPixmap(iconString());
+  QPixmap iconPixmap = QPixmap(frame);
 
-  MozillaVPN* vpn = MozillaVPN::instance();
-
-  // Only draw a status indicator if the VPN is connected
-  if (vpn->connectionManager()->state() == ConnectionManager::StateOn) {
+  if (color.isValid()) {
     QPainter painter(&iconPixmap);
     painter.setRenderHint(QPainter::Antialiasing);
     painter.setPen(Qt::NoPen);
@@ -183,7 +211,7 @@ QIcon StatusIcon::drawStatusIndicator() {
     float dotSize = maskSize - dotPadding;
     float dotPosition = maskPosition + dotPadding * 0.5;
     QRectF indicatorDot(dotPosition, dotPosition, dotSize, dotSize);
-    painter.setBrush(indicatorColor());
+    painter.setBrush(color);
     painter.drawEllipse(indicatorDot);
   }
 
@@ -5,8 +5,10 @@
 #ifndef STATUSICON_H
 #define STATUSICON_H
 
+#include <QHash>
 #include <QIcon>
 #include <QObject>
+#include <QPair>
 #include <QTimer>
 #include <QUrl>
 
@@ -24,6 +26,15 @@ class StatusIcon final : public QObject {
   const QString iconString();
   const QColor indicatorColor() const;
 
+  // The frame and the indicator color of an icon. No indicator is 0: the
+  // indicator colors are opaque.
+  using IconKey = QPair<QString, QRgb>;
+
+#ifdef UNIT_TEST
+  // The key of the icon shown since the last iconUpdateNeeded signal.
+  const IconKey& iconKey() const { return m_iconKey; }
+#endif
+
  signals:
   void iconUpdateNeeded();
 
@@ -35,11 +46,17 @@ class StatusIcon final : public QObject {
 
  private:
   void activateAnimation();
-  QIcon drawStatusIndicator();
+  QIcon drawStatusIndicator(const QString& frame, const QColor& color) const;
   void generateIcon();
+  IconKey currentIconKey();
 
  private:
   QIcon m_icon;
+  IconKey m_iconKey;
+
+  // Finished icons, by resource and indicator color. The frames are decoded
+  // and composed once: then, changing the icon only shares a cached QIcon.
+  QHash<IconKey, QIcon> m_iconAtlas;
 
   // Animated icon.
   QTimer m_animatedIconTimer;
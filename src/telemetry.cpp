@@ -269,6 +269,9 @@ void Telemetry::startTimeToFirstScreenTimer() {
 
   m_timeToFirstScreenTimerId =
       mozilla::glean::performance::time_to_main_screen.start();
+
+  m_timeToFirstScreenTimer.start();
+  m_timeToFirstScreenStageMsec = 0;
 }
 
 void Telemetry::stopTimeToFirstScreenTimer() {
@@ -276,6 +279,21 @@ void Telemetry::stopTimeToFirstScreenTimer() {
 
   mozilla::glean::performance::time_to_main_screen.stopAndAccumulate(
       m_timeToFirstScreenTimerId);
+
+  timeToFirstScreenStage("mainScreen");
+  m_timeToFirstScreenTimer.invalidate();
+}
+
+void Telemetry::timeToFirstScreenStage(const char* stage) {
+  if (!m_timeToFirstScreenTimer.isValid()) {
+    return;
+  }
+
+  qint64 elapsed = m_timeToFirstScreenTimer.elapsed();
+  logger.info() << "Time to main screen, stage" << stage << "in"
+                << elapsed - m_timeToFirstScreenStageMsec << "msec, total"
+                << elapsed << "msec";
+  m_timeToFirstScreenStageMsec = elapsed;
 }
 
 #if defined(MZ_WINDOWS) || defined(MZ_LINUX) || defined(MZ_MACOS)
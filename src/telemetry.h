@@ -5,6 +5,7 @@
 #ifndef TELEMETRY_H
 #define TELEMETRY_H
 
+#include <QElapsedTimer>
 #include <QObject>
 #include <QTimer>
 
@@ -18,6 +19,10 @@ class Telemetry final : public QObject {
   void startTimeToFirstScreenTimer();
   void stopTimeToFirstScreenTimer();
 
+  // Records that a startup stage is completed, with the time it took since
+  // the previous one. Nothing happens if the timer is not running.
+  void timeToFirstScreenStage(const char* stage);
+
  private:
   void connectionStabilityEvent();
   void vpnSessionPingTimeout();
@@ -45,6 +50,10 @@ class Telemetry final : public QObject {
 
   // The Glean timer id for the performance.time_to_main_screen metric.
   qint64 m_timeToFirstScreenTimerId = 0;
+
+  // The per-stage timings of the time to the main screen.
+  QElapsedTimer m_timeToFirstScreenTimer;
+  qint64 m_timeToFirstScreenStageMsec = 0;
 };
 
 #endif  // TELEMETRY_H
@@ -0,0 +1,160 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "tracer.h"
+
+#include <QCoreApplication>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRandomGenerator>
+#include <QThread>
+#include <chrono>
+
+namespace {
+// The oldest spans are dropped beyond this limit.
+constexpr qsizetype MAX_SPANS = 4096;
+}  // namespace
+
+// static
+Tracer* Tracer::instance() {
+  static Tracer s_instance;
+  return &s_instance;
+}
+
+// static
+qint64 Tracer::now() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+QString Tracer::startTrace() {
+  QString traceId =
+      QString::number(QRandomGenerator::global()->generate64(), 16);
+
+  QMutexLocker<QMutex> lock(&m_mutex);
+  m_traceId = traceId;
+  return traceId;
+}
+
+QString Tracer::traceId() const {
+  QMutexLocker<QMutex> lock(&m_mutex);
+  return m_traceId;
+}
+
+void Tracer::setTraceId(const QString& traceId) {
+  QMutexLocker<QMutex> lock(&m_mutex);
+  m_traceId = traceId;
+}
+
+void Tracer::addSpan(const QString& name, qint64 startUsec, qint64 endUsec) {
+  Span span;
+  span.m_name = name;
+  span.m_pid = QCoreApplication::applicationPid();
+  span.m_tid = static_cast<qint64>(
+      reinterpret_cast<quintptr>(QThread::currentThreadId()));
+  span.m_start = startUsec;
+  span.m_duration = qMax<qint64>(endUsec - startUsec, 0);
+
+  QMutexLocker<QMutex> lock(&m_mutex);
+  span.m_traceId = m_traceId;
+  addSpanLocked(std::move(span));
+}
+
+void Tracer::addSpanLocked(Span&& span) {
+  if (m_spans.length() >= MAX_SPANS) {
+    m_spans.removeFirst();
+  }
+  m_spans.append(std::move(span));
+}
+
+// static
+QJsonObject Tracer::spanToJson(const Span& span) {
+  QJsonObject args;
+  args["traceId"] = span.m_traceId;
+
+  // A "complete" event. See the Trace Event Format documentation.
+  QJsonObject obj;
+  obj["name"] = span.m_name;
+  obj["cat"] = "activation";
+  obj["ph"] = "X";
+  obj["ts"] = span.m_start;
+  obj["dur"] = span.m_duration;
+  obj["pid"] = span.m_pid;
+  obj["tid"] = span.m_tid;
+  obj["args"] = args;
+  return obj;
+}
+
+QJsonArray Tracer::events(const QString& traceId) const {
+  QMutexLocker<QMutex> lock(&m_mutex);
+
+  QJsonArray events;
+  for (const Span& span : m_spans) {
+    if (traceId.isEmpty() || span.m_traceId == traceId) {
+      events.append(spanToJson(span));
+    }
+  }
+  return events;
+}
+
+QJsonArray Tracer::takeEvents() {
+  QMutexLocker<QMutex> lock(&m_mutex);
+
+  QJsonArray events;
+  for (const Span& span : m_spans) {
+    events.append(spanToJson(span));
+  }
+  m_spans.clear();
+  return events;
+}
+
+void Tracer::importEvents(const QJsonArray& events) {
+  QMutexLocker<QMutex> lock(&m_mutex);
+
+  for (const QJsonValue& value : events) {
+    QJsonObject obj = value.toObject();
+    if (obj["ph"].toString() != "X" || !obj["name"].isString() ||
+        !obj["ts"].isDouble()) {
+      continue;
+    }
+
+    Span span;
+    span.m_name = obj["name"].toString();
+    span.m_traceId = obj["args"].toObject()["traceId"].toString();
+    span.m_pid = obj["pid"].toInteger();
+    span.m_tid = obj["tid"].toInteger();
+    span.m_start = obj["ts"].toInteger();
+    span.m_duration = obj["dur"].toInteger();
+    addSpanLocked(std::move(span));
+  }
+}
+
+QByteArray Tracer::toChromeTrace(const QString& traceId) const {
+  QJsonObject obj;
+  obj["traceEvents"] = events(traceId);
+  obj["displayTimeUnit"] = "ms";
+  return QJsonDocument(obj).toJson(QJsonDocument::Compact);
+}
+
+void Tracer::clear() {
+  QMutexLocker<QMutex> lock(&m_mutex);
+  m_spans.clear();
+}
+
+void Tracer::serializeLogs(
+    std::function<void(const QString& name, const QString& logs)>&&
+        a_callback) {
+  std::function<void(const QString& name, const QString& logs)> callback =
+      std::move(a_callback);
+
+  bool empty;
+  {
+    QMutexLocker<QMutex> lock(&m_mutex);
+    empty = m_spans.isEmpty();
+  }
+
+  callback("Activation traces (Chrome trace-event format)",
+           empty ? QString() : QString::fromUtf8(toChromeTrace()));
+}
@@ -0,0 +1,100 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef TRACER_H
+#define TRACER_H
+
+#include <QJsonArray>
+#include <QList>
+#include <QMutex>
+#include <QString>
+
+#include "loghandler.h"
+
+// Lightweight span tracing, used to understand where the time goes during an
+// activation. Spans are tagged with the current trace id, which the client
+// sends to the daemon with the activation request, so that the spans of both
+// processes can be merged into a single timeline. The timestamps come from
+// the monotonic clock, which is shared by all the processes of the machine.
+//
+// The spans are exported in the Chrome trace-event format, which can be
+// loaded in chrome://tracing or https://ui.perfetto.dev.
+
+class Tracer final : public LogSerializer {
+  Q_DISABLE_COPY_MOVE(Tracer)
+
+ public:
+  static Tracer* instance();
+
+  // Monotonic timestamp, in microseconds.
+  static qint64 now();
+
+  // Generates a new trace id, and makes it the current one.
+  QString startTrace();
+
+  QString traceId() const;
+  void setTraceId(const QString& traceId);
+
+  // Records a span of the current trace.
+  void addSpan(const QString& name, qint64 startUsec, qint64 endUsec);
+
+  // Returns the trace events, of the given trace or of all of them.
+  QJsonArray events(const QString& traceId = QString()) const;
+
+  // Returns and forgets the trace events. Used by the daemon to send its
+  // spans to the client.
+  QJsonArray takeEvents();
+
+  // Adds the trace events recorded by another process.
+  void importEvents(const QJsonArray& events);
+
+  // Returns a Chrome trace-event JSON document.
+  QByteArray toChromeTrace(const QString& traceId = QString()) const;
+
+  void clear();
+
+  // LogSerializer
+  void serializeLogs(
+      std::function<void(const QString& name, const QString& logs)>&&
+          callback) override;
+
+ private:
+  Tracer() = default;
+  ~Tracer() = default;
+
+  struct Span {
+    QString m_name;
+    QString m_traceId;
+    qint64 m_pid = 0;
+    qint64 m_tid = 0;
+    qint64 m_start = 0;
+    qint64 m_duration = 0;
+  };
+
+  void addSpanLocked(Span&& span);
+  static QJsonObject spanToJson(const Span& span);
+
+ private:
+  mutable QMutex m_mutex;
+  QString m_traceId;
+  QList<Span> m_spans;
+};
+
+// Records a span from its construction to its destruction.
+class TraceSpan final {
+  Q_DISABLE_COPY_MOVE(TraceSpan)
+
+ public:
+  explicit TraceSpan(const char* name) : m_name(name), m_start(Tracer::now()) {}
+  ~TraceSpan() {
+    Tracer::instance()->addSpan(QString::fromLatin1(m_name), m_start,
+                                Tracer::now());
+  }
+
+ private:
+  const char* m_name;
+  const qint64 m_start;
+};
+
+#endif  // TRACER_H
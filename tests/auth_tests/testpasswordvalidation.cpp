@@ -7,9 +7,11 @@
 #include <QDebug>
 #include <QEventLoop>
 #include <QTest>
+#include <QtEndian>
+#include <algorithm>
 
 #include "authenticationinapp/authenticationinapp.h"
-#include "authenticationinapp/incrementaldecoder.h"
+#include "authenticationinapp/passwordindex.h"
 #include "constants.h"
 #include "tasks/authenticate/taskauthenticate.h"
 
@@ -28,44 +30,129 @@ class EventLoop final : public QEventLoop {
   }
 };
 
-void TestPasswordValidation::incrementalDecoder_data() {
-  QTest::addColumn<QString>("buffer");
-  QTest::addColumn<QString>("input");
-  QTest::addColumn<IncrementalDecoder::Result>("result");
+namespace {
+void appendUint32(QByteArray& buffer, uint32_t value) {
+  char data[4];
+  qToLittleEndian<quint32>(value, data);
+  buffer.append(data, 4);
+}
 
-  QTest::addRow("empty") << ""
-                         << "" << IncrementalDecoder::MatchNotFound;
+// Builds an index as scripts/utils/generate_password_index.py does.
+QByteArray buildIndex(const QStringList& list, uint32_t blockSize) {
+  QList<QByteArray> entries;
+  for (const QString& entry : list) {
+    entries.append(entry.toLatin1());
+  }
 
-  {
-    QString buffer;
-    buffer.append("0word\n3ld");
-    QTest::addRow("match 1")
-        << buffer << "world" << IncrementalDecoder::MatchFound;
+  std::sort(entries.begin(), entries.end());
+  entries.erase(std::unique(entries.begin(), entries.end()), entries.end());
+
+  QByteArray offsets;
+  QByteArray data;
+  QByteArray prev;
+  for (qsizetype i = 0; i < entries.length(); ++i) {
+    const QByteArray& entry = entries[i];
+    if (i % blockSize == 0) {
+      appendUint32(offsets, data.length());
+      data.append(entry);
+    } else {
+      qsizetype shared = 0;
+      while (shared < prev.length() && shared < entry.length() &&
+             prev[shared] == entry[shared]) {
+        ++shared;
+      }
+      data.append(static_cast<char>(shared));
+      data.append(entry.mid(shared));
+    }
+    data.append('\0');
+    prev = entry;
   }
 
-  {
-    QString buffer;
-    buffer.append("0entry\n52\n61\n0out_of_order");
-    QTest::addRow("match 2")
-        << buffer << "entry" << IncrementalDecoder::MatchFound;
-    QTest::addRow("match 3")
-        << buffer << "entry2" << IncrementalDecoder::MatchFound;
-    QTest::addRow("match 4")
-        << buffer << "entry21" << IncrementalDecoder::MatchFound;
-    QTest::addRow("match 5")
-        << buffer << "out_of_order" << IncrementalDecoder::MatchFound;
+  QByteArray index("MZPI");
+  appendUint32(index, 1);
+  appendUint32(index, entries.length());
+  appendUint32(index, blockSize);
+  appendUint32(index, offsets.length() / 4);
+  appendUint32(index, data.length());
+  index.append(offsets);
+  index.append(data);
+  return index;
+}
+}  // namespace
+
+void TestPasswordValidation::passwordIndex_data() {
+  QTest::addColumn<QStringList>("entries");
+  QTest::addColumn<int>("blockSize");
+  QTest::addColumn<QString>("input");
+  QTest::addColumn<bool>("result");
+
+  QTest::addRow("empty") << QStringList() << 1 << "" << false;
+  QTest::addRow("empty input")
+      << QStringList{"world"} << 1 << "" << false;
+
+  QTest::addRow("match 1") << QStringList{"word", "world"} << 4 << "world"
+                           << true;
+  QTest::addRow("no match 1")
+      << QStringList{"word", "world"} << 4 << "wor" << false;
+  QTest::addRow("no match 2")
+      << QStringList{"word", "world"} << 4 << "worlds" << false;
+  QTest::addRow("no match 3")
+      << QStringList{"word", "world"} << 4 << "aaaa" << false;
+  QTest::addRow("no match 4")
+      << QStringList{"word", "world"} << 4 << "zzzz" << false;
+  QTest::addRow("non-ascii")
+      << QStringList{"word", "world"} << 4 << "wörld" << false;
+
+  QStringList entries{"entry", "entry2", "entry21", "out_of_order", "a",
+                      "b",     "c",      "entry",   "zzz"};
+  for (int blockSize : {1, 2, 3, 32}) {
+    for (const QString& entry : entries) {
+      QTest::addRow("match %s (block size %d)", qPrintable(entry), blockSize)
+          << entries << blockSize << entry << true;
+    }
+
+    QTest::addRow("no match (block size %d)", blockSize)
+        << entries << blockSize << "entry3" << false;
   }
 }
 
-void TestPasswordValidation::incrementalDecoder() {
-  QFETCH(QString, buffer);
+void TestPasswordValidation::passwordIndex() {
+  QFETCH(QStringList, entries);
+  QFETCH(int, blockSize);
   QFETCH(QString, input);
-  QFETCH(IncrementalDecoder::Result, result);
+  QFETCH(bool, result);
+
+  PasswordIndex index;
+  QVERIFY(index.loadFromData(buildIndex(entries, blockSize)));
+  QCOMPARE(index.contains(input), result);
+}
+
+void TestPasswordValidation::passwordIndexInvalid_data() {
+  QTest::addColumn<QByteArray>("data");
+
+  QByteArray valid = buildIndex(QStringList{"hello", "world"}, 1);
 
-  QTextStream stream(&buffer);
+  QTest::addRow("empty") << QByteArray();
+  QTest::addRow("magic") << QByteArray("MZPX").append(valid.mid(4));
+  QTest::addRow("truncated") << valid.chopped(1);
+  QTest::addRow("trailing data") << QByteArray(valid).append('\0');
 
-  IncrementalDecoder id(this);
-  QCOMPARE(id.match(stream, input), result);
+  QByteArray version(valid);
+  version[4] = 2;
+  QTest::addRow("version") << version;
+
+  QByteArray offsets(valid);
+  offsets[28] = 0;
+  QTest::addRow("offsets") << offsets;
+}
+
+void TestPasswordValidation::passwordIndexInvalid() {
+  QFETCH(QByteArray, data);
+
+  PasswordIndex index;
+  QVERIFY(!index.loadFromData(data));
+  QVERIFY(!index.isValid());
+  QVERIFY(!index.contains("hello"));
 }
 
 void TestPasswordValidation::commonPasswords_data() {
@@ -92,6 +179,25 @@ void TestPasswordValidation::commonPasswords() {
   QCOMPARE(aia->validatePasswordCommons(input), result);
 }
 
+void TestPasswordValidation::commonPasswordsBenchmark_data() {
+  QTest::addColumn<QString>("input");
+
+  QTest::addRow("common") << "12345678";
+  QTest::addRow("not common") << "12345678!!";
+}
+
+void TestPasswordValidation::commonPasswordsBenchmark() {
+  QFETCH(QString, input);
+
+  AuthenticationInApp* aia = AuthenticationInApp::instance();
+  QVERIFY(!!aia);
+
+  // The first check maps the index.
+  aia->validatePasswordCommons(input);
+
+  QBENCHMARK { aia->validatePasswordCommons(input); }
+}
+
 void TestPasswordValidation::passwordLength_data() {
   QTest::addColumn<QString>("input");
   QTest::addColumn<bool>("result");
@@ -11,12 +11,18 @@ class TestPasswordValidation final : public QObject {
   explicit TestPasswordValidation(const QString& nonce) : m_nonce(nonce) {}
 
  private slots:
-  void incrementalDecoder_data();
-  void incrementalDecoder();
+  void passwordIndex_data();
+  void passwordIndex();
+
+  void passwordIndexInvalid_data();
+  void passwordIndexInvalid();
 
   void commonPasswords_data();
   void commonPasswords();
 
+  void commonPasswordsBenchmark_data();
+  void commonPasswordsBenchmark();
+
   void passwordLength_data();
   void passwordLength();
 
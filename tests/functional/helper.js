@@ -40,6 +40,7 @@ module.exports = {
             // Ignoring logs.
             if (json.type === 'log') return;
             if (json.type === 'network') return;
+            if (json.type === 'navigation') return;
 
             // Store the last notification
             if (json.type === 'notification') {
@@ -109,9 +110,11 @@ module.exports = {
 
   async waitForInitialView() {
     await this.waitForQuery(queries.screenInitialize.GET_HELP_LINK.visible());
-    assert(await this.query(queries.screenInitialize.SIGN_UP_BUTTON.visible()));
-    assert(await this.query(
-        queries.screenInitialize.ALREADY_A_SUBSCRIBER_LINK.visible()));
+    const results = await this.queryMany([
+      queries.screenInitialize.SIGN_UP_BUTTON.visible(),
+      queries.screenInitialize.ALREADY_A_SUBSCRIBER_LINK.visible(),
+    ]);
+    assert(results.every(result => result));
   },
 
   async forceHeartbeatFailure() {
@@ -175,6 +178,15 @@ module.exports = {
     return json.value || false;
   },
 
+  async queryMany(ids) {
+    const json = await this._writeCommand(
+        `query_many ${encodeURIComponent(JSON.stringify(ids))}`);
+    assert(
+        json.type === 'query_many' && !('error' in json),
+        `Command failed: ${json.error}`);
+    return json.value;
+  },
+
   async waitForQuery(id) {
     return this.waitForCondition(async () => {
       return await this.query(id);
@@ -2,6 +2,7 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
 
+#include "connectionhealth.h"
 #include "controller.h"
 #include "helper.h"
 #include "models/location.h"
@@ -31,7 +32,10 @@ MozillaVPN::~MozillaVPN() {}
 
 CaptivePortal* MozillaVPN::captivePortal() const { return nullptr; }
 
-ConnectionHealth* MozillaVPN::connectionHealth() const { return nullptr; }
+ConnectionHealth* MozillaVPN::connectionHealth() const {
+  static ConnectionHealth* connectionHealth = new ConnectionHealth();
+  return connectionHealth;
+}
 
 Controller* MozillaVPN::controller() const { return new Controller(); }
 
@@ -0,0 +1,29 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "testbenchmarkpayload.h"
+
+#include "connectionbenchmark/benchmarkpayload.h"
+#include "constants.h"
+
+void TestBenchmarkPayload::shared() {
+  QByteArray first = BenchmarkPayload::data(1000);
+  QCOMPARE(first.size(), 1000);
+  QCOMPARE(first, QByteArray(1000, '\0'));
+
+  // The payload is page-aligned, and it is not copied.
+  QVERIFY(reinterpret_cast<quintptr>(first.constData()) % 4096 == 0);
+  QByteArray second = BenchmarkPayload::data(2000);
+  QCOMPARE(second.constData(), first.constData());
+}
+
+void TestBenchmarkPayload::bounds() {
+  QVERIFY(BenchmarkPayload::data(0).isEmpty());
+  QVERIFY(BenchmarkPayload::data(-1).isEmpty());
+  QCOMPARE(
+      BenchmarkPayload::data(Constants::BENCHMARK_MAX_BYTES_UPLOAD + 1).size(),
+      static_cast<qsizetype>(Constants::BENCHMARK_MAX_BYTES_UPLOAD));
+}
+
+static TestBenchmarkPayload s_testBenchmarkPayload;
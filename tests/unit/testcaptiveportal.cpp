@@ -0,0 +1,270 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "testcaptiveportal.h"
+
+#include <QElapsedTimer>
+#include <QSignalSpy>
+#include <QTcpServer>
+#include <QTcpSocket>
+
+#include "captiveportal/captiveportal.h"
+#include "captiveportal/captiveportalnetworkcache.h"
+#include "captiveportal/captiveportalrequest.h"
+#include "networkrequest.h"
+#include "settingsholder.h"
+#include "simplenetworkmanager.h"
+#include "tasks/function/taskfunction.h"
+
+namespace {
+
+constexpr int TIMEOUT_MSEC = 5000;
+
+// The timers can fire a bit early.
+constexpr int ATTEMPT_DELAY_MIN_MSEC =
+    CAPTIVEPORTAL_ATTEMPT_DELAY_MSEC * 9 / 10;
+
+constexpr const char* NO_PORTAL_REPLY =
+    "HTTP/1.1 200 OK\r\n"
+    "Content-Length: 8\r\n"
+    "Connection: close\r\n"
+    "\r\n"
+    "success\n";
+
+constexpr const char* PORTAL_REPLY =
+    "HTTP/1.1 200 OK\r\n"
+    "Content-Length: 6\r\n"
+    "Connection: close\r\n"
+    "\r\n"
+    "login\n";
+
+// The captive-portal endpoint of one attempt. Each attempt has its own
+// port, to know which one the request has reached, and when.
+class PortalServer final {
+ public:
+  explicit PortalServer(const QElapsedTimer& clock) : m_clock(clock) {
+    m_server.listen(QHostAddress::LocalHost);
+    QObject::connect(&m_server, &QTcpServer::newConnection, &m_server,
+                     [this]() {
+                       while (m_server.hasPendingConnections()) {
+                         QTcpSocket* socket = m_server.nextPendingConnection();
+                         if (!m_socket) {
+                           m_socket = socket;
+                           m_connectedAt = m_clock.elapsed();
+                         }
+                       }
+                     });
+  }
+
+  QString address() const {
+    return QString("127.0.0.1:%1").arg(m_server.serverPort());
+  }
+
+  // Elapsed msecs of the clock when the attempt has connected, or -1.
+  qint64 connectedAt() const { return m_connectedAt; }
+
+  bool waitForRequest() {
+    return QTest::qWaitFor(
+        [this]() {
+          if (!m_socket) {
+            return false;
+          }
+          m_request.append(m_socket->readAll());
+          return m_request.contains("\r\n\r\n");
+        },
+        TIMEOUT_MSEC);
+  }
+
+  void reply(const char* response) { m_socket->write(response); }
+
+  // The attempt has been cancelled.
+  bool waitForDisconnected() {
+    return QTest::qWaitFor(
+        [this]() {
+          return m_socket &&
+                 m_socket->state() == QAbstractSocket::UnconnectedState;
+        },
+        TIMEOUT_MSEC);
+  }
+
+ private:
+  const QElapsedTimer& m_clock;
+  QTcpServer m_server;
+  QTcpSocket* m_socket = nullptr;
+  qint64 m_connectedAt = -1;
+  QByteArray m_request;
+};
+
+// An address where the connection is refused.
+QString closedAddress() {
+  QTcpServer server;
+  server.listen(QHostAddress::LocalHost);
+  QString address = QString("127.0.0.1:%1").arg(server.serverPort());
+  server.close();
+  return address;
+}
+
+CaptivePortalRequest* createRequest(Task* task,
+                                    const QStringList& ipv4Addresses) {
+  SettingsHolder* settingsHolder = SettingsHolder::instance();
+  settingsHolder->setCaptivePortalIpv4Addresses(ipv4Addresses);
+  settingsHolder->setCaptivePortalIpv6Addresses(QStringList());
+  return new CaptivePortalRequest(task);
+}
+
+}  // namespace
+
+void TestCaptivePortal::init() {
+  // The requests reach the local servers.
+  NetworkRequest::setRequestHandler(
+      [](NetworkRequest*) { return false; },
+      [](NetworkRequest*) { return false; },
+      [](NetworkRequest*, const QByteArray&) { return false; },
+      [](NetworkRequest*, QIODevice*) { return false; });
+}
+
+void TestCaptivePortal::cleanup() {
+  NetworkRequest::setRequestHandler(
+      TestHelper::networkRequestDelete, TestHelper::networkRequestGet,
+      TestHelper::networkRequestPost, TestHelper::networkRequestPostIODevice);
+}
+
+void TestCaptivePortal::staggeredAttempts() {
+  SettingsHolder settingsHolder;
+  SimpleNetworkManager snm;
+  TaskFunction task([]() {});
+
+  QElapsedTimer clock;
+  PortalServer first(clock);
+  PortalServer second(clock);
+  PortalServer third(clock);
+
+  CaptivePortalRequest* request = createRequest(
+      &task, {first.address(), second.address(), third.address()});
+  QSignalSpy spy(request, &CaptivePortalRequest::completed);
+
+  clock.start();
+  request->run();
+
+  // While the previous attempts are pending, a new one starts after the
+  // attempt delay.
+  QVERIFY(first.waitForRequest());
+  QVERIFY(second.waitForRequest());
+  QVERIFY(second.connectedAt() >= ATTEMPT_DELAY_MIN_MSEC);
+  QVERIFY(third.waitForRequest());
+  QVERIFY(third.connectedAt() - second.connectedAt() >=
+          ATTEMPT_DELAY_MIN_MSEC);
+
+  // The first answer decides, and the other attempts are cancelled.
+  third.reply(NO_PORTAL_REPLY);
+  QVERIFY(spy.wait(TIMEOUT_MSEC));
+  QCOMPARE(spy.count(), 1);
+  QCOMPARE(spy.at(0).at(0).value<CaptivePortalRequest::CaptivePortalResult>(),
+           CaptivePortalRequest::NoPortal);
+
+  QVERIFY(first.waitForDisconnected());
+  QVERIFY(second.waitForDisconnected());
+}
+
+void TestCaptivePortal::failureStartsNextAttempt() {
+  SettingsHolder settingsHolder;
+  SimpleNetworkManager snm;
+  TaskFunction task([]() {});
+
+  QElapsedTimer clock;
+  PortalServer second(clock);
+
+  CaptivePortalRequest* request =
+      createRequest(&task, {closedAddress(), second.address()});
+  QSignalSpy spy(request, &CaptivePortalRequest::completed);
+
+  clock.start();
+  request->run();
+
+  // The refused connection does not wait for the attempt delay.
+  QVERIFY(second.waitForRequest());
+  QVERIFY(second.connectedAt() < CAPTIVEPORTAL_ATTEMPT_DELAY_MSEC);
+  QVERIFY(spy.isEmpty());
+
+  second.reply(NO_PORTAL_REPLY);
+  QVERIFY(spy.wait(TIMEOUT_MSEC));
+  QCOMPARE(spy.count(), 1);
+  QCOMPARE(spy.at(0).at(0).value<CaptivePortalRequest::CaptivePortalResult>(),
+           CaptivePortalRequest::NoPortal);
+}
+
+void TestCaptivePortal::portalCancelsOtherAttempts() {
+  SettingsHolder settingsHolder;
+  SimpleNetworkManager snm;
+  TaskFunction task([]() {});
+
+  QElapsedTimer clock;
+  PortalServer first(clock);
+  PortalServer second(clock);
+
+  CaptivePortalRequest* request =
+      createRequest(&task, {first.address(), second.address()});
+  QSignalSpy spy(request, &CaptivePortalRequest::completed);
+
+  clock.start();
+  request->run();
+
+  QVERIFY(first.waitForRequest());
+  QVERIFY(second.waitForRequest());
+
+  // A portal is a definitive answer too.
+  first.reply(PORTAL_REPLY);
+  QVERIFY(spy.wait(TIMEOUT_MSEC));
+  QCOMPARE(spy.count(), 1);
+  QCOMPARE(spy.at(0).at(0).value<CaptivePortalRequest::CaptivePortalResult>(),
+           CaptivePortalRequest::PortalDetected);
+
+  QVERIFY(second.waitForDisconnected());
+}
+
+void TestCaptivePortal::allAttemptsFailed() {
+  SettingsHolder settingsHolder;
+  SimpleNetworkManager snm;
+  TaskFunction task([]() {});
+
+  CaptivePortalRequest* request =
+      createRequest(&task, {closedAddress(), closedAddress()});
+  QSignalSpy spy(request, &CaptivePortalRequest::completed);
+
+  request->run();
+
+  // The failure is reported once, when the last attempt has failed.
+  QVERIFY(spy.wait(TIMEOUT_MSEC));
+  QTest::qWait(CAPTIVEPORTAL_ATTEMPT_DELAY_MSEC);
+  QCOMPARE(spy.count(), 1);
+  QCOMPARE(spy.at(0).at(0).value<CaptivePortalRequest::CaptivePortalResult>(),
+           CaptivePortalRequest::Failure);
+}
+
+void TestCaptivePortal::noPortalNetworks() {
+  constexpr int TTL_MSEC = 500;
+  CaptivePortalNetworkCache cache(TTL_MSEC);
+
+  // Without id, the network is unknown.
+  cache.addNoPortalNetwork(QString());
+  QVERIFY(!cache.isNoPortalNetwork(QString()));
+
+  cache.addNoPortalNetwork("AA-BB-CC-DD-EE-01");
+  QVERIFY(cache.isNoPortalNetwork("AA-BB-CC-DD-EE-01"));
+  QVERIFY(!cache.isNoPortalNetwork("AA-BB-CC-DD-EE-02"));
+
+  QTest::qWait(TTL_MSEC / 2);
+  cache.addNoPortalNetwork("AA-BB-CC-DD-EE-02");
+
+  // The first network expires before the second one.
+  QTRY_VERIFY(!cache.isNoPortalNetwork("AA-BB-CC-DD-EE-01"));
+  QVERIFY(cache.isNoPortalNetwork("AA-BB-CC-DD-EE-02"));
+  QTRY_VERIFY(!cache.isNoPortalNetwork("AA-BB-CC-DD-EE-02"));
+
+  // A new check remembers the network again.
+  cache.addNoPortalNetwork("AA-BB-CC-DD-EE-01");
+  QVERIFY(cache.isNoPortalNetwork("AA-BB-CC-DD-EE-01"));
+}
+
+static TestCaptivePortal s_testCaptivePortal;
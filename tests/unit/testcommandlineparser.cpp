@@ -73,4 +73,36 @@ void TestCommandLineParser::basic() {
   QCOMPARE(s_executed, uiExecuted);
 }
 
+void TestCommandLineParser::values_data() {
+  QTest::addColumn<QStringList>("args");
+  QTest::addColumn<int>("result");
+  QTest::addColumn<QString>("value");
+  QTest::addColumn<QStringList>("remaining");
+
+  QTest::addRow("short") << QStringList{"app", "-p", "4", "de"} << 0
+                         << QString("4") << QStringList{"de"};
+  QTest::addRow("long") << QStringList{"app", "--parallel", "4", "-f"} << 0
+                        << QString("4") << QStringList{};
+  QTest::addRow("missing value") << QStringList{"app", "-f", "-p"} << 1
+                                 << QString() << QStringList{"-p"};
+}
+
+void TestCommandLineParser::values() {
+  QFETCH(QStringList, args);
+
+  CommandLineParser::Option flagOption("f", "flag", "A flag.");
+  CommandLineParser::Option valueOption("p", "parallel", "A value.", true);
+  QList<CommandLineParser::Option*> options{&flagOption, &valueOption};
+
+  CommandLineParser clp;
+  QFETCH(int, result);
+  QCOMPARE(clp.parse(args, options, false), result);
+
+  QFETCH(QString, value);
+  QCOMPARE(valueOption.m_value, value);
+
+  QFETCH(QStringList, remaining);
+  QCOMPARE(args, remaining);
+}
+
 static TestCommandLineParser s_testCommandLineParser;
@@ -10,4 +10,7 @@ class TestCommandLineParser : public TestHelper {
  private slots:
   void basic_data();
   void basic();
+
+  void values_data();
+  void values();
 };
@@ -0,0 +1,206 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "testcryptosettings.h"
+
+#include <QBuffer>
+#include <QCborValue>
+#include <QDateTime>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include "cryptosettings.h"
+
+namespace {
+
+// Nonce and MAC.
+constexpr int HEADER_SIZE = 12 + 16;
+
+struct TestKey {
+  uint8_t bytes[CRYPTO_SETTINGS_KEY_SIZE];
+
+  explicit TestKey(uint8_t seed) {
+    for (int i = 0; i < CRYPTO_SETTINGS_KEY_SIZE; ++i) {
+      bytes[i] = static_cast<uint8_t>(seed + i);
+    }
+  }
+};
+
+QSettings::SettingsMap settings() {
+  QSettings::SettingsMap map;
+  map.insert("string", "hello world");
+  map.insert("integer", qlonglong(42));
+  map.insert("boolean", true);
+  map.insert("bytes", QByteArray("\x00\x01\xff", 3));
+  map.insert("date", QDateTime::fromMSecsSinceEpoch(1700000000000, Qt::UTC));
+  map.insert("list", QStringList{"a", "b"});
+  return map;
+}
+
+}  // namespace
+
+void TestCryptoSettings::roundTrip() {
+  TestKey key(1);
+  QSettings::SettingsMap map = settings();
+
+  QByteArray file;
+  {
+    QBuffer buffer(&file);
+    QVERIFY(buffer.open(QIODevice::WriteOnly));
+    QVERIFY(CryptoSettings::writeEncryptedChachaPolyV2File(buffer, map,
+                                                           key.bytes));
+  }
+  QVERIFY(file.length() > HEADER_SIZE);
+
+  // The payload is not in clear.
+  QVERIFY(!file.contains("hello world"));
+
+  QSettings::SettingsMap read;
+  {
+    QBuffer buffer(&file);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+    QVERIFY(
+        CryptoSettings::readEncryptedChachaPolyV2File(buffer, read, key.bytes));
+  }
+
+  // CBOR keeps the types: byte arrays and dates are not turned into strings.
+  QCOMPARE(read.keys(), map.keys());
+  QCOMPARE(read["string"].toString(), QString("hello world"));
+  QCOMPARE(read["integer"].toLongLong(), 42LL);
+  QCOMPARE(read["boolean"].toBool(), true);
+  QVERIFY(read["bytes"].typeId() == QMetaType::QByteArray);
+  QCOMPARE(read["bytes"].toByteArray(), map["bytes"].toByteArray());
+  QVERIFY(read["date"].typeId() == QMetaType::QDateTime);
+  QCOMPARE(read["date"].toDateTime(), map["date"].toDateTime());
+  QCOMPARE(read["list"].toStringList(), QStringList({"a", "b"}));
+
+  // Another key cannot read the file.
+  TestKey otherKey(2);
+  QSettings::SettingsMap other;
+  QBuffer buffer(&file);
+  QVERIFY(buffer.open(QIODevice::ReadOnly));
+  QVERIFY(!CryptoSettings::readEncryptedChachaPolyV2File(buffer, other,
+                                                         otherKey.bytes));
+  QVERIFY(other.isEmpty());
+}
+
+void TestCryptoSettings::migrateV1() {
+  TestKey key(3);
+
+  // A V1 file: the settings in JSON, encrypted with the V1 version as AAD.
+  QJsonObject obj;
+  obj.insert("string", "hello world");
+  obj.insert("integer", 42);
+  QByteArray v1(HEADER_SIZE, 0x00);
+  v1.append(QJsonDocument(obj).toJson(QJsonDocument::Compact));
+  CryptoSettings::encryptInPlace(CryptoSettings::EncryptionChachaPolyV1, v1,
+                                 key.bytes);
+
+  // A V1 file is not a V2 file.
+  QSettings::SettingsMap map;
+  {
+    QBuffer buffer(&v1);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+    QVERIFY(
+        !CryptoSettings::readEncryptedChachaPolyV2File(buffer, map, key.bytes));
+  }
+
+  {
+    QBuffer buffer(&v1);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+    QVERIFY(
+        CryptoSettings::readEncryptedChachaPolyV1File(buffer, map, key.bytes));
+  }
+  QCOMPARE(map["string"].toString(), QString("hello world"));
+  QCOMPARE(map["integer"].toInt(), 42);
+
+  // The next write migrates the settings to V2.
+  QByteArray v2;
+  {
+    QBuffer buffer(&v2);
+    QVERIFY(buffer.open(QIODevice::WriteOnly));
+    QVERIFY(
+        CryptoSettings::writeEncryptedChachaPolyV2File(buffer, map, key.bytes));
+  }
+
+  QSettings::SettingsMap migrated;
+  {
+    QBuffer buffer(&v2);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+    QVERIFY(CryptoSettings::readEncryptedChachaPolyV2File(buffer, migrated,
+                                                          key.bytes));
+  }
+  QCOMPARE(migrated.keys(), map.keys());
+  QCOMPARE(migrated["string"].toString(), QString("hello world"));
+  QCOMPARE(migrated["integer"].toInt(), 42);
+
+  // The migration is one-way: V2 cannot be read as V1.
+  QSettings::SettingsMap v1Map;
+  QBuffer buffer(&v2);
+  QVERIFY(buffer.open(QIODevice::ReadOnly));
+  QVERIFY(
+      !CryptoSettings::readEncryptedChachaPolyV1File(buffer, v1Map, key.bytes));
+}
+
+void TestCryptoSettings::corruptFile_data() {
+  QTest::addColumn<int>("length");
+  QTest::addColumn<int>("flipped");
+
+  // A file truncated within the header.
+  QTest::addRow("empty") << 0 << -1;
+  QTest::addRow("nonce only") << 12 << -1;
+  QTest::addRow("header only") << HEADER_SIZE << -1;
+
+  // One bit flipped in the nonce, the MAC or the ciphertext.
+  QTest::addRow("nonce") << -1 << 0;
+  QTest::addRow("mac") << -1 << 12;
+  QTest::addRow("ciphertext") << -1 << HEADER_SIZE;
+}
+
+void TestCryptoSettings::corruptFile() {
+  QFETCH(int, length);
+  QFETCH(int, flipped);
+
+  TestKey key(4);
+
+  QByteArray file;
+  {
+    QBuffer buffer(&file);
+    QVERIFY(buffer.open(QIODevice::WriteOnly));
+    QVERIFY(CryptoSettings::writeEncryptedChachaPolyV2File(buffer, settings(),
+                                                           key.bytes));
+  }
+
+  if (length >= 0) {
+    file.truncate(length);
+  }
+  if (flipped >= 0) {
+    file[flipped] = file.at(flipped) ^ 0x01;
+  }
+
+  QSettings::SettingsMap map;
+  QBuffer buffer(&file);
+  QVERIFY(buffer.open(QIODevice::ReadOnly));
+  QVERIFY(
+      !CryptoSettings::readEncryptedChachaPolyV2File(buffer, map, key.bytes));
+  QVERIFY(map.isEmpty());
+}
+
+void TestCryptoSettings::invalidPayload() {
+  TestKey key(5);
+
+  // Authenticated, but not a CBOR map.
+  QByteArray file(HEADER_SIZE, 0x00);
+  file.append(QCborValue("not a map").toCbor());
+  CryptoSettings::encryptInPlace(CryptoSettings::EncryptionChachaPolyV2, file,
+                                 key.bytes);
+
+  QSettings::SettingsMap map;
+  QBuffer buffer(&file);
+  QVERIFY(buffer.open(QIODevice::ReadOnly));
+  QVERIFY(
+      !CryptoSettings::readEncryptedChachaPolyV2File(buffer, map, key.bytes));
+}
+
+static TestCryptoSettings s_testCryptoSettings;
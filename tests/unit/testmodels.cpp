@@ -17,6 +17,7 @@
 #include "models/location.h"
 #include "models/recentconnections.h"
 #include "models/recommendedlocationmodel.h"
+#include "models/servercatalog.h"
 #include "models/servercity.h"
 #include "models/servercountry.h"
 #include "models/servercountrymodel.h"
@@ -1595,6 +1596,49 @@ void TestModels::serverCountryModelFromJson() {
       }
     }
   }
+
+  // from settings, after the startup. The previous block has written the
+  // snapshot of the valid lists.
+  {
+    SettingsHolder settingsHolder;
+    Localizer l;
+
+    SettingsHolder::instance()->setServers(json);
+
+    ServerCountryModel m;
+    QSignalSpy signalSpy(&m, &ServerCountryModel::modelReset);
+
+    // An invalid list is rejected right away.
+    QCOMPARE(m.fromSettingsLazily(), result);
+
+    if (!result) {
+      QCOMPARE(m.rowCount(QModelIndex()), 0);
+      QVERIFY(!m.initialized());
+    } else {
+      QVERIFY(m.initialized());
+
+      // The views see an empty model until the list is read.
+      QCOMPARE(m.rowCount(QModelIndex()), 0);
+      QCOMPARE(signalSpy.count(), 0);
+
+      QFETCH(int, countries);
+      if (countries > 0) {
+        // The C++ accessors read the list on first access.
+        QFETCH(QVariant, name);
+        QFETCH(QVariant, code);
+        QCOMPARE(m.countryName(code.toString()), name.toString());
+        QCOMPARE(signalSpy.count(), 1);
+      } else {
+        QVERIFY(signalSpy.wait());
+      }
+
+      QCOMPARE(m.rowCount(QModelIndex()), countries);
+
+      // The list is read once.
+      QCoreApplication::processEvents();
+      QCOMPARE(signalSpy.count(), 1);
+    }
+  }
 }
 
 void TestModels::serverCountryModelPick() {
@@ -1657,6 +1701,162 @@ void TestModels::serverCountryModelPick() {
   }
 }
 
+void TestModels::recommendedLocationsDistances() {
+  auto serverList = [](double nearLatitude, double farLatitude) {
+    auto city = [](const QString& code, double latitude) {
+      QJsonObject server;
+      server.insert("hostname", "hostname");
+      server.insert("ipv4_addr_in", "ipv4AddrIn");
+      server.insert("ipv4_gateway", "ipv4Gateway");
+      server.insert("ipv6_addr_in", "ipv6AddrIn");
+      server.insert("ipv6_gateway", "ipv6Gateway");
+      server.insert("public_key", code + "PublicKey");
+      server.insert("weight", 1234);
+      server.insert("port_ranges", QJsonArray());
+      server.insert("multihop_port", 1234);
+      server.insert("socks5_name", "socks5_name");
+
+      QJsonObject obj;
+      obj.insert("code", code);
+      obj.insert("name", code);
+      obj.insert("latitude", latitude);
+      obj.insert("longitude", 0.0);
+      obj.insert("servers", QJsonArray{server});
+      return obj;
+    };
+
+    QJsonObject country;
+    country.insert("name", "serverCountryName");
+    country.insert("code", "serverCountryCode");
+    country.insert("cities", QJsonArray{city("near", nearLatitude),
+                                        city("far", farLatitude)});
+
+    QJsonObject obj;
+    obj.insert("countries", QJsonArray{country});
+    return QJsonDocument(obj).toJson();
+  };
+
+  auto setLocation = [](const QString& latLong) {
+    QJsonObject obj;
+    obj.insert("city", "city");
+    obj.insert("country", "country");
+    obj.insert("subdivision", "subdivision");
+    obj.insert("ip", "127.0.0.1");
+    if (!latLong.isEmpty()) {
+      obj.insert("lat_long", latLong);
+    }
+    return MozillaVPN::instance()->location()->fromJson(
+        QJsonDocument(obj).toJson());
+  };
+
+  auto best = []() {
+    auto results = RecommendedLocationModel::recommendedLocations(1);
+    return results.isEmpty() ? QString() : results.first()->name();
+  };
+
+  SettingsHolder settingsHolder;
+  Localizer l;
+
+  ServerCountryModel* model = MozillaVPN::instance()->serverCountryModel();
+  QVERIFY(setLocation("10.0,0.0"));
+  QVERIFY(model->fromJson(serverList(10.0, 60.0)));
+  QCOMPARE(best(), "near");
+
+  // The distances of the previous server list must not be reused.
+  QVERIFY(model->fromJson(serverList(60.0, 10.0)));
+  QCOMPARE(best(), "far");
+
+  // Nor the distances from the previous location.
+  QVERIFY(setLocation("60.0,0.0"));
+  QCOMPARE(best(), "near");
+
+  QVERIFY(setLocation(QString()));
+}
+
+void TestModels::serverCatalog() {
+  QJsonObject serverObj;
+  serverObj.insert("hostname", "hostname");
+  serverObj.insert("ipv4_addr_in", "ipv4AddrIn");
+  serverObj.insert("ipv4_gateway", "ipv4Gateway");
+  serverObj.insert("ipv6_addr_in", "ipv6AddrIn");
+  serverObj.insert("ipv6_gateway", "ipv6Gateway");
+  serverObj.insert("public_key", "catalogPublicKey");
+  serverObj.insert("weight", 1234);
+  serverObj.insert("port_ranges",
+                   QJsonArray{QJsonArray{1, 2}, QJsonArray{100, 200}});
+  serverObj.insert("multihop_port", 4321);
+  serverObj.insert("socks5_name", "socks5_name");
+
+  QJsonObject cityObj;
+  cityObj.insert("code", "serverCityCode");
+  cityObj.insert("name", "serverCityName");
+  cityObj.insert("latitude", 12.34);
+  cityObj.insert("longitude", -34.56);
+  cityObj.insert("servers", QJsonArray{serverObj});
+
+  QJsonObject countryObj;
+  countryObj.insert("name", "serverCountryName");
+  countryObj.insert("code", "serverCountryCode");
+  countryObj.insert("cities", QJsonArray{cityObj});
+
+  ServerCountry country;
+  QVERIFY(country.fromJson(countryObj));
+  ServerCity city;
+  QVERIFY(city.fromJson(cityObj, "serverCountryCode"));
+  Server server("serverCountryCode", "serverCityName");
+  QVERIFY(server.fromJson(serverObj));
+
+  QByteArray source("source");
+  QByteArray snapshot = ServerCatalog::serialize(
+      source, {country}, {{city.hashKey(), city}}, {{server.id(), server}});
+
+  ServerCatalog catalog;
+  QVERIFY(catalog.loadFromData(snapshot));
+  QVERIFY(catalog.matches(source));
+  QVERIFY(!catalog.matches("another source"));
+  QCOMPARE(catalog.countryCount(), 1u);
+  QCOMPARE(catalog.cityCount(), 1u);
+  QCOMPARE(catalog.serverCount(), 1u);
+
+  ServerCountry countryB;
+  QVERIFY(countryB.fromCatalog(catalog, 0));
+  QCOMPARE(countryB.name(), country.name());
+  QCOMPARE(countryB.code(), country.code());
+  QCOMPARE(countryB.cities(), country.cities());
+
+  ServerCity cityB;
+  QVERIFY(cityB.fromCatalog(catalog, 0, "serverCountryCode"));
+  QCOMPARE(cityB.name(), city.name());
+  QCOMPARE(cityB.code(), city.code());
+  QCOMPARE(cityB.hashKey(), city.hashKey());
+  QCOMPARE(cityB.latitude(), city.latitude());
+  QCOMPARE(cityB.longitude(), city.longitude());
+  QCOMPARE(cityB.servers(), city.servers());
+
+  Server serverB("serverCountryCode", "serverCityName");
+  QVERIFY(serverB.fromCatalog(catalog, 0));
+  QCOMPARE(serverB.hostname(), server.hostname());
+  QCOMPARE(serverB.ipv4AddrIn(), server.ipv4AddrIn());
+  QCOMPARE(serverB.ipv4Gateway(), server.ipv4Gateway());
+  QCOMPARE(serverB.ipv6AddrIn(), server.ipv6AddrIn());
+  QCOMPARE(serverB.ipv6Gateway(), server.ipv6Gateway());
+  QCOMPARE(serverB.publicKey(), server.publicKey());
+  QCOMPARE(serverB.id(), server.id());
+  QCOMPARE(serverB.socksName(), server.socksName());
+  QCOMPARE(serverB.weight(), server.weight());
+  QCOMPARE(serverB.multihopPort(), server.multihopPort());
+  QCOMPARE(serverB.portRanges(), server.portRanges());
+
+  // Corrupted snapshots are rejected.
+  QByteArray corrupted(snapshot);
+  corrupted[corrupted.size() - 1] = corrupted.at(corrupted.size() - 1) ^ 1;
+  QVERIFY(!catalog.loadFromData(corrupted));
+  QVERIFY(!catalog.isValid());
+  QVERIFY(!catalog.loadFromData(snapshot.left(snapshot.size() - 1)));
+  QVERIFY(!catalog.loadFromData(QByteArray("MZSC")));
+  QVERIFY(!catalog.loadFromData(QByteArray()));
+}
+
 // ServerData
 // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
@@ -42,6 +42,9 @@ class TestModels final : public TestHelper {
   void serverCountryModelFromJson_data();
   void serverCountryModelFromJson();
   void serverCountryModelPick();
+  void recommendedLocationsDistances();
+
+  void serverCatalog();
 
   void serverDataBasic();
   void serverDataMigrate();
@@ -0,0 +1,214 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "testserverconnection.h"
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTcpSocket>
+#include <cstring>
+
+#include "localizer.h"
+#include "models/servercountrymodel.h"
+#include "server/serverhandler.h"
+#include "server/servermessage.h"
+#include "settingsholder.h"
+
+namespace {
+
+constexpr int SERVER_PORT = 8754;
+constexpr int TIMEOUT_MSEC = 5000;
+
+// Plays the role of the browser extension. The server runs in the same
+// thread: the client waits by spinning the event loop.
+class Client final {
+ public:
+  Client() { m_socket.connectToHost(QHostAddress::LocalHost, SERVER_PORT); }
+
+  bool waitForConnected() {
+    return QTest::qWaitFor(
+        [this]() {
+          return m_socket.state() == QAbstractSocket::ConnectedState;
+        },
+        TIMEOUT_MSEC);
+  }
+
+  void write(const QJsonObject& obj) {
+    m_socket.write(ServerMessage::frame(
+        QJsonDocument(obj).toJson(QJsonDocument::Compact)));
+  }
+
+  QJsonObject read() {
+    QJsonObject obj;
+    QTest::qWaitFor(
+        [&]() {
+          m_buffer.append(m_socket.readAll());
+          if (m_buffer.length() < (qsizetype)sizeof(uint32_t)) {
+            return false;
+          }
+
+          uint32_t length;
+          memcpy(&length, m_buffer.constData(), sizeof(uint32_t));
+          if (m_buffer.length() < (qsizetype)(sizeof(uint32_t) + length)) {
+            return false;
+          }
+
+          obj = QJsonDocument::fromJson(m_buffer.mid(sizeof(uint32_t), length))
+                    .object();
+          m_buffer.remove(0, sizeof(uint32_t) + length);
+          return true;
+        },
+        TIMEOUT_MSEC);
+    return obj;
+  }
+
+ private:
+  QTcpSocket m_socket;
+  QByteArray m_buffer;
+};
+
+QByteArray serverList(const QStringList& cityNames) {
+  QJsonArray cities;
+  for (const QString& cityName : cityNames) {
+    QJsonObject server;
+    server.insert("hostname", cityName + "Hostname");
+    server.insert("ipv4_addr_in", "ipv4AddrIn");
+    server.insert("ipv4_gateway", "ipv4Gateway");
+    server.insert("ipv6_addr_in", "ipv6AddrIn");
+    server.insert("ipv6_gateway", "ipv6Gateway");
+    server.insert("public_key", cityName + "PublicKey");
+    server.insert("weight", 1234);
+    server.insert("port_ranges", QJsonArray());
+    server.insert("multihop_port", 1234);
+    server.insert("socks5_name", "socks5_name");
+
+    QJsonObject city;
+    city.insert("code", cityName);
+    city.insert("name", cityName);
+    city.insert("latitude", 12.34);
+    city.insert("longitude", 34.56);
+    city.insert("servers", QJsonArray{server});
+    cities.append(city);
+  }
+
+  QJsonObject country;
+  country.insert("name", "serverCountryName");
+  country.insert("code", "serverCountryCode");
+  country.insert("cities", cities);
+
+  QJsonObject obj;
+  obj.insert("countries", QJsonArray{country});
+  return QJsonDocument(obj).toJson();
+}
+
+int cityCount(const QJsonObject& response) {
+  QJsonArray countries =
+      response["servers"].toObject()["countries"].toArray();
+  if (countries.isEmpty()) {
+    return 0;
+  }
+  return static_cast<int>(
+      countries.first().toObject()["cities"].toArray().count());
+}
+
+}  // namespace
+
+void TestServerConnection::cachedServers() {
+  SettingsHolder settingsHolder;
+  Localizer l;
+
+  ServerCountryModel* model = MozillaVPN::instance()->serverCountryModel();
+  QVERIFY(model->fromJson(serverList({"cityA"})));
+
+  ServerHandler handler;
+  if (!handler.isListening()) {
+    QSKIP("The server port is not available");
+  }
+
+  Client client;
+  QVERIFY(client.waitForConnected());
+
+  // The first request receives the full list and its version.
+  client.write(QJsonObject{{"t", "servers"}});
+  QJsonObject obj = client.read();
+  QCOMPARE(obj["t"].toString(), "servers");
+  QVERIFY(!obj.contains("unchanged"));
+  QCOMPARE(cityCount(obj), 1);
+  int version = obj["version"].toInt();
+  QVERIFY(version > 0);
+
+  // Nothing has changed since the version we know.
+  client.write(QJsonObject{{"t", "servers"}, {"version", version}});
+  obj = client.read();
+  QCOMPARE(obj["t"].toString(), "servers");
+  QCOMPARE(obj["version"].toInt(), version);
+  QVERIFY(obj["unchanged"].toBool());
+  QVERIFY(!obj.contains("servers"));
+
+  // A new server list invalidates the cached response.
+  QVERIFY(model->fromJson(serverList({"cityA", "cityB"})));
+
+  client.write(QJsonObject{{"t", "servers"}, {"version", version}});
+  obj = client.read();
+  QCOMPARE(obj["version"].toInt(), version + 1);
+  QVERIFY(!obj.contains("unchanged"));
+  QCOMPARE(cityCount(obj), 2);
+}
+
+void TestServerConnection::subscribe() {
+  SettingsHolder settingsHolder;
+  Localizer l;
+
+  MozillaVPN::instance()->setState(App::StateInitialize);
+
+  ServerHandler handler;
+  if (!handler.isListening()) {
+    QSKIP("The server port is not available");
+  }
+
+  Client subscriber;
+  QVERIFY(subscriber.waitForConnected());
+  Client legacy;
+  QVERIFY(legacy.waitForConnected());
+
+  subscriber.write(QJsonObject{{"t", "subscribe"}});
+  QJsonObject obj = subscriber.read();
+  QCOMPARE(obj["t"].toString(), "subscribe");
+  QJsonObject status = obj["status"].toObject();
+  QCOMPARE(status["app"].toString(), "StateInitialize");
+  QVERIFY(status.contains("vpn"));
+  QVERIFY(status.contains("location"));
+
+  legacy.write(QJsonObject{{"t", "status"}});
+  obj = legacy.read();
+  QCOMPARE(obj["t"].toString(), "status");
+  QCOMPARE(obj["status"].toObject()["app"].toString(), "StateInitialize");
+
+  // The status is invalidated before it is pushed: the subscriber only
+  // receives the changed field, the legacy connection the whole status.
+  MozillaVPN::instance()->setState(App::StateMain);
+
+  obj = subscriber.read();
+  QCOMPARE(obj["t"].toString(), "status_delta");
+  QCOMPARE(obj["status"].toObject().count(), 1);
+  QCOMPARE(obj["status"].toObject()["app"].toString(), "StateMain");
+
+  obj = legacy.read();
+  QCOMPARE(obj["t"].toString(), "status");
+  QCOMPARE(obj["app"].toString(), "StateMain");
+  QVERIFY(obj.contains("vpn"));
+  QVERIFY(obj.contains("location"));
+
+  // No change, no push to the subscriber.
+  MozillaVPN::instance()->setState(App::StateMain);
+  QCOMPARE(legacy.read()["app"].toString(), "StateMain");
+
+  MozillaVPN::instance()->setState(App::StateInitialize);
+  obj = subscriber.read();
+  QCOMPARE(obj["t"].toString(), "status_delta");
+  QCOMPARE(obj["status"].toObject()["app"].toString(), "StateInitialize");
+}
+
+static TestServerConnection s_testServerConnection;
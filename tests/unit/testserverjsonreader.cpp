@@ -0,0 +1,393 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "testserverjsonreader.h"
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <functional>
+
+#ifdef Q_OS_LINUX
+#  include <sys/resource.h>
+#  include <sys/wait.h>
+#  include <unistd.h>
+#endif
+
+#include "models/server.h"
+#include "models/servercity.h"
+#include "models/servercountry.h"
+#include "models/serverjsonreader.h"
+
+namespace {
+
+// Generates a server list with the size of the production one. It is
+// written as text: a JSON document would raise the peak RSS of the process
+// before the benchmark.
+QByteArray fixture(int countryCount = 50, int cityCount = 8,
+                   int serverCount = 12) {
+  QByteArray json("{\"countries\":[");
+  for (int i = 0; i < countryCount; ++i) {
+    if (i > 0) {
+      json.append(',');
+    }
+    json.append(QString("{\"name\":\"Country %1\",\"code\":\"k%1\","
+                        "\"cities\":[")
+                    .arg(i)
+                    .toUtf8());
+
+    for (int j = 0; j < cityCount; ++j) {
+      if (j > 0) {
+        json.append(',');
+      }
+      json.append(QString("{\"name\":\"City %1 %2\",\"code\":\"c%2\","
+                          "\"latitude\":%3,\"longitude\":%4,\"servers\":[")
+                      .arg(i)
+                      .arg(j)
+                      .arg(45.5 + j)
+                      .arg(-73.25 - j)
+                      .toUtf8());
+
+      for (int k = 0; k < serverCount; ++k) {
+        if (k > 0) {
+          json.append(',');
+        }
+        json.append(
+            QString("{\"hostname\":\"host-%1-%2-%3\","
+                    "\"ipv4_addr_in\":\"10.0.0.1\","
+                    "\"ipv4_gateway\":\"10.64.0.1\","
+                    "\"ipv6_addr_in\":\"fc00::1\","
+                    "\"ipv6_gateway\":\"fc00:bbbb:bbbb:bb01::1\","
+                    "\"public_key\":\"key-%1-%2-%3\",\"weight\":%4,"
+                    "\"port_ranges\":[[53,53],[4000,33433]],"
+                    "\"socks5_name\":\"socks-%1-%2-%3\","
+                    "\"multihop_port\":%5}")
+                .arg(i)
+                .arg(j)
+                .arg(k)
+                .arg(k + 1)
+                .arg(3000 + k)
+                .toUtf8());
+      }
+      json.append("]}");
+    }
+    json.append("]}");
+  }
+  json.append("]}");
+  return json;
+}
+
+// What ServerCountryModel keeps of a server list.
+struct Model {
+  QList<ServerCountry> countries;
+  QHash<QString, ServerCity> cities;
+  QHash<uint32_t, Server> servers;
+};
+
+// As ServerCountryModel::fromJsonInternal().
+bool loadStream(const QByteArray& json, Model& model) {
+  return ServerJsonReader::read(
+      json, [&](ServerJsonReader::Country& countryRecord) {
+        QList<QString> cityNames;
+        for (const ServerJsonReader::City& cityRecord : countryRecord.cities) {
+          cityNames.append(cityRecord.record.name);
+        }
+
+        ServerCountry country;
+        if (!country.fromRecord(countryRecord.record, std::move(cityNames))) {
+          return false;
+        }
+
+        for (ServerJsonReader::City& cityRecord : countryRecord.cities) {
+          QStringList publicKeys;
+          for (const ServerCatalog::ServerRecord& record :
+               cityRecord.servers) {
+            publicKeys.append(record.publicKey);
+          }
+
+          ServerCity city;
+          if (!city.fromRecord(cityRecord.record, publicKeys,
+                               country.code())) {
+            return false;
+          }
+          model.cities[city.hashKey()] = city;
+
+          for (ServerCatalog::ServerRecord& record : cityRecord.servers) {
+            Server server(country.code(), city.name());
+            if (!server.fromRecord(std::move(record))) {
+              return false;
+            }
+            model.servers[server.id()] = server;
+          }
+        }
+
+        model.countries.append(country);
+        return true;
+      });
+}
+
+// As ServerCountryModel::fromJsonInternal() before ServerJsonReader: the
+// whole document, then the model.
+bool loadDom(const QByteArray& json, Model& model) {
+  QJsonDocument doc = QJsonDocument::fromJson(json);
+  if (!doc.isObject()) {
+    return false;
+  }
+
+  for (const QJsonValue& countryValue :
+       doc.object().value("countries").toArray()) {
+    QJsonObject countryObj = countryValue.toObject();
+
+    ServerCountry country;
+    if (!country.fromJson(countryObj)) {
+      return false;
+    }
+    model.countries.append(country);
+
+    for (const QJsonValue& cityValue :
+         countryObj.value("cities").toArray()) {
+      QJsonObject cityObj = cityValue.toObject();
+
+      ServerCity city;
+      if (!city.fromJson(cityObj, country.code())) {
+        return false;
+      }
+      model.cities[city.hashKey()] = city;
+
+      for (const QJsonValue& serverValue :
+           cityObj.value("servers").toArray()) {
+        Server server(country.code(), city.name());
+        if (!server.fromJson(serverValue.toObject())) {
+          return false;
+        }
+        model.servers[server.id()] = server;
+      }
+    }
+  }
+
+  return true;
+}
+
+QList<ServerJsonReader::Country> readAll(const QByteArray& json, bool* ok) {
+  QList<ServerJsonReader::Country> countries;
+  *ok = ServerJsonReader::read(json, [&](ServerJsonReader::Country& country) {
+    countries.append(country);
+    return true;
+  });
+  return countries;
+}
+
+// Growth of the peak RSS, in KB, while `load` runs once in a child process,
+// or -1 if unknown. The child starts with the current RSS as its peak: the
+// peaks of the previous tests and rows do not hide the growth.
+qint64 peakRssGrowthKb(const std::function<void()>& load) {
+#ifdef Q_OS_LINUX
+  int fds[2];
+  if (pipe(fds) != 0) {
+    return -1;
+  }
+
+  pid_t pid = fork();
+  if (pid < 0) {
+    close(fds[0]);
+    close(fds[1]);
+    return -1;
+  }
+
+  if (pid == 0) {
+    close(fds[0]);
+
+    qint64 growth = -1;
+    struct rusage before;
+    struct rusage after;
+    if (getrusage(RUSAGE_SELF, &before) == 0) {
+      load();
+      if (getrusage(RUSAGE_SELF, &after) == 0) {
+        growth = after.ru_maxrss - before.ru_maxrss;
+      }
+    }
+
+    _exit(write(fds[1], &growth, sizeof(growth)) == sizeof(growth) ? 0 : 1);
+  }
+
+  close(fds[1]);
+  qint64 growth = -1;
+  if (read(fds[0], &growth, sizeof(growth)) != sizeof(growth)) {
+    growth = -1;
+  }
+  close(fds[0]);
+  waitpid(pid, nullptr, 0);
+  return growth;
+#else
+  Q_UNUSED(load);
+  return -1;
+#endif
+}
+
+}  // namespace
+
+void TestServerJsonReader::invalid_data() {
+  QTest::addColumn<QByteArray>("json");
+
+  QByteArray server =
+      "{\"hostname\":\"h\",\"ipv4_addr_in\":\"a\",\"ipv4_gateway\":\"b\","
+      "\"ipv6_gateway\":\"c\",\"public_key\":\"k\",\"weight\":1,"
+      "\"port_ranges\":[[1,2]]}";
+  auto wrap = [](const QByteArray& server) -> QByteArray {
+    return "{\"countries\":[{\"name\":\"n\",\"code\":\"c\",\"cities\":[{"
+           "\"name\":\"n\",\"code\":\"c\",\"latitude\":1,\"longitude\":2,"
+           "\"servers\":[" +
+           server + "]}]}]}";
+  };
+
+  // The valid list, as reference for the rows below.
+  bool ok = false;
+  readAll(wrap(server), &ok);
+  QVERIFY(ok);
+
+  QTest::addRow("empty") << QByteArray();
+  QTest::addRow("array") << QByteArray("[]");
+  QTest::addRow("no countries") << QByteArray("{}");
+  QTest::addRow("countries object") << QByteArray("{\"countries\":{}}");
+  QTest::addRow("truncated") << wrap(server).chopped(1);
+  QTest::addRow("trailing content") << wrap(server) + "{}";
+  QTest::addRow("trailing comma") << QByteArray("{\"countries\":[],}");
+  QTest::addRow("country not an object")
+      << QByteArray("{\"countries\":[42]}");
+  QTest::addRow("city without name")
+      << QByteArray(
+             "{\"countries\":[{\"name\":\"n\",\"code\":\"c\",\"cities\":[{}]}"
+             "]}");
+  QTest::addRow("server without weight")
+      << wrap(QByteArray(server).replace("\"weight\":1,", ""));
+  QTest::addRow("weight string")
+      << wrap(QByteArray(server).replace("\"weight\":1", "\"weight\":\"1\""));
+  QTest::addRow("leading zero")
+      << wrap(QByteArray(server).replace("\"weight\":1", "\"weight\":01"));
+  QTest::addRow("port range")
+      << wrap(QByteArray(server).replace("[[1,2]]", "[[1,2,3]]"));
+  QTest::addRow("control character")
+      << wrap(QByteArray(server).replace("\"h\"", "\"h\nh\""));
+  QTest::addRow("bad escape")
+      << wrap(QByteArray(server).replace("\"h\"", "\"\\x\""));
+  QTest::addRow("deep nesting")
+      << QByteArray("{\"a\":") + QByteArray(2000, '[') +
+             QByteArray(2000, ']') + ",\"countries\":[]}";
+}
+
+void TestServerJsonReader::invalid() {
+  QFETCH(QByteArray, json);
+
+  bool ok = true;
+  readAll(json, &ok);
+  QVERIFY(!ok);
+}
+
+void TestServerJsonReader::escapes() {
+  QByteArray json =
+      "{\"countries\":[{\"name\":\"Qu\\u00e9bec \\\"\\/\\\\\\t\","
+      "\"code\":\"\xc3\xa9\",\"extra\":[null,true,false,{\"a\":-1.5e3}],"
+      "\"cities\":[]}], \"version\" : 2 }";
+
+  bool ok = false;
+  QList<ServerJsonReader::Country> countries = readAll(json, &ok);
+  QVERIFY(ok);
+  QCOMPARE(countries.count(), 1);
+  QCOMPARE(countries[0].record.name,
+           QString::fromUtf8("Qu\xc3\xa9"
+                             "bec \"/\\\t"));
+  QCOMPARE(countries[0].record.code, QString::fromUtf8("\xc3\xa9"));
+  QVERIFY(countries[0].cities.isEmpty());
+}
+
+void TestServerJsonReader::matchesDom() {
+  QByteArray json = fixture(3, 2, 2);
+
+  bool ok = false;
+  QList<ServerJsonReader::Country> countries = readAll(json, &ok);
+  QVERIFY(ok);
+
+  QJsonArray countriesArray =
+      QJsonDocument::fromJson(json).object().value("countries").toArray();
+  QCOMPARE(countries.count(), countriesArray.count());
+
+  for (qsizetype i = 0; i < countries.count(); ++i) {
+    QJsonObject countryObj = countriesArray.at(i).toObject();
+    const ServerJsonReader::Country& country = countries.at(i);
+    QCOMPARE(country.record.name, countryObj.value("name").toString());
+    QCOMPARE(country.record.code, countryObj.value("code").toString());
+
+    QJsonArray citiesArray = countryObj.value("cities").toArray();
+    QCOMPARE(country.cities.count(), citiesArray.count());
+    QCOMPARE(country.record.cityCount, (uint32_t)citiesArray.count());
+
+    for (qsizetype j = 0; j < country.cities.count(); ++j) {
+      QJsonObject cityObj = citiesArray.at(j).toObject();
+      const ServerJsonReader::City& city = country.cities.at(j);
+      QCOMPARE(city.record.name, cityObj.value("name").toString());
+      QCOMPARE(city.record.code, cityObj.value("code").toString());
+      QCOMPARE(city.record.latitude, cityObj.value("latitude").toDouble());
+      QCOMPARE(city.record.longitude, cityObj.value("longitude").toDouble());
+
+      QJsonArray serversArray = cityObj.value("servers").toArray();
+      QCOMPARE(city.servers.count(), serversArray.count());
+
+      for (qsizetype k = 0; k < city.servers.count(); ++k) {
+        QJsonObject serverObj = serversArray.at(k).toObject();
+        const ServerCatalog::ServerRecord& server = city.servers.at(k);
+        QCOMPARE(server.hostname, serverObj.value("hostname").toString());
+        QCOMPARE(server.ipv4AddrIn, serverObj.value("ipv4_addr_in").toString());
+        QCOMPARE(server.ipv6AddrIn, serverObj.value("ipv6_addr_in").toString());
+        QCOMPARE(server.publicKey, serverObj.value("public_key").toString());
+        QCOMPARE(server.socksName, serverObj.value("socks5_name").toString());
+        QCOMPARE(server.weight, (uint32_t)serverObj.value("weight").toInt());
+        QCOMPARE(server.multihopPort,
+                 (uint32_t)serverObj.value("multihop_port").toInt());
+        QCOMPARE(server.portRanges.count(), 2);
+        QCOMPARE(server.portRanges.at(1),
+                 (QPair<uint32_t, uint32_t>(4000, 33433)));
+      }
+    }
+  }
+}
+
+void TestServerJsonReader::benchmark_data() {
+  QTest::addColumn<bool>("stream");
+
+  QTest::addRow("stream") << true;
+  QTest::addRow("dom") << false;
+}
+
+void TestServerJsonReader::benchmark() {
+  QFETCH(bool, stream);
+
+  static const QByteArray json = fixture();
+  auto load = [stream](Model& model) {
+    return stream ? loadStream(json, model) : loadDom(json, model);
+  };
+
+  {
+    Model model;
+    QVERIFY(load(model));
+    QCOMPARE(model.countries.count(), 50);
+    QCOMPARE(model.cities.count(), 50 * 8);
+    QCOMPARE(model.servers.count(), 50 * 8 * 12);
+  }
+
+  qint64 rssGrowth = peakRssGrowthKb([&]() {
+    Model model;
+    load(model);
+  });
+  if (rssGrowth >= 0) {
+    qDebug() << "Fixture:" << json.size() / 1024 << "KB, peak RSS growth:"
+             << rssGrowth << "KB";
+  }
+
+  QBENCHMARK {
+    Model model;
+    load(model);
+  }
+}
+
+static TestServerJsonReader s_testServerJsonReader;
@@ -5,13 +5,17 @@
 #include "testserverlatency.h"
 
 #include <QDateTime>
+#include <QJsonArray>
 #include <QJsonObject>
+#include <QRandomGenerator>
 
 #include "constants.h"
 #include "feature.h"
 #include "models/location.h"
 #include "models/servercity.h"
+#include "models/serverkeys.h"
 #include "serverlatency.h"
+#include "serverselection.h"
 #include "settingsholder.h"
 
 void TestServerLatency::init() {
@@ -146,4 +150,159 @@ void TestServerLatency::baseCityScore() {
   QCOMPARE(serverLatency.baseCityScore(&city, userCountry), score);
 }
 
+void TestServerLatency::cityStats() {
+  QJsonArray servers;
+  for (const char* pubkey : {"ServerA", "ServerB", "ServerC"}) {
+    QJsonObject server;
+    server.insert("public_key", pubkey);
+    servers.append(server);
+  }
+
+  QJsonObject obj;
+  obj.insert("name", "Rivendell");
+  obj.insert("code", "rvdl");
+  obj.insert("latitude", 1.0);
+  obj.insert("longitude", 2.0);
+  obj.insert("servers", servers);
+
+  ServerCity city;
+  QVERIFY(city.fromJson(obj, testServerCountryCode));
+
+  ServerLatency serverLatency;
+  serverLatency.setLatency("ServerA", 100);
+  serverLatency.setLatency("Unrelated", 1000);
+
+  // The aggregates are built on first use...
+  QCOMPARE(serverLatency.cityLatency(&city), 100);
+  QCOMPARE(serverLatency.cityActiveServerCount(&city), 3);
+
+  // ... and then updated incrementally.
+  serverLatency.setLatency("ServerB", 201);
+  QCOMPARE(serverLatency.cityLatency(&city), 151);
+  serverLatency.setLatency("ServerA", 0);
+  QCOMPARE(serverLatency.cityLatency(&city), 201);
+
+  serverLatency.setCooldown("ServerC",
+                            Constants::SERVER_UNRESPONSIVE_COOLDOWN_SEC);
+  QCOMPARE(serverLatency.cityActiveServerCount(&city), 2);
+  serverLatency.setCooldown("ServerC", 0);
+  QCOMPARE(serverLatency.cityActiveServerCount(&city), 3);
+}
+
+void TestServerLatency::serverKeys() {
+  QCOMPARE(ServerKeys::find("NeverSeenBefore"), ServerKeys::Invalid);
+  QVERIFY(ServerKeys::publicKey(ServerKeys::Invalid).isEmpty());
+
+  // Ids are dense and stable.
+  uint32_t count = ServerKeys::count();
+  uint32_t id = ServerKeys::intern("NeverSeenBefore");
+  QCOMPARE(id, count);
+  QCOMPARE(ServerKeys::count(), count + 1);
+  QCOMPARE(ServerKeys::intern("NeverSeenBefore"), id);
+  QCOMPARE(ServerKeys::find("NeverSeenBefore"), id);
+  QCOMPARE(ServerKeys::publicKey(id), "NeverSeenBefore");
+
+  // Servers and cities share the same ids.
+  QJsonObject serverObj;
+  serverObj.insert("hostname", "wireguard.example.com");
+  serverObj.insert("ipv4_addr_in", "1.2.3.4");
+  serverObj.insert("ipv4_gateway", "1.2.3.5");
+  serverObj.insert("ipv6_gateway", "::1");
+  serverObj.insert("public_key", "NeverSeenBefore");
+  serverObj.insert("weight", 1);
+  serverObj.insert("port_ranges", QJsonArray());
+
+  Server server;
+  QVERIFY(server.fromJson(serverObj));
+  QCOMPARE(server.id(), id);
+
+  QJsonObject cityObj;
+  cityObj.insert("name", "Rivendell");
+  cityObj.insert("code", "rvdl");
+  cityObj.insert("latitude", 1.0);
+  cityObj.insert("longitude", 2.0);
+  cityObj.insert("servers", QJsonArray{serverObj});
+
+  ServerCity city;
+  QVERIFY(city.fromJson(cityObj, testServerCountryCode));
+  QCOMPARE(city.servers(), QList<uint32_t>{id});
+
+  // The string API and the id API refer to the same data.
+  ServerLatency serverLatency;
+  serverLatency.setLatency(id, 42);
+  QCOMPARE(serverLatency.getLatency("NeverSeenBefore"), 42);
+  serverLatency.setCooldown("NeverSeenBefore", 1234);
+  QCOMPARE(serverLatency.getCooldown(id),
+           serverLatency.getCooldown("NeverSeenBefore"));
+  QCOMPARE(serverLatency.cityActiveServerCount(&city), 0);
+}
+
+void TestServerLatency::serverSelection() {
+  using Candidate = ServerSelection::Candidate;
+  QRandomGenerator generator(42);
+
+  auto choose = [&](ServerSelection::Policy policy,
+                    const QList<Candidate>& candidates) {
+    return static_cast<int>(
+        ServerSelection::choose(policy, candidates, &generator));
+  };
+
+  for (ServerSelection::Policy policy :
+       {ServerSelection::WeightedRandom, ServerSelection::PowerOfTwoChoices}) {
+    QCOMPARE(choose(policy, {}), -1);
+    QCOMPARE(choose(policy, {Candidate{0, -1, true}}), 0);
+
+    // Servers without weight are never picked if others have it.
+    QList<Candidate> weighted{Candidate{0, 10, false}, Candidate{1, 20, false},
+                              Candidate{0, 30, false}};
+    for (int i = 0; i < 100; ++i) {
+      QCOMPARE(choose(policy, weighted), 1);
+    }
+  }
+
+  // With two servers, both are always compared: the fastest one wins, and
+  // a recent failure weighs more than the latency. Unmeasured servers are as
+  // fast as the average of the others, and lose the tie against them.
+  QList<Candidate> pair{Candidate{100, 50, false}, Candidate{100, 20, false}};
+  QList<Candidate> failedPair{Candidate{100, 50, false},
+                              Candidate{100, 20, true}};
+  QList<Candidate> unmeasuredPair{Candidate{100, -1, false},
+                                  Candidate{100, 20, false}};
+  for (int i = 0; i < 100; ++i) {
+    QCOMPARE(choose(ServerSelection::PowerOfTwoChoices, pair), 1);
+    QCOMPARE(choose(ServerSelection::PowerOfTwoChoices, failedPair), 0);
+    QCOMPARE(choose(ServerSelection::PowerOfTwoChoices, unmeasuredPair), 1);
+  }
+
+  // The unmeasured server is assumed to take 60 ms, the average of the
+  // others: it still beats the slowest server.
+  QList<Candidate> unmeasuredCity{Candidate{100, -1, false},
+                                  Candidate{100, 20, false},
+                                  Candidate{100, 100, false}};
+  QList<int> unmeasuredCounts(unmeasuredCity.length(), 0);
+  for (int i = 0; i < 300; ++i) {
+    ++unmeasuredCounts[choose(ServerSelection::PowerOfTwoChoices,
+                              unmeasuredCity)];
+  }
+  QVERIFY(unmeasuredCounts[0] > 0);
+  QCOMPARE(unmeasuredCounts[2], 0);
+
+  // The slowest server is never picked, but the load is still spread over
+  // the others.
+  QList<Candidate> city{Candidate{100, 10, false}, Candidate{100, 20, false},
+                        Candidate{100, 30, false}, Candidate{100, 40, false}};
+  QList<int> randomCounts(city.length(), 0);
+  QList<int> p2cCounts(city.length(), 0);
+  for (int i = 0; i < 1000; ++i) {
+    ++randomCounts[choose(ServerSelection::WeightedRandom, city)];
+    ++p2cCounts[choose(ServerSelection::PowerOfTwoChoices, city)];
+  }
+
+  QVERIFY(randomCounts[3] > 0);
+  QCOMPARE(p2cCounts[3], 0);
+  QVERIFY(p2cCounts[2] > 0);
+  QVERIFY(p2cCounts[0] > p2cCounts[1]);
+  QVERIFY(p2cCounts[1] > p2cCounts[2]);
+}
+
 static TestServerLatency s_testServerLatency;
@@ -15,4 +15,10 @@ class TestServerLatency : public TestHelper {
 
   void baseCityScore_data();
   void baseCityScore();
+
+  void cityStats();
+
+  void serverKeys();
+
+  void serverSelection();
 };
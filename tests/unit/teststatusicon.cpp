@@ -6,7 +6,10 @@
 
 #include <QEventLoop>
 #include <QQmlApplicationEngine>
+#include <QSet>
+#include <QSignalSpy>
 
+#include "connectionhealth.h"
 #include "localizer.h"
 #include "qmlengineholder.h"
 #include "settingsholder.h"
@@ -61,4 +64,77 @@ void TestStatusIcon::basic() {
   loop.exec();
 }
 
+void TestStatusIcon::animationKeys() {
+  MozillaVPN vpn;
+  SettingsHolder settingsHolder;
+
+  MozillaVPN::instance()->setState(App::StateMain);
+  TestHelper::controllerState = ConnectionManager::StateSwitching;
+
+  StatusIcon si;
+  si.refreshNeeded();
+
+  // Two rounds of the animation: each frame is an icon of the atlas, and the
+  // second round reuses the keys of the first one.
+  QList<StatusIcon::IconKey> keys;
+  for (int i = 0; i < 8; ++i) {
+    keys.append(si.iconKey());
+    QMetaObject::invokeMethod(&si, "animateIcon");
+  }
+
+  QCOMPARE(QSet<StatusIcon::IconKey>(keys.begin(), keys.end()).count(), 4);
+  for (int i = 0; i < 4; ++i) {
+    QCOMPARE(keys.at(i + 4), keys.at(i));
+    QCOMPARE(keys.at(i).first,
+             QString(":/ui/resources/logo-animated-mask%1.png").arg(i + 1));
+    // No indicator while switching.
+    QCOMPARE(keys.at(i).second, QRgb(0));
+  }
+}
+
+void TestStatusIcon::unchangedIcon() {
+  MozillaVPN vpn;
+  SettingsHolder settingsHolder;
+
+  MozillaVPN::instance()->setState(App::StateMain);
+  TestHelper::controllerState = ConnectionManager::StateOn;
+  ConnectionHealth* connectionHealth =
+      MozillaVPN::instance()->connectionHealth();
+  connectionHealth->overwriteStabilityForInspector(ConnectionHealth::Stable);
+
+  StatusIcon si;
+  QSignalSpy spy(&si, &StatusIcon::iconUpdateNeeded);
+
+  si.refreshNeeded();
+  QCOMPARE(spy.count(), 1);
+  StatusIcon::IconKey stableKey = si.iconKey();
+  QVERIFY(stableKey.second != 0);
+
+  // The same frame and indicator: the tray is not updated again.
+  si.refreshNeeded();
+  si.refreshNeeded();
+  QCOMPARE(spy.count(), 1);
+
+  // Only the indicator changes.
+  connectionHealth->overwriteStabilityForInspector(ConnectionHealth::Unstable);
+  si.refreshNeeded();
+  QCOMPARE(spy.count(), 2);
+  QCOMPARE(si.iconKey().first, stableKey.first);
+  QVERIFY(si.iconKey().second != stableKey.second);
+
+  // Back to the first icon: the key of the atlas is the same.
+  connectionHealth->overwriteStabilityForInspector(ConnectionHealth::Stable);
+  si.refreshNeeded();
+  QCOMPARE(spy.count(), 3);
+  QCOMPARE(si.iconKey(), stableKey);
+
+  // Only the frame changes.
+  TestHelper::controllerState = ConnectionManager::StateOff;
+  si.refreshNeeded();
+  QCOMPARE(spy.count(), 4);
+  QCOMPARE(si.iconKey().second, QRgb(0));
+  si.refreshNeeded();
+  QCOMPARE(spy.count(), 4);
+}
+
 static TestStatusIcon s_testStatusIcon;
@@ -9,4 +9,6 @@ class TestStatusIcon : public TestHelper {
 
  private slots:
   void basic();
+  void animationKeys();
+  void unchangedIcon();
 };
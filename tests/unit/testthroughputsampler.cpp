@@ -0,0 +1,88 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "testthroughputsampler.h"
+
+#include "connectionbenchmark/throughputsampler.h"
+
+void TestThroughputSampler::streams() {
+  ThroughputSampler sampler(100, 0);
+
+  // Two streams in the same slice are summed.
+  sampler.addBytes(10, 1000);
+  sampler.addBytes(50, 1000);
+  QVERIFY(sampler.advance(99).isEmpty());
+
+  QList<quint64> closed = sampler.advance(100);
+  QCOMPARE(closed.count(), 1);
+  QCOMPARE(closed.at(0), 160000ULL);
+
+  // Idle slices are closed too.
+  sampler.addBytes(320, 500);
+  closed = sampler.advance(400);
+  QCOMPARE(closed, QList<quint64>({0, 0, 40000}));
+  QCOMPARE(sampler.slices().count(), 4);
+}
+
+void TestThroughputSampler::warmup() {
+  ThroughputSampler sampler(100, 200);
+
+  // Slow start: the first two slices are ignored.
+  sampler.addBytes(50, 100);
+  sampler.addBytes(150, 100);
+  for (int i = 2; i < 12; ++i) {
+    sampler.addBytes(i * 100 + 50, 1000);
+  }
+  sampler.finish(1200);
+
+  QCOMPARE(sampler.slices().count(), 12);
+  QCOMPARE(sampler.throughput(), 80000ULL);
+  QCOMPARE(sampler.p90(), 80000ULL);
+  QCOMPARE(sampler.stability(), 1.0);
+}
+
+void TestThroughputSampler::lateBytes() {
+  ThroughputSampler sampler(100, 0);
+  sampler.advance(300);
+
+  // Reported after the slice was closed: counted in the open one.
+  sampler.addBytes(150, 500);
+  QCOMPARE(sampler.advance(400), QList<quint64>({40000}));
+}
+
+void TestThroughputSampler::shortTransfer() {
+  ThroughputSampler sampler(100, 1000);
+
+  // No steady slices: the average of the whole transfer.
+  sampler.addBytes(10, 1000);
+  sampler.finish(50);
+
+  QVERIFY(sampler.slices().isEmpty());
+  QCOMPARE(sampler.throughput(), 160000ULL);
+  QCOMPARE(sampler.p90(), 160000ULL);
+  QCOMPARE(sampler.stability(), 0.0);
+}
+
+void TestThroughputSampler::statistics() {
+  ThroughputSampler sampler(100, 0);
+
+  // 10 slices: 1000..10000 bytes.
+  for (int i = 0; i < 10; ++i) {
+    sampler.addBytes(i * 100, (i + 1) * 1000);
+  }
+  sampler.finish(1000);
+
+  QCOMPARE(sampler.throughput(), 440000ULL);
+  QCOMPARE(sampler.p90(), 720000ULL);
+
+  double stability = sampler.stability();
+  QVERIFY(stability > 0.4 && stability < 0.5);
+
+  // The partial slice is not part of the series.
+  sampler.addBytes(1010, 1000);
+  sampler.finish(1050);
+  QCOMPARE(sampler.slices().count(), 10);
+}
+
+static TestThroughputSampler s_testThroughputSampler;
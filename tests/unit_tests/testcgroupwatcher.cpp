@@ -0,0 +1,108 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "testcgroupwatcher.h"
+
+#include <QDir>
+#include <QFile>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+
+#include "platforms/linux/daemon/cgroupwatcher.h"
+
+namespace {
+// A fake cgroup2 tree: the kernel files are plain files.
+constexpr const char* APP_SLICE =
+    "/user.slice/user-1000.slice/user@1000.service/app.slice";
+
+bool writeProcs(const QString& path, const QByteArray& content) {
+  QFile file(path + "/cgroup.procs");
+  if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+    return false;
+  }
+  return file.write(content) == content.length();
+}
+}  // namespace
+
+void TestCgroupWatcher::scopes() {
+  QTemporaryDir mountPoint;
+  QVERIFY(mountPoint.isValid());
+
+  QString slice = mountPoint.path() + APP_SLICE;
+  QVERIFY(QDir().mkpath(slice + "/app-firefox.scope"));
+  QVERIFY(QDir().mkpath(slice + "/not-an-app"));
+
+  CgroupWatcher watcher(mountPoint.path());
+  QVERIFY(watcher.isValid());
+
+  QSignalSpy created(&watcher, &CgroupWatcher::scopeCreated);
+  QSignalSpy removed(&watcher, &CgroupWatcher::scopeRemoved);
+
+  // Only the directories under the mount point can be watched.
+  QTemporaryDir elsewhere;
+  QVERIFY(!watcher.watchDirectory(elsewhere.path()));
+
+  // The existing scopes are reported immediately, by their control group.
+  QVERIFY(watcher.watchDirectory(slice));
+  QCOMPARE(created.count(), 1);
+  QString firefox = QString(APP_SLICE) + "/app-firefox.scope";
+  QCOMPARE(created.takeFirst().at(0).toString(), firefox);
+  QVERIFY(watcher.contains(firefox));
+  QVERIFY(!watcher.contains(QString(APP_SLICE) + "/not-an-app"));
+
+  // Watching the same directory again reports nothing.
+  QVERIFY(watcher.watchDirectory(slice));
+  QCOMPARE(created.count(), 0);
+
+  // New scopes are reported by inotify. Other directories are ignored.
+  QVERIFY(QDir().mkpath(slice + "/other"));
+  QVERIFY(QDir().mkpath(slice + "/app-gedit.scope"));
+  QVERIFY(created.wait());
+  QCOMPARE(created.count(), 1);
+  QString gedit = QString(APP_SLICE) + "/app-gedit.scope";
+  QCOMPARE(created.takeFirst().at(0).toString(), gedit);
+  QCOMPARE(watcher.scopes().count(), 2);
+
+  QVERIFY(QDir(slice + "/app-gedit.scope").removeRecursively());
+  QVERIFY(removed.wait());
+  QCOMPARE(removed.takeFirst().at(0).toString(), gedit);
+  QVERIFY(!watcher.contains(gedit));
+  QVERIFY(watcher.contains(firefox));
+
+  // Removing the watched directory removes its scopes.
+  QVERIFY(QDir(slice).removeRecursively());
+  QVERIFY(removed.wait());
+  QCOMPARE(removed.takeFirst().at(0).toString(), firefox);
+  QVERIFY(watcher.scopes().isEmpty());
+}
+
+void TestCgroupWatcher::pids() {
+  QTemporaryDir mountPoint;
+  QVERIFY(mountPoint.isValid());
+
+  QString scope = mountPoint.path() + APP_SLICE + "/app-firefox.scope";
+  QVERIFY(QDir().mkpath(scope));
+
+  CgroupWatcher watcher(mountPoint.path());
+  QVERIFY(watcher.watchDirectory(mountPoint.path() + APP_SLICE));
+
+  QString cgroup = QString(APP_SLICE) + "/app-firefox.scope";
+  QCOMPARE(watcher.pids(cgroup), QList<int>());
+
+  QVERIFY(writeProcs(scope, "1234\n5678\n"));
+  QCOMPARE(watcher.pids(cgroup), QList<int>({1234, 5678}));
+
+  // Processes forking or exiting in a running scope are seen immediately.
+  QVERIFY(writeProcs(scope, "1234\n5678\n9012\n"));
+  QCOMPARE(watcher.pids(cgroup), QList<int>({1234, 5678, 9012}));
+  QVERIFY(writeProcs(scope, "9012\n"));
+  QCOMPARE(watcher.pids(cgroup), QList<int>({9012}));
+
+  // Unknown control groups are read too.
+  QVERIFY(QDir().mkpath(mountPoint.path() + "/init.scope"));
+  QVERIFY(writeProcs(mountPoint.path() + "/init.scope", "1\n"));
+  QCOMPARE(watcher.pids("/init.scope"), QList<int>({1}));
+}
+
+static TestCgroupWatcher s_testCgroupWatcher;
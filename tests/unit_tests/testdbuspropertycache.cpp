@@ -0,0 +1,84 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "testdbuspropertycache.h"
+
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QScopeGuard>
+#include <QSignalSpy>
+
+#include "platforms/linux/dbuspropertycache.h"
+
+namespace {
+constexpr const char* SERVICE_CONNECTION = "TestDBusPropertyCacheService";
+constexpr const char* MOCK_PATH = "/org/mozilla/vpn/test/PropertyCache";
+constexpr const char* MOCK_INTERFACE = "org.mozilla.vpn.test.PropertyCache";
+
+void emitPropertiesChanged(const QDBusConnection& connection,
+                           const QVariantMap& changed,
+                           const QStringList& invalidated) {
+  QDBusMessage signal = QDBusMessage::createSignal(
+      MOCK_PATH, "org.freedesktop.DBus.Properties", "PropertiesChanged");
+  signal << QString(MOCK_INTERFACE) << changed << invalidated;
+  QVERIFY(connection.send(signal));
+}
+}  // namespace
+
+void TestDBusPropertyCache::propertiesChanged() {
+  // The mock service has its own connection, as the real one would.
+  QDBusConnection service = QDBusConnection::connectToBus(
+      QDBusConnection::SessionBus, SERVICE_CONNECTION);
+  auto guard = qScopeGuard(
+      []() { QDBusConnection::disconnectFromBus(SERVICE_CONNECTION); });
+  if (!service.isConnected()) {
+    QSKIP("No session bus");
+  }
+
+  DBusPropertyCacheMock mock;
+  mock.m_state = "activated";
+  mock.m_strength = 42;
+  QVERIFY(service.registerObject(MOCK_PATH, &mock,
+                                 QDBusConnection::ExportAllProperties));
+
+  DBusPropertyCache cache(QDBusConnection::sessionBus(),
+                          service.baseService(), MOCK_INTERFACE);
+  QSignalSpy spy(&cache, &DBusPropertyCache::propertiesChanged);
+
+  // The properties are fetched asynchronously.
+  cache.watch(MOCK_PATH);
+  QVERIFY(cache.isWatched(MOCK_PATH));
+  QVERIFY(!cache.isReady(MOCK_PATH));
+  QVERIFY(spy.wait());
+  QVERIFY(cache.isReady(MOCK_PATH));
+  QCOMPARE(spy.last().at(0).toString(), MOCK_PATH);
+  QCOMPARE(cache.property(MOCK_PATH, "state").toString(), "activated");
+  QCOMPARE(cache.property(MOCK_PATH, "strength").toUInt(), 42u);
+
+  // The values of PropertiesChanged are applied as they are.
+  mock.m_strength = 80;
+  emitPropertiesChanged(service, QVariantMap{{"strength", 80u}},
+                        QStringList());
+  QVERIFY(spy.wait());
+  QCOMPARE(spy.last().at(1).toStringList(), QStringList{"strength"});
+  QCOMPARE(cache.property(MOCK_PATH, "strength").toUInt(), 80u);
+  QCOMPARE(cache.property(MOCK_PATH, "state").toString(), "activated");
+
+  // Invalidated properties are fetched again.
+  mock.m_state = "deactivated";
+  emitPropertiesChanged(service, QVariantMap(), QStringList{"state"});
+  QVERIFY(spy.wait());
+  QCOMPARE(cache.property(MOCK_PATH, "state").toString(), "deactivated");
+  QCOMPARE(cache.property(MOCK_PATH, "strength").toUInt(), 80u);
+
+  // Nothing is received once unwatched.
+  cache.unwatch(MOCK_PATH);
+  QVERIFY(!cache.isWatched(MOCK_PATH));
+  emitPropertiesChanged(service, QVariantMap{{"strength", 10u}},
+                        QStringList());
+  QVERIFY(!spy.wait(500));
+  QVERIFY(!cache.property(MOCK_PATH, "strength").isValid());
+}
+
+static TestDBusPropertyCache s_testDBusPropertyCache;
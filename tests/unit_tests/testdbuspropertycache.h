@@ -0,0 +1,27 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "helper.h"
+
+// Stands in for a NetworkManager object on a private session bus connection.
+class DBusPropertyCacheMock final : public QObject {
+  Q_OBJECT
+  Q_CLASSINFO("D-Bus Interface", "org.mozilla.vpn.test.PropertyCache")
+  Q_PROPERTY(QString state READ state)
+  Q_PROPERTY(uint strength READ strength)
+
+ public:
+  QString state() const { return m_state; }
+  uint strength() const { return m_strength; }
+
+  QString m_state;
+  uint m_strength = 0;
+};
+
+class TestDBusPropertyCache final : public TestHelper {
+  Q_OBJECT
+
+ private slots:
+  void propertiesChanged();
+};
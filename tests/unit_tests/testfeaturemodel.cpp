@@ -185,4 +185,19 @@ void TestFeatureModel::enableByAPI() {
               .m_defaultValue == "testValue");
 }
 
+void TestFeatureModel::featureIds() {
+  SettingsHolder settingsHolder;
+
+  // The compile-time ids and the string ids refer to the same features.
+  for (int i = 0; i < Feature::FeatureCount; ++i) {
+    const Feature* feature = Feature::get(static_cast<Feature::Id>(i));
+    QVERIFY(!!feature);
+    QCOMPARE(Feature::get(feature->id()), feature);
+  }
+
+  QCOMPARE(Feature::get(Feature::Feature_addon)->id(), "addon");
+  QCOMPARE(Feature::getAll().count(),
+           static_cast<qsizetype>(Feature::FeatureCount));
+}
+
 static TestFeatureModel s_testFeature;
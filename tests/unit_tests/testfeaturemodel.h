@@ -10,4 +10,5 @@ class TestFeatureModel final : public TestHelper {
  private slots:
   void flipOnOff();
   void enableByAPI();
+  void featureIds();
 };
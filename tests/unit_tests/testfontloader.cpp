@@ -0,0 +1,44 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "testfontloader.h"
+
+#include <QQmlAbstractUrlInterceptor>
+#include <QUrl>
+
+#include "fontloader.h"
+#include "resourceloader.h"
+
+namespace {
+
+class FontFolderInterceptor final : public QQmlAbstractUrlInterceptor {
+ public:
+  QUrl intercept(const QUrl& url,
+                 QQmlAbstractUrlInterceptor::DataType) override {
+    if (url == QUrl("qrc:/nebula/resources/fonts/")) {
+      return QUrl("qrc:/replace/");
+    }
+    return url;
+  }
+};
+
+}  // namespace
+
+void TestFontLoader::fontFiles() {
+  ResourceLoader* rl = ResourceLoader::instance();
+
+  // The fonts are the content of the font folder, wherever it is loaded
+  // from: a file added to the folder is registered too.
+  FontFolderInterceptor interceptor;
+  rl->addUrlInterceptor(&interceptor);
+
+  QStringList files = FontLoader::fontFiles();
+  files.sort();
+  QCOMPARE(files,
+           QStringList({":/replace/LICENSE.md", ":/replace/languages.json"}));
+
+  rl->removeUrlInterceptor(&interceptor);
+}
+
+static TestFontLoader s_testFontLoader;
@@ -0,0 +1,45 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "testjsonprefetch.h"
+
+#include <QJsonObject>
+
+#include "helper.h"
+#include "jsonprefetch.h"
+
+void TestJsonPrefetch::prefetched() {
+  JsonPrefetch prefetch;
+  prefetch.start("{\"a\":42}");
+
+  QJsonDocument doc = prefetch.take("{\"a\":42}");
+  QVERIFY(doc.isObject());
+  QCOMPARE(doc.object().value("a").toInt(), 42);
+
+  // The prefetched document is taken once.
+  QVERIFY(prefetch.take("invalid").isNull());
+}
+
+void TestJsonPrefetch::outdated() {
+  JsonPrefetch prefetch;
+  prefetch.start("{\"a\":42}");
+
+  // The settings changed after the prefetch started.
+  QJsonDocument doc = prefetch.take("{\"a\":43}");
+  QVERIFY(doc.isObject());
+  QCOMPARE(doc.object().value("a").toInt(), 43);
+}
+
+void TestJsonPrefetch::synchronous() {
+  JsonPrefetch prefetch;
+  QVERIFY(prefetch.take("").isNull());
+  QVERIFY(prefetch.take("[1,2]").isArray());
+
+  // The destructor does not wait for the job.
+  JsonPrefetch* pending = new JsonPrefetch();
+  pending->start("[1,2,3]");
+  delete pending;
+}
+
+static TestJsonPrefetch s_testJsonPrefetch;
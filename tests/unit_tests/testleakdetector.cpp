@@ -0,0 +1,88 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "testleakdetector.h"
+
+#include <atomic>
+#include <thread>
+
+#include "helper.h"
+#include "leakdetector.h"
+
+namespace {
+
+class LeakDetectorTracked final {
+ public:
+  LeakDetectorTracked() { MZ_COUNT_CTOR(LeakDetectorTracked); }
+  ~LeakDetectorTracked() { MZ_COUNT_DTOR(LeakDetectorTracked); }
+
+  uint64_t m_data = 0;
+};
+
+QHash<void*, uint32_t> tracked() {
+  return LeakDetector::liveObjects().value("LeakDetectorTracked");
+}
+
+}  // namespace
+
+void TestLeakDetector::ctorDtor() {
+  QVERIFY(tracked().isEmpty());
+
+  LeakDetectorTracked* a = new LeakDetectorTracked();
+  LeakDetectorTracked* b = new LeakDetectorTracked();
+
+  QHash<void*, uint32_t> live = tracked();
+  QCOMPARE(live.count(), 2);
+  QVERIFY(live.contains(a));
+  QVERIFY(live.contains(b));
+  QCOMPARE(live.value(a), static_cast<uint32_t>(sizeof(LeakDetectorTracked)));
+
+  delete a;
+  live = tracked();
+  QCOMPARE(live.count(), 1);
+  QVERIFY(live.contains(b));
+
+  delete b;
+  QVERIFY(tracked().isEmpty());
+}
+
+void TestLeakDetector::crossThread() {
+  QVERIFY(tracked().isEmpty());
+
+  // Created by another thread, destroyed by this one.
+  LeakDetectorTracked* a = nullptr;
+  std::thread creator([&a] { a = new LeakDetectorTracked(); });
+  creator.join();
+
+  QVERIFY(tracked().contains(a));
+  delete a;
+  QVERIFY(tracked().isEmpty());
+
+  // Created by this thread, destroyed by another one which is still running
+  // when the report is generated.
+  LeakDetectorTracked* b = new LeakDetectorTracked();
+  QVERIFY(tracked().contains(b));
+
+  std::atomic<bool> deleted = false;
+  std::atomic<bool> done = false;
+  std::thread destroyer([&] {
+    delete b;
+    deleted = true;
+    while (!done) {
+      std::this_thread::yield();
+    }
+  });
+
+  while (!deleted) {
+    std::this_thread::yield();
+  }
+  bool empty = tracked().isEmpty();
+
+  done = true;
+  destroyer.join();
+  QVERIFY(empty);
+  QVERIFY(tracked().isEmpty());
+}
+
+static TestLeakDetector s_testLeakDetector;
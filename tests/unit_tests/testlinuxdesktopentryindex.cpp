@@ -0,0 +1,127 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "testlinuxdesktopentryindex.h"
+
+#include <QFile>
+#include <QTemporaryDir>
+
+#include "platforms/linux/linuxdesktopentryindex.h"
+
+void TestLinuxDesktopEntryIndex::parseDesktopEntry_data() {
+  QTest::addColumn<QByteArray>("content");
+  QTest::addColumn<QString>("name");
+  QTest::addColumn<QString>("icon");
+  QTest::addColumn<bool>("visible");
+  QTest::addColumn<QStringList>("notShowIn");
+  QTest::addColumn<QStringList>("onlyShowIn");
+
+  QTest::addRow("application")
+      << QByteArray("[Desktop Entry]\n"
+                    "Type=Application\n"
+                    "Name=Firefox\n"
+                    "Icon=firefox\n"
+                    "Exec=firefox %u\n")
+      << "Firefox"
+      << "firefox" << true << QStringList() << QStringList();
+
+  QTest::addRow("comments and spaces")
+      << QByteArray("# A comment\n"
+                    "\n"
+                    "[Desktop Entry]\n"
+                    "  Type = Application  \n"
+                    "# Name=Commented\n"
+                    "Name = Text Editor\n"
+                    "Icon=/usr/share/pixmaps/editor.png\n")
+      << "Text Editor"
+      << "/usr/share/pixmaps/editor.png" << true << QStringList()
+      << QStringList();
+
+  QTest::addRow("no display")
+      << QByteArray("[Desktop Entry]\n"
+                    "Type=Application\n"
+                    "Name=Helper\n"
+                    "NoDisplay=true\n")
+      << "Helper" << QString() << false << QStringList() << QStringList();
+
+  QTest::addRow("hidden")
+      << QByteArray("[Desktop Entry]\n"
+                    "Hidden=true\n"
+                    "Type=Application\n"
+                    "Name=Removed\n")
+      << "Removed" << QString() << false << QStringList() << QStringList();
+
+  QTest::addRow("link")
+      << QByteArray("[Desktop Entry]\n"
+                    "Type=Link\n"
+                    "Name=Website\n"
+                    "URL=https://www.mozilla.org\n")
+      << "Website" << QString() << false << QStringList() << QStringList();
+
+  QTest::addRow("desktop filters")
+      << QByteArray("[Desktop Entry]\n"
+                    "Type=Application\n"
+                    "Name=Settings\n"
+                    "NotShowIn=KDE;LXQt;\n"
+                    "OnlyShowIn=GNOME;\n")
+      << "Settings" << QString() << true << QStringList({"KDE", "LXQt"})
+      << QStringList({"GNOME"});
+
+  QTest::addRow("other groups")
+      << QByteArray("[Other Group]\n"
+                    "Name=Before\n"
+                    "[Desktop Entry]\n"
+                    "Type=Application\n"
+                    "Name=Terminal\n"
+                    "[Desktop Action new-window]\n"
+                    "Name=New Window\n"
+                    "Icon=window-new\n")
+      << "Terminal" << QString() << true << QStringList() << QStringList();
+
+  QTest::addRow("utf-8")
+      << QByteArray("[Desktop Entry]\n"
+                    "Type=Application\n"
+                    "Name=Lecteur multim\xc3\xa9" "dia\n")
+      << QString::fromUtf8("Lecteur multim\xc3\xa9" "dia") << QString() << true
+      << QStringList() << QStringList();
+
+  QTest::addRow("empty") << QByteArray() << QString() << QString() << false
+                         << QStringList() << QStringList();
+}
+
+void TestLinuxDesktopEntryIndex::parseDesktopEntry() {
+  QFETCH(QByteArray, content);
+  QFETCH(QString, name);
+  QFETCH(QString, icon);
+  QFETCH(bool, visible);
+  QFETCH(QStringList, notShowIn);
+  QFETCH(QStringList, onlyShowIn);
+
+  QTemporaryDir folder;
+  QVERIFY(folder.isValid());
+
+  QFile file(folder.filePath("test.desktop"));
+  QVERIFY(file.open(QIODevice::WriteOnly));
+  QCOMPARE(file.write(content), content.length());
+  file.close();
+
+  LinuxDesktopEntryIndex::Entry entry;
+  QVERIFY(LinuxDesktopEntryIndex::parseDesktopEntry(file.fileName(), &entry));
+  QCOMPARE(entry.name, name);
+  QCOMPARE(entry.icon, icon);
+  QCOMPARE(entry.visible, visible);
+  QCOMPARE(entry.notShowIn, notShowIn);
+  QCOMPARE(entry.onlyShowIn, onlyShowIn);
+}
+
+void TestLinuxDesktopEntryIndex::parseMissingDesktopEntry() {
+  QTemporaryDir folder;
+  QVERIFY(folder.isValid());
+
+  LinuxDesktopEntryIndex::Entry entry;
+  QVERIFY(!LinuxDesktopEntryIndex::parseDesktopEntry(
+      folder.filePath("missing.desktop"), &entry));
+}
+
+static TestLinuxDesktopEntryIndex s_testLinuxDesktopEntryIndex;
@@ -0,0 +1,95 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "testnavigator.h"
+
+#include <QCoreApplication>
+#include <QQmlApplicationEngine>
+#include <QQmlComponent>
+#include <QScopeGuard>
+#include <QSignalSpy>
+
+#include "frontend/navigator.h"
+#include "qmlengineholder.h"
+
+namespace {
+constexpr const char* SCREEN_URL = "qrc:/components/FooBar.qml";
+
+// Two more than the budget of cached components.
+constexpr int TEMPORARY_SCREENS = 10;
+
+void registerScreen(int screen, Navigator::LoadPolicy loadPolicy) {
+  Navigator::registerScreen(
+      screen, loadPolicy, SCREEN_URL, QVector<int>{},
+      [](int*) -> int8_t { return 0; }, []() -> bool { return false; });
+}
+
+// Navigates to `screen`, and reports the screen as created, as the loader of
+// MZNavigatorLoader does once the component is ready.
+bool navigate(int screen) {
+  Navigator* navigator = Navigator::instance();
+  QSignalSpy spy(navigator, &Navigator::navigationCompleted);
+  navigator->requestScreen(screen);
+
+  QQmlComponent* component =
+      navigator->property("component").value<QQmlComponent*>();
+  if (!component ||
+      !QTest::qWaitFor([component]() { return !component->isLoading(); })) {
+    return false;
+  }
+
+  // The navigation is not completed before the screen is created.
+  if (!spy.isEmpty()) {
+    return false;
+  }
+
+  navigator->screenLoaded(component);
+
+  return spy.count() == 1 && spy.last().at(0).toInt() == screen;
+}
+}  // namespace
+
+void TestNavigator::componentEviction() {
+  QQmlApplicationEngine engine;
+  QmlEngineHolder qml(&engine);
+
+  // The components go away before their engine.
+  auto guard = qScopeGuard([]() {
+    Navigator::instance()->unregisterScreens();
+    QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+  });
+
+  // Screens 100 to 102 are persistent, 1 to 12 temporary.
+  registerScreen(100, Navigator::LoadPersistently);
+  registerScreen(101, Navigator::LoadPersistently);
+  registerScreen(102, Navigator::LoadPersistently);
+  for (int screen = 1; screen <= TEMPORARY_SCREENS + 2; ++screen) {
+    registerScreen(screen, Navigator::LoadTemporarily);
+  }
+
+  QVERIFY(navigate(100));
+  QVERIFY(navigate(101));
+  for (int screen = 1; screen <= TEMPORARY_SCREENS; ++screen) {
+    QVERIFY(navigate(screen));
+  }
+
+  // The persistent screens do not count: the two least recently used
+  // temporary screens have been released.
+  QCOMPARE(Navigator::cachedScreens(),
+           QList<int>({100, 101, 3, 4, 5, 6, 7, 8, 9, 10}));
+
+  // A visit refreshes a screen: the next eviction skips it.
+  Navigator::registerNextScreens(11, QVector<int>{12, 102});
+  QVERIFY(navigate(3));
+  QVERIFY(navigate(11));
+  QCOMPARE(Navigator::cachedScreens(),
+           QList<int>({100, 101, 5, 6, 7, 8, 9, 10, 3, 11}));
+
+  // The budget is full, but the persistent next screens are still compiled.
+  // A temporary one would evict a component of the budget.
+  QTRY_VERIFY(Navigator::cachedScreens().contains(102));
+  QVERIFY(!Navigator::cachedScreens().contains(12));
+}
+
+static TestNavigator s_testNavigator;
@@ -7,6 +7,7 @@
 #include <QQmlApplicationEngine>
 #include <QQuickItem>
 
+#include "qmlitemindex.h"
 #include "qmlpath.h"
 
 void TestQmlPath::parse_data() {
@@ -178,4 +179,119 @@ void TestQmlPath::evaluate() {
   }
 }
 
+void TestQmlPath::evaluateIndexed() {
+  QQmlApplicationEngine engine("qrc:a.qml");
+  QmlItemIndex index(&engine);
+
+  QFETCH(QString, input);
+  QmlPath qmlPath(input);
+
+  QVERIFY(qmlPath.isValid());
+
+  // The index must not change the result of the evaluation.
+  QFETCH(bool, result);
+  QQuickItem* output = qmlPath.evaluate(&engine, &index);
+  QCOMPARE(output, qmlPath.evaluate(&engine));
+  QCOMPARE(!!output, result);
+
+  if (output) {
+    QFETCH(QString, name);
+    QCOMPARE(output->objectName(), name);
+  }
+}
+
+void TestQmlPath::evaluateIndexedDynamic() {
+  QQmlApplicationEngine engine("qrc:a.qml");
+  QmlItemIndex index(&engine);
+
+  QCOMPARE(engine.rootObjects().count(), 1);
+  QQuickItem* root = qobject_cast<QQuickItem*>(engine.rootObjects()[0]);
+  QVERIFY(root);
+
+  // The index must follow the changes made after the first lookup: the
+  // indexed evaluation must always match the unindexed one.
+  QStringList mismatches;
+  auto evaluate = [&](const QString& path) {
+    QmlPath qmlPath(path);
+    QQuickItem* output = qmlPath.evaluate(&engine, &index);
+    if (output != qmlPath.evaluate(&engine)) {
+      mismatches.append(path);
+    }
+    return output;
+  };
+
+  QQuickItem* def = root->findChild<QQuickItem*>("def");
+  QVERIFY(def);
+  QQuickItem* ghi = evaluate("//ghi");
+  QVERIFY(ghi);
+  QVERIFY(!evaluate("//dyn"));
+
+  // A new item.
+  QQuickItem* dyn = new QQuickItem(def);
+  dyn->setObjectName("dyn");
+  QCOMPARE(evaluate("//dyn"), dyn);
+  QCOMPARE(evaluate("/abc/def/dyn"), dyn);
+
+  // A new subtree: its children are indexed too.
+  QQuickItem* subtree = new QQuickItem();
+  subtree->setObjectName("subtree");
+  QQuickItem* leaf = new QQuickItem(subtree);
+  leaf->setObjectName("leaf");
+  subtree->setParent(dyn);
+  subtree->setParentItem(dyn);
+  QCOMPARE(evaluate("//leaf"), leaf);
+  QCOMPARE(evaluate("//dyn//leaf"), leaf);
+
+  // A child added to an item already walked by the index.
+  QQuickItem* late = new QQuickItem(leaf);
+  late->setObjectName("late");
+  QCOMPARE(evaluate("//subtree/leaf/late"), late);
+
+  // A subtree moved out of the tree, then back.
+  subtree->setParentItem(nullptr);
+  QVERIFY(!evaluate("//leaf"));
+  subtree->setParentItem(def);
+  QCOMPARE(evaluate("//leaf"), leaf);
+  QCOMPARE(evaluate("/abc/def/subtree/leaf"), leaf);
+
+  // An objectName set or changed after the indexing.
+  QQuickItem* unnamed = new QQuickItem(def);
+  QVERIFY(!evaluate("//named"));
+  unnamed->setObjectName("named");
+  QCOMPARE(evaluate("//named"), unnamed);
+
+  ghi->setObjectName("renamed");
+  QVERIFY(!evaluate("//ghi"));
+  QCOMPARE(evaluate("//def/renamed"), ghi);
+
+  // Two items sharing a name, then one of them renamed again.
+  unnamed->setObjectName("renamed");
+  QCOMPARE(evaluate("//renamed[1]"), unnamed);
+  unnamed->setObjectName("");
+  QVERIFY(!evaluate("//renamed[1]"));
+  QCOMPARE(evaluate("//renamed"), ghi);
+
+  // Destroyed items, alone or with their subtree.
+  delete late;
+  QVERIFY(!evaluate("//late"));
+  QCOMPARE(evaluate("//leaf"), leaf);
+
+  delete dyn;
+  QVERIFY(!evaluate("//dyn"));
+  QVERIFY(!evaluate("//subtree"));
+  QVERIFY(!evaluate("//leaf"));
+
+  QQuickItem* rangeB = evaluate("//rangeB[1]");
+  QVERIFY(rangeB);
+  QQuickItem* foo = evaluate("//rangeB[1]/foo");
+  QVERIFY(foo);
+  QCOMPARE(foo->parentItem(), rangeB);
+  delete rangeB;
+  QVERIFY(!evaluate("//rangeB[1]"));
+  QVERIFY(!evaluate("//rangeB[1]/foo"));
+  QVERIFY(evaluate("//rangeB[0]"));
+
+  QVERIFY2(mismatches.isEmpty(), qPrintable(mismatches.join(", ")));
+}
+
 static TestQmlPath s_testQmlPath;
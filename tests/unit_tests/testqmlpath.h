@@ -13,4 +13,8 @@ class TestQmlPath : public TestHelper {
 
   void evaluate_data();
   void evaluate();
+
+  void evaluateIndexed_data() { evaluate_data(); }
+  void evaluateIndexed();
+  void evaluateIndexedDynamic();
 };
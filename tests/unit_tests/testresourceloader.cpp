@@ -89,8 +89,8 @@ void TestResourceLoader::commonPasswords() {
 
   QCOMPARE(aia->validatePasswordCommons("12345678"), false);
 
-  Interceptor i(QUrl("qrc:/resources/encodedPassword.txt"),
-                QUrl("qrc:/replace/encodedPassword.txt"));
+  Interceptor i(QUrl("qrc:/resources/commonPasswords.idx"),
+                QUrl("qrc:/replace/commonPasswords.idx"));
 
   ResourceLoader* rl = ResourceLoader::instance();
 
@@ -0,0 +1,76 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "testtracer.h"
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include "helper.h"
+#include "tracer.h"
+
+void TestTracer::cleanup() {
+  Tracer::instance()->clear();
+  Tracer::instance()->setTraceId(QString());
+}
+
+void TestTracer::spans() {
+  Tracer* tracer = Tracer::instance();
+
+  QString first = tracer->startTrace();
+  QVERIFY(!first.isEmpty());
+  QCOMPARE(tracer->traceId(), first);
+
+  qint64 start = Tracer::now();
+  { TraceSpan span("outer"); }
+  QVERIFY(Tracer::now() >= start);
+
+  QString second = tracer->startTrace();
+  QVERIFY(second != first);
+  tracer->addSpan("manual", 100, 50);
+
+  QCOMPARE(tracer->events().count(), 2);
+  QCOMPARE(tracer->events(second).count(), 1);
+
+  QJsonObject event = tracer->events(first).at(0).toObject();
+  QCOMPARE(event["name"].toString(), "outer");
+  QCOMPARE(event["ph"].toString(), "X");
+  QVERIFY(event["ts"].toInteger() >= start);
+  QVERIFY(event["dur"].toInteger() >= 0);
+  QCOMPARE(event["args"].toObject()["traceId"].toString(), first);
+
+  // Spans ending before they start are recorded as empty ones.
+  event = tracer->events(second).at(0).toObject();
+  QCOMPARE(event["ts"].toInteger(), 100);
+  QCOMPARE(event["dur"].toInteger(), 0);
+
+  // The export is a valid Chrome trace document.
+  QJsonDocument json = QJsonDocument::fromJson(tracer->toChromeTrace(first));
+  QVERIFY(json.isObject());
+  QCOMPARE(json.object()["traceEvents"].toArray().count(), 1);
+}
+
+void TestTracer::importEvents() {
+  Tracer* tracer = Tracer::instance();
+  tracer->setTraceId("abc");
+  tracer->addSpan("local", 10, 20);
+
+  // takeEvents() forgets what it returns, as the daemon does.
+  QJsonArray events = tracer->takeEvents();
+  QCOMPARE(events.count(), 1);
+  QVERIFY(tracer->events().isEmpty());
+
+  QJsonObject invalid;
+  invalid["ph"] = "B";
+  invalid["name"] = "invalid";
+  events.append(invalid);
+
+  tracer->importEvents(events);
+  QJsonArray imported = tracer->events("abc");
+  QCOMPARE(imported.count(), 1);
+  QCOMPARE(imported.at(0).toObject(), events.at(0).toObject());
+}
+
+static TestTracer s_testTracer;
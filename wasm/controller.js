@@ -139,6 +139,7 @@ class Controller {
     // Ignoring logs.
     if (obj.type === 'log') return;
     if (obj.type === 'network') return;
+    if (obj.type === 'navigation') return;
     if (obj.type === 'notification') return;
     if (obj.type === 'addon_load_completed') return;
 